@@ -684,6 +684,70 @@ extern DECLSPEC SDL_AudioStatus SDLCALL SDL_GetAudioStatus(void);
  * \sa SDL_PauseAudioDevice
  */
 extern DECLSPEC SDL_AudioStatus SDLCALL SDL_GetAudioDeviceStatus(SDL_AudioDeviceID dev);
+
+/**
+ * Timing statistics gathered by an open audio device's thread.
+ *
+ * All durations are in nanoseconds. A "wakeup" is the moment the device
+ * thread returns from waiting for the device (or from pacing itself when the
+ * device can't block), which should happen once per `period_ns`. A wakeup is
+ * counted as late when it comes more than a quarter period after it was due.
+ *
+ * Underruns are playback buffers that could not be filled in time, either
+ * because the device thread fell a whole period behind or because data
+ * queued with SDL_QueueAudio() ran out partway through a buffer. Overruns
+ * are capture periods the device thread woke too late to read in time, so
+ * the device probably dropped input.
+ *
+ * \sa SDL_GetAudioDeviceStats
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    SDL_bool low_latency;       /**< SDL_TRUE if opened with SDL_HINT_AUDIO_LOW_LATENCY */
+    Uint64 period_ns;           /**< Nominal time covered by one device buffer */
+    Uint64 wakeups;             /**< Number of times the device thread woke up */
+    Uint64 late_wakeups;        /**< Wakeups that came more than a quarter period late */
+    Uint64 underruns;           /**< Playback buffers that could not be filled in time */
+    Uint64 overruns;            /**< Capture periods that were read too late */
+    Uint64 callbacks;           /**< Number of times the audio callback ran */
+    Uint64 callback_ns;         /**< Duration of the most recent audio callback */
+    Uint64 callback_min_ns;     /**< Shortest audio callback seen */
+    Uint64 callback_avg_ns;     /**< Average audio callback duration */
+    Uint64 callback_max_ns;     /**< Longest audio callback seen */
+    Uint64 wake_jitter_ns;      /**< Deviation of the most recent wakeup interval from the period */
+    Uint64 wake_jitter_max_ns;  /**< Largest wakeup deviation seen */
+    Uint64 conversion_ns;       /**< Time spent converting/resampling the most recent buffer */
+    Uint64 conversion_max_ns;   /**< Longest conversion seen */
+    Uint32 queued_bytes;        /**< Bytes waiting in the SDL_QueueAudio() queue */
+    Uint32 stream_bytes;        /**< Converted bytes left in the device's SDL_AudioStream */
+} SDL_AudioDeviceStats;
+
+/**
+ * Get timing statistics for an open audio device.
+ *
+ * The statistics are accumulated from the moment the device is opened. They
+ * are most useful with SDL_HINT_AUDIO_LOW_LATENCY, where the device thread
+ * paces itself against absolute deadlines and the numbers show how well it
+ * keeps up.
+ *
+ * Devices whose backend provides its own callback thread only report
+ * `low_latency`, `period_ns` and `queued_bytes`.
+ *
+ * Set SDL_HINT_AUDIO_STATS_LOG_INTERVAL to have the device thread log the
+ * same numbers periodically.
+ *
+ * \param dev the ID of an audio device previously opened with
+ *            SDL_OpenAudioDevice()
+ * \param stats an SDL_AudioDeviceStats structure to be filled in
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_OpenAudioDevice
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev,
+                                                    SDL_AudioDeviceStats *stats);
 /* @} *//* Audio State */
 
 /**
@@ -750,6 +814,44 @@ extern DECLSPEC void SDLCALL SDL_PauseAudioDevice(SDL_AudioDeviceID dev,
                                                   int pause_on);
 /* @} *//* Pause audio functions */
 
+/**
+ * Set the gain applied to a logical audio device when it is mixed.
+ *
+ * With SDL_HINT_AUDIO_LOGICAL_DEVICES set, output devices opened with the
+ * same device name are logical devices mixed onto one physical device by a
+ * single thread. Each logical device's output is converted to float and
+ * multiplied by its gain before it is added to the mix. The final mix is
+ * clamped to the device's range.
+ *
+ * \param dev the ID of a logical audio device
+ * \param gain the new gain; 1.0f leaves the output unchanged, 0.0f silences
+ *             it, and values above 1.0f amplify it
+ * \returns 0 on success or a negative error code on failure, including if
+ *          `dev` is not a logical device; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetAudioDeviceGain
+ * \sa SDL_OpenAudioDevice
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioDeviceGain(SDL_AudioDeviceID dev, float gain);
+
+/**
+ * Get the gain applied to a logical audio device when it is mixed.
+ *
+ * \param dev the ID of a logical audio device
+ * \param gain a pointer filled in with the current gain
+ * \returns 0 on success or a negative error code on failure, including if
+ *          `dev` is not a logical device; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_SetAudioDeviceGain
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceGain(SDL_AudioDeviceID dev, float *gain);
+
 /**
  * Load the audio data of a WAVE file into memory.
  *
@@ -1082,6 +1184,144 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+/* SDL_WaveStream decodes a WAVE file on demand, one block at a time, instead
+   of loading and decoding all of it up front like SDL_LoadWAV_RW() does.
+   Memory use stays constant no matter how long the file is.
+ */
+/* this is opaque to the outside world. */
+struct _SDL_WaveStream;
+typedef struct _SDL_WaveStream SDL_WaveStream;
+
+/**
+ * Open a WAVE file for streaming.
+ *
+ * This parses the headers of the WAVE file and fills `spec` with the format
+ * that SDL_WaveStreamRead() will return, exactly like SDL_LoadWAV_RW() would
+ * for the same file. The sample data is decoded only as it is read.
+ *
+ * The same encodings as SDL_LoadWAV_RW() are supported, and the
+ * SDL_HINT_WAVE_RIFF_CHUNK_SIZE, SDL_HINT_WAVE_TRUNCATION and
+ * SDL_HINT_WAVE_FACT_CHUNK hints are respected.
+ *
+ * The stream reads from `src` until it is closed, so `src` must stay valid
+ * and must be seekable. If `src` is a memory stream (SDL_RWFromMem() or
+ * SDL_RWFromConstMem()), the data is decoded directly from that memory
+ * without copying it first.
+ *
+ * \param src the data source for the WAVE data
+ * \param freesrc if non-zero, SDL_WaveStreamClose() will close `src`; it is
+ *                also closed if this function fails
+ * \param spec an SDL_AudioSpec that will be filled in with the format of
+ *             the decoded data
+ * \returns a new SDL_WaveStream, or NULL on error; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamRead
+ * \sa SDL_WaveStreamSeek
+ * \sa SDL_WaveStreamPut
+ * \sa SDL_WaveStreamClose
+ */
+extern DECLSPEC SDL_WaveStream * SDLCALL SDL_WaveStreamOpen(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec);
+
+/**
+ * Decode audio data from a WAVE stream.
+ *
+ * Only whole sample frames are returned, so the result is always a multiple
+ * of the frame size (the sample size times the channel count).
+ *
+ * \param stream the stream to read from
+ * \param buf a buffer to fill with audio data
+ * \param len the maximum number of bytes to fill
+ * \returns the number of bytes read, 0 at the end of the stream, or -1 on
+ *          error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamOpen
+ * \sa SDL_WaveStreamSeek
+ */
+extern DECLSPEC int SDLCALL SDL_WaveStreamRead(SDL_WaveStream *stream, void *buf, int len);
+
+/**
+ * Move the read position of a WAVE stream.
+ *
+ * For ADPCM data only the block that contains `frame` is decoded.
+ *
+ * \param stream the stream to seek in
+ * \param frame the sample frame to continue reading from, between 0 and
+ *              SDL_WaveStreamLength()
+ * \returns 0 on success, or -1 on error; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamTell
+ * \sa SDL_WaveStreamLength
+ */
+extern DECLSPEC int SDLCALL SDL_WaveStreamSeek(SDL_WaveStream *stream, Sint64 frame);
+
+/**
+ * Get the read position of a WAVE stream.
+ *
+ * \param stream the stream to query
+ * \returns the sample frame that will be read next, or -1 on error; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WaveStreamTell(SDL_WaveStream *stream);
+
+/**
+ * Get the length of a WAVE stream.
+ *
+ * \param stream the stream to query
+ * \returns the number of sample frames in the stream, or -1 on error; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WaveStreamLength(SDL_WaveStream *stream);
+
+/**
+ * Decode audio data from a WAVE stream into an audio stream.
+ *
+ * This reads up to `len` bytes with SDL_WaveStreamRead() and adds them to
+ * `audiostream` with SDL_AudioStreamPut(). The audio stream's source format
+ * must match the spec returned by SDL_WaveStreamOpen(). When this returns 0,
+ * the WAVE stream is at its end and you may want to call
+ * SDL_AudioStreamFlush().
+ *
+ * \param stream the stream to read from
+ * \param audiostream the audio stream to add the data to
+ * \param len the maximum number of bytes to decode
+ * \returns the number of bytes added, 0 at the end of the stream, or -1 on
+ *          error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamRead
+ * \sa SDL_NewAudioStream
+ * \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_WaveStreamPut(SDL_WaveStream *stream, SDL_AudioStream *audiostream, int len);
+
+/**
+ * Close a WAVE stream.
+ *
+ * \param stream the stream to close; NULL is ignored
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaveStreamOpen
+ */
+extern DECLSPEC void SDLCALL SDL_WaveStreamClose(SDL_WaveStream *stream);
+
 #define SDL_MIX_MAXVOLUME 128
 
 /**
@@ -146,12 +146,51 @@ typedef enum
     SDL_EFWRITE,
     SDL_EFSEEK,
     SDL_UNSUPPORTED,
+    SDL_ENOERROR,   /**< No error has been set on this thread */
+    SDL_EMESSAGE,   /**< The error is only described by its message */
     SDL_LASTERROR
 } SDL_errorcode;
 /* SDL_Error() unconditionally returns -1. */
 extern DECLSPEC int SDLCALL SDL_Error(SDL_errorcode code);
 /* @} *//* Internal error functions */
 
+/**
+ * Set a numeric error code for the current thread.
+ *
+ * This works like SDL_SetError(), but it only records the code. The matching
+ * message is produced when SDL_GetError() asks for it, so this is cheap
+ * enough to call on paths that fail routinely.
+ *
+ * \param code the error code to set, one of SDL_ENOMEM, SDL_EFREAD,
+ *             SDL_EFWRITE, SDL_EFSEEK or SDL_UNSUPPORTED
+ * \returns always -1.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetError
+ * \sa SDL_GetErrorCode
+ */
+extern DECLSPEC int SDLCALL SDL_SetErrorCode(SDL_errorcode code);
+
+/**
+ * Get the numeric code of the last error that occurred on the current
+ * thread.
+ *
+ * Like the message returned by SDL_GetError(), this is only meaningful after
+ * an SDL function has signaled an error.
+ *
+ * \returns the code passed to SDL_SetErrorCode(), `SDL_EMESSAGE` if the error
+ *          was set with SDL_SetError(), or `SDL_ENOERROR` if there hasn't
+ *          been an error since the last call to SDL_ClearError().
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_ClearError
+ * \sa SDL_GetError
+ * \sa SDL_SetErrorCode
+ */
+extern DECLSPEC SDL_errorcode SDLCALL SDL_GetErrorCode(void);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -722,6 +722,36 @@ extern DECLSPEC int SDLCALL SDL_PeepEvents(SDL_Event * events, int numevents,
                                            Uint32 minType, Uint32 maxType);
 /* @} */
 
+/**
+ * Pump the event loop and remove a batch of events from the event queue.
+ *
+ * This takes every pending event with a type in the range `minType` to
+ * `maxType`, up to `maxevents` of them, in the order they were queued, with
+ * a single pass over the event queue. It's meant for input loops that would
+ * otherwise call SDL_PollEvent() once for each of many high-rate events, such
+ * as mouse motion or sensor updates.
+ *
+ * As this function implicitly calls SDL_PumpEvents(), you can only call this
+ * function in the thread that set the video mode.
+ *
+ * \param events an array of at least `maxevents` SDL_Event structures to fill
+ * \param maxevents the maximum number of events to remove
+ * \param minType minimum value of the event type to be removed; see
+ *                SDL_EventType for details
+ * \param maxType maximum value of the event type to be removed; see
+ *                SDL_EventType for details
+ * \returns the number of events stored in `events`, or a negative error code
+ *          on failure; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_PeepEvents
+ * \sa SDL_PollEvent
+ * \sa SDL_HINT_EVENT_COALESCE
+ */
+extern DECLSPEC int SDLCALL SDL_DrainEvents(SDL_Event * events, int maxevents,
+                                            Uint32 minType, Uint32 maxType);
+
 /**
  * Check for the existence of a certain event type in the event queue.
  *
@@ -412,6 +412,25 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling whether high-rate motion events are merged while they wait in the event queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Every motion event is queued separately (default)
+ *    "1"     - An event is merged into the most recently queued event if both are
+ *              motion of the same mouse, finger, joystick axis or ball, or updates
+ *              of the same sensor.
+ *
+ *  A merged mouse, finger or ball motion event has the latest position and the
+ *  sum of the relative motion of the events it replaces. Axis and sensor events
+ *  keep only their latest value. Events are never merged across other events,
+ *  so the order of the queue is preserved.
+ *
+ *  This hint can be toggled on and off at runtime.
+ */
+#define SDL_HINT_EVENT_COALESCE   "SDL_EVENT_COALESCE"
+
 /**
  *  \brief  A variable controlling how 3D acceleration is used to accelerate the SDL screen surface.
  *
@@ -1144,7 +1163,9 @@ extern "C" {
  *  This variable can be set to the following values:
  *    "0" or "nearest" - Nearest pixel sampling
  *    "1" or "linear"  - Linear filtering (supported by OpenGL and Direct3D)
- *    "2" or "best"    - Currently this is the same as "linear"
+ *    "2" or "best"    - Currently this is the same as "linear", except that the
+ *                       software renderer averages the covered pixels when
+ *                       reducing a texture by more than 2x
  *
  *  By default nearest pixel sampling is used
  */
@@ -1562,6 +1583,21 @@ extern "C" {
  */
 #define SDL_HINT_WAVE_TRUNCATION   "SDL_WAVE_TRUNCATION"
 
+/**
+ *  \brief  Controls how many threads decode the blocks of an ADPCM WAVE file.
+ *
+ *  MS ADPCM and IMA ADPCM blocks don't depend on each other, so a large file
+ *  can be decoded on several threads at once. Small files, like most sound
+ *  effects, are always decoded on the calling thread.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"       - Use up to one thread per CPU core (default)
+ *    "1"       - Decode on the calling thread only
+ *    "N"       - Use up to N threads, including the calling thread
+ */
+#define SDL_HINT_WAVE_DECODE_THREADS   "SDL_WAVE_DECODE_THREADS"
+
 /**
  * \brief Tell SDL not to name threads on Windows with the 0x406D1388 Exception.
  *        The 0x406D1388 Exception is a trick used to inform Visual Studio of a
@@ -1824,6 +1860,98 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_INCLUDE_MONITORS "SDL_AUDIO_INCLUDE_MONITORS"
 
+/**
+ *  \brief  A variable controlling whether audio devices are opened in low-latency mode
+ *
+ *  In low-latency mode the audio device thread paces itself against absolute
+ *  deadlines on the performance counter instead of sleeping a whole buffer
+ *  with SDL_Delay(), capture threads run at SDL_THREAD_PRIORITY_TIME_CRITICAL,
+ *  and devices opened with `samples` set to 0 default to a 128 sample frame
+ *  period instead of ~46 milliseconds. Backends that have no device to block
+ *  on, like the "disk" driver, use the same deadline pacing.
+ *
+ *  For a realtime scheduling policy on Linux, also set
+ *  SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL.
+ *
+ *  Timing can be checked with SDL_GetAudioDeviceStats().
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use normal audio thread pacing (default)
+ *    "1"       - Use low-latency pacing for devices opened from now on
+ *
+ *  This hint is checked in SDL_OpenAudioDevice().
+ */
+#define SDL_HINT_AUDIO_LOW_LATENCY "SDL_AUDIO_LOW_LATENCY"
+
+/**
+ *  \brief  A variable setting how often audio devices log their timing statistics
+ *
+ *  When set to a number of milliseconds greater than 0, each audio device
+ *  thread logs the numbers returned by SDL_GetAudioDeviceStats() at that
+ *  interval, at SDL_LOG_PRIORITY_INFO in SDL_LOG_CATEGORY_AUDIO.
+ *
+ *  The default value is "0", which disables logging.
+ *
+ *  This hint is checked in SDL_OpenAudioDevice().
+ */
+#define SDL_HINT_AUDIO_STATS_LOG_INTERVAL "SDL_AUDIO_STATS_LOG_INTERVAL"
+
+/**
+ *  \brief  A variable controlling whether output devices are mixed onto a shared physical device
+ *
+ *  When enabled, each output device opened with SDL_OpenAudioDevice() is a
+ *  logical device. Logical devices opened with the same device name share one
+ *  physical device, and a single thread mixes them in float. Each logical
+ *  device keeps its own callback or queue, format, pause state and lock, and
+ *  gets its own gain (see SDL_SetAudioDeviceGain()). The physical device opens
+ *  with the first logical device's frequency, channels and buffer size, and
+ *  closes with the last one.
+ *
+ *  This saves a thread, a backend stream and a conversion path for each
+ *  extra device an app opens for music, effects or voice. Drivers that bring
+ *  their own callback thread and capture devices always get a device of their
+ *  own.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Every device opens its own physical device (default)
+ *    "1"       - Output devices opened from now on are logical devices
+ *
+ *  This hint is checked in SDL_OpenAudioDevice().
+ */
+#define SDL_HINT_AUDIO_LOGICAL_DEVICES "SDL_AUDIO_LOGICAL_DEVICES"
+
+/**
+ *  \brief  A variable setting how many threads large software blits and pixel conversions use
+ *
+ *  When set to a number greater than 1, SDL_ConvertPixels(),
+ *  SDL_ConvertSurface() and unscaled software blits split the destination
+ *  into bands of rows and convert them on that many threads, the calling
+ *  thread included. YUV conversions to and from RGB are split the same way.
+ *  The worker threads are started the first time they are needed and stop
+ *  in SDL_Quit().
+ *
+ *  The default value is "0", which does all of the work on the calling
+ *  thread.
+ *
+ *  This hint is checked on every blit and conversion.
+ *
+ *  \sa SDL_HINT_BLIT_THREADS_MIN_PIXELS
+ */
+#define SDL_HINT_BLIT_THREADS "SDL_BLIT_THREADS"
+
+/**
+ *  \brief  A variable setting the smallest blit that is split across threads
+ *
+ *  Blits and conversions with fewer destination pixels than this stay on the
+ *  calling thread even if SDL_HINT_BLIT_THREADS is set, because starting the
+ *  other threads costs more than they save.
+ *
+ *  The default value is "262144", or 512x512 pixels.
+ *
+ *  This hint is checked on every blit and conversion.
+ */
+#define SDL_HINT_BLIT_THREADS_MIN_PIXELS "SDL_BLIT_THREADS_MIN_PIXELS"
+
 
 /**
  *  \brief  An enumeration of hint priorities
@@ -1904,6 +2032,115 @@ extern DECLSPEC const char * SDLCALL SDL_GetHint(const char *name);
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_GetHintBoolean(const char *name, SDL_bool default_value);
 
+/**
+ * A handle to a hint, for reading it without looking it up by name.
+ *
+ * \sa SDL_GetHintHandle
+ */
+typedef struct SDL_HintHandle SDL_HintHandle;
+
+/**
+ * Get a handle to a hint.
+ *
+ * The handle stays valid until SDL_ClearHints() is called, which SDL_Quit()
+ * does, so it can be looked up once and kept. The hint doesn't have to be
+ * set yet.
+ *
+ * \param name the hint to get a handle to
+ * \returns a handle to the hint or NULL on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHintHandleGeneration
+ * \sa SDL_GetHintHandleValue
+ */
+extern DECLSPEC SDL_HintHandle * SDLCALL SDL_GetHintHandle(const char *name);
+
+/**
+ * Get a number that changes whenever the value of a hint may have changed.
+ *
+ * The number changes when SDL_SetHint() or SDL_SetHintWithPriority() gives
+ * the hint a new value, and when SDL_setenv() changes the environment.
+ * Environment variables changed directly with the C library are only seen
+ * after one of these. This only reads a couple of counters, so it's cheap
+ * enough to check every frame or event, and re-read the hint only when the
+ * number changes.
+ *
+ * \param handle the handle of the hint to check
+ * \returns the current generation of the hint.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHintHandle
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetHintHandleGeneration(SDL_HintHandle *handle);
+
+/**
+ * Get the value of a hint from its handle.
+ *
+ * The string stays valid until SDL_ClearHints() is called, even if the hint
+ * changes in the meantime.
+ *
+ * \param handle the handle of the hint to query
+ * \returns the string value of a hint or NULL if the hint isn't set.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHint
+ * \sa SDL_GetHintHandle
+ */
+extern DECLSPEC const char * SDLCALL SDL_GetHintHandleValue(SDL_HintHandle *handle);
+
+/**
+ * Get the boolean value of a hint from its handle.
+ *
+ * The value is parsed when the hint changes, not each time it's read.
+ *
+ * \param handle the handle of the hint to query
+ * \param default_value the value to return if the hint isn't set or is empty
+ * \returns the boolean value of the hint or the provided default value.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHintBoolean
+ * \sa SDL_GetHintHandle
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_GetHintHandleBoolean(SDL_HintHandle *handle, SDL_bool default_value);
+
+/**
+ * Get the integer value of a hint from its handle.
+ *
+ * The value is parsed with SDL_atoi() when the hint changes, not each time
+ * it's read.
+ *
+ * \param handle the handle of the hint to query
+ * \param default_value the value to return if the hint isn't set or is empty
+ * \returns the integer value of the hint or the provided default value.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHintHandle
+ */
+extern DECLSPEC int SDLCALL SDL_GetHintHandleInt(SDL_HintHandle *handle, int default_value);
+
+/**
+ * Get the floating point value of a hint from its handle.
+ *
+ * The value is parsed with SDL_atof() when the hint changes, not each time
+ * it's read.
+ *
+ * \param handle the handle of the hint to query
+ * \param default_value the value to return if the hint isn't set or is empty
+ * \returns the floating point value of the hint or the provided default
+ *          value.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetHintHandle
+ */
+extern DECLSPEC float SDLCALL SDL_GetHintHandleFloat(SDL_HintHandle *handle, float default_value);
+
 /**
  * Type definition of the hint callback function.
  *
@@ -1949,7 +2186,9 @@ extern DECLSPEC void SDLCALL SDL_DelHintCallback(const char *name,
 /**
  * Clear all hints.
  *
- * This function is automatically called during SDL_Quit().
+ * This function is automatically called during SDL_Quit(). It frees hint
+ * handles and the strings returned for hints, so it must not be called
+ * while other threads use hints.
  *
  * \since This function is available since SDL 2.0.0.
  */
@@ -164,6 +164,142 @@ extern DECLSPEC void SDLCALL SDL_DestroyMutex(SDL_mutex * mutex);
 /* @} *//* Mutex functions */
 
 
+/**
+ *  \name Reader-writer lock functions
+ */
+/* @{ */
+
+/* The SDL reader-writer lock structure, defined in SDL_sysrwlock.c */
+struct SDL_rwlock;
+typedef struct SDL_rwlock SDL_rwlock;
+
+/**
+ * Create a new reader-writer lock.
+ *
+ * A reader-writer lock is useful for data that is read often and changed
+ * rarely: any number of threads can hold the lock for reading at the same
+ * time, but a thread that holds it for writing excludes everyone else.
+ *
+ * All newly-created reader-writer locks begin in the _unlocked_ state.
+ *
+ * Unlike SDL mutexes, SDL reader-writer locks are not reentrant: a thread
+ * must not lock one that it already holds, in either mode, and a read lock
+ * can't be upgraded to a write lock. Doing so may deadlock.
+ *
+ * \returns the initialized and unlocked lock or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_DestroyRWLock
+ * \sa SDL_LockRWLockForReading
+ * \sa SDL_LockRWLockForWriting
+ * \sa SDL_TryLockRWLockForReading
+ * \sa SDL_TryLockRWLockForWriting
+ * \sa SDL_UnlockRWLock
+ */
+extern DECLSPEC SDL_rwlock *SDLCALL SDL_CreateRWLock(void);
+
+/**
+ * Lock a reader-writer lock for reading.
+ *
+ * This will block while another thread holds the lock for writing. Other
+ * threads may hold the lock for reading at the same time.
+ *
+ * \param rwlock the lock to lock
+ * \returns 0, or -1 on error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_LockRWLockForWriting
+ * \sa SDL_TryLockRWLockForReading
+ * \sa SDL_UnlockRWLock
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ * Lock a reader-writer lock for writing.
+ *
+ * This will block while any other thread holds the lock, in either mode.
+ *
+ * \param rwlock the lock to lock
+ * \returns 0, or -1 on error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_LockRWLockForReading
+ * \sa SDL_TryLockRWLockForWriting
+ * \sa SDL_UnlockRWLock
+ */
+extern DECLSPEC int SDLCALL SDL_LockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ * Try to lock a reader-writer lock for reading without blocking.
+ *
+ * This works just like SDL_LockRWLockForReading(), but if the lock is held
+ * for writing, this function returns `SDL_MUTEX_TIMEDOUT` immediately.
+ *
+ * \param rwlock the lock to try to lock
+ * \returns 0, `SDL_MUTEX_TIMEDOUT`, or -1 on error; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_LockRWLockForReading
+ * \sa SDL_UnlockRWLock
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForReading(SDL_rwlock * rwlock);
+
+/**
+ * Try to lock a reader-writer lock for writing without blocking.
+ *
+ * This works just like SDL_LockRWLockForWriting(), but if the lock is held
+ * by any thread, this function returns `SDL_MUTEX_TIMEDOUT` immediately.
+ *
+ * \param rwlock the lock to try to lock
+ * \returns 0, `SDL_MUTEX_TIMEDOUT`, or -1 on error; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_LockRWLockForWriting
+ * \sa SDL_UnlockRWLock
+ */
+extern DECLSPEC int SDLCALL SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock);
+
+/**
+ * Unlock a reader-writer lock.
+ *
+ * This releases one read lock or the write lock held by the current thread.
+ * It is an error to unlock a lock that the current thread doesn't hold, and
+ * doing so results in undefined behavior.
+ *
+ * \param rwlock the lock to unlock
+ * \returns 0, or -1 on error; call SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_LockRWLockForReading
+ * \sa SDL_LockRWLockForWriting
+ */
+extern DECLSPEC int SDLCALL SDL_UnlockRWLock(SDL_rwlock * rwlock);
+
+/**
+ * Destroy a reader-writer lock created with SDL_CreateRWLock().
+ *
+ * It is not safe to destroy a lock that is held by any thread.
+ *
+ * \param rwlock the lock to destroy
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_CreateRWLock
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRWLock(SDL_rwlock * rwlock);
+
+/* @} *//* Reader-writer lock functions */
+
+
 /**
  *  \name Semaphore functions
  */
@@ -54,6 +54,7 @@ extern "C" {
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
 #define SDL_SIMD_ALIGNED    0x00000008  /**< Surface uses aligned memory */
+#define SDL_PREMULTIPLIED   0x00000010  /**< Surface colors are premultiplied by alpha */
 /* @} *//* Surface flags */
 
 /**
@@ -595,6 +596,34 @@ extern DECLSPEC int SDLCALL SDL_SetSurfaceBlendMode(SDL_Surface * surface,
 extern DECLSPEC int SDLCALL SDL_GetSurfaceBlendMode(SDL_Surface * surface,
                                                     SDL_BlendMode *blendMode);
 
+/**
+ * Mark whether the colors of a surface are premultiplied by its alpha.
+ *
+ * This doesn't change the pixels, use SDL_PremultiplySurfaceAlpha() to
+ * convert them. It sets or clears `SDL_PREMULTIPLIED` in the surface flags,
+ * and switches between `SDL_BLENDMODE_BLEND` and
+ * `SDL_BLENDMODE_BLEND_PREMULTIPLIED` if the surface uses one of them, so
+ * that blits pick the blender that matches the pixels. Premultiplied blits
+ * only need one multiply per channel.
+ *
+ * The color and alpha modulation of a premultiplied surface are applied to
+ * its channels as they are, so to fade it out the color has to be modulated
+ * by the same amount as the alpha.
+ *
+ * \param surface the SDL_Surface structure to update
+ * \param premultiplied SDL_TRUE if the colors are premultiplied, SDL_FALSE
+ *                      otherwise
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_PremultiplySurfaceAlpha
+ * \sa SDL_SetSurfaceBlendMode
+ */
+extern DECLSPEC int SDLCALL SDL_SetSurfacePremultiplied(SDL_Surface * surface,
+                                                        SDL_bool premultiplied);
+
 /**
  * Set the clipping rectangle for a surface.
  *
@@ -746,6 +775,22 @@ extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
                                                  Uint32 dst_format,
                                                  void * dst, int dst_pitch);
 
+/**
+ * Premultiply the alpha of a surface in place.
+ *
+ * The surface is then marked as premultiplied with
+ * SDL_SetSurfacePremultiplied(). Nothing is done if it already is.
+ *
+ * \param surface the SDL_Surface structure to convert
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_SetSurfacePremultiplied
+ */
+extern DECLSPEC int SDLCALL SDL_PremultiplySurfaceAlpha(SDL_Surface * surface);
+
 /**
  * Perform a fast fill of a rectangle with a specific color.
  *
@@ -453,6 +453,166 @@ extern DECLSPEC int SDLCALL SDL_TLSSet(SDL_TLSID id, const void *value, void (SD
  */
 extern DECLSPEC void SDLCALL SDL_TLSCleanup(void);
 
+/**
+ * The job system structure, created with SDL_CreateJobSystem().
+ *
+ * \sa SDL_CreateJobSystem
+ */
+typedef struct SDL_JobSystem SDL_JobSystem;
+
+/**
+ * A handle to a job submitted with SDL_SubmitJob().
+ *
+ * \sa SDL_SubmitJob
+ */
+typedef struct SDL_Job SDL_Job;
+
+/**
+ * The function type for jobs.
+ *
+ * \param job the running job, which can be the parent of jobs it submits
+ * \param data what was passed as `data` to SDL_SubmitJob()
+ */
+typedef void (SDLCALL * SDL_JobFunction) (SDL_Job *job, void *data);
+
+/**
+ * The function type for the pieces of an SDL_ParallelFor() range.
+ *
+ * \param start the first index of the piece
+ * \param end one past the last index of the piece
+ * \param data what was passed as `data` to SDL_ParallelFor()
+ */
+typedef void (SDLCALL * SDL_ParallelForFunction) (int start, int end, void *data);
+
+/**
+ * Create a job system with a pool of worker threads.
+ *
+ * Each worker keeps its own queue of jobs and takes jobs from the other
+ * workers when it runs out, so jobs that submit more jobs spread over all
+ * the threads without contending on a shared lock.
+ *
+ * If no worker thread can be started, for example when SDL was built
+ * without thread support, the job system still works but runs every job on
+ * the thread that submits it.
+ *
+ * \param num_threads the number of worker threads, or 0 for one less than
+ *                    the number of CPU cores, but at least one
+ * \returns a new job system or NULL on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_DestroyJobSystem
+ * \sa SDL_SubmitJob
+ * \sa SDL_ParallelFor
+ */
+extern DECLSPEC SDL_JobSystem *SDLCALL SDL_CreateJobSystem(int num_threads);
+
+/**
+ * Submit a job to a job system.
+ *
+ * The job runs on one of the worker threads, or on a thread that is waiting
+ * in SDL_WaitJob() or SDL_ParallelFor(). Jobs may submit and wait for other
+ * jobs.
+ *
+ * If `parent` is not NULL, the new job is a child of `parent` and `parent`
+ * isn't finished until all of its children are. Children must be submitted
+ * before `parent` finishes, usually from within the parent job itself.
+ *
+ * Every returned job must be passed to either SDL_WaitJob() or
+ * SDL_DetachJob(), but not both.
+ *
+ * \param jobs the job system
+ * \param func the function to run
+ * \param data a pointer that is passed to `func`
+ * \param parent the job the new job is a child of, or NULL
+ * \returns a handle to the job or NULL on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_WaitJob
+ * \sa SDL_DetachJob
+ */
+extern DECLSPEC SDL_Job *SDLCALL SDL_SubmitJob(SDL_JobSystem *jobs,
+                                               SDL_JobFunction func,
+                                               void *data, SDL_Job *parent);
+
+/**
+ * Wait for a job and all of its children to finish.
+ *
+ * While it waits, the calling thread runs other queued jobs of the same job
+ * system, unless it is not a worker and every CPU core already has a worker
+ * thread. The job handle is no longer valid after this call.
+ *
+ * It is safe to pass NULL to this function; it is a no-op.
+ *
+ * \param job the job returned by SDL_SubmitJob()
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_SubmitJob
+ */
+extern DECLSPEC void SDLCALL SDL_WaitJob(SDL_Job *job);
+
+/**
+ * Let a job finish on its own without waiting for it.
+ *
+ * The job handle is no longer valid after this call. The job can still be
+ * a parent of jobs submitted before it was detached.
+ *
+ * It is safe to pass NULL to this function; it is a no-op.
+ *
+ * \param job the job returned by SDL_SubmitJob()
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_SubmitJob
+ */
+extern DECLSPEC void SDLCALL SDL_DetachJob(SDL_Job *job);
+
+/**
+ * Call a function over a range of indices on the threads of a job system.
+ *
+ * The range is split in pieces of at most `grain` indices, and `func` is
+ * called once for each piece, possibly on different threads at the same
+ * time. The calling thread works on the range too, and this function
+ * returns when all of it is done.
+ *
+ * \param jobs the job system
+ * \param start the first index of the range
+ * \param end one past the last index of the range
+ * \param grain the largest piece to pass to `func`, or 0 to pick one from
+ *              the number of threads
+ * \param func the function to call for each piece
+ * \param data a pointer that is passed to `func`
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_CreateJobSystem
+ */
+extern DECLSPEC int SDLCALL SDL_ParallelFor(SDL_JobSystem *jobs,
+                                            int start, int end, int grain,
+                                            SDL_ParallelForFunction func,
+                                            void *data);
+
+/**
+ * Destroy a job system.
+ *
+ * This waits for the jobs that are still queued or running to finish and
+ * stops the worker threads. All job handles must have been waited for or
+ * detached.
+ *
+ * \param jobs the job system to destroy
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_CreateJobSystem
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyJobSystem(SDL_JobSystem *jobs);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -146,6 +146,129 @@ extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
  */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ * Wait a specified number of nanoseconds before returning.
+ *
+ * Unlike SDL_Delay(), this function doesn't round the wait to whole
+ * milliseconds and tries hard not to overshoot it: it sleeps for the bulk of
+ * the wait and then spins on the clock until the deadline, so it costs some
+ * CPU time near the end of each wait.
+ *
+ * \param ns the number of nanoseconds to delay
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_Delay
+ * \sa SDL_CreateFramePacer
+ */
+extern DECLSPEC void SDLCALL SDL_DelayPrecise(Uint64 ns);
+
+/**
+ * A structure that paces a loop to a fixed frame interval.
+ *
+ * \sa SDL_CreateFramePacer
+ */
+typedef struct SDL_FramePacer SDL_FramePacer;
+
+/**
+ * Frame timing statistics of an SDL_FramePacer.
+ *
+ * Frame times are measured between consecutive returns from
+ * SDL_FramePacerWait(). A frame is missed when the loop was still busy at
+ * its deadline.
+ *
+ * \sa SDL_GetFramePacerStats
+ */
+typedef struct SDL_FramePacerStats
+{
+    Uint64 interval_ns;         /**< The target frame interval */
+    Uint64 frames;              /**< Number of frames measured */
+    Uint64 missed_frames;       /**< Frames that were not ready by their deadline */
+    Uint64 frame_min_ns;        /**< Shortest frame time seen */
+    Uint64 frame_avg_ns;        /**< Average frame time */
+    Uint64 frame_max_ns;        /**< Longest frame time seen */
+    Uint64 jitter_ns;           /**< Standard deviation of the frame time */
+    Uint64 wake_late_max_ns;    /**< Largest time a wakeup came after its deadline */
+} SDL_FramePacerStats;
+
+/**
+ * Create a frame pacer with a fixed frame interval.
+ *
+ * Call SDL_FramePacerWait() once per iteration of the loop you want to pace,
+ * it waits until the next frame deadline. Deadlines are absolute, so the
+ * time the loop spends working doesn't add drift.
+ *
+ * \param interval_ns the target frame interval in nanoseconds, e.g.
+ *                    1000000000 / 60 for 60 frames per second
+ * \returns a new frame pacer or NULL on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_DestroyFramePacer
+ * \sa SDL_FramePacerWait
+ */
+extern DECLSPEC SDL_FramePacer *SDLCALL SDL_CreateFramePacer(Uint64 interval_ns);
+
+/**
+ * Wait until the next frame deadline of a frame pacer.
+ *
+ * If the loop or the wakeup is late by more than a quarter of a frame, the
+ * following deadlines are counted from now, rather than running short frames
+ * to catch up. If the deadline has already passed this returns right away.
+ *
+ * \param pacer the frame pacer
+ * \returns the time since the previous call in nanoseconds, or 0 on the
+ *          first call.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_CreateFramePacer
+ * \sa SDL_GetFramePacerStats
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_FramePacerWait(SDL_FramePacer *pacer);
+
+/**
+ * Get the frame timing statistics of a frame pacer.
+ *
+ * \param pacer the frame pacer
+ * \param stats an SDL_FramePacerStats structure to be filled in
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_ResetFramePacerStats
+ */
+extern DECLSPEC int SDLCALL SDL_GetFramePacerStats(SDL_FramePacer *pacer,
+                                                   SDL_FramePacerStats *stats);
+
+/**
+ * Reset the frame timing statistics of a frame pacer.
+ *
+ * This is useful after a loading screen or another pause that shouldn't
+ * count towards the statistics. The next call to SDL_FramePacerWait() starts
+ * a new frame deadline schedule.
+ *
+ * \param pacer the frame pacer
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_GetFramePacerStats
+ */
+extern DECLSPEC void SDLCALL SDL_ResetFramePacerStats(SDL_FramePacer *pacer);
+
+/**
+ * Destroy a frame pacer.
+ *
+ * \param pacer the frame pacer to destroy
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_CreateFramePacer
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyFramePacer(SDL_FramePacer *pacer);
+
 /**
  * Function prototype for the timer callback function.
  *
@@ -198,7 +321,41 @@ extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimer(Uint32 interval,
                                                  void *param);
 
 /**
- * Remove a timer created with SDL_AddTimer().
+ * Function prototype for the nanosecond timer callback function.
+ *
+ * The callback function is passed the current timer interval in nanoseconds
+ * and returns the next timer interval, in nanoseconds. If the callback
+ * returns 0, the periodic alarm is cancelled.
+ */
+typedef Uint64 (SDLCALL * SDL_NSTimerCallback) (Uint64 interval, void *param);
+
+/**
+ * Call a callback function at a future time, with nanosecond intervals.
+ *
+ * This works like SDL_AddTimer(), but the interval is measured with the
+ * performance counter, so timers can fire more than once per millisecond.
+ * While such a timer is the next one due, the timer thread yields instead of
+ * sleeping for the last fraction of a millisecond, which costs some CPU
+ * time.
+ *
+ * \param interval the timer delay, in nanoseconds, passed to `callback`
+ * \param callback the SDL_NSTimerCallback function to call when the specified
+ *                 `interval` elapses
+ * \param param a pointer that is passed to `callback`
+ * \returns a timer ID or 0 if an error occurs; call SDL_GetError() for more
+ *          information.
+ *
+ * \since This function is available since SDL 2.0.22.
+ *
+ * \sa SDL_AddTimer
+ * \sa SDL_RemoveTimer
+ */
+extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimerNS(Uint64 interval,
+                                                   SDL_NSTimerCallback callback,
+                                                   void *param);
+
+/**
+ * Remove a timer created with SDL_AddTimer() or SDL_AddTimerNS().
  *
  * \param id the ID of the timer to remove
  * \returns SDL_TRUE if the timer is removed or SDL_FALSE if the timer wasn't
@@ -207,6 +364,7 @@ extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimer(Uint32 interval,
  * \since This function is available since SDL 2.0.0.
  *
  * \sa SDL_AddTimer
+ * \sa SDL_AddTimerNS
  */
 extern DECLSPEC SDL_bool SDLCALL SDL_RemoveTimer(SDL_TimerID id);
 
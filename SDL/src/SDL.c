@@ -60,6 +60,7 @@
 extern int SDL_HelperWindowCreate(void);
 extern int SDL_HelperWindowDestroy(void);
 #endif
+extern void SDL_QuitBlitThreads(void);
 
 
 /* This is not declared in any header, although it is shared between some
@@ -467,6 +468,7 @@ SDL_Quit(void)
     SDL_TicksQuit();
 #endif
 
+    SDL_QuitBlitThreads();
     SDL_ClearHints();
     SDL_AssertionsQuit();
     SDL_LogResetPriorities();
@@ -36,6 +36,7 @@ SDL_SetError(SDL_PRINTF_FORMAT_STRING const char *fmt, ...)
         SDL_error *error = SDL_GetErrBuf();
 
         error->error = 1;  /* mark error as valid */
+        error->code = SDL_EMESSAGE;
 
         va_start(ap, fmt);
         SDL_vsnprintf(error->str, ERR_MAX_STRLEN, fmt, ap);
@@ -50,12 +51,63 @@ SDL_SetError(SDL_PRINTF_FORMAT_STRING const char *fmt, ...)
     return -1;
 }
 
+/* The messages for error codes are constant, so they are only looked up
+   when somebody asks for them */
+static const char *
+SDL_GetErrorCodeMessage(SDL_errorcode code)
+{
+    switch (code) {
+    case SDL_ENOMEM:
+        return "Out of memory";
+    case SDL_EFREAD:
+        return "Error reading from datastream";
+    case SDL_EFWRITE:
+        return "Error writing to datastream";
+    case SDL_EFSEEK:
+        return "Error seeking in datastream";
+    case SDL_UNSUPPORTED:
+        return "That operation is not supported";
+    default:
+        return "Unknown SDL error";
+    }
+}
+
+int
+SDL_SetErrorCode(SDL_errorcode code)
+{
+    SDL_error *error = SDL_GetErrBuf();
+
+    if (code == SDL_ENOERROR || code == SDL_EMESSAGE) {
+        code = SDL_LASTERROR;  /* these can't be set, report an unknown error */
+    }
+    error->error = 1;  /* mark error as valid */
+    error->code = code;
+
+    if (SDL_LogGetPriority(SDL_LOG_CATEGORY_ERROR) <= SDL_LOG_PRIORITY_DEBUG) {
+        /* If we are in debug mode, print out the error message */
+        SDL_LogDebug(SDL_LOG_CATEGORY_ERROR, "%s", SDL_GetErrorCodeMessage(code));
+    }
+
+    return -1;
+}
+
+SDL_errorcode
+SDL_GetErrorCode(void)
+{
+    const SDL_error *error = SDL_GetErrBuf();
+    return error->error ? error->code : SDL_ENOERROR;
+}
+
 /* Available for backwards compatibility */
 const char *
 SDL_GetError(void)
 {
     const SDL_error *error = SDL_GetErrBuf();
-    return error->error ? error->str : "";
+
+    if (!error->error) {
+        return "";
+    }
+    return (error->code == SDL_EMESSAGE) ? error->str : SDL_GetErrorCodeMessage(error->code);
 }
 
 void
@@ -68,20 +120,7 @@ SDL_ClearError(void)
 int
 SDL_Error(SDL_errorcode code)
 {
-    switch (code) {
-    case SDL_ENOMEM:
-        return SDL_SetError("Out of memory");
-    case SDL_EFREAD:
-        return SDL_SetError("Error reading from datastream");
-    case SDL_EFWRITE:
-        return SDL_SetError("Error writing to datastream");
-    case SDL_EFSEEK:
-        return SDL_SetError("Error seeking in datastream");
-    case SDL_UNSUPPORTED:
-        return SDL_SetError("That operation is not supported");
-    default:
-        return SDL_SetError("Unknown SDL error");
-    }
+    return SDL_SetErrorCode(code);
 }
 
 #ifdef TEST_ERROR
@@ -105,14 +144,7 @@ main(int argc, char *argv[])
 char *
 SDL_GetErrorMsg(char *errstr, int maxlen)
 {
-    const SDL_error *error = SDL_GetErrBuf();
-
-    if (error->error) {
-        SDL_strlcpy(errstr, error->str, maxlen);
-    } else {
-        *errstr = '\0';
-    }
-
+    SDL_strlcpy(errstr, SDL_GetError(), maxlen);
     return errstr;
 }
 
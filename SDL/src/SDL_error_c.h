@@ -27,11 +27,14 @@
 #ifndef SDL_error_c_h_
 #define SDL_error_c_h_
 
+#include "SDL_error.h"
+
 #define ERR_MAX_STRLEN  128
 
 typedef struct SDL_error
 {
     int error; /* This is a numeric value corresponding to the current error */
+    SDL_errorcode code; /* str is only filled in for SDL_EMESSAGE */
     char str[ERR_MAX_STRLEN];
 } SDL_error;
 
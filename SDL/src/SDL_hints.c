@@ -21,77 +21,242 @@
 #include "./SDL_internal.h"
 
 #include "SDL_hints.h"
+#include "SDL_atomic.h"
 #include "SDL_error.h"
 #include "SDL_hints_c.h"
 
 
-/* Assuming there aren't many hints set and they aren't being queried in
-   critical performance paths, we'll just use linked lists here.
+/* Hints live in a small hash table, so looking one up doesn't depend on
+   how many are set. An entry is created when a hint is set or watched, or
+   when a handle to it is requested, and is freed by SDL_ClearHints(). A hint
+   without an entry is just its environment variable.
+
+   Each entry keeps its environment variable, which is read again after
+   SDL_setenv() bumps SDL_hint_env_generation, and points at its current
+   value, already parsed. Values are never changed or freed before
+   SDL_ClearHints(): each distinct value a hint takes gets its own
+   SDL_HintValue, so strings returned by SDL_GetHint() stay valid while
+   other threads change the hint, and a reader only needs an atomic load.
+
+   Lookups walk the buckets without locking, new entries are published
+   at the head of a bucket under SDL_hint_lock, which also serializes
+   changes to the entries.
  */
+#define SDL_HINT_BUCKETS    64
+
 typedef struct SDL_HintWatch {
     SDL_HintCallback callback;
     void *userdata;
     struct SDL_HintWatch *next;
 } SDL_HintWatch;
 
-typedef struct SDL_Hint {
+typedef struct SDL_HintValue {
+    const char *string;
+    SDL_bool boolean;
+    int integer;
+    float number;
+    struct SDL_HintValue *next;
+} SDL_HintValue;
+
+typedef struct SDL_HintHandle {
     char *name;
-    char *value;
+    Uint32 hash;
+    SDL_HintValue *value;       /* set with SDL_SetHint() */
     SDL_HintPriority priority;
     SDL_HintWatch *callbacks;
-    struct SDL_Hint *next;
+    SDL_HintValue *env;         /* the environment variable, if it's set */
+    SDL_atomic_t env_generation;    /* SDL_hint_env_generation when env was read */
+    void *current;              /* what readers see, value or env */
+    SDL_atomic_t generation;
+    SDL_HintValue *values;      /* every value the hint has had */
+    struct SDL_HintHandle *next;
 } SDL_Hint;
 
-static SDL_Hint *SDL_hints;
+static void *SDL_hint_buckets[SDL_HINT_BUCKETS];
+static SDL_SpinLock SDL_hint_lock;
+static SDL_atomic_t SDL_hint_env_generation;
+
+static Uint32
+SDL_HashHintName(const char *name)
+{
+    Uint32 hash = 2166136261u;  /* FNV-1a */
+
+    while (*name) {
+        hash ^= (Uint8) *name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static SDL_Hint *
+SDL_FindHint(const char *name, Uint32 hash)
+{
+    SDL_Hint *hint = (SDL_Hint *)SDL_AtomicGetPtr(&SDL_hint_buckets[hash % SDL_HINT_BUCKETS]);
+
+    for (; hint; hint = hint->next) {
+        if (hint->hash == hash && SDL_strcmp(name, hint->name) == 0) {
+            return hint;
+        }
+    }
+    return NULL;
+}
+
+/* Get the entry for a hint, creating it if needed */
+static SDL_Hint *
+SDL_InternHint(const char *name)
+{
+    const Uint32 hash = SDL_HashHintName(name);
+    SDL_Hint *hint = SDL_FindHint(name, hash);
+
+    if (hint) {
+        return hint;
+    }
+
+    SDL_AtomicLock(&SDL_hint_lock);
+    hint = SDL_FindHint(name, hash);
+    if (!hint) {
+        hint = (SDL_Hint *)SDL_calloc(1, sizeof(*hint));
+        if (hint) {
+            hint->name = SDL_strdup(name);
+            if (!hint->name) {
+                SDL_free(hint);
+                hint = NULL;
+            }
+        }
+        if (hint) {
+            hint->hash = hash;
+            hint->priority = SDL_HINT_DEFAULT;
+            SDL_AtomicSet(&hint->env_generation, SDL_AtomicGet(&SDL_hint_env_generation) - 1);
+            hint->next = (SDL_Hint *)SDL_hint_buckets[hash % SDL_HINT_BUCKETS];
+            SDL_MemoryBarrierRelease();
+            SDL_AtomicSetPtr(&SDL_hint_buckets[hash % SDL_HINT_BUCKETS], hint);
+        }
+    }
+    SDL_AtomicUnlock(&SDL_hint_lock);
+    return hint;
+}
+
+/* Find or add the parsed form of a string the hint has had -- called with SDL_hint_lock held */
+static SDL_HintValue *
+SDL_GetHintValueLocked(SDL_Hint *hint, const char *string)
+{
+    SDL_HintValue *value;
+    size_t length;
+
+    for (value = hint->values; value; value = value->next) {
+        if (SDL_strcmp(value->string, string) == 0) {
+            return value;
+        }
+    }
+
+    length = SDL_strlen(string) + 1;
+    value = (SDL_HintValue *)SDL_malloc(sizeof(*value) + length);
+    if (!value) {
+        return NULL;
+    }
+    SDL_memcpy(value + 1, string, length);
+    value->string = (const char *)(value + 1);
+    value->boolean = SDL_GetStringBoolean(string, SDL_FALSE);
+    value->integer = SDL_atoi(string);
+    value->number = (float) SDL_atof(string);
+    value->next = hint->values;
+    hint->values = value;
+    return value;
+}
+
+/* Work out the hint's current value -- called with SDL_hint_lock held */
+static void
+SDL_UpdateHintLocked(SDL_Hint *hint)
+{
+    const int env_generation = SDL_AtomicGet(&SDL_hint_env_generation);
+    SDL_HintValue *current;
+
+    if (SDL_AtomicGet(&hint->env_generation) != env_generation) {
+        const char *env = SDL_getenv(hint->name);
+
+        hint->env = env ? SDL_GetHintValueLocked(hint, env) : NULL;
+        SDL_AtomicSet(&hint->env_generation, env_generation);
+    }
+
+    if (!hint->env || hint->priority == SDL_HINT_OVERRIDE) {
+        current = hint->value;
+    } else {
+        current = hint->env;
+    }
+    if (current != hint->current) {
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSetPtr(&hint->current, current);
+        SDL_AtomicIncRef(&hint->generation);
+    }
+}
+
+/* The hint's current value, after catching up with the environment */
+static SDL_HintValue *
+SDL_GetCurrentHintValue(SDL_Hint *hint)
+{
+    SDL_HintValue *value;
+
+    if (SDL_AtomicGet(&hint->env_generation) != SDL_AtomicGet(&SDL_hint_env_generation)) {
+        SDL_AtomicLock(&SDL_hint_lock);
+        SDL_UpdateHintLocked(hint);
+        SDL_AtomicUnlock(&SDL_hint_lock);
+    }
+    value = (SDL_HintValue *)SDL_AtomicGetPtr(&hint->current);
+    SDL_MemoryBarrierAcquire();
+    return value;
+}
+
+void
+SDL_InvalidateHintEnvironment(void)
+{
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicIncRef(&SDL_hint_env_generation);
+}
 
 SDL_bool
 SDL_SetHintWithPriority(const char *name, const char *value,
                         SDL_HintPriority priority)
 {
-    const char *env;
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    SDL_HintValue *new_value, *old_value;
 
     if (!name || !value) {
         return SDL_FALSE;
     }
 
-    env = SDL_getenv(name);
-    if (env && priority < SDL_HINT_OVERRIDE) {
+    hint = SDL_InternHint(name);
+    if (!hint) {
         return SDL_FALSE;
     }
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (priority < hint->priority) {
-                return SDL_FALSE;
-            }
-            if (!hint->value || !value || SDL_strcmp(hint->value, value) != 0) {
-                for (entry = hint->callbacks; entry; ) {
-                    /* Save the next entry in case this one is deleted */
-                    SDL_HintWatch *next = entry->next;
-                    entry->callback(entry->userdata, name, hint->value, value);
-                    entry = next;
-                }
-                SDL_free(hint->value);
-                hint->value = value ? SDL_strdup(value) : NULL;
-            }
-            hint->priority = priority;
-            return SDL_TRUE;
-        }
+    SDL_AtomicLock(&SDL_hint_lock);
+    SDL_UpdateHintLocked(hint);
+    if ((hint->env && priority < SDL_HINT_OVERRIDE) || priority < hint->priority) {
+        SDL_AtomicUnlock(&SDL_hint_lock);
+        return SDL_FALSE;
     }
-
-    /* Couldn't find the hint, add a new one */
-    hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-    if (!hint) {
+    new_value = SDL_GetHintValueLocked(hint, value);
+    old_value = hint->value;
+    SDL_AtomicUnlock(&SDL_hint_lock);
+    if (!new_value) {
         return SDL_FALSE;
     }
-    hint->name = SDL_strdup(name);
-    hint->value = value ? SDL_strdup(value) : NULL;
+
+    if (new_value != old_value) {
+        for (entry = hint->callbacks; entry; ) {
+            /* Save the next entry in case this one is deleted */
+            SDL_HintWatch *next = entry->next;
+            entry->callback(entry->userdata, name, old_value ? old_value->string : NULL, value);
+            entry = next;
+        }
+    }
+
+    SDL_AtomicLock(&SDL_hint_lock);
+    hint->value = new_value;
     hint->priority = priority;
-    hint->callbacks = NULL;
-    hint->next = SDL_hints;
-    SDL_hints = hint;
+    SDL_UpdateHintLocked(hint);
+    SDL_AtomicUnlock(&SDL_hint_lock);
     return SDL_TRUE;
 }
 
@@ -104,19 +269,19 @@ SDL_SetHint(const char *name, const char *value)
 const char *
 SDL_GetHint(const char *name)
 {
-    const char *env;
     SDL_Hint *hint;
+    SDL_HintValue *value;
 
-    env = SDL_getenv(name);
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            if (!env || hint->priority == SDL_HINT_OVERRIDE) {
-                return hint->value;
-            }
-            break;
-        }
+    if (!name) {
+        return NULL;
     }
-    return env;
+
+    hint = SDL_FindHint(name, SDL_HashHintName(name));
+    if (!hint) {
+        return SDL_getenv(name);
+    }
+    value = SDL_GetCurrentHintValue(hint);
+    return value ? value->string : NULL;
 }
 
 SDL_bool
@@ -134,8 +299,85 @@ SDL_GetStringBoolean(const char *value, SDL_bool default_value)
 SDL_bool
 SDL_GetHintBoolean(const char *name, SDL_bool default_value)
 {
-    const char *hint = SDL_GetHint(name);
-    return SDL_GetStringBoolean(hint, default_value);
+    SDL_HintHandle *handle;
+
+    if (!name) {
+        return default_value;
+    }
+
+    handle = SDL_FindHint(name, SDL_HashHintName(name));
+    if (!handle) {
+        return SDL_GetStringBoolean(SDL_getenv(name), default_value);
+    }
+    return SDL_GetHintHandleBoolean(handle, default_value);
+}
+
+SDL_HintHandle *
+SDL_GetHintHandle(const char *name)
+{
+    SDL_Hint *hint;
+
+    if (!name || !*name) {
+        SDL_InvalidParamError("name");
+        return NULL;
+    }
+
+    hint = SDL_InternHint(name);
+    if (!hint) {
+        SDL_OutOfMemory();
+    }
+    return hint;
+}
+
+Uint32
+SDL_GetHintHandleGeneration(SDL_HintHandle *handle)
+{
+    if (!handle) {
+        return 0;
+    }
+    /* Both counters only ever go up, so their sum changes whenever either does */
+    return (Uint32) SDL_AtomicGet(&handle->generation) + (Uint32) SDL_AtomicGet(&SDL_hint_env_generation);
+}
+
+const char *
+SDL_GetHintHandleValue(SDL_HintHandle *handle)
+{
+    SDL_HintValue *value = handle ? SDL_GetCurrentHintValue(handle) : NULL;
+
+    return value ? value->string : NULL;
+}
+
+SDL_bool
+SDL_GetHintHandleBoolean(SDL_HintHandle *handle, SDL_bool default_value)
+{
+    SDL_HintValue *value = handle ? SDL_GetCurrentHintValue(handle) : NULL;
+
+    if (!value || !*value->string) {
+        return default_value;
+    }
+    return value->boolean;
+}
+
+int
+SDL_GetHintHandleInt(SDL_HintHandle *handle, int default_value)
+{
+    SDL_HintValue *value = handle ? SDL_GetCurrentHintValue(handle) : NULL;
+
+    if (!value || !*value->string) {
+        return default_value;
+    }
+    return value->integer;
+}
+
+float
+SDL_GetHintHandleFloat(SDL_HintHandle *handle, float default_value)
+{
+    SDL_HintValue *value = handle ? SDL_GetCurrentHintValue(handle) : NULL;
+
+    if (!value || !*value->string) {
+        return default_value;
+    }
+    return value->number;
 }
 
 void
@@ -164,25 +406,11 @@ SDL_AddHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     entry->callback = callback;
     entry->userdata = userdata;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            break;
-        }
-    }
+    hint = SDL_InternHint(name);
     if (!hint) {
-        /* Need to add a hint entry for this watcher */
-        hint = (SDL_Hint *)SDL_malloc(sizeof(*hint));
-        if (!hint) {
-            SDL_OutOfMemory();
-            SDL_free(entry);
-            return;
-        }
-        hint->name = SDL_strdup(name);
-        hint->value = NULL;
-        hint->priority = SDL_HINT_DEFAULT;
-        hint->callbacks = NULL;
-        hint->next = SDL_hints;
-        SDL_hints = hint;
+        SDL_OutOfMemory();
+        SDL_free(entry);
+        return;
     }
 
     /* Add it to the callbacks for this hint */
@@ -200,22 +428,24 @@ SDL_DelHintCallback(const char *name, SDL_HintCallback callback, void *userdata)
     SDL_Hint *hint;
     SDL_HintWatch *entry, *prev;
 
-    for (hint = SDL_hints; hint; hint = hint->next) {
-        if (SDL_strcmp(name, hint->name) == 0) {
-            prev = NULL;
-            for (entry = hint->callbacks; entry; entry = entry->next) {
-                if (callback == entry->callback && userdata == entry->userdata) {
-                    if (prev) {
-                        prev->next = entry->next;
-                    } else {
-                        hint->callbacks = entry->next;
-                    }
-                    SDL_free(entry);
-                    break;
+    if (!name) {
+        return;
+    }
+
+    hint = SDL_FindHint(name, SDL_HashHintName(name));
+    if (hint) {
+        prev = NULL;
+        for (entry = hint->callbacks; entry; entry = entry->next) {
+            if (callback == entry->callback && userdata == entry->userdata) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    hint->callbacks = entry->next;
                 }
-                prev = entry;
+                SDL_free(entry);
+                break;
             }
-            return;
+            prev = entry;
         }
     }
 }
@@ -224,20 +454,32 @@ void SDL_ClearHints(void)
 {
     SDL_Hint *hint;
     SDL_HintWatch *entry;
+    SDL_HintValue *value;
+    int i;
 
-    while (SDL_hints) {
-        hint = SDL_hints;
-        SDL_hints = hint->next;
+    SDL_AtomicLock(&SDL_hint_lock);
+    for (i = 0; i < SDL_HINT_BUCKETS; ++i) {
+        hint = (SDL_Hint *)SDL_AtomicGetPtr(&SDL_hint_buckets[i]);
+        SDL_AtomicSetPtr(&SDL_hint_buckets[i], NULL);
+        while (hint) {
+            SDL_Hint *freeable = hint;
 
-        SDL_free(hint->name);
-        SDL_free(hint->value);
-        for (entry = hint->callbacks; entry; ) {
-            SDL_HintWatch *freeable = entry;
-            entry = entry->next;
+            for (entry = hint->callbacks; entry; ) {
+                SDL_HintWatch *next = entry->next;
+                SDL_free(entry);
+                entry = next;
+            }
+            for (value = hint->values; value; ) {
+                SDL_HintValue *next = value->next;
+                SDL_free(value);
+                value = next;
+            }
+            SDL_free(hint->name);
+            hint = hint->next;
             SDL_free(freeable);
         }
-        SDL_free(hint);
     }
+    SDL_AtomicUnlock(&SDL_hint_lock);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
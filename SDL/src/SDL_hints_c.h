@@ -27,6 +27,9 @@
 
 extern SDL_bool SDL_GetStringBoolean(const char *value, SDL_bool default_value);
 
+/* Called when the environment changes, so hints read their variables again */
+extern void SDL_InvalidateHintEnvironment(void);
+
 #endif /* SDL_hints_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
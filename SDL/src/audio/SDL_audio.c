@@ -32,6 +32,7 @@
 
 static SDL_AudioDriver current_audio;
 static SDL_AudioDevice *open_devices[16];
+static SDL_AudioDevice *physical_devices[16];
 
 /* Available audio drivers */
 static const AudioBootStrap *const bootstrap[] = {
@@ -413,7 +414,7 @@ add_audio_device(const char *name, SDL_AudioSpec *spec, void *handle, SDL_AudioD
     }
     item->handle = handle;
 
-    SDL_LockMutex(current_audio.detectionLock);
+    SDL_LockRWLockForWriting(current_audio.detectionLock);
 
     for (i = *devices; i != NULL; i = i->next) {
         if (SDL_strcmp(name, i->original_name) == 0) {
@@ -426,7 +427,7 @@ add_audio_device(const char *name, SDL_AudioSpec *spec, void *handle, SDL_AudioD
         const size_t len = SDL_strlen(name) + 16;
         char *replacement = (char *) SDL_malloc(len);
         if (!replacement) {
-            SDL_UnlockMutex(current_audio.detectionLock);
+            SDL_UnlockRWLock(current_audio.detectionLock);
             SDL_free(item->original_name);
             SDL_free(item);
             SDL_OutOfMemory();
@@ -442,7 +443,7 @@ add_audio_device(const char *name, SDL_AudioSpec *spec, void *handle, SDL_AudioD
     *devices = item;
     retval = (*devCount)++;   /* !!! FIXME: this should be an atomic increment */
 
-    SDL_UnlockMutex(current_audio.detectionLock);
+    SDL_UnlockRWLock(current_audio.detectionLock);
 
     return retval;
 }
@@ -502,7 +503,13 @@ SDL_AddAudioDevice(const int iscapture, const char *name, SDL_AudioSpec *spec, v
 /* The audio backends call this when a currently-opened device is lost. */
 void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device)
 {
-    SDL_assert(get_audio_device(device->id) == device);
+    SDL_AudioDeviceID ids[SDL_arraysize(open_devices)];
+    SDL_AudioDevice *logical;
+    int num_ids = 0;
+    int i;
+
+    /* physical devices shared by logical devices don't have an ID. */
+    SDL_assert((device->id == 0) || (get_audio_device(device->id) == device));
 
     if (!SDL_AtomicGet(&device->enabled)) {
         return;  /* don't report disconnects more than once. */
@@ -518,14 +525,28 @@ void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device)
     SDL_AtomicSet(&device->enabled, 0);
     current_audio.impl.UnlockDevice(device);
 
+    if (device->id == 0) {
+        /* Every logical device on this physical device is gone with it. */
+        SDL_LockMutex(device->mixer_lock);
+        for (logical = device->logical_devices; logical != NULL; logical = logical->logical_next) {
+            SDL_AtomicSet(&logical->enabled, 0);
+            ids[num_ids++] = logical->id;
+        }
+        SDL_UnlockMutex(device->mixer_lock);
+    } else {
+        ids[num_ids++] = device->id;
+    }
+
     /* Post the event, if desired */
     if (SDL_GetEventState(SDL_AUDIODEVICEREMOVED) == SDL_ENABLE) {
-        SDL_Event event;
-        SDL_zero(event);
-        event.adevice.type = SDL_AUDIODEVICEREMOVED;
-        event.adevice.which = device->id;
-        event.adevice.iscapture = device->iscapture ? 1 : 0;
-        SDL_PushEvent(&event);
+        for (i = 0; i < num_ids; i++) {
+            SDL_Event event;
+            SDL_zero(event);
+            event.adevice.type = SDL_AUDIODEVICEREMOVED;
+            event.adevice.which = ids[i];
+            event.adevice.iscapture = device->iscapture ? 1 : 0;
+            SDL_PushEvent(&event);
+        }
     }
 }
 
@@ -550,12 +571,16 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
     int device_index;
     SDL_AudioDevice *device = NULL;
 
-    SDL_LockMutex(current_audio.detectionLock);
+    SDL_LockRWLockForWriting(current_audio.detectionLock);
     if (iscapture) {
         mark_device_removed(handle, current_audio.inputDevices, &current_audio.captureDevicesRemoved);
     } else {
         mark_device_removed(handle, current_audio.outputDevices, &current_audio.outputDevicesRemoved);
     }
+    SDL_UnlockRWLock(current_audio.detectionLock);
+
+    /* This posts events, and event watchers may look at the device list,
+       so it has to happen after the lock is released. */
     for (device_index = 0; device_index < SDL_arraysize(open_devices); device_index++)
     {
         device = open_devices[device_index];
@@ -565,7 +590,6 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
             break;
         }
     }
-    SDL_UnlockMutex(current_audio.detectionLock);
 
     current_audio.impl.FreeDeviceHandle(handle);
 }
@@ -592,6 +616,9 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
     if (len > 0) {  /* fill any remaining space in the stream with silence. */
         SDL_assert(SDL_CountDataQueue(device->buffer_queue) == 0);
         SDL_memset(stream, device->callbackspec.silence, len);
+        if (dequeued > 0) {  /* the app was feeding us, but not fast enough. */
+            device->stats.underruns++;
+        }
     }
 }
 
@@ -694,6 +721,176 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
 }
 
 
+/* low-latency pacing and timing statistics... */
+
+static Uint64
+audio_ticks_to_ns(Uint64 ticks)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    return ((ticks / freq) * 1000000000) + (((ticks % freq) * 1000000000) / freq);
+}
+
+static void
+audio_delay_until(Uint64 deadline)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+
+    if (now < deadline) {
+        SDL_DelayPrecise(audio_ticks_to_ns(deadline - now));
+    }
+}
+
+/* Copy a device's statistics. The device thread updates the wakeup
+   counters without taking mixer_lock, so retry if it was in the middle of
+   an update, the sequence number is odd while it writes them. */
+static void
+audio_copy_stats(SDL_AudioDevice *device, SDL_AudioDeviceStats *stats)
+{
+    int seq;
+
+    SDL_LockMutex(device->mixer_lock);
+    for (;;) {
+        seq = SDL_AtomicGet(&device->wake_seq);
+        if (seq & 1) {
+            SDL_CPUPauseInstruction();
+            continue;
+        }
+        SDL_MemoryBarrierAcquire();
+        SDL_memcpy(stats, &device->stats, sizeof (*stats));
+        SDL_MemoryBarrierAcquire();
+        if (SDL_AtomicGet(&device->wake_seq) == seq) {
+            break;
+        }
+    }
+    SDL_UnlockMutex(device->mixer_lock);
+}
+
+static void
+audio_log_stats(SDL_AudioDevice *device)
+{
+    SDL_AudioDeviceStats stats;
+
+    audio_copy_stats(device, &stats);
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_AUDIO,
+                "Audio device %u: period=%" SDL_PRIu64 "ns wakeups=%" SDL_PRIu64 " late=%" SDL_PRIu64
+                " underruns=%" SDL_PRIu64 " overruns=%" SDL_PRIu64
+                " callback=%" SDL_PRIu64 "/%" SDL_PRIu64 "/%" SDL_PRIu64 "ns (min/avg/max)"
+                " jitter_max=%" SDL_PRIu64 "ns conversion_max=%" SDL_PRIu64 "ns stream=%u bytes",
+                (unsigned int) device->id, stats.period_ns, stats.wakeups, stats.late_wakeups,
+                stats.underruns, stats.overruns,
+                stats.callback_min_ns, stats.callback_avg_ns, stats.callback_max_ns,
+                stats.wake_jitter_max_ns, stats.conversion_max_ns, (unsigned int) stats.stream_bytes);
+}
+
+/* Called by the device thread each time it returns from waiting on the
+   device (or from pacing itself), which should happen once per period.
+   This runs every period, so it doesn't lock, see audio_copy_stats(). */
+static void
+audio_thread_woke(SDL_AudioDevice *device, Uint64 *last_wake)
+{
+    SDL_AudioDeviceStats *stats = &device->stats;
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 period = device->period_ticks;
+    const Uint64 interval = now - *last_wake;
+
+    SDL_AtomicIncRef(&device->wake_seq);
+    SDL_MemoryBarrierRelease();
+    stats->wakeups++;
+    if (*last_wake) {
+        const Uint64 jitter = audio_ticks_to_ns((interval > period) ? (interval - period) : (period - interval));
+        stats->wake_jitter_ns = jitter;
+        if (jitter > stats->wake_jitter_max_ns) {
+            stats->wake_jitter_max_ns = jitter;
+        }
+        if (interval > (period + (period / 4))) {
+            stats->late_wakeups++;
+        }
+        if (interval >= (period * 2)) {
+            /* a whole period went by without us servicing the device. */
+            if (device->iscapture) {
+                stats->overruns++;
+            } else {
+                stats->underruns++;
+            }
+        }
+    }
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicIncRef(&device->wake_seq);
+    *last_wake = now;
+
+    if (device->stats_log_interval && ((now - device->stats_last_log) >= device->stats_log_interval)) {
+        device->stats_last_log = now;
+        audio_log_stats(device);
+    }
+}
+
+/* Record how long the audio callback took. Call with mixer_lock held. */
+static void
+audio_record_callback(SDL_AudioDevice *device, Uint64 start)
+{
+    SDL_AudioDeviceStats *stats = &device->stats;
+    const Uint64 ns = audio_ticks_to_ns(SDL_GetPerformanceCounter() - start);
+
+    stats->callback_ns = ns;
+    if ((stats->callbacks == 0) || (ns < stats->callback_min_ns)) {
+        stats->callback_min_ns = ns;
+    }
+    if (ns > stats->callback_max_ns) {
+        stats->callback_max_ns = ns;
+    }
+    device->callback_total_ns += ns;
+    stats->callbacks++;
+    stats->callback_avg_ns = device->callback_total_ns / stats->callbacks;
+}
+
+/* Record time spent in the device's SDL_AudioStream and what it still holds. */
+static void
+audio_record_conversion(SDL_AudioDevice *device, Uint64 ticks)
+{
+    SDL_AudioDeviceStats *stats = &device->stats;
+    const Uint64 ns = audio_ticks_to_ns(ticks);
+    const int available = SDL_AudioStreamAvailable(device->stream);
+
+    SDL_LockMutex(device->mixer_lock);
+    stats->conversion_ns = ns;
+    if (ns > stats->conversion_max_ns) {
+        stats->conversion_max_ns = ns;
+    }
+    stats->stream_bytes = (Uint32) SDL_max(available, 0);
+    SDL_UnlockMutex(device->mixer_lock);
+}
+
+void
+SDL_AudioWaitNextPeriod(SDL_AudioDevice *device, Uint64 *deadline)
+{
+    if (*deadline == 0) {
+        *deadline = SDL_GetPerformanceCounter();
+    }
+
+    *deadline += device->period_ticks;
+    if (SDL_GetPerformanceCounter() >= (*deadline + device->period_ticks)) {
+        /* We fell more than a whole period behind; start over from now,
+           instead of firing a burst of callbacks to catch up. The late
+           wakeup gets counted as an underrun or overrun by the caller. */
+        *deadline = SDL_GetPerformanceCounter();
+    } else {
+        audio_delay_until(*deadline);
+    }
+}
+
+/* Wait out one device period when there's no device to block on. */
+static void
+audio_thread_pace(SDL_AudioDevice *device, Uint64 *deadline)
+{
+    if (device->low_latency) {
+        SDL_AudioWaitNextPeriod(device, deadline);
+    } else {
+        const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
+        SDL_Delay(delay);
+    }
+}
+
 /* The general mixing thread function */
 static int SDLCALL
 SDL_RunAudio(void *devicep)
@@ -703,6 +900,8 @@ SDL_RunAudio(void *devicep)
     SDL_AudioCallback callback = device->callbackspec.callback;
     int data_len = 0;
     Uint8 *data;
+    Uint64 deadline = 0;
+    Uint64 last_wake = 0;
 
     SDL_assert(!device->iscapture);
 
@@ -749,24 +948,30 @@ SDL_RunAudio(void *devicep)
         if (SDL_AtomicGet(&device->paused)) {
             SDL_memset(data, device->callbackspec.silence, data_len);
         } else {
+            const Uint64 callback_start = SDL_GetPerformanceCounter();
             callback(udata, data, data_len);
+            audio_record_callback(device, callback_start);
         }
         SDL_UnlockMutex(device->mixer_lock);
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
             /* if this fails...oh well. We'll play silence here. */
+            Uint64 conversion_start = SDL_GetPerformanceCounter();
             SDL_AudioStreamPut(device->stream, data, data_len);
+            audio_record_conversion(device, SDL_GetPerformanceCounter() - conversion_start);
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->spec.size)) {
                 int got;
                 data = SDL_AtomicGet(&device->enabled) ? current_audio.impl.GetDeviceBuf(device) : NULL;
+                conversion_start = SDL_GetPerformanceCounter();
                 got = SDL_AudioStreamGet(device->stream, data ? data : device->work_buffer, device->spec.size);
+                audio_record_conversion(device, SDL_GetPerformanceCounter() - conversion_start);
                 SDL_assert((got <= 0) || (got == device->spec.size));
 
                 if (data == NULL) {  /* device is having issues... */
-                    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-                    SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
+                    /* wait for as long as this buffer would have played. Maybe device recovers later? */
+                    audio_thread_pace(device, &deadline);
                 } else {
                     if (got != device->spec.size) {
                         SDL_memset(data, device->spec.silence, device->spec.size);
@@ -774,15 +979,17 @@ SDL_RunAudio(void *devicep)
                     current_audio.impl.PlayDevice(device);
                     current_audio.impl.WaitDevice(device);
                 }
+                audio_thread_woke(device, &last_wake);
             }
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
-            const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-            SDL_Delay(delay);
+            audio_thread_pace(device, &deadline);
+            audio_thread_woke(device, &last_wake);
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
             current_audio.impl.PlayDevice(device);
             current_audio.impl.WaitDevice(device);
+            audio_thread_woke(device, &last_wake);
         }
     }
 
@@ -808,6 +1015,7 @@ SDL_CaptureAudio(void *devicep)
     Uint8 *data;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    Uint64 last_wake = 0;
 
     SDL_assert(device->iscapture);
 
@@ -819,7 +1027,7 @@ SDL_CaptureAudio(void *devicep)
     }
 #else
     /* The audio mixing is always a high priority thread */
-    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+    SDL_SetThreadPriority(device->low_latency ? SDL_THREAD_PRIORITY_TIME_CRITICAL : SDL_THREAD_PRIORITY_HIGH);
 #endif
 
     /* Perform any thread setup */
@@ -839,6 +1047,7 @@ SDL_CaptureAudio(void *devicep)
                 SDL_AudioStreamClear(device->stream);
             }
             current_audio.impl.FlushCapture(device);  /* dump anything pending. */
+            last_wake = 0;  /* don't count the pause as a late wakeup. */
             continue;
         }
 
@@ -871,6 +1080,8 @@ SDL_CaptureAudio(void *devicep)
             }
         }
 
+        audio_thread_woke(device, &last_wake);
+
         if (still_need > 0) {
             /* Keep any data we already read, silence the rest. */
             SDL_memset(ptr, silence, still_need);
@@ -878,10 +1089,15 @@ SDL_CaptureAudio(void *devicep)
 
         if (device->stream) {
             /* if this fails...oh well. */
+            Uint64 conversion_start = SDL_GetPerformanceCounter();
             SDL_AudioStreamPut(device->stream, data, data_len);
+            audio_record_conversion(device, SDL_GetPerformanceCounter() - conversion_start);
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->callbackspec.size)) {
-                const int got = SDL_AudioStreamGet(device->stream, device->work_buffer, device->callbackspec.size);
+                int got;
+                conversion_start = SDL_GetPerformanceCounter();
+                got = SDL_AudioStreamGet(device->stream, device->work_buffer, device->callbackspec.size);
+                audio_record_conversion(device, SDL_GetPerformanceCounter() - conversion_start);
                 SDL_assert((got < 0) || (got == device->callbackspec.size));
                 if (got != device->callbackspec.size) {
                     SDL_memset(device->work_buffer, device->spec.silence, device->callbackspec.size);
@@ -890,7 +1106,9 @@ SDL_CaptureAudio(void *devicep)
                 /* !!! FIXME: this should be LockDevice. */
                 SDL_LockMutex(device->mixer_lock);
                 if (!SDL_AtomicGet(&device->paused)) {
+                    const Uint64 callback_start = SDL_GetPerformanceCounter();
                     callback(udata, device->work_buffer, device->callbackspec.size);
+                    audio_record_callback(device, callback_start);
                 }
                 SDL_UnlockMutex(device->mixer_lock);
             }
@@ -898,7 +1116,9 @@ SDL_CaptureAudio(void *devicep)
             /* !!! FIXME: this should be LockDevice. */
             SDL_LockMutex(device->mixer_lock);
             if (!SDL_AtomicGet(&device->paused)) {
+                const Uint64 callback_start = SDL_GetPerformanceCounter();
                 callback(udata, data, device->callbackspec.size);
+                audio_record_callback(device, callback_start);
             }
             SDL_UnlockMutex(device->mixer_lock);
         }
@@ -912,6 +1132,174 @@ SDL_CaptureAudio(void *devicep)
 }
 
 
+/* logical devices mixed onto a shared physical device... */
+
+static void free_audio_device(SDL_AudioDevice *device);
+
+/* Add one period of a logical device's output to the physical device's
+   float mix. The logical device's spec is the mix format, so this is either
+   straight from its callback or out of its SDL_AudioStream. */
+static void
+mix_logical_device(SDL_AudioDevice *device, float *mix, int mix_len)
+{
+    const int callback_len = device->callbackspec.size;
+    const float *src = (const float *) device->work_buffer;
+    SDL_bool paused;
+    float gain;
+    int samples;
+    int i;
+
+    SDL_assert(mix_len == device->spec.size);
+
+    SDL_LockMutex(device->mixer_lock);
+    paused = SDL_AtomicGet(&device->paused) ? SDL_TRUE : SDL_FALSE;
+    gain = device->gain;
+    if (!paused && !device->stream) {
+        device->callbackspec.callback(device->callbackspec.userdata, device->work_buffer, callback_len);
+    }
+    SDL_UnlockMutex(device->mixer_lock);
+
+    if (paused) {
+        return;  /* paused devices add nothing to the mix. */
+    }
+
+    samples = mix_len / sizeof (float);
+    if (device->stream) {
+        while (SDL_AudioStreamAvailable(device->stream) < mix_len) {
+            SDL_LockMutex(device->mixer_lock);
+            paused = SDL_AtomicGet(&device->paused) ? SDL_TRUE : SDL_FALSE;
+            if (!paused) {
+                device->callbackspec.callback(device->callbackspec.userdata, device->work_buffer, callback_len);
+            }
+            SDL_UnlockMutex(device->mixer_lock);
+
+            /* if this fails...oh well. It's just silent for now. */
+            if (paused || (SDL_AudioStreamPut(device->stream, device->work_buffer, callback_len) < 0)) {
+                break;
+            }
+        }
+        samples = SDL_AudioStreamGet(device->stream, device->work_buffer, mix_len) / (int) sizeof (float);
+    }
+
+    if (gain == 1.0f) {
+        for (i = 0; i < samples; i++) {
+            mix[i] += src[i];
+        }
+    } else {
+        for (i = 0; i < samples; i++) {
+            mix[i] += src[i] * gain;
+        }
+    }
+}
+
+/* The mixing thread function for physical devices shared by logical devices */
+static int SDLCALL
+SDL_MixAudioDevices(void *devicep)
+{
+    SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
+    SDL_AudioDevice *logical[SDL_arraysize(open_devices)];
+    SDL_AudioDevice *item;
+    const int mix_len = device->callbackspec.size;
+    Uint64 deadline = 0;
+    Uint64 last_wake = 0;
+    int num_logical;
+    int i;
+
+    SDL_assert(!device->iscapture);
+
+#if SDL_AUDIO_DRIVER_ANDROID
+    {
+        /* Set thread priority to THREAD_PRIORITY_AUDIO */
+        extern void Android_JNI_AudioSetThreadPriority(int, int);
+        Android_JNI_AudioSetThreadPriority(device->iscapture, device->id);
+    }
+#else
+    /* The audio mixing is always a high priority thread */
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+#endif
+
+    /* Perform any thread setup */
+    device->threadid = SDL_ThreadID();
+    current_audio.impl.ThreadInit(device);
+
+    /* Loop, mixing the logical devices into the audio buffers */
+    while (!SDL_AtomicGet(&device->shutdown)) {
+        Uint8 *data = NULL;
+        float *mix;
+        Uint64 mix_start;
+
+        current_audio.impl.BeginLoopIteration(device);
+
+        /* Mix straight into the device buffer if it takes our floats. */
+        if (!device->stream && SDL_AtomicGet(&device->enabled)) {
+            data = current_audio.impl.GetDeviceBuf(device);
+        }
+        mix = (float *) (data ? data : device->work_buffer);
+        SDL_memset(mix, 0, mix_len);
+
+        /* Hold a reference to each logical device instead of our lock while
+           mixing, as their callbacks might lock (or close) other devices. */
+        num_logical = 0;
+        SDL_LockMutex(device->mixer_lock);
+        for (item = device->logical_devices; item != NULL; item = item->logical_next) {
+            SDL_AtomicIncRef(&item->refcount);
+            logical[num_logical++] = item;
+        }
+        SDL_UnlockMutex(device->mixer_lock);
+
+        mix_start = SDL_GetPerformanceCounter();
+        for (i = 0; i < num_logical; i++) {
+            mix_logical_device(logical[i], mix, mix_len);
+            if (SDL_AtomicDecRef(&logical[i]->refcount)) {
+                free_audio_device(logical[i]);  /* closed while we were mixing it. */
+            }
+        }
+        SDL_LockMutex(device->mixer_lock);
+        audio_record_callback(device, mix_start);
+        SDL_UnlockMutex(device->mixer_lock);
+
+        if (device->stream) {
+            /* Convert the mix to the device format; this clamps it, too. */
+            data = SDL_AtomicGet(&device->enabled) ? current_audio.impl.GetDeviceBuf(device) : NULL;
+            if (data != NULL) {
+                const Uint64 conversion_start = SDL_GetPerformanceCounter();
+                int got = -1;
+                if (SDL_AudioStreamPut(device->stream, mix, mix_len) == 0) {
+                    got = SDL_AudioStreamGet(device->stream, data, device->spec.size);
+                }
+                audio_record_conversion(device, SDL_GetPerformanceCounter() - conversion_start);
+                if (got != device->spec.size) {
+                    SDL_memset(data, device->spec.silence, device->spec.size);
+                }
+            }
+        } else if (data != NULL) {
+            const int samples = mix_len / sizeof (float);
+            for (i = 0; i < samples; i++) {
+                mix[i] = SDL_clamp(mix[i], -1.0f, 1.0f);
+            }
+        }
+
+        if (data == NULL) {
+            /* nothing to do; pause like we queued a buffer to play. */
+            audio_thread_pace(device, &deadline);
+        } else {
+            current_audio.impl.PlayDevice(device);
+            current_audio.impl.WaitDevice(device);
+        }
+        audio_thread_woke(device, &last_wake);
+    }
+
+    current_audio.impl.PrepareToClose(device);
+
+    /* Wait for the audio to drain. */
+    SDL_Delay(((device->spec.samples * 1000) / device->spec.freq) * 2);
+
+    current_audio.impl.ThreadDeinit(device);
+
+    return 0;
+}
+
+
 static SDL_AudioFormat
 SDL_ParseAudioFormat(const char *string)
 {
@@ -966,6 +1354,7 @@ SDL_AudioInit(const char *driver_name)
 
     SDL_zero(current_audio);
     SDL_zeroa(open_devices);
+    SDL_zeroa(physical_devices);
 
     /* Select the proper audio driver */
     if (driver_name == NULL) {
@@ -1029,7 +1418,7 @@ SDL_AudioInit(const char *driver_name)
         return -1;            /* No driver was available, so fail. */
     }
 
-    current_audio.detectionLock = SDL_CreateMutex();
+    current_audio.detectionLock = SDL_CreateRWLock();
 
     finish_audio_entry_points_init();
 
@@ -1095,17 +1484,22 @@ SDL_GetNumAudioDevices(int iscapture)
         return -1;
     }
 
-    SDL_LockMutex(current_audio.detectionLock);
-    if (iscapture && current_audio.captureDevicesRemoved) {
-        clean_out_device_list(&current_audio.inputDevices, &current_audio.inputDeviceCount, &current_audio.captureDevicesRemoved);
-    }
+    /* The device lists only need to be written if a device went away */
+    SDL_LockRWLockForReading(current_audio.detectionLock);
+    if (iscapture ? current_audio.captureDevicesRemoved : current_audio.outputDevicesRemoved) {
+        SDL_UnlockRWLock(current_audio.detectionLock);
+        SDL_LockRWLockForWriting(current_audio.detectionLock);
+        if (iscapture && current_audio.captureDevicesRemoved) {
+            clean_out_device_list(&current_audio.inputDevices, &current_audio.inputDeviceCount, &current_audio.captureDevicesRemoved);
+        }
 
-    if (!iscapture && current_audio.outputDevicesRemoved) {
-        clean_out_device_list(&current_audio.outputDevices, &current_audio.outputDeviceCount, &current_audio.outputDevicesRemoved);
+        if (!iscapture && current_audio.outputDevicesRemoved) {
+            clean_out_device_list(&current_audio.outputDevices, &current_audio.outputDeviceCount, &current_audio.outputDevicesRemoved);
+        }
     }
 
     retval = iscapture ? current_audio.inputDeviceCount : current_audio.outputDeviceCount;
-    SDL_UnlockMutex(current_audio.detectionLock);
+    SDL_UnlockRWLock(current_audio.detectionLock);
 
     return retval;
 }
@@ -1130,7 +1524,7 @@ SDL_GetAudioDeviceName(int index, int iscapture)
         SDL_AudioDeviceItem *item;
         int i;
 
-        SDL_LockMutex(current_audio.detectionLock);
+        SDL_LockRWLockForReading(current_audio.detectionLock);
         item = iscapture ? current_audio.inputDevices : current_audio.outputDevices;
         i = iscapture ? current_audio.inputDeviceCount : current_audio.outputDeviceCount;
         if (index < i) {
@@ -1140,7 +1534,7 @@ SDL_GetAudioDeviceName(int index, int iscapture)
             SDL_assert(item != NULL);
             retval = item->name;
         }
-        SDL_UnlockMutex(current_audio.detectionLock);
+        SDL_UnlockRWLock(current_audio.detectionLock);
     }
 
     if (retval == NULL) {
@@ -1172,7 +1566,7 @@ SDL_GetAudioDeviceSpec(int index, int iscapture, SDL_AudioSpec *spec)
         SDL_AudioDeviceItem *item;
         int i;
 
-        SDL_LockMutex(current_audio.detectionLock);
+        SDL_LockRWLockForReading(current_audio.detectionLock);
         item = iscapture ? current_audio.inputDevices : current_audio.outputDevices;
         i = iscapture ? current_audio.inputDeviceCount : current_audio.outputDeviceCount;
         if (index < i) {
@@ -1182,13 +1576,88 @@ SDL_GetAudioDeviceSpec(int index, int iscapture, SDL_AudioSpec *spec)
             SDL_assert(item != NULL);
             SDL_memcpy(spec, &item->spec, sizeof(SDL_AudioSpec));
         }
-        SDL_UnlockMutex(current_audio.detectionLock);
+        SDL_UnlockRWLock(current_audio.detectionLock);
     }
 
     return 0;
 }
 
 
+static void
+free_audio_device(SDL_AudioDevice *device)
+{
+    if (device->mixer_lock != NULL) {
+        SDL_DestroyMutex(device->mixer_lock);
+    }
+
+    SDL_free(device->work_buffer);
+    SDL_FreeAudioStream(device->stream);
+
+    if (device->hidden != NULL) {
+        current_audio.impl.CloseDevice(device);
+    }
+
+    SDL_FreeDataQueue(device->buffer_queue);
+    SDL_free(device->physical_name);
+
+    SDL_free(device);
+}
+
+static void close_audio_device(SDL_AudioDevice * device);
+
+/* Take a logical device off its physical device, closing the physical
+   device if this was the last logical device on it. */
+static void
+detach_logical_device(SDL_AudioDevice *device)
+{
+    SDL_AudioDevice *physical = device->physical;
+    SDL_AudioDevice **prev;
+    int i;
+
+    SDL_LockMutex(physical->mixer_lock);
+    for (prev = &physical->logical_devices; *prev != NULL; prev = &(*prev)->logical_next) {
+        if (*prev == device) {
+            *prev = device->logical_next;
+            break;
+        }
+    }
+    SDL_UnlockMutex(physical->mixer_lock);
+
+    if (SDL_AtomicDecRef(&physical->refcount)) {
+        if (SDL_ThreadID() == physical->threadid) {
+            /* A callback closed the last logical device from the mixing
+               thread, which can't wait for itself. Let the thread finish and
+               leave the rest to close_pending_physical_devices(). */
+            SDL_AtomicSet(&physical->shutdown, 1);
+            return;
+        }
+        for (i = 0; i < SDL_arraysize(physical_devices); i++) {
+            if (physical_devices[i] == physical) {
+                physical_devices[i] = NULL;
+            }
+        }
+        close_audio_device(physical);
+    }
+}
+
+/* Close the physical devices that lost their last logical device from
+   inside their own mixing thread. */
+static void
+close_pending_physical_devices(void)
+{
+    SDL_AudioDevice *physical;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(physical_devices); i++) {
+        physical = physical_devices[i];
+        if ((physical != NULL) && (SDL_AtomicGet(&physical->refcount) == 0) &&
+            (SDL_ThreadID() != physical->threadid)) {
+            physical_devices[i] = NULL;
+            close_audio_device(physical);
+        }
+    }
+}
+
 static void
 close_audio_device(SDL_AudioDevice * device)
 {
@@ -1207,12 +1676,6 @@ close_audio_device(SDL_AudioDevice * device)
     if (device->thread != NULL) {
         SDL_WaitThread(device->thread, NULL);
     }
-    if (device->mixer_lock != NULL) {
-        SDL_DestroyMutex(device->mixer_lock);
-    }
-
-    SDL_free(device->work_buffer);
-    SDL_FreeAudioStream(device->stream);
 
     if (device->id > 0) {
         SDL_AudioDevice *opendev = open_devices[device->id - 1];
@@ -1222,13 +1685,15 @@ close_audio_device(SDL_AudioDevice * device)
         }
     }
 
-    if (device->hidden != NULL) {
-        current_audio.impl.CloseDevice(device);
+    if (device->physical != NULL) {
+        detach_logical_device(device);
+        /* the mixing thread might still hold a reference; the last one frees it. */
+        if (!SDL_AtomicDecRef(&device->refcount)) {
+            return;
+        }
     }
 
-    SDL_FreeDataQueue(device->buffer_queue);
-
-    SDL_free(device);
+    free_audio_device(device);
 }
 
 
@@ -1238,7 +1703,7 @@ close_audio_device(SDL_AudioDevice * device)
  *  Returns non-zero if okay, zero on fatal parameters in (orig).
  */
 static int
-prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
+prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared, SDL_bool low_latency)
 {
     SDL_memcpy(prepared, orig, sizeof(SDL_AudioSpec));
 
@@ -1279,14 +1744,18 @@ prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
     if (orig->samples == 0) {
         const char *env = SDL_getenv("SDL_AUDIO_SAMPLES");
         if ((!env) || ((prepared->samples = (Uint16) SDL_atoi(env)) == 0)) {
-            /* Pick a default of ~46 ms at desired frequency */
-            /* !!! FIXME: remove this when the non-Po2 resampling is in. */
-            const int samples = (prepared->freq / 1000) * 46;
-            int power2 = 1;
-            while (power2 < samples) {
-                power2 *= 2;
+            if (low_latency) {
+                prepared->samples = SDL_AUDIO_LOW_LATENCY_SAMPLES;
+            } else {
+                /* Pick a default of ~46 ms at desired frequency */
+                /* !!! FIXME: remove this when the non-Po2 resampling is in. */
+                const int samples = (prepared->freq / 1000) * 46;
+                int power2 = 1;
+                while (power2 < samples) {
+                    power2 *= 2;
+                }
+                prepared->samples = power2;
             }
-            prepared->samples = power2;
         }
     }
 
@@ -1296,12 +1765,141 @@ prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
     return 1;
 }
 
+static void
+init_device_timing(SDL_AudioDevice *device, Uint32 stats_log_ms)
+{
+    device->period_ticks = (device->spec.samples * SDL_GetPerformanceFrequency()) / device->spec.freq;
+    device->stats.low_latency = device->low_latency;
+    device->stats.period_ns = audio_ticks_to_ns(device->period_ticks);
+    device->stats_log_interval = (SDL_GetPerformanceFrequency() * stats_log_ms) / 1000;
+    device->stats_last_log = SDL_GetPerformanceCounter();
+}
+
+/* Get the physical device that logical devices opened with this name share,
+   opening it with the first logical device's spec if necessary. */
+static SDL_AudioDevice *
+get_physical_device(const char *devname, void *handle, const SDL_AudioSpec *spec,
+                    SDL_bool low_latency, Uint32 stats_log_ms)
+{
+    SDL_AudioDevice *device;
+    int i;
+
+    close_pending_physical_devices();
+
+    for (i = 0; i < SDL_arraysize(physical_devices); i++) {
+        device = physical_devices[i];
+        if ((device == NULL) || (SDL_AtomicGet(&device->refcount) == 0)) {
+            continue;
+        } else if ((device->physical_name == NULL) ? (devname == NULL) :
+                   ((devname != NULL) && (SDL_strcmp(device->physical_name, devname) == 0))) {
+            SDL_AtomicIncRef(&device->refcount);
+            return device;
+        }
+    }
+
+    for (i = 0; i < SDL_arraysize(physical_devices); i++) {
+        if (physical_devices[i] == NULL) {
+            break;
+        }
+    }
+
+    if (i == SDL_arraysize(physical_devices)) {
+        SDL_SetError("Too many open audio devices");
+        return NULL;
+    }
+
+    device = (SDL_AudioDevice *) SDL_calloc(1, sizeof (SDL_AudioDevice));
+    if (device == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Ask for the float format we mix in; the backend may pick another. */
+    device->spec = *spec;
+    device->spec.format = AUDIO_F32SYS;
+    device->spec.callback = NULL;
+    device->spec.userdata = NULL;
+    SDL_CalculateAudioSpec(&device->spec);
+    device->handle = handle;
+    device->low_latency = low_latency;
+
+    SDL_AtomicSet(&device->shutdown, 0);
+    SDL_AtomicSet(&device->paused, 0);
+    SDL_AtomicSet(&device->enabled, 1);
+    SDL_AtomicSet(&device->refcount, 1);
+
+    if (devname != NULL) {
+        device->physical_name = SDL_strdup(devname);
+        if (device->physical_name == NULL) {
+            close_audio_device(device);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+
+    device->mixer_lock = SDL_CreateMutex();
+    if (device->mixer_lock == NULL) {
+        close_audio_device(device);
+        SDL_SetError("Couldn't create mixer lock");
+        return NULL;
+    }
+
+    if (current_audio.impl.OpenDevice(device, handle, devname, 0) < 0) {
+        close_audio_device(device);
+        return NULL;
+    }
+
+    SDL_assert(device->hidden != NULL);
+
+    init_device_timing(device, stats_log_ms);
+
+    /* The mix is float at whatever rate and layout the device settled on. */
+    device->callbackspec = device->spec;
+    device->callbackspec.format = AUDIO_F32SYS;
+    SDL_CalculateAudioSpec(&device->callbackspec);
+
+    if (device->spec.format != AUDIO_F32SYS) {
+        device->stream = SDL_NewAudioStream(AUDIO_F32SYS, device->spec.channels, device->spec.freq,
+                                            device->spec.format, device->spec.channels, device->spec.freq);
+        if (!device->stream) {
+            close_audio_device(device);
+            return NULL;
+        }
+    }
+
+    device->work_buffer_len = device->callbackspec.size;
+    device->work_buffer = (Uint8 *) SDL_malloc(device->work_buffer_len);
+    if (device->work_buffer == NULL) {
+        close_audio_device(device);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    device->thread = SDL_CreateThreadInternal(SDL_MixAudioDevices, "SDLAudioMixer", 0, device);
+    if (device->thread == NULL) {
+        close_audio_device(device);
+        SDL_SetError("Couldn't create audio thread");
+        return NULL;
+    }
+
+    physical_devices[i] = device;
+
+    return device;
+}
+
 static SDL_AudioDeviceID
 open_audio_device(const char *devname, int iscapture,
                   const SDL_AudioSpec * desired, SDL_AudioSpec * obtained,
                   int allowed_changes, int min_id)
 {
     const SDL_bool is_internal_thread = (desired->callback == NULL);
+    const SDL_bool low_latency = SDL_GetHintBoolean(SDL_HINT_AUDIO_LOW_LATENCY, SDL_FALSE);
+    const char *stats_log_hint = SDL_GetHint(SDL_HINT_AUDIO_STATS_LOG_INTERVAL);
+    const Uint32 stats_log_ms = stats_log_hint ? (Uint32) SDL_max(SDL_atoi(stats_log_hint), 0) : 0;
+    /* logical devices need our mixing thread and our locking. */
+    const SDL_bool logical = !iscapture && SDL_GetHintBoolean(SDL_HINT_AUDIO_LOGICAL_DEVICES, SDL_FALSE) &&
+                             !current_audio.impl.ProvidesOwnCallbackThread &&
+                             (current_audio.impl.LockDevice == SDL_AudioLockDevice_Default);
     SDL_AudioDeviceID id = 0;
     SDL_AudioSpec _obtained;
     SDL_AudioDevice *device;
@@ -1335,7 +1933,7 @@ open_audio_device(const char *devname, int iscapture,
     if (!obtained) {
         obtained = &_obtained;
     }
-    if (!prepare_audiospec(desired, obtained)) {
+    if (!prepare_audiospec(desired, obtained, low_latency)) {
         return 0;
     }
 
@@ -1375,7 +1973,8 @@ open_audio_device(const char *devname, int iscapture,
         devname = NULL;
 
         for (i = 0; i < SDL_arraysize(open_devices); i++) {
-            if ((open_devices[i]) && (!open_devices[i]->iscapture)) {
+            /* logical devices can share the device with each other, though. */
+            if ((open_devices[i]) && (!open_devices[i]->iscapture) && (!logical || !open_devices[i]->physical)) {
                 SDL_SetError("Audio device already open");
                 return 0;
             }
@@ -1388,14 +1987,14 @@ open_audio_device(const char *devname, int iscapture,
            It might still need to open a device based on the string for,
            say, a network audio server, but this optimizes some cases. */
         SDL_AudioDeviceItem *item;
-        SDL_LockMutex(current_audio.detectionLock);
+        SDL_LockRWLockForReading(current_audio.detectionLock);
         for (item = iscapture ? current_audio.inputDevices : current_audio.outputDevices; item; item = item->next) {
             if ((item->handle != NULL) && (SDL_strcmp(item->name, devname) == 0)) {
                 handle = item->handle;
                 break;
             }
         }
-        SDL_UnlockMutex(current_audio.detectionLock);
+        SDL_UnlockRWLock(current_audio.detectionLock);
     }
 
     if (!current_audio.impl.AllowsArbitraryDeviceNames) {
@@ -1415,6 +2014,7 @@ open_audio_device(const char *devname, int iscapture,
     device->spec = *obtained;
     device->iscapture = iscapture ? SDL_TRUE : SDL_FALSE;
     device->handle = handle;
+    device->low_latency = low_latency;
 
     SDL_AtomicSet(&device->shutdown, 0);  /* just in case. */
     SDL_AtomicSet(&device->paused, 1);
@@ -1430,14 +2030,33 @@ open_audio_device(const char *devname, int iscapture,
         }
     }
 
-    if (current_audio.impl.OpenDevice(device, handle, devname, iscapture) < 0) {
-        close_audio_device(device);
-        return 0;
-    }
+    if (logical) {
+        device->physical = get_physical_device(devname, handle, obtained, low_latency, stats_log_ms);
+        if (device->physical == NULL) {
+            close_audio_device(device);
+            return 0;
+        }
+        SDL_AtomicSet(&device->refcount, 1);
+        device->gain = 1.0f;
+
+        /* Our "hardware" is the physical device's float mix. */
+        device->spec.format = device->physical->callbackspec.format;
+        device->spec.channels = device->physical->callbackspec.channels;
+        device->spec.freq = device->physical->callbackspec.freq;
+        device->spec.samples = device->physical->callbackspec.samples;
+        SDL_CalculateAudioSpec(&device->spec);
+    } else {
+        if (current_audio.impl.OpenDevice(device, handle, devname, iscapture) < 0) {
+            close_audio_device(device);
+            return 0;
+        }
 
-    /* if your target really doesn't need it, set it to 0x1 or something. */
-    /* otherwise, close_audio_device() won't call impl.CloseDevice(). */
-    SDL_assert(device->hidden != NULL);
+        /* if your target really doesn't need it, set it to 0x1 or something. */
+        /* otherwise, close_audio_device() won't call impl.CloseDevice(). */
+        SDL_assert(device->hidden != NULL);
+
+        init_device_timing(device, stats_log_ms);
+    }
 
     /* See if we need to do any conversion */
     build_stream = SDL_FALSE;
@@ -1519,8 +2138,13 @@ open_audio_device(const char *devname, int iscapture,
 
     open_devices[id] = device;  /* add it to our list of open devices. */
 
-    /* Start the audio thread if necessary */
-    if (!current_audio.impl.ProvidesOwnCallbackThread) {
+    if (device->physical != NULL) {
+        /* The physical device's thread mixes it in from now on. */
+        SDL_LockMutex(device->physical->mixer_lock);
+        device->logical_next = device->physical->logical_devices;
+        device->physical->logical_devices = device;
+        SDL_UnlockMutex(device->physical->mixer_lock);
+    } else if (!current_audio.impl.ProvidesOwnCallbackThread) {
         /* Start the audio thread */
         /* !!! FIXME: we don't force the audio thread stack size here if it calls into user code, but maybe we should? */
         /* buffer queueing callback only needs a few bytes, so make the stack tiny. */
@@ -1601,6 +2225,66 @@ SDL_GetAudioDeviceStatus(SDL_AudioDeviceID devid)
     return status;
 }
 
+int
+SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    current_audio.impl.LockDevice(device);
+    if (device->physical != NULL) {
+        /* logical devices report on the thread that mixes them. */
+        audio_copy_stats(device->physical, stats);
+    } else {
+        audio_copy_stats(device, stats);
+    }
+    stats->queued_bytes = (Uint32) SDL_CountDataQueue(device->buffer_queue);
+    current_audio.impl.UnlockDevice(device);
+    return 0;
+}
+
+int
+SDL_SetAudioDeviceGain(SDL_AudioDeviceID devid, float gain)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!device->physical) {
+        return SDL_SetError("Audio device is not a logical device");
+    } else if (!(gain >= 0.0f)) {  /* this catches NaN, too. */
+        return SDL_InvalidParamError("gain");
+    }
+
+    current_audio.impl.LockDevice(device);
+    device->gain = gain;
+    current_audio.impl.UnlockDevice(device);
+    return 0;
+}
+
+int
+SDL_GetAudioDeviceGain(SDL_AudioDeviceID devid, float *gain)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!device->physical) {
+        return SDL_SetError("Audio device is not a logical device");
+    } else if (!gain) {
+        return SDL_InvalidParamError("gain");
+    }
+
+    current_audio.impl.LockDevice(device);
+    *gain = device->gain;
+    current_audio.impl.UnlockDevice(device);
+    return 0;
+}
 
 SDL_AudioStatus
 SDL_GetAudioStatus(void)
@@ -1662,6 +2346,7 @@ void
 SDL_CloseAudioDevice(SDL_AudioDeviceID devid)
 {
     close_audio_device(get_audio_device(devid));
+    close_pending_physical_devices();
 }
 
 void
@@ -1682,6 +2367,7 @@ SDL_AudioQuit(void)
     for (i = 0; i < SDL_arraysize(open_devices); i++) {
         close_audio_device(open_devices[i]);
     }
+    close_pending_physical_devices();
 
     free_device_list(&current_audio.outputDevices, &current_audio.outputDeviceCount);
     free_device_list(&current_audio.inputDevices, &current_audio.inputDeviceCount);
@@ -1689,10 +2375,11 @@ SDL_AudioQuit(void)
     /* Free the driver data */
     current_audio.impl.Deinitialize();
 
-    SDL_DestroyMutex(current_audio.detectionLock);
+    SDL_DestroyRWLock(current_audio.detectionLock);
 
     SDL_zero(current_audio);
     SDL_zeroa(open_devices);
+    SDL_zeroa(physical_devices);
 
 #ifdef HAVE_LIBSAMPLERATE_H
     UnloadLibSampleRate();
@@ -51,6 +51,13 @@ extern void SDL_RemoveAudioDevice(const int iscapture, void *handle);
    as appropriate so SDL's list of devices is accurate. */
 extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
 
+/* Audio targets that have no hardware to block on can call this from
+   WaitDevice() to sleep until the next period ends. (deadline) holds the
+   previous deadline on SDL_GetPerformanceCounter(), or 0 to start from now.
+   Unlike repeated SDL_Delay() calls this doesn't drift, and if the thread
+   fell a whole period behind it resyncs instead of trying to catch up. */
+extern void SDL_AudioWaitNextPeriod(SDL_AudioDevice *device, Uint64 *deadline);
+
 /* This is the size of a packet when using SDL_QueueAudio(). We allocate
    these as necessary and pool them, under the assumption that we'll
    eventually end up with a handful that keep recycling, meeting whatever
@@ -62,6 +69,10 @@ extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
    The system preallocates enough packets for 2 callbacks' worth of data. */
 #define SDL_AUDIOBUFFERQUEUE_PACKETLEN (8 * 1024)
 
+/* Default device period, in sample frames, for devices opened with
+   SDL_HINT_AUDIO_LOW_LATENCY when the app didn't ask for a size. */
+#define SDL_AUDIO_LOW_LATENCY_SAMPLES 128
+
 typedef struct SDL_AudioDriverImpl
 {
     void (*DetectDevices) (void);
@@ -117,8 +128,8 @@ typedef struct SDL_AudioDriver
 
     SDL_AudioDriverImpl impl;
 
-    /* A mutex for device detection */
-    SDL_mutex *detectionLock;
+    /* Protects the device lists, which are read much more often than changed */
+    SDL_rwlock *detectionLock;
     SDL_bool captureDevicesRemoved;
     SDL_bool outputDevicesRemoved;
     int outputDeviceCount;
@@ -166,6 +177,43 @@ struct SDL_AudioDevice
     /* Queued buffers (if app not using callback). */
     SDL_DataQueue *buffer_queue;
 
+    /* SDL_TRUE if opened with SDL_HINT_AUDIO_LOW_LATENCY. */
+    SDL_bool low_latency;
+
+    /* Length of one device buffer, in SDL_GetPerformanceCounter() ticks. */
+    Uint64 period_ticks;
+
+    /* Timing statistics, protected by mixer_lock, except for the wakeup
+       counters the device thread writes while wake_seq is odd. */
+    SDL_AudioDeviceStats stats;
+    SDL_atomic_t wake_seq;
+    Uint64 callback_total_ns;
+
+    /* SDL_HINT_AUDIO_STATS_LOG_INTERVAL, in SDL_GetPerformanceCounter() ticks. */
+    Uint64 stats_log_interval;
+    Uint64 stats_last_log;
+
+    /* Logical devices (SDL_HINT_AUDIO_LOGICAL_DEVICES) have no backend
+       state or thread of their own; the physical device's thread mixes them. */
+    SDL_AudioDevice *physical;
+
+    /* Next logical device on the same physical device, protected by the
+       physical device's mixer_lock. */
+    SDL_AudioDevice *logical_next;
+
+    /* Physical devices: the logical devices they mix, protected by mixer_lock. */
+    SDL_AudioDevice *logical_devices;
+
+    /* Physical devices: the device name they were opened with (NULL for the default). */
+    char *physical_name;
+
+    /* Logical devices: references from the app and the mixing thread.
+       Physical devices: number of logical devices opened on them. */
+    SDL_atomic_t refcount;
+
+    /* Gain applied when mixing a logical device, protected by mixer_lock. */
+    float gain;
+
     /* * * */
     /* Data private to this driver */
     struct SDL_PrivateAudioData *hidden;
@@ -35,8 +35,10 @@
 
 #include "SDL_hints.h"
 #include "SDL_audio.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_wave.h"
 #include "SDL_audio_c.h"
+#include "../thread/SDL_systhread.h"
 
 /* Reads the value stored at the location of the f1 pointer, multiplies it
  * with the second argument and then stores the result to f1.
@@ -331,6 +333,145 @@ WaveAdjustToFactValue(WaveFile *file, Sint64 sampleframes)
     return sampleframes;
 }
 
+/* Blocks that can be decoded in parallel are split between at most this many
+ * threads, and each thread gets at least ADPCM_MIN_BYTES_PER_THREAD of output.
+ * Spawning threads costs more than decoding a short sound effect.
+ */
+#define ADPCM_MAX_THREADS 16
+#define ADPCM_MIN_BYTES_PER_THREAD (256 * 1024)
+
+typedef int (*ADPCM_DecodeFunc)(ADPCM_DecoderState *state);
+
+typedef struct ADPCM_DecodeJob
+{
+    ADPCM_DecoderState state;
+    ADPCM_DecodeFunc decodeheader;
+    ADPCM_DecodeFunc decodedata;
+    size_t blockcount;
+    size_t blocksdone;
+    union {
+        MS_ADPCM_ChannelState ms[2];
+        Sint8 ima[256];
+    } cstate;
+} ADPCM_DecodeJob;
+
+static int SDLCALL
+ADPCM_RunDecodeJob(void *data)
+{
+    ADPCM_DecodeJob *job = (ADPCM_DecodeJob *)data;
+    ADPCM_DecoderState *state = &job->state;
+
+    for (job->blocksdone = 0; job->blocksdone < job->blockcount; job->blocksdone++) {
+        state->block.data = state->input.data + state->input.pos;
+        state->block.size = state->blocksize;
+        state->block.pos = 0;
+        if (job->decodeheader(state) < 0 || job->decodedata(state) < 0) {
+            /* Errors are per thread. The caller decodes this block again. */
+            break;
+        }
+        state->input.pos += state->blocksize;
+    }
+
+    return 0;
+}
+
+static int
+ADPCM_GetDecodeThreadCount(size_t outputsize)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_WAVE_DECODE_THREADS);
+    int threads = hint ? SDL_atoi(hint) : 0;
+    const size_t maxthreads = outputsize / ADPCM_MIN_BYTES_PER_THREAD;
+
+    if (threads <= 0) {
+        threads = SDL_GetCPUCount();
+    }
+    if ((size_t)threads > maxthreads) {
+        threads = (int)maxthreads;
+    }
+    return SDL_clamp(threads, 1, ADPCM_MAX_THREADS);
+}
+
+/* ADPCM blocks don't depend on each other. This decodes the complete blocks at
+ * the start of the input on several threads, if there are enough of them, and
+ * advances the state past the blocks that were decoded. The caller decodes
+ * whatever is left block by block, including any block that failed here.
+ */
+static void
+ADPCM_DecodeBlocksParallel(ADPCM_DecoderState *state, ADPCM_DecodeFunc decodeheader, ADPCM_DecodeFunc decodedata)
+{
+    ADPCM_DecodeJob jobs[ADPCM_MAX_THREADS];
+    SDL_Thread *threads[ADPCM_MAX_THREADS];
+    const size_t framesperblock = state->samplesperblock;
+    const size_t blockoutput = framesperblock * state->channels;
+    size_t blockcount, blocksperjob, i, done;
+    int jobcount;
+
+    if (framesperblock == 0 || state->framesleft <= 0) {
+        return;
+    }
+
+    /* Only blocks that are fully present and aren't cut short by the number
+     * of sample frames. The last block is left to the caller.
+     */
+    blockcount = (state->input.size - state->input.pos) / state->blocksize;
+    if ((Uint64)blockcount > (Uint64)state->framesleft / framesperblock) {
+        blockcount = (size_t)(state->framesleft / framesperblock);
+    }
+
+    jobcount = ADPCM_GetDecodeThreadCount(blockcount * blockoutput * sizeof(Sint16));
+    if (jobcount <= 1) {
+        return;
+    }
+    blocksperjob = (blockcount + jobcount - 1) / jobcount;
+
+    for (i = 0; i < (size_t)jobcount; i++) {
+        ADPCM_DecodeJob *job = &jobs[i];
+        const size_t first = i * blocksperjob;
+
+        job->state = *state;
+        job->state.input.pos += first * state->blocksize;
+        job->state.output.pos += first * blockoutput;
+        job->state.cstate = &job->cstate;
+        job->decodeheader = decodeheader;
+        job->decodedata = decodedata;
+        job->blockcount = first < blockcount ? SDL_min(blocksperjob, blockcount - first) : 0;
+        job->blocksdone = 0;
+        job->state.framesleft = (Sint64)(job->blockcount * framesperblock);
+
+        /* The calling thread takes the last job. */
+        threads[i] = NULL;
+        if (i + 1 < (size_t)jobcount && job->blockcount > 0) {
+            threads[i] = SDL_CreateThreadInternal(ADPCM_RunDecodeJob, "SDLWaveDecode", 0, job);
+        }
+    }
+
+    for (i = 0; i < (size_t)jobcount; i++) {
+        if (threads[i] == NULL) {
+            /* Last job, or thread creation failed. */
+            ADPCM_RunDecodeJob(&jobs[i]);
+        }
+    }
+
+    for (i = 0; i < (size_t)jobcount; i++) {
+        if (threads[i] != NULL) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+    }
+
+    /* Everything up to the first block that failed is done. */
+    done = 0;
+    for (i = 0; i < (size_t)jobcount; i++) {
+        done += jobs[i].blocksdone;
+        if (jobs[i].blocksdone < jobs[i].blockcount) {
+            break;
+        }
+    }
+
+    state->input.pos += done * state->blocksize;
+    state->output.pos += done * blockoutput;
+    state->framesleft -= (Sint64)(done * framesperblock);
+}
+
 static int
 MS_ADPCM_CalculateSampleFrames(WaveFile *file, size_t datalength)
 {
@@ -490,30 +631,29 @@ MS_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
+static const Uint16 MS_ADPCM_adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
+
+static SDL_INLINE Sint16
 MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sample2, Uint8 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
     const Uint16 max_deltaval = 65535;
-    const Uint16 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
     Sint32 new_sample;
-    Sint32 errordelta;
     Uint32 delta = cstate->delta;
 
     new_sample = (sample1 * cstate->coeff1 + sample2 * cstate->coeff2) / 256;
     /* The nibble is a signed 4-bit error delta. */
-    errordelta = (Sint32)nybble - (nybble >= 0x08 ? 0x10 : 0);
-    new_sample += (Sint32)delta * errordelta;
+    new_sample += (Sint32)delta * (((Sint32)nybble ^ 0x08) - 0x08);
     if (new_sample < min_audioval) {
         new_sample = min_audioval;
     } else if (new_sample > max_audioval) {
         new_sample = max_audioval;
     }
-    delta = (delta * adaptive[nybble]) / 256;
+    delta = (delta * MS_ADPCM_adaptive[nybble]) / 256;
     if (delta < 16) {
         delta = 16;
     } else if (delta > max_deltaval) {
@@ -591,49 +731,56 @@ MS_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
 static int
 MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 {
-    Uint16 nybble = 0;
-    Sint16 sample1, sample2;
+    int retval = 0;
     const Uint32 channels = state->channels;
-    Uint32 c;
     MS_ADPCM_ChannelState *cstate = (MS_ADPCM_ChannelState *)state->cstate;
-
-    size_t blockpos = state->block.pos;
-    size_t blocksize = state->block.size;
-
-    size_t outpos = state->output.pos;
+    const Uint8 *data = state->block.data + state->block.pos;
+    Sint16 *out = state->output.data + state->output.pos;
+    size_t availablesamples = (state->block.size - state->block.pos) * 2;
+    size_t frames, i;
 
     Sint64 blockframesleft = state->samplesperblock - 2;
     if (blockframesleft > state->framesleft) {
         blockframesleft = state->framesleft;
     }
+    if (blockframesleft <= 0) {
+        return 0;
+    }
 
-    while (blockframesleft > 0) {
-        for (c = 0; c < channels; c++) {
-            if (nybble & 0x4000) {
-                nybble <<= 4;
-            } else if (blockpos < blocksize) {
-                nybble = state->block.data[blockpos++] | 0x4000;
-            } else {
-                /* Out of input data. Drop the incomplete frame and return. */
-                state->output.pos = outpos - c;
-                return -1;
-            }
-
-            /* Load previous samples which may come from the block header. */
-            sample1 = state->output.data[outpos - channels];
-            sample2 = state->output.data[outpos - channels * 2];
+    frames = (size_t)blockframesleft;
+    if (availablesamples < frames * channels) {
+        /* Out of input data. Decode the complete frames and return. */
+        frames = availablesamples / channels;
+        retval = -1;
+    }
 
-            sample1 = MS_ADPCM_ProcessNibble(cstate + c, sample1, sample2, (nybble >> 4) & 0x0f);
-            state->output.data[outpos++] = sample1;
+    /* The nibbles are in the same order as the output samples, high nibble
+     * first. The two previous samples of a channel, which may come from the
+     * block header, are one and two frames back in the output.
+     */
+    if (channels == 2) {
+        for (i = 0; i < frames; i++) {
+            const Uint8 byte = *data++;
+            out[0] = MS_ADPCM_ProcessNibble(cstate, out[-2], out[-4], byte >> 4);
+            out[1] = MS_ADPCM_ProcessNibble(cstate + 1, out[-1], out[-3], byte & 0x0f);
+            out += 2;
+        }
+    } else {
+        for (i = 0; i + 1 < frames; i += 2) {
+            const Uint8 byte = *data++;
+            out[0] = MS_ADPCM_ProcessNibble(cstate, out[-1], out[-2], byte >> 4);
+            out[1] = MS_ADPCM_ProcessNibble(cstate, out[0], out[-1], byte & 0x0f);
+            out += 2;
+        }
+        if (i < frames) {
+            out[0] = MS_ADPCM_ProcessNibble(cstate, out[-1], out[-2], *data >> 4);
         }
-
-        state->framesleft--;
-        blockframesleft--;
     }
 
-    state->output.pos = outpos;
+    state->output.pos += frames * channels;
+    state->framesleft -= frames;
 
-    return 0;
+    return retval;
 }
 
 static int
@@ -692,6 +839,9 @@ MS_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 
     state.cstate = cstate;
 
+    /* Large files get most of their blocks decoded on several threads. */
+    ADPCM_DecodeBlocksParallel(&state, MS_ADPCM_DecodeBlockHeader, MS_ADPCM_DecodeBlockData);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -856,59 +1006,64 @@ IMA_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
-IMA_ADPCM_ProcessNibble(Sint8 *cindex, Sint16 lastsample, Uint8 nybble)
-{
-    const Sint32 max_audioval = 32767;
-    const Sint32 min_audioval = -32768;
-    const Sint8 index_table_4b[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Uint16 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
-    Uint32 step;
-    Sint32 sample, delta;
-    Sint8 index = *cindex;
+static const Sint8 IMA_ADPCM_index_table_4b[16] = {
+    -1, -1, -1, -1,
+    2, 4, 6, 8,
+    -1, -1, -1, -1,
+    2, 4, 6, 8
+};
+
+static const Uint16 IMA_ADPCM_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+    143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
 
-    /* Clamp index into valid range. */
+/* The step index in the channel state and the block header can be out of
+ * range. It gets clamped before it is used.
+ */
+static SDL_INLINE Sint32
+IMA_ADPCM_ClampIndex(Sint32 index)
+{
     if (index > 88) {
-        index = 88;
+        return 88;
     } else if (index < 0) {
-        index = 0;
+        return 0;
     }
+    return index;
+}
 
-    /* explicit cast to avoid gcc warning about using 'char' as array index */
-    step = step_table[(size_t)index];
+/* Decodes one nibble. index must be in range and gets updated. */
+static SDL_INLINE Sint16
+IMA_ADPCM_ProcessNibble(Sint32 *index, Sint32 lastsample, Uint8 nybble)
+{
+    const Sint32 max_audioval = 32767;
+    const Sint32 min_audioval = -32768;
+    const Sint32 step = IMA_ADPCM_step_table[*index];
+    Sint32 sample, delta;
 
     /* Update index value */
-    *cindex = index + index_table_4b[nybble];
+    *index = IMA_ADPCM_ClampIndex(*index + IMA_ADPCM_index_table_4b[nybble]);
 
     /* This calculation uses shifts and additions because multiplications were
      * much slower back then. Sadly, this can't just be replaced with an actual
      * multiplication now as the old algorithm drops some bits. The closest
      * approximation I could find is something like this:
      * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
+     * The masks select the terms without branching.
      */
     delta = step >> 3;
-    if (nybble & 0x04)
-        delta += step;
-    if (nybble & 0x02)
-        delta += step >> 1;
-    if (nybble & 0x01)
-        delta += step >> 2;
-    if (nybble & 0x08)
+    delta += step & -(Sint32)((nybble >> 2) & 1);
+    delta += (step >> 1) & -(Sint32)((nybble >> 1) & 1);
+    delta += (step >> 2) & -(Sint32)(nybble & 1);
+    if (nybble & 0x08) {
         delta = -delta;
+    }
 
     sample = lastsample + delta;
 
@@ -1005,20 +1160,26 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
         const size_t subblocksamples = blockframesleft < 8 ? (size_t)blockframesleft : 8;
 
         for (c = 0; c < channels; c++) {
-            Uint8 nybble = 0;
+            Sint8 *cindex = (Sint8 *)state->cstate + c;
+            Sint32 index = IMA_ADPCM_ClampIndex(*cindex);
+            Sint16 *out = state->output.data + outpos + c;
             /* Load previous sample which may come from the block header. */
-            Sint16 sample = state->output.data[outpos + c - channels];
-
-            for (i = 0; i < subblocksamples; i++) {
-                if (i & 1) {
-                    nybble >>= 4;
-                } else {
-                    nybble = state->block.data[blockpos++];
-                }
-
-                sample = IMA_ADPCM_ProcessNibble((Sint8 *)state->cstate + c, sample, nybble & 0x0f);
-                state->output.data[outpos + c + i * channels] = sample;
+            Sint16 sample = out[-(Sint32)channels];
+
+            /* Two nibbles per byte, low nibble first. */
+            for (i = 0; i + 1 < subblocksamples; i += 2) {
+                const Uint8 byte = state->block.data[blockpos++];
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, byte & 0x0f);
+                out[i * channels] = sample;
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, byte >> 4);
+                out[(i + 1) * channels] = sample;
             }
+            if (i < subblocksamples) {
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, state->block.data[blockpos++] & 0x0f);
+                out[i * channels] = sample;
+            }
+
+            *cindex = (Sint8)index;
         }
 
         outpos += channels * subblocksamples;
@@ -1090,6 +1251,9 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     }
     state.cstate = cstate;
 
+    /* Large files get most of their blocks decoded on several threads. */
+    ADPCM_DecodeBlocksParallel(&state, IMA_ADPCM_DecodeBlockHeader, IMA_ADPCM_DecodeBlockData);
+
     /* Decode block by block. A truncated block will stop the decoding. */
     bytesleft = state.input.size - state.input.pos;
     while (state.framesleft > 0 && bytesleft >= state.blockheadersize) {
@@ -1165,8 +1329,11 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Expands companded samples to 16 bits. Works backwards, so dst may start at
+ * the same address as src to expand in-place.
+ */
 static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+LAW_Expand(Uint16 encoding, Sint16 *dst, const Uint8 *src, size_t sample_count)
 {
 #ifdef SDL_WAVE_LAW_LUT
     const Sint16 alaw_lut[256] = {
@@ -1206,54 +1373,9 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
     };
 #endif
+    size_t i = sample_count;
 
-    WaveFormat *format = &file->format;
-    WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
-    Uint8 *src;
-    Sint16 *dst;
-
-    if (chunk->length != chunk->size) {
-        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
-        if (file->sampleframes < 0) {
-            return -1;
-        }
-    }
-
-    /* Nothing to decode, nothing to return. */
-    if (file->sampleframes == 0) {
-        *audio_buf = NULL;
-        *audio_len = 0;
-        return 0;
-    }
-
-    sample_count = (size_t)file->sampleframes;
-    if (SafeMult(&sample_count, format->channels)) {
-        return SDL_OutOfMemory();
-    }
-
-    expanded_len = sample_count;
-    if (SafeMult(&expanded_len, sizeof(Sint16))) {
-        return SDL_OutOfMemory();
-    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
-        return SDL_SetError("WAVE file too big");
-    }
-
-    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
-    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
-    if (src == NULL) {
-        return SDL_OutOfMemory();
-    }
-    chunk->data = NULL;
-    chunk->size = 0;
-
-    dst = (Sint16 *)src;
-
-    /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
-     * inform the caller about the byte order.
-     */
-    i = sample_count;
-    switch (file->format.encoding) {
+    switch (encoding) {
 #ifdef SDL_WAVE_LAW_LUT
     case ALAW_CODE:
         while (i--) {
@@ -1298,10 +1420,65 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         break;
 #endif
     default:
-        SDL_free(src);
         return SDL_SetError("Unknown companded encoding");
     }
 
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    size_t sample_count, expanded_len;
+    Uint8 *src;
+    Sint16 *dst;
+
+    if (chunk->length != chunk->size) {
+        file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
+        if (file->sampleframes < 0) {
+            return -1;
+        }
+    }
+
+    /* Nothing to decode, nothing to return. */
+    if (file->sampleframes == 0) {
+        *audio_buf = NULL;
+        *audio_len = 0;
+        return 0;
+    }
+
+    sample_count = (size_t)file->sampleframes;
+    if (SafeMult(&sample_count, format->channels)) {
+        return SDL_OutOfMemory();
+    }
+
+    expanded_len = sample_count;
+    if (SafeMult(&expanded_len, sizeof(Sint16))) {
+        return SDL_OutOfMemory();
+    } else if (expanded_len > SDL_MAX_UINT32 || file->sampleframes > SIZE_MAX) {
+        return SDL_SetError("WAVE file too big");
+    }
+
+    /* 1 to avoid allocating zero bytes, to keep static analysis happy. */
+    src = (Uint8 *)SDL_realloc(chunk->data, expanded_len ? expanded_len : 1);
+    if (src == NULL) {
+        return SDL_OutOfMemory();
+    }
+    chunk->data = NULL;
+    chunk->size = 0;
+
+    dst = (Sint16 *)src;
+
+    /* Expanding in-place. SDL_AudioSpec.format will inform the caller about
+     * the byte order.
+     */
+    if (LAW_Expand(format->encoding, dst, src, sample_count) < 0) {
+        SDL_free(src);
+        return -1;
+    }
+
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
 
@@ -1352,12 +1529,36 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts 24-bit samples to 32 bits. Works from end to start, so this can
+ * expand in-place.
+ */
+static void
+PCM_Expand24To32(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1586,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_Expand24To32(ptr, sample_count);
 
     return 0;
 }
@@ -1783,8 +1970,12 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Finds and parses the fmt and data chunks, and initializes the decoder. The
+ * data itself is not read. On success, data holds the data chunk and
+ * endposition the position after the RIFF chunk (or the last chunk found).
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveReadHeaders(SDL_RWops *src, WaveFile *file, WaveChunk *data, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1792,7 +1983,6 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     char *envchunkcountlimit;
     Sint64 RIFFstart, RIFFend, lastchunkpos;
     SDL_bool RIFFlengthknown = SDL_FALSE;
-    WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
     WaveChunk RIFFchunk;
     WaveChunk fmtchunk;
@@ -1997,55 +2187,25 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
-    *chunk = datachunk;
+    *data = datachunk;
 
-    if (chunk->length > 0) {
-        result = WaveReadChunkData(src, chunk);
-        if (result == -1) {
-            return -1;
-        } else if (result == -2) {
-            return SDL_SetError("Could not seek data of WAVE data chunk");
-        }
+    /* Report the end position back to the cleanup code. */
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
     }
 
-    if (chunk->length != chunk->size) {
-        /* I/O issues or corrupt file. */
-        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
-            return SDL_SetError("Could not read data of WAVE data chunk");
-        }
-        /* The decoders handle this truncation. */
-    }
+    return 0;
+}
 
-    /* Decode or convert the data if necessary. */
-    switch (format->encoding) {
-    case PCM_CODE:
-    case IEEE_FLOAT_CODE:
-        if (PCM_Decode(file, audio_buf, audio_len) < 0) {
-            return -1;
-        }
-        break;
-    case ALAW_CODE:
-    case MULAW_CODE:
-        if (LAW_Decode(file, audio_buf, audio_len) < 0) {
-            return -1;
-        }
-        break;
-    case MS_ADPCM_CODE:
-        if (MS_ADPCM_Decode(file, audio_buf, audio_len) < 0) {
-            return -1;
-        }
-        break;
-    case IMA_ADPCM_CODE:
-        if (IMA_ADPCM_Decode(file, audio_buf, audio_len) < 0) {
-            return -1;
-        }
-        break;
-    }
+/* Sets up the SDL_AudioSpec for the decoded data. */
+static int
+WaveSetupSpec(WaveFile *file, SDL_AudioSpec *spec)
+{
+    WaveFormat *format = &file->format;
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
+    /* All unsupported formats were filtered out by WaveCheckFormat. */
     SDL_zerop(spec);
     spec->freq = format->frequency;
     spec->channels = (Uint8)format->channels;
@@ -2083,13 +2243,75 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     spec->silence = SDL_SilenceValueForFormat(spec->format);
 
-    /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+    WaveChunk datachunk;
+
+    if (WaveReadHeaders(src, file, &datachunk, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
+    *chunk = datachunk;
+
+    if (chunk->length > 0) {
+        result = WaveReadChunkData(src, chunk);
+        if (result == -1) {
+            return -1;
+        } else if (result == -2) {
+            return SDL_SetError("Could not seek data of WAVE data chunk");
+        }
+    }
+
+    if (chunk->length != chunk->size) {
+        /* I/O issues or corrupt file. */
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            return SDL_SetError("Could not read data of WAVE data chunk");
+        }
+        /* The decoders handle this truncation. */
     }
 
+    /* Decode or convert the data if necessary. */
+    switch (format->encoding) {
+    case PCM_CODE:
+    case IEEE_FLOAT_CODE:
+        if (PCM_Decode(file, audio_buf, audio_len) < 0) {
+            return -1;
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        if (LAW_Decode(file, audio_buf, audio_len) < 0) {
+            return -1;
+        }
+        break;
+    case MS_ADPCM_CODE:
+        if (MS_ADPCM_Decode(file, audio_buf, audio_len) < 0) {
+            return -1;
+        }
+        break;
+    case IMA_ADPCM_CODE:
+        if (IMA_ADPCM_Decode(file, audio_buf, audio_len) < 0) {
+            return -1;
+        }
+        break;
+    }
+
+    if (WaveSetupSpec(file, spec) < 0) {
+        return -1;
+    }
+
+    /* Report the end position back to the cleanup code. */
+    chunk->position = endposition;
+
     return 0;
 }
 
@@ -2152,4 +2374,423 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Streaming WAVE decoder. The headers are parsed by the same code as
+ * SDL_LoadWAV_RW, but the data chunk is read and decoded only as requested.
+ * ADPCM is decoded one block at a time with the regular block decoders.
+ */
+struct _SDL_WaveStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    SDL_AudioSpec spec;
+
+    Uint8 *mem;         /* Data chunk in memory, if src is a memory stream. */
+    size_t datasize;    /* Bytes of the data chunk that are actually present. */
+    Sint64 srcpos;      /* Position of src, or -1 if unknown. */
+
+    Sint64 frame;       /* Next sample frame to be read. */
+    size_t framesize;   /* Size of a decoded sample frame in bytes. */
+
+    /* ADPCM only. */
+    size_t blockheadersize;
+    void *cstate;       /* Decoding state for each channel. */
+    Uint8 *blockdata;   /* Current block read from src, unused with mem. */
+    Sint16 *blockout;   /* Decoded sample frames of the current block. */
+    Sint64 block;       /* Index of the block in blockout, -1 if none. */
+    size_t blockframes; /* Number of sample frames in blockout. */
+};
+
+/* Reads data chunk bytes starting at offset. Returns the number of bytes read. */
+static size_t
+WaveStreamReadData(SDL_WaveStream *stream, size_t offset, void *dst, size_t length)
+{
+    const Sint64 position = stream->file.chunk.position + (Sint64)offset;
+    size_t got;
+
+    if (offset >= stream->datasize) {
+        return 0;
+    } else if (length > stream->datasize - offset) {
+        length = stream->datasize - offset;
+    }
+
+    if (stream->mem != NULL) {
+        SDL_memcpy(dst, stream->mem + offset, length);
+        return length;
+    }
+
+    if (stream->srcpos != position) {
+        if (SDL_RWseek(stream->src, position, RW_SEEK_SET) != position) {
+            /* Handled like a truncated file, same as SDL_LoadWAV_RW. */
+            stream->srcpos = -1;
+            return 0;
+        }
+    }
+
+    got = SDL_RWread(stream->src, dst, 1, length);
+    stream->srcpos = position + (Sint64)got;
+    return got;
+}
+
+/* Decodes ADPCM block number 'block' into stream->blockout. */
+static int
+WaveStreamDecodeBlock(SDL_WaveStream *stream, Sint64 block)
+{
+    WaveFile *file = &stream->file;
+    const size_t samplesperblock = file->format.samplesperblock;
+    const size_t offset = (size_t)block * file->format.blockalign;
+    ADPCM_DecoderState state;
+    int result;
+
+    SDL_zero(state);
+    state.channels = file->format.channels;
+    state.blocksize = file->format.blockalign;
+    state.blockheadersize = stream->blockheadersize;
+    state.samplesperblock = samplesperblock;
+    state.framesize = stream->framesize;
+    state.ddata = file->decoderdata;
+    state.cstate = stream->cstate;
+    state.framestotal = file->sampleframes - block * (Sint64)samplesperblock;
+    if (state.framestotal > (Sint64)samplesperblock) {
+        state.framestotal = samplesperblock;
+    }
+    state.framesleft = state.framestotal;
+
+    stream->block = block;
+    stream->blockframes = 0;
+
+    if (offset >= stream->datasize) {
+        return 0;
+    } else if (stream->mem != NULL) {
+        state.block.data = stream->mem + offset;
+        state.block.size = SDL_min(state.blocksize, stream->datasize - offset);
+    } else {
+        state.block.data = stream->blockdata;
+        state.block.size = WaveStreamReadData(stream, offset, stream->blockdata, state.blocksize);
+    }
+    if (state.block.size < state.blockheadersize) {
+        return 0;
+    }
+
+    state.output.data = stream->blockout;
+    state.output.size = samplesperblock * state.channels;
+
+    if (file->format.encoding == MS_ADPCM_CODE) {
+        result = MS_ADPCM_DecodeBlockHeader(&state);
+        if (result == -1) {
+            stream->block = -1;
+            return -1;
+        }
+        result = MS_ADPCM_DecodeBlockData(&state);
+    } else {
+        result = IMA_ADPCM_DecodeBlockHeader(&state);
+        if (result == 0) {
+            result = IMA_ADPCM_DecodeBlockData(&state);
+        }
+    }
+
+    /* A truncated block keeps what could be decoded. The number of sample
+     * frames in the file already accounts for the truncation hint.
+     */
+    stream->blockframes = state.output.pos / state.channels;
+    if ((Sint64)stream->blockframes > state.framestotal) {
+        stream->blockframes = (size_t)state.framestotal;
+    }
+
+    return 0;
+}
+
+static int
+WaveStreamReadADPCM(SDL_WaveStream *stream, Uint8 *buf, size_t frames)
+{
+    const size_t samplesperblock = stream->file.format.samplesperblock;
+    size_t done = 0;
+
+    while (done < frames) {
+        const Sint64 block = stream->frame / (Sint64)samplesperblock;
+        const size_t blockpos = (size_t)(stream->frame % (Sint64)samplesperblock);
+        size_t count;
+
+        if (block != stream->block) {
+            if (WaveStreamDecodeBlock(stream, block) < 0) {
+                return -1;
+            }
+        }
+        if (blockpos >= stream->blockframes) {
+            break; /* Truncated data. */
+        }
+
+        count = SDL_min(stream->blockframes - blockpos, frames - done);
+        SDL_memcpy(buf + done * stream->framesize, stream->blockout + blockpos * stream->file.format.channels, count * stream->framesize);
+        done += count;
+        stream->frame += count;
+    }
+
+    return (int)(done * stream->framesize);
+}
+
+static int
+WaveStreamReadPCM(SDL_WaveStream *stream, Uint8 *buf, size_t frames)
+{
+    WaveFormat *format = &stream->file.format;
+    const size_t offset = (size_t)stream->frame * format->blockalign;
+    size_t got;
+
+    /* The raw data is never larger than the decoded data, so the samples get
+     * read to the start of buf and expanded in-place.
+     */
+    got = WaveStreamReadData(stream, offset, buf, frames * format->blockalign);
+    frames = got / format->blockalign;
+
+    switch (format->encoding) {
+    case ALAW_CODE:
+    case MULAW_CODE:
+        if (LAW_Expand(format->encoding, (Sint16 *)buf, buf, frames * format->channels) < 0) {
+            return -1;
+        }
+        break;
+    case PCM_CODE:
+        if (format->bitspersample == 24) {
+            PCM_Expand24To32(buf, frames * format->channels);
+        }
+        break;
+    }
+
+    stream->frame += frames;
+    return (int)(frames * stream->framesize);
+}
+
+SDL_WaveStream *
+SDL_WaveStreamOpen(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WaveStream *stream;
+    WaveFile *file;
+    WaveChunk datachunk;
+    Sint64 endposition, srcsize;
+
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        goto failed;
+    }
+
+    stream = (SDL_WaveStream *)SDL_calloc(1, sizeof(*stream));
+    if (stream == NULL) {
+        SDL_OutOfMemory();
+        goto failed;
+    }
+    stream->src = src;
+    stream->freesrc = freesrc;
+    stream->srcpos = -1;
+    stream->block = -1;
+
+    file = &stream->file;
+    file->riffhint = WaveGetRiffSizeHint();
+    file->trunchint = WaveGetTruncationHint();
+    file->facthint = WaveGetFactChunkHint();
+
+    if (WaveReadHeaders(src, file, &datachunk, &endposition) < 0 || WaveSetupSpec(file, &stream->spec) < 0) {
+        goto failed_stream;
+    }
+    file->chunk = datachunk;
+
+    /* Find out how much of the data chunk is actually there. */
+    if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+        srcsize = src->hidden.mem.stop - src->hidden.mem.base;
+    } else {
+        srcsize = SDL_RWsize(src);
+    }
+    stream->datasize = datachunk.length;
+    if (srcsize >= 0 && datachunk.position + datachunk.length > srcsize) {
+        stream->datasize = srcsize > datachunk.position ? (size_t)(srcsize - datachunk.position) : 0;
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            goto failed_stream;
+        }
+
+        /* Same as the decoders do when the data chunk is short. */
+        switch (file->format.encoding) {
+        case MS_ADPCM_CODE:
+            if (MS_ADPCM_CalculateSampleFrames(file, stream->datasize) < 0) {
+                goto failed_stream;
+            }
+            break;
+        case IMA_ADPCM_CODE:
+            if (IMA_ADPCM_CalculateSampleFrames(file, stream->datasize) < 0) {
+                goto failed_stream;
+            }
+            break;
+        default:
+            file->sampleframes = WaveAdjustToFactValue(file, stream->datasize / file->format.blockalign);
+            if (file->sampleframes < 0) {
+                goto failed_stream;
+            }
+            break;
+        }
+    }
+    if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+        stream->mem = src->hidden.mem.base + datachunk.position;
+    }
+
+    switch (file->format.encoding) {
+    case PCM_CODE:
+    case IEEE_FLOAT_CODE:
+        if (file->format.bitspersample == 24) {
+            stream->framesize = (size_t)file->format.channels * 4;
+        } else {
+            /* Returned as is, like SDL_LoadWAV_RW does. */
+            stream->framesize = file->format.blockalign;
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        stream->framesize = (size_t)file->format.channels * 2;
+        break;
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        stream->framesize = (size_t)file->format.channels * 2;
+        if (file->format.encoding == MS_ADPCM_CODE) {
+            stream->blockheadersize = (size_t)file->format.channels * 7;
+            stream->cstate = SDL_calloc(2, sizeof(MS_ADPCM_ChannelState));
+        } else {
+            stream->blockheadersize = (size_t)file->format.channels * 4;
+            stream->cstate = SDL_calloc(file->format.channels, sizeof(Sint8));
+        }
+        stream->blockout = (Sint16 *)SDL_malloc(file->format.samplesperblock * stream->framesize);
+        if (stream->mem == NULL) {
+            stream->blockdata = (Uint8 *)SDL_malloc(file->format.blockalign);
+        }
+        if (stream->cstate == NULL || stream->blockout == NULL || (stream->mem == NULL && stream->blockdata == NULL)) {
+            SDL_OutOfMemory();
+            goto failed_stream;
+        }
+        break;
+    }
+
+    SDL_memcpy(spec, &stream->spec, sizeof(*spec));
+    return stream;
+
+failed_stream:
+    /* src is closed below, not by SDL_WaveStreamClose. */
+    stream->freesrc = 0;
+    SDL_WaveStreamClose(stream);
+failed:
+    if (freesrc) {
+        SDL_RWclose(src);
+    }
+    return NULL;
+}
+
+int
+SDL_WaveStreamRead(SDL_WaveStream *stream, void *buf, int len)
+{
+    size_t frames;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (len < 0) {
+        return SDL_InvalidParamError("len");
+    }
+
+    frames = (size_t)len / stream->framesize;
+    if ((Sint64)frames > stream->file.sampleframes - stream->frame) {
+        frames = (size_t)(stream->file.sampleframes - stream->frame);
+    }
+    if (frames == 0) {
+        return 0;
+    }
+
+    switch (stream->file.format.encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+        return WaveStreamReadADPCM(stream, (Uint8 *)buf, frames);
+    default:
+        return WaveStreamReadPCM(stream, (Uint8 *)buf, frames);
+    }
+}
+
+int
+SDL_WaveStreamSeek(SDL_WaveStream *stream, Sint64 frame)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (frame < 0 || frame > stream->file.sampleframes) {
+        return SDL_SetError("Seek position out of range");
+    }
+
+    /* ADPCM blocks get decoded by the next read. */
+    stream->frame = frame;
+    return 0;
+}
+
+Sint64
+SDL_WaveStreamTell(SDL_WaveStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+    return stream->frame;
+}
+
+Sint64
+SDL_WaveStreamLength(SDL_WaveStream *stream)
+{
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+    return stream->file.sampleframes;
+}
+
+int
+SDL_WaveStreamPut(SDL_WaveStream *stream, SDL_AudioStream *audiostream, int len)
+{
+    /* Big enough for a sample frame of 255 channels with 32-bit samples. */
+    Uint32 buf[1024];
+    int total = 0;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (audiostream == NULL) {
+        return SDL_InvalidParamError("audiostream");
+    } else if (len < 0) {
+        return SDL_InvalidParamError("len");
+    }
+
+    while (total < len) {
+        const int got = SDL_WaveStreamRead(stream, buf, SDL_min(len - total, (int)sizeof(buf)));
+        if (got < 0) {
+            return -1;
+        } else if (got == 0) {
+            break;
+        } else if (SDL_AudioStreamPut(audiostream, buf, got) < 0) {
+            return -1;
+        }
+        total += got;
+    }
+
+    return total;
+}
+
+void
+SDL_WaveStreamClose(SDL_WaveStream *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    }
+    WaveFreeChunkData(&stream->file.chunk);
+    SDL_free(stream->file.decoderdata);
+    SDL_free(stream->cstate);
+    SDL_free(stream->blockdata);
+    SDL_free(stream->blockout);
+    SDL_free(stream);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -46,7 +46,11 @@
 static void
 DISKAUDIO_WaitDevice(_THIS)
 {
-    SDL_Delay(_this->hidden->io_delay);
+    if (_this->hidden->paced) {
+        SDL_AudioWaitNextPeriod(_this, &_this->hidden->deadline);
+    } else {
+        SDL_Delay(_this->hidden->io_delay);
+    }
 }
 
 static void
@@ -143,6 +147,7 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
         _this->hidden->io_delay = SDL_atoi(envr);
     } else {
         _this->hidden->io_delay = ((_this->spec.samples * 1000) / _this->spec.freq);
+        _this->hidden->paced = _this->low_latency;
     }
 
     /* Open the audio device */
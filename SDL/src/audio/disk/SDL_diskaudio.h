@@ -35,6 +35,9 @@ struct SDL_PrivateAudioData
     SDL_RWops *io;
     Uint32 io_delay;
     Uint8 *mixbuf;
+    /* Low-latency mode: pace playback against absolute deadlines. */
+    SDL_bool paced;
+    Uint64 deadline;
 };
 
 #endif /* SDL_diskaudio_h_ */
@@ -855,3 +855,44 @@
 #define SDL_GameControllerHasRumbleTriggers SDL_GameControllerHasRumbleTriggers_REAL
 #define SDL_hid_ble_scan SDL_hid_ble_scan_REAL
 #define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_WaveStreamOpen SDL_WaveStreamOpen_REAL
+#define SDL_WaveStreamRead SDL_WaveStreamRead_REAL
+#define SDL_WaveStreamSeek SDL_WaveStreamSeek_REAL
+#define SDL_WaveStreamTell SDL_WaveStreamTell_REAL
+#define SDL_WaveStreamLength SDL_WaveStreamLength_REAL
+#define SDL_WaveStreamPut SDL_WaveStreamPut_REAL
+#define SDL_WaveStreamClose SDL_WaveStreamClose_REAL
+#define SDL_SetAudioDeviceGain SDL_SetAudioDeviceGain_REAL
+#define SDL_GetAudioDeviceGain SDL_GetAudioDeviceGain_REAL
+#define SDL_DrainEvents SDL_DrainEvents_REAL
+#define SDL_GetHintHandle SDL_GetHintHandle_REAL
+#define SDL_GetHintHandleGeneration SDL_GetHintHandleGeneration_REAL
+#define SDL_GetHintHandleValue SDL_GetHintHandleValue_REAL
+#define SDL_GetHintHandleBoolean SDL_GetHintHandleBoolean_REAL
+#define SDL_GetHintHandleInt SDL_GetHintHandleInt_REAL
+#define SDL_GetHintHandleFloat SDL_GetHintHandleFloat_REAL
+#define SDL_AddTimerNS SDL_AddTimerNS_REAL
+#define SDL_DelayPrecise SDL_DelayPrecise_REAL
+#define SDL_CreateFramePacer SDL_CreateFramePacer_REAL
+#define SDL_FramePacerWait SDL_FramePacerWait_REAL
+#define SDL_GetFramePacerStats SDL_GetFramePacerStats_REAL
+#define SDL_ResetFramePacerStats SDL_ResetFramePacerStats_REAL
+#define SDL_DestroyFramePacer SDL_DestroyFramePacer_REAL
+#define SDL_CreateJobSystem SDL_CreateJobSystem_REAL
+#define SDL_SubmitJob SDL_SubmitJob_REAL
+#define SDL_WaitJob SDL_WaitJob_REAL
+#define SDL_DetachJob SDL_DetachJob_REAL
+#define SDL_ParallelFor SDL_ParallelFor_REAL
+#define SDL_DestroyJobSystem SDL_DestroyJobSystem_REAL
+#define SDL_CreateRWLock SDL_CreateRWLock_REAL
+#define SDL_LockRWLockForReading SDL_LockRWLockForReading_REAL
+#define SDL_LockRWLockForWriting SDL_LockRWLockForWriting_REAL
+#define SDL_TryLockRWLockForReading SDL_TryLockRWLockForReading_REAL
+#define SDL_TryLockRWLockForWriting SDL_TryLockRWLockForWriting_REAL
+#define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
+#define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
+#define SDL_SetErrorCode SDL_SetErrorCode_REAL
+#define SDL_GetErrorCode SDL_GetErrorCode_REAL
+#define SDL_SetSurfacePremultiplied SDL_SetSurfacePremultiplied_REAL
+#define SDL_PremultiplySurfaceAlpha SDL_PremultiplySurfaceAlpha_REAL
@@ -924,3 +924,44 @@ SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumble,(SDL_GameController *a),(a)
 SDL_DYNAPI_PROC(SDL_bool,SDL_GameControllerHasRumbleTriggers,(SDL_GameController *a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_hid_ble_scan,(SDL_bool a),(a),)
 SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_WaveStream*,SDL_WaveStreamOpen,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WaveStreamRead,(SDL_WaveStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WaveStreamSeek,(SDL_WaveStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WaveStreamTell,(SDL_WaveStream *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WaveStreamLength,(SDL_WaveStream *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_WaveStreamPut,(SDL_WaveStream *a, SDL_AudioStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_WaveStreamClose,(SDL_WaveStream *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_SetAudioDeviceGain,(SDL_AudioDeviceID a, float b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceGain,(SDL_AudioDeviceID a, float *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_DrainEvents,(SDL_Event *a, int b, Uint32 c, Uint32 d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_HintHandle*,SDL_GetHintHandle,(const char *a),(a),return)
+SDL_DYNAPI_PROC(Uint32,SDL_GetHintHandleGeneration,(SDL_HintHandle *a),(a),return)
+SDL_DYNAPI_PROC(const char*,SDL_GetHintHandleValue,(SDL_HintHandle *a),(a),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_GetHintHandleBoolean,(SDL_HintHandle *a, SDL_bool b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetHintHandleInt,(SDL_HintHandle *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(float,SDL_GetHintHandleFloat,(SDL_HintHandle *a, float b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_TimerID,SDL_AddTimerNS,(Uint64 a, SDL_NSTimerCallback b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DelayPrecise,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(SDL_FramePacer*,SDL_CreateFramePacer,(Uint64 a),(a),return)
+SDL_DYNAPI_PROC(Uint64,SDL_FramePacerWait,(SDL_FramePacer *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetFramePacerStats,(SDL_FramePacer *a, SDL_FramePacerStats *b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_ResetFramePacerStats,(SDL_FramePacer *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_DestroyFramePacer,(SDL_FramePacer *a),(a),)
+SDL_DYNAPI_PROC(SDL_JobSystem*,SDL_CreateJobSystem,(int a),(a),return)
+SDL_DYNAPI_PROC(SDL_Job*,SDL_SubmitJob,(SDL_JobSystem *a, SDL_JobFunction b, void *c, SDL_Job *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_WaitJob,(SDL_Job *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_DetachJob,(SDL_Job *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_ParallelFor,(SDL_JobSystem *a, int b, int c, int d, SDL_ParallelForFunction e, void *f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyJobSystem,(SDL_JobSystem *a),(a),)
+SDL_DYNAPI_PROC(SDL_rwlock*,SDL_CreateRWLock,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_LockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForReading,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_rwlock *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_rwlock *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_SetErrorCode,(SDL_errorcode a),(a),return)
+SDL_DYNAPI_PROC(SDL_errorcode,SDL_GetErrorCode,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_SetSurfacePremultiplied,(SDL_Surface *a, SDL_bool b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PremultiplySurfaceAlpha,(SDL_Surface *a),(a),return)
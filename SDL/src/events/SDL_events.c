@@ -44,6 +44,12 @@
 /* An arbitrary limit so we don't have unbounded growth */
 #define SDL_MAX_QUEUED_EVENTS   65535
 
+/* Number of events the lock-free ring holds before pushes fall back to the list, must be a power of two */
+#define SDL_EVENT_RING_SIZE     1024
+
+/* Number of list entries allocated at once */
+#define SDL_EVENT_SLAB_SIZE     256
+
 /* Determines how often we wake to call SDL_PumpEvents() in SDL_WaitEventTimeout_Device() */
 #define PERIODIC_POLL_INTERVAL_MS 3000
 
@@ -72,11 +78,21 @@ static Uint32 SDL_userevents = SDL_USEREVENT;
 typedef struct _SDL_EventEntry
 {
     SDL_Event event;
-    SDL_SysWMmsg msg;
     struct _SDL_EventEntry *prev;
     struct _SDL_EventEntry *next;
 } SDL_EventEntry;
 
+/* List entries are carved out of slabs. Whenever the list empties, all but
+   one slab go back to the system, so a burst of events doesn't keep its
+   memory for the rest of the program. */
+typedef struct _SDL_EventSlab
+{
+    struct _SDL_EventSlab *next;
+    SDL_EventEntry entries[SDL_EVENT_SLAB_SIZE];
+} SDL_EventSlab;
+
+/* SysWM messages live in their own pool, and a queued SDL_SYSWMEVENT's
+   event.syswm.msg points at one of these. msg must be the first member. */
 typedef struct _SDL_SysWMEntry
 {
     SDL_SysWMmsg msg;
@@ -87,14 +103,48 @@ static struct
 {
     SDL_mutex *lock;
     SDL_atomic_t active;
+    SDL_atomic_t adding;     /* threads adding events without the lock */
     SDL_atomic_t count;
-    int max_events_seen;
+    SDL_atomic_t max_events_seen;
     SDL_EventEntry *head;
     SDL_EventEntry *tail;
     SDL_EventEntry *free;
+    SDL_EventSlab *slabs;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
-} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
+    size_t memory;       /* bytes allocated for slabs and SysWM messages */
+    size_t max_memory;
+} SDL_EventQ = { NULL, { 1 }, { 0 }, { 0 }, { 0 }, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0 };
+
+/* Events are pushed onto a bounded lock-free ring, so threads adding events
+   don't contend on SDL_EventQ.lock. Whoever holds the lock is the single
+   consumer: it hands events out straight from the ring while the list above
+   is empty, and otherwise moves them to the end of the list first. SysWM
+   events (which carry a message that has to be copied) and pushes that
+   find the ring full go through the lock and onto the list, after moving
+   the ring's events there, so every event on the list is older than every
+   event on the ring.
+
+   Each slot's sequence number says whose turn it is: a slot is free for
+   the producer at position 'pos' when it equals pos, and holds a finished
+   event for the consumer when it equals pos + 1. */
+typedef struct
+{
+    SDL_atomic_t sequence;
+    SDL_Event event;
+} SDL_EventSlot;
+
+static struct
+{
+    SDL_atomic_t ready;
+    SDL_atomic_t enqueue_pos;
+    Uint8 pad[SDL_CACHELINE_SIZE];
+    Uint32 dequeue_pos;  /* protected by SDL_EventQ.lock */
+    SDL_EventSlot slots[SDL_EVENT_RING_SIZE];
+} SDL_EventRing;
+
+static void SDL_ResetEventRing(void);
+static void SDL_DrainEventRing(void);
 
 
 #if !SDL_JOYSTICK_DISABLED
@@ -159,6 +209,14 @@ SDL_EventLoggingChanged(void *userdata, const char *name, const char *oldValue,
     SDL_DoEventLogging = (hint && *hint) ? SDL_clamp(SDL_atoi(hint), 0, 2) : 0;
 }
 
+static SDL_bool SDL_DoEventCoalescing = SDL_FALSE;
+
+static void SDLCALL
+SDL_EventCoalesceChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_DoEventCoalescing = SDL_GetStringBoolean(hint, SDL_FALSE);
+}
+
 static void
 SDL_LogEvent(const SDL_Event *event)
 {
@@ -438,29 +496,39 @@ SDL_StopEventLoop(void)
     const char *report = SDL_GetHint("SDL_EVENT_QUEUE_STATISTICS");
     int i;
     SDL_EventEntry *entry;
+    SDL_EventSlab *slab;
     SDL_SysWMEntry *wmmsg;
 
+    /* Turn away new events, and wait for threads that got in before that
+       to finish, so nothing lands on the ring after it's been cleaned out. */
+    SDL_AtomicSet(&SDL_EventQ.active, 0);
+    while (SDL_AtomicGet(&SDL_EventQ.adding) > 0) {
+        SDL_Delay(0);
+    }
+
     if (SDL_EventQ.lock) {
         SDL_LockMutex(SDL_EventQ.lock);
     }
 
-    SDL_AtomicSet(&SDL_EventQ.active, 0);
-
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
-                SDL_EventQ.max_events_seen);
+                SDL_AtomicGet(&SDL_EventQ.max_events_seen));
+        SDL_Log("SDL EVENT QUEUE: Maximum memory used: %u bytes (plus %u for the ring)\n",
+                (unsigned int) SDL_EventQ.max_memory, (unsigned int) sizeof(SDL_EventRing));
     }
 
     /* Clean out EventQ */
-    for (entry = SDL_EventQ.head; entry; ) {
-        SDL_EventEntry *next = entry->next;
-        SDL_free(entry);
-        entry = next;
+    SDL_DrainEventRing();
+    SDL_ResetEventRing();
+    for (entry = SDL_EventQ.head; entry; entry = entry->next) {
+        if (entry->event.type == SDL_SYSWMEVENT && entry->event.syswm.msg) {
+            SDL_free(entry->event.syswm.msg);
+        }
     }
-    for (entry = SDL_EventQ.free; entry; ) {
-        SDL_EventEntry *next = entry->next;
-        SDL_free(entry);
-        entry = next;
+    for (slab = SDL_EventQ.slabs; slab; ) {
+        SDL_EventSlab *next = slab->next;
+        SDL_free(slab);
+        slab = next;
     }
     for (wmmsg = SDL_EventQ.wmmsg_used; wmmsg; ) {
         SDL_SysWMEntry *next = wmmsg->next;
@@ -474,12 +542,15 @@ SDL_StopEventLoop(void)
     }
 
     SDL_AtomicSet(&SDL_EventQ.count, 0);
-    SDL_EventQ.max_events_seen = 0;
+    SDL_AtomicSet(&SDL_EventQ.max_events_seen, 0);
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
     SDL_EventQ.free = NULL;
+    SDL_EventQ.slabs = NULL;
     SDL_EventQ.wmmsg_used = NULL;
     SDL_EventQ.wmmsg_free = NULL;
+    SDL_EventQ.memory = 0;
+    SDL_EventQ.max_memory = 0;
     SDL_AtomicSet(&SDL_sentinel_pending, 0);
 
     /* Clear disabled event state */
@@ -542,45 +613,121 @@ SDL_StartEventLoop(void)
     SDL_EventState(SDL_DROPTEXT, SDL_DISABLE);
 #endif
 
+    /* The ring is set up the first time through, while it can't have
+       anything on it yet, and SDL_StopEventLoop() resets it after that;
+       until then, events go on the list. */
+    if (!SDL_AtomicGet(&SDL_EventRing.ready)) {
+        if (SDL_EventQ.lock) {
+            SDL_LockMutex(SDL_EventQ.lock);
+        }
+        SDL_ResetEventRing();
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+
     SDL_AtomicSet(&SDL_EventQ.active, 1);
 
     return 0;
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
-static int
-SDL_AddEvent(SDL_Event * event)
+/* Keep track of the queue's memory use -- called with the queue locked */
+static void
+SDL_AddEventMemory(size_t size)
 {
-    SDL_EventEntry *entry;
-    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
+    SDL_EventQ.memory += size;
+    if (SDL_EventQ.memory > SDL_EventQ.max_memory) {
+        SDL_EventQ.max_memory = SDL_EventQ.memory;
+    }
+}
 
-    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
-        SDL_SetError("Event queue is full (%d events)", initial_count);
-        return 0;
+/* Get a copy of a SysWM message from the pool -- called with the queue locked */
+static SDL_SysWMEntry *
+SDL_AllocSysWMEntry(const SDL_SysWMmsg *msg)
+{
+    SDL_SysWMEntry *wmmsg;
+
+    if (SDL_EventQ.wmmsg_free) {
+        wmmsg = SDL_EventQ.wmmsg_free;
+        SDL_EventQ.wmmsg_free = wmmsg->next;
+    } else {
+        wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
+        if (!wmmsg) {
+            return NULL;
+        }
+        SDL_AddEventMemory(sizeof(*wmmsg));
     }
+    wmmsg->msg = *msg;
+    wmmsg->next = NULL;
+    return wmmsg;
+}
 
-    if (SDL_EventQ.free == NULL) {
-        entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
-        if (!entry) {
-            return 0;
+/* Free all slabs but one, once every entry is free -- called with the queue locked */
+static void
+SDL_TrimEventSlabs(void)
+{
+    SDL_EventSlab *slab = SDL_EventQ.slabs;
+    int i;
+
+    if (!slab || !slab->next) {
+        return;
+    }
+
+    SDL_assert(!SDL_EventQ.head);
+    while (slab->next) {
+        SDL_EventSlab *next = slab->next->next;
+        SDL_free(slab->next);
+        SDL_EventQ.memory -= sizeof(*slab);
+        slab->next = next;
+    }
+
+    SDL_EventQ.free = NULL;
+    for (i = SDL_EVENT_SLAB_SIZE - 1; i >= 0; --i) {
+        slab->entries[i].next = SDL_EventQ.free;
+        SDL_EventQ.free = &slab->entries[i];
+    }
+}
+
+/* Add an event to the end of the list -- called with the queue locked */
+static SDL_bool
+SDL_LinkEvent(const SDL_Event * event)
+{
+    SDL_EventEntry *entry;
+    SDL_SysWMEntry *wmmsg = NULL;
+
+    if (event->type == SDL_SYSWMEVENT && event->syswm.msg) {
+        wmmsg = SDL_AllocSysWMEntry(event->syswm.msg);
+        if (!wmmsg) {
+            return SDL_FALSE;
         }
-    } else {
-        entry = SDL_EventQ.free;
-        SDL_EventQ.free = entry->next;
     }
 
-    if (SDL_DoEventLogging) {
-        SDL_LogEvent(event);
+    if (SDL_EventQ.free == NULL) {
+        SDL_EventSlab *slab = (SDL_EventSlab *)SDL_malloc(sizeof(*slab));
+        int i;
+
+        if (!slab) {
+            if (wmmsg) {
+                wmmsg->next = SDL_EventQ.wmmsg_free;
+                SDL_EventQ.wmmsg_free = wmmsg;
+            }
+            return SDL_FALSE;
+        }
+        SDL_AddEventMemory(sizeof(*slab));
+        slab->next = SDL_EventQ.slabs;
+        SDL_EventQ.slabs = slab;
+        for (i = SDL_EVENT_SLAB_SIZE - 1; i >= 0; --i) {
+            slab->entries[i].next = SDL_EventQ.free;
+            SDL_EventQ.free = &slab->entries[i];
+        }
     }
+    entry = SDL_EventQ.free;
+    SDL_EventQ.free = entry->next;
 
     entry->event = *event;
-    if (event->type == SDL_POLLSENTINEL) {
-        SDL_AtomicAdd(&SDL_sentinel_pending, 1);
-    } else if (event->type == SDL_SYSWMEVENT) {
-        entry->msg = *event->syswm.msg;
-        entry->event.syswm.msg = &entry->msg;
+    if (wmmsg) {
+        entry->event.syswm.msg = &wmmsg->msg;
     }
 
     if (SDL_EventQ.tail) {
@@ -596,14 +743,280 @@ SDL_AddEvent(SDL_Event * event)
         entry->next = NULL;
     }
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
+    return SDL_TRUE;
+}
+
+/* Returns SDL_TRUE for the high-rate events SDL_HINT_EVENT_COALESCE can merge */
+static SDL_bool
+SDL_IsCoalescableEvent(const SDL_Event * event)
+{
+    switch (event->type) {
+    case SDL_MOUSEMOTION:
+    case SDL_FINGERMOTION:
+    case SDL_JOYAXISMOTION:
+    case SDL_JOYBALLMOTION:
+    case SDL_CONTROLLERAXISMOTION:
+    case SDL_CONTROLLERSENSORUPDATE:
+    case SDL_SENSORUPDATE:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
     }
+}
 
+/* Merge an event into the newest queued one if they're motion of the same thing -- called with the queue locked */
+static SDL_bool
+SDL_CoalesceEvent(const SDL_Event * event)
+{
+    SDL_Event *last;
+
+    if (!SDL_EventQ.tail) {
+        return SDL_FALSE;
+    }
+
+    last = &SDL_EventQ.tail->event;
+    if (last->type != event->type) {
+        return SDL_FALSE;
+    }
+
+    switch (event->type) {
+    case SDL_MOUSEMOTION:
+        if (last->motion.windowID != event->motion.windowID ||
+            last->motion.which != event->motion.which) {
+            return SDL_FALSE;
+        }
+        last->motion.state = event->motion.state;
+        last->motion.x = event->motion.x;
+        last->motion.y = event->motion.y;
+        last->motion.xrel += event->motion.xrel;
+        last->motion.yrel += event->motion.yrel;
+        break;
+    case SDL_FINGERMOTION:
+        if (last->tfinger.touchId != event->tfinger.touchId ||
+            last->tfinger.fingerId != event->tfinger.fingerId ||
+            last->tfinger.windowID != event->tfinger.windowID) {
+            return SDL_FALSE;
+        }
+        last->tfinger.x = event->tfinger.x;
+        last->tfinger.y = event->tfinger.y;
+        last->tfinger.dx += event->tfinger.dx;
+        last->tfinger.dy += event->tfinger.dy;
+        last->tfinger.pressure = event->tfinger.pressure;
+        break;
+    case SDL_JOYAXISMOTION:
+        if (last->jaxis.which != event->jaxis.which ||
+            last->jaxis.axis != event->jaxis.axis) {
+            return SDL_FALSE;
+        }
+        last->jaxis.value = event->jaxis.value;
+        break;
+    case SDL_JOYBALLMOTION:
+        if (last->jball.which != event->jball.which ||
+            last->jball.ball != event->jball.ball) {
+            return SDL_FALSE;
+        }
+        last->jball.xrel = (Sint16) SDL_clamp(last->jball.xrel + event->jball.xrel, SDL_MIN_SINT16, SDL_MAX_SINT16);
+        last->jball.yrel = (Sint16) SDL_clamp(last->jball.yrel + event->jball.yrel, SDL_MIN_SINT16, SDL_MAX_SINT16);
+        break;
+    case SDL_CONTROLLERAXISMOTION:
+        if (last->caxis.which != event->caxis.which ||
+            last->caxis.axis != event->caxis.axis) {
+            return SDL_FALSE;
+        }
+        last->caxis.value = event->caxis.value;
+        break;
+    case SDL_CONTROLLERSENSORUPDATE:
+        if (last->csensor.which != event->csensor.which ||
+            last->csensor.sensor != event->csensor.sensor) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(last->csensor.data, event->csensor.data, sizeof(last->csensor.data));
+        break;
+    case SDL_SENSORUPDATE:
+        if (last->sensor.which != event->sensor.which) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(last->sensor.data, event->sensor.data, sizeof(last->sensor.data));
+        break;
+    default:
+        return SDL_FALSE;
+    }
+
+    last->common.timestamp = event->common.timestamp;
+    return SDL_TRUE;
+}
+
+/* Forget about an event that was counted but never made it onto the queue */
+static void
+SDL_UncountEvent(const SDL_Event * event)
+{
+    if (event->type == SDL_POLLSENTINEL) {
+        SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+    }
+    SDL_AtomicAdd(&SDL_EventQ.count, -1);
+}
+
+/* Try to add an event to the ring, returns 0 if it's full */
+static int
+SDL_PushEventRing(const SDL_Event * event)
+{
+    SDL_EventSlot *slot;
+    Uint32 pos = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+
+    for (;;) {
+        int diff;
+
+        slot = &SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)];
+        diff = (int) ((Uint32) SDL_AtomicGet(&slot->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&SDL_EventRing.enqueue_pos, (int) pos, (int) (pos + 1))) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;  /* the consumer hasn't gotten to this slot yet. */
+        }
+        pos = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    }
+
+    slot->event = *event;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&slot->sequence, (int) (pos + 1));
     return 1;
 }
 
+/* Get the oldest event on the ring, or NULL if there isn't a finished one -- called with the queue locked */
+static SDL_EventSlot *
+SDL_GetEventRingHead(void)
+{
+    SDL_EventSlot *slot = &SDL_EventRing.slots[SDL_EventRing.dequeue_pos & (SDL_EVENT_RING_SIZE - 1)];
+
+    if ((Uint32) SDL_AtomicGet(&slot->sequence) != (SDL_EventRing.dequeue_pos + 1)) {
+        return NULL;
+    }
+    SDL_MemoryBarrierAcquire();
+    return slot;
+}
+
+/* Hand the oldest slot on the ring back to the producers -- called with the queue locked */
+static void
+SDL_ReleaseEventRingHead(SDL_EventSlot *slot)
+{
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&slot->sequence, (int) (SDL_EventRing.dequeue_pos + SDL_EVENT_RING_SIZE));
+    SDL_EventRing.dequeue_pos++;
+}
+
+/* Empty the ring and hand all of its slots to the producers, starting over
+   at position 0 -- called with the queue locked and nobody adding events */
+static void
+SDL_ResetEventRing(void)
+{
+    int i;
+
+    for (i = 0; i < SDL_EVENT_RING_SIZE; ++i) {
+        SDL_AtomicSet(&SDL_EventRing.slots[i].sequence, i);
+    }
+    SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+    SDL_EventRing.dequeue_pos = 0;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&SDL_EventRing.ready, 1);
+}
+
+/* Get the oldest event on the ring, which a producer has already claimed
+   but might still be copying in -- called with the queue locked */
+static SDL_EventSlot *
+SDL_WaitEventRingHead(void)
+{
+    SDL_EventSlot *slot;
+    int spins = 0;
+
+    /* Wait for the event, so later ones can't jump ahead of it. */
+    while ((slot = SDL_GetEventRingHead()) == NULL) {
+        if (++spins > 100) {
+            SDL_Delay(0);
+        }
+    }
+    return slot;
+}
+
+/* Move every event pushed so far from the ring to the end of the list -- called with the queue locked */
+static void
+SDL_DrainEventRing(void)
+{
+    const Uint32 end = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+
+    if (!SDL_AtomicGet(&SDL_EventRing.ready)) {
+        return;
+    }
+
+    while (SDL_EventRing.dequeue_pos != end) {
+        SDL_EventSlot *slot = SDL_WaitEventRingHead();
+        if (!SDL_LinkEvent(&slot->event)) {
+            SDL_UncountEvent(&slot->event);
+        }
+        SDL_ReleaseEventRingHead(slot);
+    }
+}
+
+/* Add an event to the event queue */
+static int
+SDL_AddEvent(SDL_Event * event)
+{
+    const int initial_count = SDL_AtomicAdd(&SDL_EventQ.count, 1);
+    const SDL_bool coalesce = SDL_DoEventCoalescing && SDL_IsCoalescableEvent(event);
+    int max_events_seen;
+    int added = 0;
+
+    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        SDL_SetError("Event queue is full (%d events)", initial_count);
+        return 0;
+    }
+
+    max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    while (initial_count + 1 > max_events_seen) {
+        if (SDL_AtomicCAS(&SDL_EventQ.max_events_seen, max_events_seen, initial_count + 1)) {
+            break;
+        }
+        max_events_seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    }
+
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
+
+    if (event->type == SDL_POLLSENTINEL) {
+        SDL_AtomicAdd(&SDL_sentinel_pending, 1);
+    }
+
+    if (event->type != SDL_SYSWMEVENT && !coalesce && SDL_AtomicGet(&SDL_EventRing.ready)) {
+        added = SDL_PushEventRing(event);
+    }
+
+    if (!added) {
+        /* SysWM events, events that may be merged into the newest one and
+           overflow from a full ring go on the list, behind everything on the ring. */
+        if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+            SDL_DrainEventRing();
+            if (coalesce && SDL_CoalesceEvent(event)) {
+                /* It's part of an event that's already counted */
+                SDL_AtomicAdd(&SDL_EventQ.count, -1);
+                added = 1;
+            } else {
+                added = SDL_LinkEvent(event) ? 1 : 0;
+            }
+            if (SDL_EventQ.lock) {
+                SDL_UnlockMutex(SDL_EventQ.lock);
+            }
+        }
+        if (!added) {
+            SDL_UncountEvent(event);
+        }
+    }
+
+    return added;
+}
+
 /* Remove an event from the queue -- called with the queue locked */
 static void
 SDL_CutEvent(SDL_EventEntry *entry)
@@ -626,12 +1039,20 @@ SDL_CutEvent(SDL_EventEntry *entry)
 
     if (entry->event.type == SDL_POLLSENTINEL) {
         SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+    } else if (entry->event.type == SDL_SYSWMEVENT && entry->event.syswm.msg) {
+        SDL_SysWMEntry *wmmsg = (SDL_SysWMEntry *)entry->event.syswm.msg;
+        wmmsg->next = SDL_EventQ.wmmsg_free;
+        SDL_EventQ.wmmsg_free = wmmsg;
     }
 
     entry->next = SDL_EventQ.free;
     SDL_EventQ.free = entry;
     SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
     SDL_AtomicAdd(&SDL_EventQ.count, -1);
+
+    if (!SDL_EventQ.head) {
+        SDL_TrimEventSlabs();
+    }
 }
 
 static int
@@ -655,6 +1076,22 @@ SDL_SendWakeupEvent()
     return 0;
 }
 
+/* Clean out any used wmmsg data -- called with the queue locked
+   FIXME: Do we want to retain the data for some period of time?
+ */
+static void
+SDL_RecycleSysWMEntries(void)
+{
+    SDL_SysWMEntry *wmmsg, *wmmsg_next;
+
+    for (wmmsg = SDL_EventQ.wmmsg_used; wmmsg; wmmsg = wmmsg_next) {
+        wmmsg_next = wmmsg->next;
+        wmmsg->next = SDL_EventQ.wmmsg_free;
+        SDL_EventQ.wmmsg_free = wmmsg;
+    }
+    SDL_EventQ.wmmsg_used = NULL;
+}
+
 /* Lock the event queue, take a peep at it, and unlock it */
 static int
 SDL_PeepEventsInternal(SDL_Event * events, int numevents, SDL_eventaction action,
@@ -670,66 +1107,93 @@ SDL_PeepEventsInternal(SDL_Event * events, int numevents, SDL_eventaction action
         }
         return (-1);
     }
-    /* Lock the event queue */
     used = 0;
-    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
-        if (action == SDL_ADDEVENT) {
+    if (action == SDL_ADDEVENT) {
+        /* Adding events mostly doesn't need the lock. SDL_StopEventLoop()
+           waits for us instead, once it has turned the queue inactive. */
+        SDL_AtomicAdd(&SDL_EventQ.adding, 1);
+        if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+            used = -1;
+        } else {
             for (i = 0; i < numevents; ++i) {
                 used += SDL_AddEvent(&events[i]);
             }
-        } else {
-            SDL_EventEntry *entry, *next;
-            SDL_SysWMEntry *wmmsg, *wmmsg_next;
-            Uint32 type;
-
-            if (action == SDL_GETEVENT) {
-                /* Clean out any used wmmsg data
-                   FIXME: Do we want to retain the data for some period of time?
-                 */
-                for (wmmsg = SDL_EventQ.wmmsg_used; wmmsg; wmmsg = wmmsg_next) {
-                    wmmsg_next = wmmsg->next;
-                    wmmsg->next = SDL_EventQ.wmmsg_free;
-                    SDL_EventQ.wmmsg_free = wmmsg;
+        }
+        SDL_AtomicAdd(&SDL_EventQ.adding, -1);
+    } else if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        /* Lock the event queue */
+        SDL_EventEntry *entry, *next;
+        SDL_EventSlot *slot;
+        SDL_SysWMEntry *wmmsg;
+        Uint32 type;
+
+        if (action == SDL_GETEVENT) {
+            SDL_RecycleSysWMEntries();
+
+            /* With nothing older on the list, events can come straight off the ring */
+            while (events && !SDL_EventQ.head && used < numevents && (slot = SDL_GetEventRingHead()) != NULL) {
+                type = slot->event.type;
+                if (type < minType || maxType < type) {
+                    break;
+                }
+                events[used] = slot->event;
+                SDL_ReleaseEventRingHead(slot);
+                SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
+                SDL_AtomicAdd(&SDL_EventQ.count, -1);
+                if (type == SDL_POLLSENTINEL) {
+                    SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+                    if (!include_sentinel || SDL_AtomicGet(&SDL_sentinel_pending) > 0) {
+                        /* Skip it, we don't want to include it or there's another one pending */
+                        continue;
+                    }
                 }
-                SDL_EventQ.wmmsg_used = NULL;
+                ++used;
             }
+        }
 
-            for (entry = SDL_EventQ.head; entry && (!events || used < numevents); entry = next) {
-                next = entry->next;
-                type = entry->event.type;
-                if (minType <= type && type <= maxType) {
-                    if (events) {
-                        events[used] = entry->event;
-                        if (entry->event.type == SDL_SYSWMEVENT) {
-                            /* We need to copy the wmmsg somewhere safe.
-                               For now we'll guarantee it's valid at least until
-                               the next call to SDL_PeepEvents()
-                             */
-                            if (SDL_EventQ.wmmsg_free) {
-                                wmmsg = SDL_EventQ.wmmsg_free;
-                                SDL_EventQ.wmmsg_free = wmmsg->next;
-                            } else {
-                                wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
-                            }
-                            wmmsg->msg = *entry->event.syswm.msg;
+        if (!events || used < numevents) {
+            SDL_DrainEventRing();
+        }
+
+        for (entry = SDL_EventQ.head; entry && (!events || used < numevents); entry = next) {
+            next = entry->next;
+            type = entry->event.type;
+            if (minType <= type && type <= maxType) {
+                if (events) {
+                    events[used] = entry->event;
+                    if (entry->event.type == SDL_SYSWMEVENT && entry->event.syswm.msg) {
+                        /* The wmmsg has to stay somewhere safe.
+                           For now we'll guarantee it's valid at least until
+                           the next call to SDL_PeepEvents(). A removed event
+                           hands over its own copy, a peeked one gets a new one.
+                         */
+                        if (action == SDL_GETEVENT) {
+                            wmmsg = (SDL_SysWMEntry *)entry->event.syswm.msg;
+                            entry->event.syswm.msg = NULL;
+                        } else {
+                            wmmsg = SDL_AllocSysWMEntry(entry->event.syswm.msg);
+                        }
+                        if (wmmsg) {
                             wmmsg->next = SDL_EventQ.wmmsg_used;
                             SDL_EventQ.wmmsg_used = wmmsg;
                             events[used].syswm.msg = &wmmsg->msg;
+                        } else {
+                            events[used].syswm.msg = NULL;
                         }
+                    }
 
-                        if (action == SDL_GETEVENT) {
-                            SDL_CutEvent(entry);
-                        }
+                    if (action == SDL_GETEVENT) {
+                        SDL_CutEvent(entry);
                     }
-                    if (type == SDL_POLLSENTINEL) {
-                        /* Special handling for the sentinel event */
-                        if (!include_sentinel || SDL_AtomicGet(&SDL_sentinel_pending) > 0) {
-                            /* Skip it, we don't want to include it or there's another one pending */
-                            continue;
-                        }
+                }
+                if (type == SDL_POLLSENTINEL) {
+                    /* Special handling for the sentinel event */
+                    if (!include_sentinel || SDL_AtomicGet(&SDL_sentinel_pending) > 0) {
+                        /* Skip it, we don't want to include it or there's another one pending */
+                        continue;
                     }
-                    ++used;
                 }
+                ++used;
             }
         }
         if (SDL_EventQ.lock) {
@@ -794,6 +1258,7 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
         Uint32 type;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             type = entry->event.type;
@@ -807,6 +1272,84 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     }
 }
 
+int
+SDL_DrainEvents(SDL_Event * events, int maxevents, Uint32 minType, Uint32 maxType)
+{
+    SDL_EventEntry *entry, *next;
+    SDL_SysWMEntry *wmmsg;
+    Uint32 type;
+    int used = 0;
+
+    if (!events) {
+        return SDL_InvalidParamError("events");
+    }
+    if (maxevents <= 0) {
+        return 0;
+    }
+
+    SDL_PumpEvents();
+
+    if (!SDL_AtomicGet(&SDL_EventQ.active)) {
+        return SDL_SetError("The event system has been shut down");
+    }
+    if (SDL_EventQ.lock && SDL_LockMutex(SDL_EventQ.lock) < 0) {
+        return SDL_SetError("Couldn't lock event queue");
+    }
+
+    SDL_RecycleSysWMEntries();
+
+    /* The list holds the oldest events, so they come first */
+    for (entry = SDL_EventQ.head; entry && used < maxevents; entry = next) {
+        next = entry->next;
+        type = entry->event.type;
+        if (type < minType || maxType < type) {
+            continue;
+        }
+        if (type != SDL_POLLSENTINEL) {
+            events[used] = entry->event;
+            if (type == SDL_SYSWMEVENT && entry->event.syswm.msg) {
+                /* Hand over the event's own copy of the message */
+                wmmsg = (SDL_SysWMEntry *)entry->event.syswm.msg;
+                entry->event.syswm.msg = NULL;
+                wmmsg->next = SDL_EventQ.wmmsg_used;
+                SDL_EventQ.wmmsg_used = wmmsg;
+            }
+            ++used;
+        }
+        SDL_CutEvent(entry);
+    }
+
+    /* Then take everything pushed so far off the ring in one go: matching
+       events go straight to the caller, the rest to the end of the list. */
+    if (SDL_AtomicGet(&SDL_EventRing.ready)) {
+        const Uint32 end = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+
+        while (used < maxevents && SDL_EventRing.dequeue_pos != end) {
+            SDL_EventSlot *slot = SDL_WaitEventRingHead();
+            type = slot->event.type;
+            if (type < minType || maxType < type) {
+                if (!SDL_LinkEvent(&slot->event)) {
+                    SDL_UncountEvent(&slot->event);
+                }
+            } else {
+                if (type == SDL_POLLSENTINEL) {
+                    SDL_AtomicAdd(&SDL_sentinel_pending, -1);
+                } else {
+                    events[used++] = slot->event;
+                }
+                SDL_assert(SDL_AtomicGet(&SDL_EventQ.count) > 0);
+                SDL_AtomicAdd(&SDL_EventQ.count, -1);
+            }
+            SDL_ReleaseEventRingHead(slot);
+        }
+    }
+
+    if (SDL_EventQ.lock) {
+        SDL_UnlockMutex(SDL_EventQ.lock);
+    }
+    return used;
+}
+
 /* Run the system dependent event loops */
 static void
 SDL_PumpEventsInternal(SDL_bool push_sentinel)
@@ -1217,6 +1760,7 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             if (!filter(userdata, &entry->event)) {
@@ -1356,8 +1900,10 @@ SDL_EventsInit(void)
     SDL_AddHintCallback(SDL_HINT_AUTO_UPDATE_SENSORS, SDL_AutoUpdateSensorsChanged, NULL);
 #endif
     SDL_AddHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_AddHintCallback(SDL_HINT_EVENT_COALESCE, SDL_EventCoalesceChanged, NULL);
     SDL_AddHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
     if (SDL_StartEventLoop() < 0) {
+        SDL_DelHintCallback(SDL_HINT_EVENT_COALESCE, SDL_EventCoalesceChanged, NULL);
         SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
         return -1;
     }
@@ -1373,6 +1919,7 @@ SDL_EventsQuit(void)
     SDL_QuitQuit();
     SDL_StopEventLoop();
     SDL_DelHintCallback(SDL_HINT_POLL_SENTINEL, SDL_PollSentinelChanged, NULL);
+    SDL_DelHintCallback(SDL_HINT_EVENT_COALESCE, SDL_EventCoalesceChanged, NULL);
     SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
 #if !SDL_JOYSTICK_DISABLED
     SDL_DelHintCallback(SDL_HINT_AUTO_UPDATE_JOYSTICKS, SDL_AutoUpdateJoysticksChanged, NULL);
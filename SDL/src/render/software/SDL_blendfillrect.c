@@ -213,6 +213,151 @@ SDL_BlendFillRect_RGBA(SDL_Surface * dst, const SDL_Rect * rect,
     }
 }
 
+#if defined(__SSE2__)
+/* For 32-bit formats with one byte per channel, every blend mode comes down to
+     c = min(c * mul1 / 255 + c * mul2 / 255 + add, 255)
+   on each byte of the destination, which vectorizes nicely. */
+typedef struct
+{
+    Uint8 mul1[4];
+    Uint8 mul2[4];
+    Uint8 add[4];
+    Uint32 mask;
+} SDL_BlendFillInfo;
+
+static int
+SDL_ByteIndex8888(Uint32 mask)
+{
+    switch (mask) {
+    case 0x000000FF:
+        return 0;
+    case 0x0000FF00:
+        return 1;
+    case 0x00FF0000:
+        return 2;
+    case 0xFF000000:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+static SDL_bool
+SDL_SetupBlendFill8888(const SDL_PixelFormat *fmt, SDL_BlendMode blendMode,
+                       Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendFillInfo *info)
+{
+    const Uint8 color[4] = { r, g, b, a };
+    const Uint8 inva = 0xff - a;
+    int channels[4];
+    int i;
+
+    if (fmt->BytesPerPixel != 4) {
+        return SDL_FALSE;
+    }
+    channels[0] = SDL_ByteIndex8888(fmt->Rmask);
+    channels[1] = SDL_ByteIndex8888(fmt->Gmask);
+    channels[2] = SDL_ByteIndex8888(fmt->Bmask);
+    channels[3] = fmt->Amask ? SDL_ByteIndex8888(fmt->Amask) : -1;
+    if (channels[0] < 0 || channels[1] < 0 || channels[2] < 0 || (fmt->Amask && channels[3] < 0)) {
+        return SDL_FALSE;
+    }
+
+    /* Bytes that aren't part of any channel end up as 0, like in DRAW_SETPIXEL_* */
+    SDL_zerop(info);
+    info->mask = fmt->Rmask | fmt->Gmask | fmt->Bmask | fmt->Amask;
+    for (i = 0; i < 4; ++i) {
+        const int byte = channels[i];
+        const SDL_bool alpha = (i == 3);
+
+        if (byte < 0) {
+            continue;
+        }
+        switch (blendMode) {
+        case SDL_BLENDMODE_BLEND:
+            info->mul1[byte] = inva;
+            info->add[byte] = color[i];
+            break;
+        case SDL_BLENDMODE_ADD:
+            info->mul1[byte] = 0xff;
+            info->add[byte] = alpha ? 0 : color[i];
+            break;
+        case SDL_BLENDMODE_MOD:
+            info->mul1[byte] = alpha ? 0xff : color[i];
+            break;
+        case SDL_BLENDMODE_MUL:
+            info->mul1[byte] = color[i];
+            info->mul2[byte] = inva;
+            break;
+        default:
+            info->add[byte] = color[i];
+            break;
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* x / 255, exact for x <= 255 * 255 */
+static SDL_INLINE __m128i
+SDL_Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+static void
+SDL_BlendFillRect_8888_SSE2(SDL_Surface * dst, const SDL_Rect * rect, const SDL_BlendFillInfo *info)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mul1 = _mm_setr_epi16(info->mul1[0], info->mul1[1], info->mul1[2], info->mul1[3],
+                                        info->mul1[0], info->mul1[1], info->mul1[2], info->mul1[3]);
+    const __m128i mul2 = _mm_setr_epi16(info->mul2[0], info->mul2[1], info->mul2[2], info->mul2[3],
+                                        info->mul2[0], info->mul2[1], info->mul2[2], info->mul2[3]);
+    const __m128i add = _mm_setr_epi16(info->add[0], info->add[1], info->add[2], info->add[3],
+                                       info->add[0], info->add[1], info->add[2], info->add[3]);
+    const __m128i mask = _mm_set1_epi32((int) info->mask);
+    const SDL_bool two_products = (info->mul2[0] | info->mul2[1] | info->mul2[2] | info->mul2[3]) != 0;
+    Uint8 *pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch + rect->x * 4;
+    int height = rect->h;
+
+    while (height--) {
+        Uint32 *pixel = (Uint32 *) pixels;
+        int n = rect->w;
+
+        while (n > 0) {
+            __m128i p, lo, hi, lo2, hi2;
+
+            if (n >= 4) {
+                p = _mm_loadu_si128((const __m128i *) pixel);
+            } else {
+                p = _mm_cvtsi32_si128((int) *pixel);
+            }
+            lo = _mm_unpacklo_epi8(p, zero);
+            hi = _mm_unpackhi_epi8(p, zero);
+            if (two_products) {
+                lo2 = SDL_Div255_SSE2(_mm_mullo_epi16(lo, mul2));
+                hi2 = SDL_Div255_SSE2(_mm_mullo_epi16(hi, mul2));
+                lo = _mm_add_epi16(SDL_Div255_SSE2(_mm_mullo_epi16(lo, mul1)), lo2);
+                hi = _mm_add_epi16(SDL_Div255_SSE2(_mm_mullo_epi16(hi, mul1)), hi2);
+            } else {
+                lo = SDL_Div255_SSE2(_mm_mullo_epi16(lo, mul1));
+                hi = SDL_Div255_SSE2(_mm_mullo_epi16(hi, mul1));
+            }
+            /* packus clamps to 255 */
+            p = _mm_and_si128(_mm_packus_epi16(_mm_add_epi16(lo, add), _mm_add_epi16(hi, add)), mask);
+
+            if (n >= 4) {
+                _mm_storeu_si128((__m128i *) pixel, p);
+                pixel += 4;
+                n -= 4;
+            } else {
+                *pixel++ = (Uint32) _mm_cvtsi128_si32(p);
+                --n;
+            }
+        }
+        pixels += dst->pitch;
+    }
+}
+#endif /* __SSE2__ */
+
 int
 SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
                   SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
@@ -243,7 +388,21 @@ SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already what the BLEND pixel functions expect */
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
+
+#if defined(__SSE2__)
+    if (SDL_HasSSE2()) {
+        SDL_BlendFillInfo info;
+        if (SDL_SetupBlendFill8888(dst->format, blendMode, r, g, b, a, &info)) {
+            SDL_BlendFillRect_8888_SSE2(dst, rect, &info);
+            return 0;
+        }
     }
+#endif
 
     switch (dst->format->BitsPerPixel) {
     case 15:
@@ -289,6 +448,9 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
     int (*func)(SDL_Surface * dst, const SDL_Rect * rect,
                 SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
     int status = 0;
+#if defined(__SSE2__)
+    SDL_BlendFillInfo info;
+#endif
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -303,7 +465,23 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already what the BLEND pixel functions expect */
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+        blendMode = SDL_BLENDMODE_BLEND;
+    }
+
+#if defined(__SSE2__)
+    /* The whole batch shares the same setup */
+    if (SDL_HasSSE2() && SDL_SetupBlendFill8888(dst->format, blendMode, r, g, b, a, &info)) {
+        for (i = 0; i < count; ++i) {
+            if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &rect)) {
+                SDL_BlendFillRect_8888_SSE2(dst, &rect, &info);
+            }
+        }
+        return 0;
     }
+#endif
 
     /* FIXME: Does this function pointer slow things down significantly? */
     switch (dst->format->BitsPerPixel) {
@@ -51,6 +51,7 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -69,6 +70,7 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -87,6 +89,7 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -105,6 +108,7 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY2_BLEND_RGB, DRAW_SETPIXELXY2_BLEND_RGB,
                    draw_end);
@@ -156,6 +160,7 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB555, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -174,6 +179,7 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB555, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -192,6 +198,7 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB555, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -210,6 +217,7 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY_BLEND_RGB555, DRAW_SETPIXELXY_BLEND_RGB555,
                    draw_end);
@@ -261,6 +269,7 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB565, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -279,6 +288,7 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB565, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -297,6 +307,7 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint16, DRAW_SETPIXEL_BLEND_RGB565, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -315,6 +326,7 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY_BLEND_RGB565, DRAW_SETPIXELXY_BLEND_RGB565,
                    draw_end);
@@ -367,6 +379,7 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -385,6 +398,7 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -403,6 +417,7 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -421,6 +436,7 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY4_BLEND_RGB, DRAW_SETPIXELXY4_BLEND_RGB,
                    draw_end);
@@ -473,6 +489,7 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint32, DRAW_SETPIXEL_BLEND_RGBA, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -491,6 +508,7 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint32, DRAW_SETPIXEL_BLEND_RGBA, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -509,6 +527,7 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint32, DRAW_SETPIXEL_BLEND_RGBA, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -527,6 +546,7 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY4_BLEND_RGBA, DRAW_SETPIXELXY4_BLEND_RGBA,
                    draw_end);
@@ -578,6 +598,7 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -596,6 +617,7 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -614,6 +636,7 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint32, DRAW_SETPIXEL_BLEND_RGB888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -632,6 +655,7 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY_BLEND_RGB888, DRAW_SETPIXELXY_BLEND_RGB888,
                    draw_end);
@@ -683,6 +707,7 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     if (y1 == y2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             HLINE(Uint32, DRAW_SETPIXEL_BLEND_ARGB8888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -701,6 +726,7 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (x1 == x2) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             VLINE(Uint32, DRAW_SETPIXEL_BLEND_ARGB8888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -719,6 +745,7 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             DLINE(Uint32, DRAW_SETPIXEL_BLEND_ARGB8888, draw_end);
             break;
         case SDL_BLENDMODE_ADD:
@@ -737,6 +764,7 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
     } else {
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
             AALINE(x1, y1, x2, y2,
                    DRAW_SETPIXELXY_BLEND_ARGB8888, DRAW_SETPIXELXY_BLEND_ARGB8888,
                    draw_end);
@@ -817,6 +845,10 @@ SDL_BlendLine(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         return SDL_SetError("SDL_BlendLine(): Unsupported surface format");
     }
 
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+    }
+
     /* Perform clipping */
     /* FIXME: We don't actually want to clip, as it may change line slope */
     if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
@@ -846,6 +878,10 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         return SDL_SetError("SDL_BlendLines(): Unsupported surface format");
     }
 
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+    }
+
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
         y1 = points[i-1].y;
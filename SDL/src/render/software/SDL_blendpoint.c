@@ -237,6 +237,10 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already what the BLEND pixel functions expect */
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+        blendMode = SDL_BLENDMODE_BLEND;
     }
 
     switch (dst->format->BitsPerPixel) {
@@ -299,6 +303,10 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         r = DRAW_MUL(r, a);
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
+    } else if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        /* The color is already what the BLEND pixel functions expect */
+        DRAW_CLAMP_PREMULTIPLIED(r, g, b, a);
+        blendMode = SDL_BLENDMODE_BLEND;
     }
 
     /* FIXME: Does this function pointer slow things down significantly? */
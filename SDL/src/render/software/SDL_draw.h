@@ -28,6 +28,16 @@
 
 #define DRAW_MUL(_a, _b) (((unsigned)(_a)*(_b))/255)
 
+/* A premultiplied color can't be brighter than its alpha, or blending it
+ * would carry into the next channel of the pixel.
+ */
+#define DRAW_CLAMP_PREMULTIPLIED(r, g, b, a) \
+do { \
+    r = SDL_min(r, a); \
+    g = SDL_min(g, a); \
+    b = SDL_min(b, a); \
+} while (0)
+
 #define DRAW_FASTSETPIXEL(type) \
     *pixel = (type) color
 
@@ -34,6 +34,7 @@
 #include "SDL_drawpoint.h"
 #include "SDL_rotate.h"
 #include "SDL_triangle.h"
+#include "SDL_transform.h"
 
 /* SDL surface based renderer implementation */
 
@@ -44,12 +45,47 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+/* Scratch memory kept between draw calls, so that intermediate buffers don't
+   go through the allocator on every SDL_RenderCopyEx() */
+enum
+{
+    SW_SCRATCH_ROW,
+    SW_SCRATCH_SCALED,
+    SW_NUM_SCRATCH
+};
+
+typedef struct
+{
+    void *pixels;
+    size_t size;
+} SW_ScratchBuffer;
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SW_ScratchBuffer scratch[SW_NUM_SCRATCH];
 } SW_RenderData;
 
+static void *
+SW_GetScratch(SW_RenderData *data, int index, size_t size)
+{
+    SW_ScratchBuffer *scratch = &data->scratch[index];
+
+    if (size > scratch->size) {
+        /* The contents don't need to be preserved */
+        SDL_free(scratch->pixels);
+        scratch->pixels = SDL_malloc(size);
+        if (!scratch->pixels) {
+            scratch->size = 0;
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        scratch->size = size;
+    }
+    return scratch->pixels;
+}
+
 
 static SDL_Surface *
 SW_ActivateRenderer(SDL_Renderer * renderer)
@@ -103,6 +139,14 @@ SW_GetOutputSize(SDL_Renderer * renderer, int *w, int *h)
     return -1;
 }
 
+static SDL_bool
+SW_SupportsBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
+{
+    /* Besides the required blend modes, the blitters and the drawing
+       functions handle premultiplied alpha */
+    return (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+}
+
 static int
 SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -307,6 +351,7 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * tex
                 const SDL_Rect * srcrect, const SDL_Rect * final_rect,
                 const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *src = (SDL_Surface *) texture->driverdata;
     SDL_Rect tmp_rect;
     SDL_Surface *src_clone, *src_rotated, *src_scaled;
@@ -323,6 +368,15 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * tex
         return -1;
     }
 
+    /* Sample the texture straight into the destination when possible */
+    if (SDL_SW_CanBlitTransformed(src, srcrect, surface)) {
+        Uint32 *row = (Uint32 *) SW_GetScratch(data, SW_SCRATCH_ROW, surface->w * sizeof(Uint32));
+        if (!row) {
+            return -1;
+        }
+        return SDL_SW_BlitTransformed(src, srcrect, surface, final_rect, angle, center, flip, texture->scaleMode, row);
+    }
+
     tmp_rect.x = 0;
     tmp_rect.y = 0;
     tmp_rect.w = final_rect->w;
@@ -397,8 +451,9 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * tex
      */
     if (!retval && (blitRequired || applyModulation)) {
         SDL_Rect scale_rect = tmp_rect;
-        src_scaled = SDL_CreateRGBSurface(0, final_rect->w, final_rect->h, 32,
-                                          0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+        void *pixels = SW_GetScratch(data, SW_SCRATCH_SCALED, (size_t) final_rect->w * final_rect->h * 4);
+        src_scaled = pixels ? SDL_CreateRGBSurfaceFrom(pixels, final_rect->w, final_rect->h, 32, final_rect->w * 4,
+                                                       0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000) : NULL;
         if (src_scaled == NULL) {
             retval = -1;
         } else {
@@ -639,7 +694,8 @@ PrepTextureForCopy(const SDL_RenderCommand *cmd)
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
     const SDL_bool colormod = ((r & g & b) != 0xFF);
     const SDL_bool alphamod = (a != 0xFF);
-    const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL));
+    const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL) ||
+                               (blend == SDL_BLENDMODE_BLEND_PREMULTIPLIED));
 
     if (colormod || alphamod || blending) {
         SDL_SetSurfaceRLE(surface, 0);
@@ -777,9 +833,29 @@ SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 const Uint8 g = cmd->data.draw.g;
                 const Uint8 b = cmd->data.draw.b;
                 const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+                const size_t first = cmd->data.draw.first;
+                int count = (int) cmd->data.draw.count;
+                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + first);
                 const SDL_BlendMode blend = cmd->data.draw.blend;
+                SDL_RenderCommand *nextcmd = cmd->next;
+
+                /* Consecutive fills with the same state have their rects next to
+                   each other in the vertex buffer, so they can all go in one batch. */
+                while (nextcmd != NULL) {
+                    if (nextcmd->command != SDL_RENDERCMD_FILL_RECTS) {
+                        break;  /* different render command up next. */
+                    } else if (nextcmd->data.draw.blend != blend ||
+                               nextcmd->data.draw.r != r || nextcmd->data.draw.g != g ||
+                               nextcmd->data.draw.b != b || nextcmd->data.draw.a != a) {
+                        break;  /* different color or blend mode up next. */
+                    } else if (nextcmd->data.draw.first != first + count * sizeof (SDL_Rect)) {
+                        break;  /* the rects aren't contiguous. */
+                    }
+                    count += (int) nextcmd->data.draw.count;
+                    cmd = nextcmd;  /* skip the fill commands combined in here. */
+                    nextcmd = nextcmd->next;
+                }
+
                 SetDrawState(surface, &drawstate);
 
                 /* Apply viewport */
@@ -965,7 +1041,13 @@ static void
 SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    int i;
 
+    if (data) {
+        for (i = 0; i < SW_NUM_SCRATCH; ++i) {
+            SDL_free(data->scratch[i].pixels);
+        }
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -998,6 +1080,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
+    renderer->SupportsBlendMode = SW_SupportsBlendMode;
     renderer->CreateTexture = SW_CreateTexture;
     renderer->UpdateTexture = SW_UpdateTexture;
     renderer->LockTexture = SW_LockTexture;
@@ -0,0 +1,687 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED
+
+#include "SDL_surface.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_transform.h"
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+/* Source coordinates are 16.16 fixed point */
+#define FP_BITS     16
+#define FP_ONE      (1 << FP_BITS)
+
+/* Bilinear filtering weights precision */
+#define FRAC_BITS   7
+#define FRAC_ONE    (1 << FRAC_BITS)
+
+typedef struct
+{
+    const Uint8 *src;       /* top left pixel of the source rectangle */
+    int src_pitch;
+    int src_w;
+    int src_h;
+    Uint32 opaque;          /* or'ed into the pixels of a source without an alpha channel */
+    int alpha_shift;
+    Uint8 mod[4];           /* color or alpha modulation of each byte of a pixel */
+    SDL_bool modulate;
+    SDL_bool blend;
+    SDL_bool premultiplied; /* blend without multiplying the colors by alpha first */
+} TransformInfo;
+
+typedef void (*SampleFunc)(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv);
+typedef void (*CompositeFunc)(const TransformInfo *info, const Uint32 *src, Uint32 *dst, int n);
+
+SDL_bool
+SDL_SW_CanBlitTransformed(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst)
+{
+    const SDL_PixelFormat *src_fmt = src->format;
+    const SDL_PixelFormat *dst_fmt = dst->format;
+    SDL_BlendMode blendMode;
+
+    if (SDL_GetSurfaceBlendMode(src, &blendMode) < 0 ||
+        (blendMode != SDL_BLENDMODE_NONE && blendMode != SDL_BLENDMODE_BLEND &&
+         blendMode != SDL_BLENDMODE_BLEND_PREMULTIPLIED)) {
+        return SDL_FALSE;
+    }
+    if (SDL_HasColorKey(src)) {
+        return SDL_FALSE;
+    }
+    if (src_fmt->BytesPerPixel != 4 || SDL_PIXELLAYOUT(src_fmt->format) != SDL_PACKEDLAYOUT_8888 ||
+        dst_fmt->BytesPerPixel != 4 || SDL_PIXELLAYOUT(dst_fmt->format) != SDL_PACKEDLAYOUT_8888) {
+        return SDL_FALSE;
+    }
+    if (src_fmt->Rmask != dst_fmt->Rmask || src_fmt->Gmask != dst_fmt->Gmask || src_fmt->Bmask != dst_fmt->Bmask) {
+        return SDL_FALSE;
+    }
+    /* Keep the fixed point source coordinates and their increments within 31 bits */
+    if (srcrect->w > 16384 || srcrect->h > 16384) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static void
+SampleNearest(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    const int max_x = info->src_w - 1;
+    const int max_y = info->src_h - 1;
+
+    while (n--) {
+        /* The span is computed in floating point: clamp rounding errors at its ends */
+        int x = u >> FP_BITS;
+        int y = v >> FP_BITS;
+        x = SDL_clamp(x, 0, max_x);
+        y = SDL_clamp(y, 0, max_y);
+        *dst++ = ((const Uint32 *)(info->src + y * info->src_pitch))[x] | info->opaque;
+        u += du;
+        v += dv;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+/* 4 pixels at a time: the coordinates are clamped together, then the pixels
+   are fetched one by one, since SSE2 can't gather */
+static void
+SampleNearest_SSE2(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    const __m128i zero = _mm_setzero_si128();
+    /* x in the low half, y in the high half, as packed below */
+    const __m128i max = _mm_unpacklo_epi64(_mm_set1_epi16((short)(info->src_w - 1)), _mm_set1_epi16((short)(info->src_h - 1)));
+    const __m128i opaque = _mm_set1_epi32(info->opaque);
+    const __m128i du4 = _mm_slli_epi32(_mm_set1_epi32(du), 2);
+    const __m128i dv4 = _mm_slli_epi32(_mm_set1_epi32(dv), 2);
+    __m128i vu = _mm_add_epi32(_mm_set1_epi32(u), _mm_setr_epi32(0, du, (int)((Uint32)du * 2), (int)((Uint32)du * 3)));
+    __m128i vv = _mm_add_epi32(_mm_set1_epi32(v), _mm_setr_epi32(0, dv, (int)((Uint32)dv * 2), (int)((Uint32)dv * 3)));
+
+    while (n >= 4) {
+        Sint16 xy[8];
+        __m128i c = _mm_packs_epi32(_mm_srai_epi32(vu, FP_BITS), _mm_srai_epi32(vv, FP_BITS));
+        c = _mm_min_epi16(_mm_max_epi16(c, zero), max);
+        _mm_storeu_si128((__m128i *)xy, c);
+        c = _mm_setr_epi32(((const Uint32 *)(info->src + xy[4] * info->src_pitch))[xy[0]],
+                           ((const Uint32 *)(info->src + xy[5] * info->src_pitch))[xy[1]],
+                           ((const Uint32 *)(info->src + xy[6] * info->src_pitch))[xy[2]],
+                           ((const Uint32 *)(info->src + xy[7] * info->src_pitch))[xy[3]]);
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(c, opaque));
+        vu = _mm_add_epi32(vu, du4);
+        vv = _mm_add_epi32(vv, dv4);
+        dst += 4;
+        n -= 4;
+    }
+    SampleNearest(info, dst, n, _mm_cvtsi128_si32(vu), _mm_cvtsi128_si32(vv), du, dv);
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static void
+SampleNearest_NEON(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t max_x = vdupq_n_s32(info->src_w - 1);
+    const int32x4_t max_y = vdupq_n_s32(info->src_h - 1);
+    const uint32x4_t opaque = vdupq_n_u32(info->opaque);
+    const int32x4_t du4 = vdupq_n_s32((int)((Uint32)du * 4));
+    const int32x4_t dv4 = vdupq_n_s32((int)((Uint32)dv * 4));
+    const Sint32 steps_u[4] = { 0, du, (int)((Uint32)du * 2), (int)((Uint32)du * 3) };
+    const Sint32 steps_v[4] = { 0, dv, (int)((Uint32)dv * 2), (int)((Uint32)dv * 3) };
+    int32x4_t vu = vaddq_s32(vdupq_n_s32(u), vld1q_s32(steps_u));
+    int32x4_t vv = vaddq_s32(vdupq_n_s32(v), vld1q_s32(steps_v));
+
+    while (n >= 4) {
+        Sint32 x[4], y[4];
+        Uint32 pixels[4];
+        int i;
+
+        vst1q_s32(x, vminq_s32(vmaxq_s32(vshrq_n_s32(vu, FP_BITS), zero), max_x));
+        vst1q_s32(y, vminq_s32(vmaxq_s32(vshrq_n_s32(vv, FP_BITS), zero), max_y));
+        for (i = 0; i < 4; ++i) {
+            pixels[i] = ((const Uint32 *)(info->src + y[i] * info->src_pitch))[x[i]];
+        }
+        vst1q_u32(dst, vorrq_u32(vld1q_u32(pixels), opaque));
+        vu = vaddq_s32(vu, du4);
+        vv = vaddq_s32(vv, dv4);
+        dst += 4;
+        n -= 4;
+    }
+    SampleNearest(info, dst, n, vgetq_lane_s32(vu, 0), vgetq_lane_s32(vv, 0), du, dv);
+}
+#endif
+
+/* The 4 source pixels around u, v (relative to the pixel centers) and the
+   weights of the right and bottom ones, clamped to the edges of the source */
+static SDL_INLINE void
+GetBilinearTaps(const TransformInfo *info, int u, int v, Uint32 *p, int *fx, int *fy)
+{
+    const int x = u >> FP_BITS;
+    const int y = v >> FP_BITS;
+    const int x0 = SDL_clamp(x, 0, info->src_w - 1);
+    const int x1 = SDL_clamp(x + 1, 0, info->src_w - 1);
+    const Uint32 *row0 = (const Uint32 *)(info->src + SDL_clamp(y, 0, info->src_h - 1) * info->src_pitch);
+    const Uint32 *row1 = (const Uint32 *)(info->src + SDL_clamp(y + 1, 0, info->src_h - 1) * info->src_pitch);
+
+    p[0] = row0[x0];
+    p[1] = row0[x1];
+    p[2] = row1[x0];
+    p[3] = row1[x1];
+    *fx = (u >> (FP_BITS - FRAC_BITS)) & (FRAC_ONE - 1);
+    *fy = (v >> (FP_BITS - FRAC_BITS)) & (FRAC_ONE - 1);
+}
+
+static SDL_INLINE Uint32
+Interpolate(Uint32 p00, Uint32 p01, Uint32 p10, Uint32 p11, int fx, int fy)
+{
+    Uint32 pixel = 0;
+    int shift;
+
+    for (shift = 0; shift < 32; shift += 8) {
+        const int c0 = (int)((p00 >> shift) & 0xFF) * (FRAC_ONE - fy) + (int)((p10 >> shift) & 0xFF) * fy;
+        const int c1 = (int)((p01 >> shift) & 0xFF) * (FRAC_ONE - fy) + (int)((p11 >> shift) & 0xFF) * fy;
+        const int c = (c0 * (FRAC_ONE - fx) + c1 * fx + (1 << (2 * FRAC_BITS - 1))) >> (2 * FRAC_BITS);
+        pixel |= (Uint32)c << shift;
+    }
+    return pixel;
+}
+
+/* u and v are relative to the pixel centers */
+static void
+SampleLinearCentered(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    while (n--) {
+        Uint32 p[4];
+        int fx, fy;
+
+        GetBilinearTaps(info, u, v, p, &fx, &fy);
+        *dst++ = Interpolate(p[0], p[1], p[2], p[3], fx, fy) | info->opaque;
+        u += du;
+        v += dv;
+    }
+}
+
+static void
+SampleLinear(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    /* Interpolate between the centers of the source pixels */
+    SampleLinearCentered(info, dst, n, u - FP_ONE / 2, v - FP_ONE / 2, du, dv);
+}
+
+#if HAVE_SSE2_INTRINSICS
+/* Same arithmetic as Interpolate(), for 2 pixels: returns the channels of
+   the first one in the low half, as 16-bit values */
+static SDL_INLINE __m128i
+Interpolate2_SSE2(const Uint32 *a, int fxa, int fya, const Uint32 *b, int fxb, int fyb)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i top = _mm_setr_epi32(a[0], a[1], b[0], b[1]);
+    const __m128i bottom = _mm_setr_epi32(a[2], a[3], b[2], b[3]);
+    const __m128i round = _mm_set1_epi32(1 << (2 * FRAC_BITS - 1));
+    __m128i ca, cb;
+
+    /* Vertical: { c0, c1 } for each channel */
+    ca = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(top, zero), _mm_set1_epi16(FRAC_ONE - fya)),
+                       _mm_mullo_epi16(_mm_unpacklo_epi8(bottom, zero), _mm_set1_epi16(fya)));
+    cb = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(top, zero), _mm_set1_epi16(FRAC_ONE - fyb)),
+                       _mm_mullo_epi16(_mm_unpackhi_epi8(bottom, zero), _mm_set1_epi16(fyb)));
+
+    /* Horizontal: interleave c0 and c1 of each channel and multiply-add */
+    ca = _mm_madd_epi16(_mm_unpacklo_epi16(ca, _mm_srli_si128(ca, 8)), _mm_set1_epi32((fxa << 16) | (FRAC_ONE - fxa)));
+    cb = _mm_madd_epi16(_mm_unpacklo_epi16(cb, _mm_srli_si128(cb, 8)), _mm_set1_epi32((fxb << 16) | (FRAC_ONE - fxb)));
+    ca = _mm_srli_epi32(_mm_add_epi32(ca, round), 2 * FRAC_BITS);
+    cb = _mm_srli_epi32(_mm_add_epi32(cb, round), 2 * FRAC_BITS);
+    return _mm_packs_epi32(ca, cb);
+}
+
+static void
+SampleLinear_SSE2(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    const __m128i opaque = _mm_set1_epi32(info->opaque);
+
+    u -= FP_ONE / 2;
+    v -= FP_ONE / 2;
+
+    while (n >= 4) {
+        Uint32 p[4][4];
+        int fx[4], fy[4], i;
+
+        for (i = 0; i < 4; ++i) {
+            GetBilinearTaps(info, u, v, p[i], &fx[i], &fy[i]);
+            u += du;
+            v += dv;
+        }
+        _mm_storeu_si128((__m128i *)dst,
+                         _mm_or_si128(_mm_packus_epi16(Interpolate2_SSE2(p[0], fx[0], fy[0], p[1], fx[1], fy[1]),
+                                                       Interpolate2_SSE2(p[2], fx[2], fy[2], p[3], fx[3], fy[3])),
+                                      opaque));
+        dst += 4;
+        n -= 4;
+    }
+    SampleLinearCentered(info, dst, n, u, v, du, dv);
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+/* Same arithmetic as Interpolate(), for 2 pixels */
+static SDL_INLINE uint8x8_t
+Interpolate2_NEON(const Uint32 *a, int fxa, int fya, const Uint32 *b, int fxb, int fyb)
+{
+    const uint32x4_t top = vld1q_u32(a);   /* a00 a01 a10 a11 */
+    const uint32x4_t other = vld1q_u32(b);
+    uint16x8_t ca, cb;
+    uint32x4_t ha, hb;
+
+    /* Vertical: { c0, c1 } for each channel */
+    ca = vmlal_u8(vmull_u8(vreinterpret_u8_u32(vget_low_u32(top)), vdup_n_u8((Uint8)(FRAC_ONE - fya))),
+                  vreinterpret_u8_u32(vget_high_u32(top)), vdup_n_u8((Uint8)fya));
+    cb = vmlal_u8(vmull_u8(vreinterpret_u8_u32(vget_low_u32(other)), vdup_n_u8((Uint8)(FRAC_ONE - fyb))),
+                  vreinterpret_u8_u32(vget_high_u32(other)), vdup_n_u8((Uint8)fyb));
+
+    /* Horizontal */
+    ha = vmlal_n_u16(vmull_n_u16(vget_low_u16(ca), (Uint16)(FRAC_ONE - fxa)), vget_high_u16(ca), (Uint16)fxa);
+    hb = vmlal_n_u16(vmull_n_u16(vget_low_u16(cb), (Uint16)(FRAC_ONE - fxb)), vget_high_u16(cb), (Uint16)fxb);
+    return vmovn_u16(vcombine_u16(vrshrn_n_u32(ha, 2 * FRAC_BITS), vrshrn_n_u32(hb, 2 * FRAC_BITS)));
+}
+
+static void
+SampleLinear_NEON(const TransformInfo *info, Uint32 *dst, int n, int u, int v, int du, int dv)
+{
+    const uint32x4_t opaque = vdupq_n_u32(info->opaque);
+
+    u -= FP_ONE / 2;
+    v -= FP_ONE / 2;
+
+    while (n >= 4) {
+        Uint32 p[4][4];
+        int fx[4], fy[4], i;
+
+        for (i = 0; i < 4; ++i) {
+            GetBilinearTaps(info, u, v, p[i], &fx[i], &fy[i]);
+            u += du;
+            v += dv;
+        }
+        vst1q_u32(dst, vorrq_u32(vreinterpretq_u32_u8(vcombine_u8(Interpolate2_NEON(p[0], fx[0], fy[0], p[1], fx[1], fy[1]),
+                                                                   Interpolate2_NEON(p[2], fx[2], fy[2], p[3], fx[3], fy[3]))),
+                                 opaque));
+        dst += 4;
+        n -= 4;
+    }
+    SampleLinearCentered(info, dst, n, u, v, du, dv);
+}
+#endif
+
+/* Same as the generic blitters:
+   modulated = src * mod / 255
+   dstRGB = srcRGB * srcA / 255 + dstRGB * (255 - srcA) / 255
+   dstA = srcA + dstA * (255 - srcA) / 255
+   where premultiplied sources skip the srcRGB * srcA / 255 */
+static void
+Composite(const TransformInfo *info, const Uint32 *src, Uint32 *dst, int n)
+{
+    const int alpha_shift = info->alpha_shift;
+
+    while (n--) {
+        Uint32 s = *src++;
+        int shift;
+
+        if (info->modulate) {
+            Uint32 pixel = 0;
+            for (shift = 0; shift < 32; shift += 8) {
+                pixel |= ((((s >> shift) & 0xFF) * info->mod[shift / 8]) / 255) << shift;
+            }
+            s = pixel;
+        }
+
+        if (info->blend) {
+            const Uint32 a = (s >> alpha_shift) & 0xFF;
+            if (a == 0 && !info->premultiplied) {
+                s = *dst;
+            } else if (a < 255) {
+                const Uint32 d = *dst;
+                Uint32 pixel = 0;
+                for (shift = 0; shift < 32; shift += 8) {
+                    Uint32 c = (s >> shift) & 0xFF;
+                    if (shift != alpha_shift && !info->premultiplied) {
+                        c = (c * a) / 255;
+                    }
+                    c += (((d >> shift) & 0xFF) * (255 - a)) / 255;
+                    pixel |= SDL_min(c, 0xFF) << shift;
+                }
+                s = pixel;
+            }
+        }
+        *dst++ = s;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+/* x / 255, exact for x <= 255 * 255 */
+static SDL_INLINE __m128i
+Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+static SDL_INLINE __m128i
+Composite2_SSE2(const TransformInfo *info, __m128i s, __m128i d, __m128i mod, __m128i alpha_mask, __m128i alpha_shift)
+{
+    if (info->modulate) {
+        s = Div255_SSE2(_mm_mullo_epi16(s, mod));
+    }
+    if (info->blend) {
+        /* Broadcast the alpha of each pixel to its 4 channels */
+        __m128i a = _mm_srl_epi64(_mm_and_si128(s, alpha_mask), alpha_shift);
+        a = _mm_or_si128(a, _mm_slli_epi64(a, 16));
+        a = _mm_or_si128(a, _mm_slli_epi64(a, 32));
+
+        /* Premultiply the colors, but keep the alpha */
+        if (!info->premultiplied) {
+            s = _mm_or_si128(_mm_andnot_si128(alpha_mask, Div255_SSE2(_mm_mullo_epi16(s, a))), _mm_and_si128(alpha_mask, s));
+        }
+        s = _mm_add_epi16(s, Div255_SSE2(_mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a))));
+    }
+    return s;
+}
+
+static void
+Composite_SSE2(const TransformInfo *info, const Uint32 *src, Uint32 *dst, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mod = _mm_setr_epi16(info->mod[0], info->mod[1], info->mod[2], info->mod[3],
+                                       info->mod[0], info->mod[1], info->mod[2], info->mod[3]);
+    /* 0xFFFF in the 16-bit lanes of the alpha channel */
+    const __m128i alpha_mask = _mm_unpacklo_epi8(_mm_set1_epi32(0xFFu << info->alpha_shift), _mm_set1_epi32(0xFFu << info->alpha_shift));
+    /* Shift from the alpha lane to the first lane of a pixel */
+    const __m128i alpha_shift = _mm_cvtsi32_si128(info->alpha_shift * 2);
+
+    while (n >= 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        const __m128i lo = Composite2_SSE2(info, _mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), mod, alpha_mask, alpha_shift);
+        const __m128i hi = Composite2_SSE2(info, _mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), mod, alpha_mask, alpha_shift);
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+        src += 4;
+        dst += 4;
+        n -= 4;
+    }
+    Composite(info, src, dst, n);
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+/* x / 255, exact for x <= 255 * 255 */
+static SDL_INLINE uint16x8_t
+Div255_NEON(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+static SDL_INLINE uint16x8_t
+Composite2_NEON(const TransformInfo *info, uint16x8_t s, uint16x8_t d, uint16x8_t mod, uint16x8_t alpha_mask, int64x2_t alpha_shift)
+{
+    if (info->modulate) {
+        s = Div255_NEON(vmulq_u16(s, mod));
+    }
+    if (info->blend) {
+        /* Broadcast the alpha of each pixel to its 4 channels */
+        uint64x2_t a = vshlq_u64(vreinterpretq_u64_u16(vandq_u16(s, alpha_mask)), alpha_shift);
+        a = vorrq_u64(a, vshlq_n_u64(a, 16));
+        a = vorrq_u64(a, vshlq_n_u64(a, 32));
+
+        /* Premultiply the colors, but keep the alpha */
+        if (!info->premultiplied) {
+            s = vbslq_u16(alpha_mask, s, Div255_NEON(vmulq_u16(s, vreinterpretq_u16_u64(a))));
+        }
+        s = vaddq_u16(s, Div255_NEON(vmulq_u16(d, vsubq_u16(vdupq_n_u16(255), vreinterpretq_u16_u64(a)))));
+    }
+    return s;
+}
+
+static void
+Composite_NEON(const TransformInfo *info, const Uint32 *src, Uint32 *dst, int n)
+{
+    const Uint16 mods[8] = {
+        info->mod[0], info->mod[1], info->mod[2], info->mod[3],
+        info->mod[0], info->mod[1], info->mod[2], info->mod[3]
+    };
+    const uint16x8_t mod = vld1q_u16(mods);
+    /* 0xFFFF in the 16-bit lanes of the alpha channel */
+    const uint16x8_t alpha_mask = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(0xFFu << info->alpha_shift)));
+    const uint16x8_t alpha_mask16 = vorrq_u16(alpha_mask, vshlq_n_u16(alpha_mask, 8));
+    /* Shift from the alpha lane to the first lane of a pixel */
+    const int64x2_t alpha_shift = vdupq_n_s64(-info->alpha_shift * 2);
+
+    while (n >= 4) {
+        const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(src));
+        const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+        const uint16x8_t lo = Composite2_NEON(info, vmovl_u8(vget_low_u8(s)), vmovl_u8(vget_low_u8(d)), mod, alpha_mask16, alpha_shift);
+        const uint16x8_t hi = Composite2_NEON(info, vmovl_u8(vget_high_u8(s)), vmovl_u8(vget_high_u8(d)), mod, alpha_mask16, alpha_shift);
+        vst1q_u32(dst, vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi))));
+        src += 4;
+        dst += 4;
+        n -= 4;
+    }
+    Composite(info, src, dst, n);
+}
+#endif
+
+/* Limits [*lo, *hi) to the integers x for which 0 <= a + b * x < size */
+static void
+LimitSpan(double a, double b, int size, double *lo, double *hi)
+{
+    double first, end;
+
+    if (b > 0.0) {
+        first = SDL_ceil(-a / b);
+        end = SDL_ceil((size - a) / b);
+    } else if (b < 0.0) {
+        first = SDL_floor((size - a) / b) + 1.0;
+        end = SDL_floor(-a / b) + 1.0;
+    } else if (a >= 0.0 && a < size) {
+        return;
+    } else {
+        *hi = *lo;
+        return;
+    }
+    *lo = SDL_max(*lo, first);
+    *hi = SDL_min(*hi, end);
+}
+
+int
+SDL_SW_BlitTransformed(SDL_Surface *src, const SDL_Rect *srcrect,
+        SDL_Surface *dst, const SDL_Rect *dstrect,
+        double angle, const SDL_FPoint *center, SDL_RendererFlip flip,
+        SDL_ScaleMode scaleMode, Uint32 *row)
+{
+    const SDL_PixelFormat *fmt = src->format;
+    TransformInfo info;
+    SDL_BlendMode blendMode;
+    SampleFunc sample;
+    CompositeFunc composite;
+    Uint8 r, g, b, a;
+    Uint32 alpha_mask;
+    SDL_Rect clip;
+    double cosine, sine, scale_u, scale_v, origin_x, origin_y;
+    double u_00, v_00, du_dx, du_dy, dv_dx, dv_dy;
+    int angle90, i, x, y;
+
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+
+    if (SDL_MUSTLOCK(src) && SDL_LockSurface(src) < 0) {
+        return -1;
+    }
+    if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0) {
+        if (SDL_MUSTLOCK(src)) {
+            SDL_UnlockSurface(src);
+        }
+        return -1;
+    }
+
+    SDL_GetSurfaceBlendMode(src, &blendMode);
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_GetSurfaceAlphaMod(src, &a);
+
+    alpha_mask = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask);
+    info.src = (const Uint8 *)src->pixels + srcrect->y * src->pitch + srcrect->x * 4;
+    info.src_pitch = src->pitch;
+    info.src_w = srcrect->w;
+    info.src_h = srcrect->h;
+    info.opaque = fmt->Amask ? 0 : alpha_mask;
+    info.alpha_shift = (alpha_mask & 0x000000FF) ? 0 : (alpha_mask & 0x0000FF00) ? 8 : (alpha_mask & 0x00FF0000) ? 16 : 24;
+    for (i = 0; i < 4; ++i) {
+        const Uint32 byte_mask = 0xFFu << (i * 8);
+        info.mod[i] = (fmt->Rmask & byte_mask) ? r : (fmt->Gmask & byte_mask) ? g : (fmt->Bmask & byte_mask) ? b : a;
+    }
+    info.modulate = (r & g & b & a) != 0xFF;
+    info.blend = (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    info.premultiplied = (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+
+    sample = (scaleMode == SDL_ScaleModeNearest) ? SampleNearest : SampleLinear;
+    composite = Composite;
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        if (scaleMode != SDL_ScaleModeNearest) {
+            sample = SampleLinear_SSE2;
+        } else if (info.src_w <= SDL_MAX_SINT16 && info.src_h <= SDL_MAX_SINT16) {
+            /* The coordinates are clamped as 16-bit values */
+            sample = SampleNearest_SSE2;
+        }
+        composite = Composite_SSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        sample = (scaleMode == SDL_ScaleModeNearest) ? SampleNearest_NEON : SampleLinear_NEON;
+        composite = Composite_NEON;
+    }
+#endif
+
+    /* Exact values for multiples of 90 degrees, so that the edges stay straight */
+    angle90 = (int)(angle / 90);
+    if (angle90 == angle / 90) {
+        static const int cosines[4] = { 1, 0, -1, 0 };
+        cosine = cosines[angle90 & 3];
+        sine = cosines[(angle90 + 3) & 3];
+    } else {
+        const double radians = angle * (M_PI / 180.0);
+        cosine = SDL_cos(radians);
+        sine = SDL_sin(radians);
+    }
+
+    /* Map the center of each destination pixel back to the source rectangle:
+       undo the rotation around the center, then the flip, then the scaling. */
+    scale_u = (double)srcrect->w / dstrect->w;
+    scale_v = (double)srcrect->h / dstrect->h;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        scale_u = -scale_u;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        scale_v = -scale_v;
+    }
+    origin_x = dstrect->x + center->x;
+    origin_y = dstrect->y + center->y;
+    du_dx = scale_u * cosine;
+    du_dy = scale_u * sine;
+    dv_dx = -scale_v * sine;
+    dv_dy = scale_v * cosine;
+    u_00 = scale_u * ((0.5 - origin_x) * cosine + (0.5 - origin_y) * sine + center->x);
+    v_00 = scale_v * (-(0.5 - origin_x) * sine + (0.5 - origin_y) * cosine + center->y);
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        u_00 += srcrect->w;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        v_00 += srcrect->h;
+    }
+
+    /* Only visit the bounding box of the transformed destination rectangle */
+    SDL_GetClipRect(dst, &clip);
+    {
+        double min_x = 0.0, max_x = 0.0, min_y = 0.0, max_y = 0.0;
+        SDL_Rect bounds;
+
+        for (i = 0; i < 4; ++i) {
+            const double px = ((i & 1) ? dstrect->w : 0) - center->x;
+            const double py = ((i & 2) ? dstrect->h : 0) - center->y;
+            const double qx = px * cosine - py * sine;
+            const double qy = px * sine + py * cosine;
+            min_x = i ? SDL_min(min_x, qx) : qx;
+            max_x = i ? SDL_max(max_x, qx) : qx;
+            min_y = i ? SDL_min(min_y, qy) : qy;
+            max_y = i ? SDL_max(max_y, qy) : qy;
+        }
+        bounds.x = (int)SDL_floor(origin_x + min_x);
+        bounds.y = (int)SDL_floor(origin_y + min_y);
+        bounds.w = (int)SDL_ceil(origin_x + max_x) - bounds.x;
+        bounds.h = (int)SDL_ceil(origin_y + max_y) - bounds.y;
+        if (!SDL_IntersectRect(&clip, &bounds, &clip)) {
+            clip.h = 0;
+        }
+    }
+
+    for (y = clip.y; y < clip.y + clip.h; ++y) {
+        const double u_row = u_00 + du_dy * y;
+        const double v_row = v_00 + dv_dy * y;
+        double lo = clip.x, hi = clip.x + clip.w;
+        Uint32 *dst_row;
+        int n;
+
+        LimitSpan(u_row, du_dx, srcrect->w, &lo, &hi);
+        LimitSpan(v_row, dv_dx, srcrect->h, &lo, &hi);
+        if (lo >= hi) {
+            continue;
+        }
+        x = (int)lo;
+        n = (int)hi - x;
+
+        dst_row = (Uint32 *)((Uint8 *)dst->pixels + y * dst->pitch) + x;
+        if (info.modulate || info.blend) {
+            sample(&info, row, n,
+                   (int)SDL_floor((u_row + du_dx * x) * FP_ONE), (int)SDL_floor((v_row + dv_dx * x) * FP_ONE),
+                   (int)(du_dx * FP_ONE), (int)(dv_dx * FP_ONE));
+            composite(&info, row, dst_row, n);
+        } else {
+            sample(&info, dst_row, n,
+                   (int)SDL_floor((u_row + du_dx * x) * FP_ONE), (int)SDL_floor((v_row + dv_dx * x) * FP_ONE),
+                   (int)(du_dx * FP_ONE), (int)(dv_dx * FP_ONE));
+        }
+    }
+
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    if (SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    return 0;
+}
+
+#endif /* SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
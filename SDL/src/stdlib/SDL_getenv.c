@@ -34,6 +34,7 @@
 #endif
 
 #include "SDL_stdinc.h"
+#include "../SDL_hints_c.h"
 
 #if defined(__WIN32__) && (!defined(HAVE_SETENV) || !defined(HAVE_GETENV))
 /* Note this isn't thread-safe! */
@@ -44,8 +45,8 @@ static size_t SDL_envmemlen = 0;
 /* Put a variable into the environment */
 /* Note: Name may not contain a '=' character. (Reference: http://www.unix.com/man-page/Linux/3/setenv/) */
 #if defined(HAVE_SETENV)
-int
-SDL_setenv(const char *name, const char *value, int overwrite)
+static int
+SDL_setenv_internal(const char *name, const char *value, int overwrite)
 {
     /* Input validation */
     if (!name || SDL_strlen(name) == 0 || SDL_strchr(name, '=') != NULL || !value) {
@@ -55,8 +56,8 @@ SDL_setenv(const char *name, const char *value, int overwrite)
     return setenv(name, value, overwrite);
 }
 #elif defined(__WIN32__)
-int
-SDL_setenv(const char *name, const char *value, int overwrite)
+static int
+SDL_setenv_internal(const char *name, const char *value, int overwrite)
 {
     /* Input validation */
     if (!name || SDL_strlen(name) == 0 || SDL_strchr(name, '=') != NULL || !value) {
@@ -75,8 +76,8 @@ SDL_setenv(const char *name, const char *value, int overwrite)
 }
 /* We have a real environment table, but no real setenv? Fake it w/ putenv. */
 #elif (defined(HAVE_GETENV) && defined(HAVE_PUTENV) && !defined(HAVE_SETENV))
-int
-SDL_setenv(const char *name, const char *value, int overwrite)
+static int
+SDL_setenv_internal(const char *name, const char *value, int overwrite)
 {
     size_t len;
     char *new_variable;
@@ -106,8 +107,8 @@ SDL_setenv(const char *name, const char *value, int overwrite)
 }
 #else /* roll our own */
 static char **SDL_env = (char **) 0;
-int
-SDL_setenv(const char *name, const char *value, int overwrite)
+static int
+SDL_setenv_internal(const char *name, const char *value, int overwrite)
 {
     int added;
     size_t len, i;
@@ -170,6 +171,18 @@ SDL_setenv(const char *name, const char *value, int overwrite)
 }
 #endif
 
+int
+SDL_setenv(const char *name, const char *value, int overwrite)
+{
+    const int retval = SDL_setenv_internal(name, value, overwrite);
+
+    if (retval == 0) {
+        /* Hints cache their environment variables */
+        SDL_InvalidateHintEnvironment();
+    }
+    return retval;
+}
+
 /* Retrieve a variable named "name" from the environment */
 #if defined(HAVE_GETENV)
 char *
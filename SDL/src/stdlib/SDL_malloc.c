@@ -5304,11 +5304,245 @@ History:
 
 #endif /* !HAVE_MALLOC */
 
+/* With USE_LOCKS, every dlmalloc() and dlfree() takes the same global lock,
+   so threads that allocate a lot spend their time waiting on each other.
+   The thread cache keeps freed small blocks in per-thread size class bins
+   and hands them back out without touching the heap. Bins that grow too big
+   pass a batch of blocks on to shared bins, where other threads can pick
+   them up, and the shared bins return their surplus to dlmalloc.
+
+   The cached blocks are ordinary dlmalloc chunks, so realloc() and the size
+   class of a freed block come straight from dlmalloc. Thread exit is hooked
+   through a pthread key, so this is only built where dlmalloc uses pthread
+   locks. Define SDL_MALLOC_THREAD_CACHE to 0 to leave it out.
+ */
+#ifndef SDL_MALLOC_THREAD_CACHE
+#if !defined(HAVE_MALLOC) && !SDL_THREADS_DISABLED && !defined(WIN32) && !defined(__OS2__)
+#define SDL_MALLOC_THREAD_CACHE 1
+#else
+#define SDL_MALLOC_THREAD_CACHE 0
+#endif
+#endif
+
+#if SDL_MALLOC_THREAD_CACHE
+
+#define CACHE_NUM_BINS      16
+#define CACHE_MAX_SIZE      1024
+#define CACHE_BIN_BLOCKS    64      /* the most blocks a thread keeps per bin */
+#define CACHE_BATCH_BLOCKS  32      /* blocks moved between the thread and shared bins at a time */
+#define CACHE_SHARED_BLOCKS 1024    /* the most blocks kept per shared bin */
+
+static const size_t cache_bin_size[CACHE_NUM_BINS] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 256, 320, 384, 512, 768, CACHE_MAX_SIZE
+};
+
+typedef struct cache_block
+{
+    struct cache_block *next;
+} cache_block;
+
+typedef struct cache_bin
+{
+    cache_block *head;
+    int count;
+} cache_bin;
+
+typedef struct thread_cache
+{
+    cache_bin bins[CACHE_NUM_BINS];
+} thread_cache;
+
+static struct
+{
+    pthread_once_t once;
+    pthread_key_t key;
+    SDL_bool ready;
+    Uint8 bin_for_size[(CACHE_MAX_SIZE / 16) + 1];  /* smallest bin that fits, by (size + 15) / 16 */
+    SDL_SpinLock lock[CACHE_NUM_BINS];
+    cache_bin shared[CACHE_NUM_BINS];
+} s_cache = { PTHREAD_ONCE_INIT };
+
+/* Give a chain of up to count blocks from the front of a bin to the shared bin, or to dlmalloc */
+static void
+cache_release_blocks(cache_bin *bin, int index, int count)
+{
+    cache_block *first = bin->head;
+    cache_block *last = first;
+    int moved;
+
+    if (!first) {
+        return;
+    }
+    for (moved = 1; moved < count && last->next; ++moved) {
+        last = last->next;
+    }
+    bin->head = last->next;
+    bin->count -= moved;
+
+    SDL_AtomicLock(&s_cache.lock[index]);
+    if (s_cache.shared[index].count + moved <= CACHE_SHARED_BLOCKS) {
+        last->next = s_cache.shared[index].head;
+        s_cache.shared[index].head = first;
+        s_cache.shared[index].count += moved;
+        first = NULL;
+    }
+    SDL_AtomicUnlock(&s_cache.lock[index]);
+
+    last->next = NULL;
+    while (first) {
+        cache_block *next = first->next;
+        dlfree(first);
+        first = next;
+    }
+}
+
+static void
+cache_destroy(void *data)
+{
+    thread_cache *cache = (thread_cache *) data;
+    int i;
+
+    for (i = 0; i < CACHE_NUM_BINS; ++i) {
+        while (cache->bins[i].head) {
+            cache_release_blocks(&cache->bins[i], i, CACHE_BATCH_BLOCKS);
+        }
+    }
+    dlfree(cache);
+}
+
+static void
+cache_init(void)
+{
+    int i, index = 0;
+
+    for (i = 0; i < SDL_arraysize(s_cache.bin_for_size); ++i) {
+        while (cache_bin_size[index] < (size_t) i * 16) {
+            ++index;
+        }
+        s_cache.bin_for_size[i] = (Uint8) index;
+    }
+    if (pthread_key_create(&s_cache.key, cache_destroy) == 0) {
+        s_cache.ready = SDL_TRUE;
+    }
+}
+
+static thread_cache *
+cache_get(void)
+{
+    thread_cache *cache;
+
+    pthread_once(&s_cache.once, cache_init);
+    if (!s_cache.ready) {
+        return NULL;
+    }
+
+    cache = (thread_cache *) pthread_getspecific(s_cache.key);
+    if (!cache) {
+        cache = (thread_cache *) dlcalloc(1, sizeof(*cache));
+        if (cache && pthread_setspecific(s_cache.key, cache) != 0) {
+            dlfree(cache);
+            cache = NULL;
+        }
+    }
+    return cache;
+}
+
+static void *
+cache_malloc(size_t size)
+{
+    thread_cache *cache;
+    cache_bin *bin;
+    cache_block *block;
+    int index;
+
+    if (size > CACHE_MAX_SIZE || (cache = cache_get()) == NULL) {
+        return dlmalloc(size);
+    }
+
+    index = s_cache.bin_for_size[(size + 15) / 16];
+    bin = &cache->bins[index];
+    if (!bin->head && s_cache.shared[index].head) {
+        /* Take a batch of blocks that other threads gave up */
+        SDL_AtomicLock(&s_cache.lock[index]);
+        while (bin->count < CACHE_BATCH_BLOCKS && s_cache.shared[index].head) {
+            block = s_cache.shared[index].head;
+            s_cache.shared[index].head = block->next;
+            --s_cache.shared[index].count;
+            block->next = bin->head;
+            bin->head = block;
+            ++bin->count;
+        }
+        SDL_AtomicUnlock(&s_cache.lock[index]);
+    }
+
+    block = bin->head;
+    if (!block) {
+        /* Allocate the whole size class, so the block comes back to this bin */
+        return dlmalloc(cache_bin_size[index]);
+    }
+    bin->head = block->next;
+    --bin->count;
+    return block;
+}
+
+static void *
+cache_calloc(size_t nmemb, size_t size)
+{
+    void *mem;
+
+    if (size && nmemb > CACHE_MAX_SIZE / size) {
+        return dlcalloc(nmemb, size);
+    }
+    mem = cache_malloc(nmemb * size);
+    if (mem) {
+        SDL_memset(mem, 0, nmemb * size);
+    }
+    return mem;
+}
+
+static void
+cache_free(void *mem)
+{
+    const size_t usable = dlmalloc_usable_size(mem);
+    thread_cache *cache;
+    cache_bin *bin;
+    cache_block *block;
+    int index;
+
+    /* Blocks much bigger than the largest bin would waste memory there */
+    if (usable < cache_bin_size[0] || usable >= CACHE_MAX_SIZE + CACHE_MAX_SIZE / 4 ||
+        (cache = cache_get()) == NULL) {
+        dlfree(mem);
+        return;
+    }
+
+    /* The largest bin that the block is big enough for */
+    index = s_cache.bin_for_size[(SDL_min(usable, CACHE_MAX_SIZE) + 15) / 16];
+    if (cache_bin_size[index] > usable) {
+        --index;
+    }
+    bin = &cache->bins[index];
+
+    block = (cache_block *) mem;
+    block->next = bin->head;
+    bin->head = block;
+    if (++bin->count > CACHE_BIN_BLOCKS) {
+        cache_release_blocks(bin, index, CACHE_BATCH_BLOCKS);
+    }
+}
+
+#endif /* SDL_MALLOC_THREAD_CACHE */
+
 #ifdef HAVE_MALLOC
 #define real_malloc malloc
 #define real_calloc calloc
 #define real_realloc realloc
 #define real_free free
+#elif SDL_MALLOC_THREAD_CACHE
+#define real_malloc cache_malloc
+#define real_calloc cache_calloc
+#define real_realloc dlrealloc
+#define real_free cache_free
 #else
 #define real_malloc dlmalloc
 #define real_calloc dlcalloc
@@ -244,7 +244,7 @@ void SDLTest_LogAllocations()
 
     SDL_strlcpy(line, "Memory allocations:\n", sizeof(line));
     ADD_LINE();
-    SDL_strlcpy(line, "Expect 2 allocations from within SDL_GetErrBuf()\n", sizeof(line));
+    SDL_strlcpy(line, "Expect up to 2 allocations from within SDL_GetErrBuf()\n", sizeof(line));
     ADD_LINE();
 
     count = 0;
@@ -0,0 +1,881 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* A work-stealing job system.
+
+   Each worker thread owns a Chase-Lev deque: it pushes and pops its own jobs
+   at the bottom without taking locks, and idle workers steal the oldest jobs
+   from the top with a compare-and-swap. Threads that aren't workers submit
+   through a shared queue. Idle threads spin for a little while looking for
+   work and then sleep on a condition variable.
+
+   Only one sleeping worker is woken at a time: once it finds a job, it
+   wakes the next one if there's more work. This keeps a burst of small jobs
+   from waking every worker for every job.
+
+   One extra deque has no thread of its own. A thread that isn't a worker
+   borrows it while it waits for jobs, so the jobs it helps out with can
+   push their children without going through the shared queue.
+ */
+
+#include "SDL_thread.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_systhread.h"
+
+#define SDL_JOB_DEQUE_SIZE  256     /* initial size, must be a power of two */
+#define SDL_JOB_SPIN_COUNT  64      /* times to look for work before sleeping */
+#define SDL_JOB_BLOCK_SIZE  64      /* jobs allocated at a time */
+
+struct SDL_Job
+{
+    SDL_JobSystem *system;
+    SDL_JobFunction func;
+    void *data;
+    SDL_ParallelForFunction for_func;   /* set for SDL_ParallelFor() ranges */
+    int for_start;
+    int for_end;
+    int for_grain;
+    SDL_Job *parent;
+    SDL_atomic_t unfinished;    /* the job itself plus its unfinished children */
+    SDL_atomic_t refcount;      /* the scheduler plus the caller's handle */
+    SDL_atomic_t waiting;       /* threads sleeping in SDL_WaitJob() on this job */
+    SDL_Job *next;              /* in the shared queue or a free list */
+};
+
+typedef struct SDL_JobBlock
+{
+    struct SDL_JobBlock *next;
+    SDL_Job jobs[SDL_JOB_BLOCK_SIZE];
+} SDL_JobBlock;
+
+typedef struct SDL_JobArray
+{
+    int size;                   /* a power of two */
+    struct SDL_JobArray *retired;
+    SDL_Job *jobs[1];
+} SDL_JobArray;
+
+typedef struct SDL_JobDeque
+{
+    SDL_atomic_t top;           /* advanced by thieves */
+    char pad[SDL_CACHELINE_SIZE - sizeof(SDL_atomic_t)];
+    SDL_atomic_t bottom;        /* only written by the owner */
+    SDL_JobArray *array;        /* only replaced by the owner */
+} SDL_JobDeque;
+
+typedef struct SDL_JobWorker
+{
+    SDL_JobSystem *system;
+    SDL_Thread *thread;
+    Uint32 seed;                /* for picking victims to steal from */
+    SDL_Job *free_jobs;         /* only touched by this worker */
+    SDL_JobBlock *blocks;       /* allocated by this worker */
+    SDL_JobDeque deque;
+} SDL_JobWorker;
+
+struct SDL_JobSystem
+{
+    SDL_JobWorker **workers;
+    int num_workers;
+    int num_threads;            /* workers whose thread started */
+    SDL_JobWorker *helper;      /* the deque without a thread */
+    SDL_atomic_t helper_busy;
+    SDL_bool waiters_help;      /* whether other threads run jobs while they wait */
+    SDL_atomic_t shutdown;
+
+    /* Jobs submitted by threads that aren't workers */
+    SDL_SpinLock queue_lock;
+    SDL_Job *queue_head;
+    SDL_Job *queue_tail;
+
+    /* Jobs released by threads that aren't workers */
+    SDL_SpinLock free_lock;
+    SDL_Job *free_jobs;
+    SDL_JobBlock *blocks;       /* allocated by threads that aren't workers */
+
+    /* Idle workers sleep on work_cond and SDL_WaitJob() on done_cond */
+    SDL_mutex *sleep_lock;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    SDL_atomic_t sleepers;      /* idle workers */
+    SDL_atomic_t waking;        /* set while a woken worker hasn't found work yet */
+    SDL_atomic_t waiters;       /* threads sleeping in SDL_WaitJob() */
+    int spin_count;
+};
+
+static SDL_SpinLock SDL_job_tls_lock;
+static SDL_TLSID SDL_job_worker_tls;
+
+/* The Chase-Lev deque. The indices grow without bound and wrap around, so
+   they're compared through unsigned differences. */
+static int
+SDL_JobDequeSize(int bottom, int top)
+{
+    return (int) ((Uint32) bottom - (Uint32) top);
+}
+
+static SDL_JobArray *
+SDL_CreateJobArray(int size)
+{
+    SDL_JobArray *array = (SDL_JobArray *) SDL_malloc(sizeof(*array) + (size - 1) * sizeof(SDL_Job *));
+    if (array) {
+        array->size = size;
+        array->retired = NULL;
+    }
+    return array;
+}
+
+static SDL_bool
+SDL_PushJobDeque(SDL_JobDeque *deque, SDL_Job *job)
+{
+    const int bottom = SDL_AtomicGet(&deque->bottom);
+    const int top = SDL_AtomicGet(&deque->top);
+    SDL_JobArray *array = deque->array;
+
+    if (SDL_JobDequeSize(bottom, top) >= array->size) {
+        /* Move to a bigger array. Thieves may still be reading the old one,
+           so it's kept until the job system is destroyed. */
+        SDL_JobArray *bigger = SDL_CreateJobArray(array->size * 2);
+        int i;
+
+        if (!bigger) {
+            return SDL_FALSE;
+        }
+        for (i = top; i != bottom; i = (int) ((Uint32) i + 1)) {
+            bigger->jobs[i & (bigger->size - 1)] = array->jobs[i & (array->size - 1)];
+        }
+        bigger->retired = array;
+        array = bigger;
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSetPtr((void **) &deque->array, array);
+    }
+
+    array->jobs[bottom & (array->size - 1)] = job;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&deque->bottom, (int) ((Uint32) bottom + 1));
+    return SDL_TRUE;
+}
+
+static SDL_Job *
+SDL_PopJobDeque(SDL_JobDeque *deque)
+{
+    int bottom, top, size;
+    SDL_Job *job;
+
+    /* Only the owner changes the bottom and the top only grows, so this
+       can't miss a job, and it saves the barrier when there's nothing */
+    if (SDL_JobDequeSize(deque->bottom.value, SDL_AtomicGet(&deque->top)) <= 0) {
+        return NULL;
+    }
+
+    /* SDL_AtomicAdd() is a full barrier, so the new bottom is visible to
+       thieves before we look at the top. */
+    bottom = (int) ((Uint32) SDL_AtomicAdd(&deque->bottom, -1) - 1);
+    top = SDL_AtomicGet(&deque->top);
+    size = SDL_JobDequeSize(bottom, top);
+
+    if (size < 0) {
+        /* It was empty */
+        SDL_AtomicSet(&deque->bottom, top);
+        return NULL;
+    }
+
+    job = deque->array->jobs[bottom & (deque->array->size - 1)];
+    if (size > 0) {
+        return job;
+    }
+
+    /* This is the last job, race the thieves for it */
+    if (!SDL_AtomicCAS(&deque->top, top, (int) ((Uint32) top + 1))) {
+        job = NULL;
+    }
+    SDL_AtomicSet(&deque->bottom, (int) ((Uint32) top + 1));
+    return job;
+}
+
+static SDL_Job *
+SDL_StealJobDeque(SDL_JobDeque *deque)
+{
+    const int top = SDL_AtomicGet(&deque->top);
+    const int bottom = SDL_AtomicGet(&deque->bottom);
+    SDL_JobArray *array;
+    SDL_Job *job;
+
+    if (SDL_JobDequeSize(bottom, top) <= 0) {
+        return NULL;
+    }
+
+    array = (SDL_JobArray *) SDL_AtomicGetPtr((void **) &deque->array);
+    job = array->jobs[top & (array->size - 1)];
+    if (!SDL_AtomicCAS(&deque->top, top, (int) ((Uint32) top + 1))) {
+        /* Another thread got it first */
+        return NULL;
+    }
+    return job;
+}
+
+/* Whether any deque or the shared queue has a job waiting in it */
+static SDL_bool
+SDL_JobsQueued(SDL_JobSystem *jobs)
+{
+    int i;
+
+    if (SDL_AtomicGetPtr((void **) &jobs->queue_head)) {
+        return SDL_TRUE;
+    }
+    for (i = 0; i < jobs->num_workers; i++) {
+        SDL_JobDeque *deque = &jobs->workers[i]->deque;
+        if (SDL_JobDequeSize(SDL_AtomicGet(&deque->bottom), SDL_AtomicGet(&deque->top)) > 0) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static SDL_JobWorker *
+SDL_GetCurrentJobWorker(SDL_JobSystem *jobs)
+{
+    SDL_JobWorker *worker = (SDL_JobWorker *) SDL_TLSGet(SDL_job_worker_tls);
+    if (worker && worker->system == jobs) {
+        return worker;
+    }
+    return NULL;
+}
+
+/* Allocates a block of jobs, returning them linked into a free list */
+static SDL_JobBlock *
+SDL_CreateJobBlock(void)
+{
+    SDL_JobBlock *block = (SDL_JobBlock *) SDL_malloc(sizeof(*block));
+    int i;
+
+    if (!block) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    for (i = 0; i < SDL_JOB_BLOCK_SIZE - 1; i++) {
+        block->jobs[i].next = &block->jobs[i + 1];
+    }
+    block->jobs[i].next = NULL;
+    return block;
+}
+
+static SDL_Job *
+SDL_AllocJob(SDL_JobSystem *jobs, SDL_JobWorker *worker)
+{
+    SDL_Job *job;
+
+    if (worker) {
+        if (!worker->free_jobs && jobs->free_jobs) {
+            /* Take everything the other threads have released */
+            SDL_AtomicLock(&jobs->free_lock);
+            worker->free_jobs = jobs->free_jobs;
+            jobs->free_jobs = NULL;
+            SDL_AtomicUnlock(&jobs->free_lock);
+        }
+        if (!worker->free_jobs) {
+            SDL_JobBlock *block = SDL_CreateJobBlock();
+            if (!block) {
+                return NULL;
+            }
+            block->next = worker->blocks;
+            worker->blocks = block;
+            worker->free_jobs = block->jobs;
+        }
+        job = worker->free_jobs;
+        worker->free_jobs = job->next;
+    } else {
+        SDL_AtomicLock(&jobs->free_lock);
+        job = jobs->free_jobs;
+        if (job) {
+            jobs->free_jobs = job->next;
+        }
+        SDL_AtomicUnlock(&jobs->free_lock);
+
+        if (!job) {
+            SDL_JobBlock *block = SDL_CreateJobBlock();
+            if (!block) {
+                return NULL;
+            }
+            job = block->jobs;
+            SDL_AtomicLock(&jobs->free_lock);
+            block->next = jobs->blocks;
+            jobs->blocks = block;
+            block->jobs[SDL_JOB_BLOCK_SIZE - 1].next = jobs->free_jobs;
+            jobs->free_jobs = job->next;
+            SDL_AtomicUnlock(&jobs->free_lock);
+        }
+    }
+
+    /* Nobody else can see the job yet, so no atomics are needed here */
+    SDL_zerop(job);
+    job->system = jobs;
+    job->unfinished.value = 1;
+    job->refcount.value = 2;
+    return job;
+}
+
+static void
+SDL_FreeJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    SDL_JobSystem *jobs = job->system;
+
+    if (worker) {
+        job->next = worker->free_jobs;
+        worker->free_jobs = job;
+    } else {
+        SDL_AtomicLock(&jobs->free_lock);
+        job->next = jobs->free_jobs;
+        jobs->free_jobs = job;
+        SDL_AtomicUnlock(&jobs->free_lock);
+    }
+}
+
+static void
+SDL_ReleaseJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    /* Nobody can take a new reference, so if we hold the last one there's
+       no need for the atomic decrement. That's the case for detached jobs. */
+    if (SDL_AtomicGet(&job->refcount) == 1 || SDL_AtomicDecRef(&job->refcount)) {
+        SDL_FreeJob(worker, job);
+    }
+}
+
+static void
+SDL_WakeJobWorker(SDL_JobSystem *jobs)
+{
+    if (SDL_AtomicGet(&jobs->sleepers) > 0 && SDL_AtomicCAS(&jobs->waking, 0, 1)) {
+        SDL_LockMutex(jobs->sleep_lock);
+        if (SDL_AtomicGet(&jobs->sleepers) > 0) {
+            SDL_CondSignal(jobs->work_cond);
+        } else {
+            /* They all got up in the meantime, so nobody would clear it */
+            SDL_AtomicSet(&jobs->waking, 0);
+        }
+        SDL_UnlockMutex(jobs->sleep_lock);
+    }
+}
+
+static void
+SDL_WakeJobWaiters(SDL_JobSystem *jobs)
+{
+    SDL_LockMutex(jobs->sleep_lock);
+    SDL_CondBroadcast(jobs->done_cond);
+    SDL_UnlockMutex(jobs->sleep_lock);
+}
+
+static void SDL_RunJob(SDL_JobWorker *worker, SDL_Job *job);
+
+static void
+SDL_ScheduleJob(SDL_JobSystem *jobs, SDL_JobWorker *worker, SDL_Job *job)
+{
+    if (jobs->num_threads == 0) {
+        /* No threads, run it right away */
+        SDL_RunJob(NULL, job);
+        return;
+    }
+
+    if (!worker || !SDL_PushJobDeque(&worker->deque, job)) {
+        job->next = NULL;
+        SDL_AtomicLock(&jobs->queue_lock);
+        if (jobs->queue_tail) {
+            jobs->queue_tail->next = job;
+        } else {
+            /* A full barrier, like pushing onto a deque */
+            SDL_AtomicSetPtr((void **) &jobs->queue_head, job);
+        }
+        jobs->queue_tail = job;
+        SDL_AtomicUnlock(&jobs->queue_lock);
+    }
+
+    /* Pushing the job was a full barrier, so either we see a worker that
+       went to sleep, or it sees the job before it sleeps */
+    SDL_WakeJobWorker(jobs);
+
+    /* A worker that submits a job runs it later itself if nobody else
+       does, so blocked waiters only need to hear about jobs from other
+       threads. That keeps them from being woken for every child job. */
+    if (!worker && SDL_AtomicGet(&jobs->waiters) > 0) {
+        SDL_WakeJobWaiters(jobs);
+    }
+}
+
+/* Lends the helper deque to the calling thread if nobody else has it */
+static SDL_JobWorker *
+SDL_BorrowJobHelper(SDL_JobSystem *jobs, void **prev)
+{
+    if (jobs->helper && jobs->num_threads > 0 && SDL_AtomicCAS(&jobs->helper_busy, 0, 1)) {
+        *prev = SDL_TLSGet(SDL_job_worker_tls);
+        if (SDL_TLSSet(SDL_job_worker_tls, jobs->helper, NULL) == 0) {
+            return jobs->helper;
+        }
+        SDL_AtomicSet(&jobs->helper_busy, 0);
+    }
+    return NULL;
+}
+
+static void
+SDL_ReturnJobHelper(SDL_JobSystem *jobs, void *prev)
+{
+    /* Jobs left in the deque are stolen by the workers, or popped by
+       whoever borrows it next */
+    SDL_TLSSet(SDL_job_worker_tls, prev, NULL);
+    SDL_AtomicSet(&jobs->helper_busy, 0);
+}
+
+static SDL_Job *
+SDL_FindJob(SDL_JobSystem *jobs, SDL_JobWorker *worker)
+{
+    SDL_Job *job = NULL;
+    int i;
+
+    if (worker) {
+        job = SDL_PopJobDeque(&worker->deque);
+    }
+
+    if (!job && jobs->queue_head) {
+        SDL_AtomicLock(&jobs->queue_lock);
+        job = jobs->queue_head;
+        if (job) {
+            jobs->queue_head = job->next;
+            if (!jobs->queue_head) {
+                jobs->queue_tail = NULL;
+            }
+        }
+        SDL_AtomicUnlock(&jobs->queue_lock);
+    }
+
+    /* num_threads is still being counted while the first workers start
+       looking for jobs, so go by num_workers, which is already final */
+    if (!job && jobs->num_workers > 0) {
+        /* Steal from the other workers, starting at a random one */
+        int victim;
+        if (worker) {
+            worker->seed = worker->seed * 1103515245 + 12345;
+            victim = (int) ((worker->seed >> 16) % (Uint32) jobs->num_workers);
+        } else {
+            victim = 0;
+        }
+        for (i = 0; i < jobs->num_workers && !job; i++) {
+            SDL_JobWorker *other = jobs->workers[(victim + i) % jobs->num_workers];
+            if (other != worker) {
+                job = SDL_StealJobDeque(&other->deque);
+            }
+        }
+    }
+
+    return job;
+}
+
+static void
+SDL_FinishJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    while (job && SDL_AtomicAdd(&job->unfinished, -1) == 1) {
+        SDL_Job *parent = job->parent;
+
+        if (SDL_AtomicGet(&job->waiting) > 0) {
+            SDL_WakeJobWaiters(job->system);
+        }
+        SDL_ReleaseJob(worker, job);
+        job = parent;
+    }
+}
+
+static SDL_bool
+SDL_SubmitRange(SDL_JobWorker *worker, SDL_Job *root, int start, int end)
+{
+    SDL_Job *job = SDL_AllocJob(root->system, worker);
+
+    if (!job) {
+        return SDL_FALSE;
+    }
+    job->for_func = root->for_func;
+    job->data = root->data;
+    job->for_start = start;
+    job->for_end = end;
+    job->for_grain = root->for_grain;
+    job->parent = root;
+    job->refcount.value = 1;    /* nobody holds a handle */
+    SDL_AtomicIncRef(&root->unfinished);
+    SDL_ScheduleJob(root->system, worker, job);
+    return SDL_TRUE;
+}
+
+static void
+SDL_RunJob(SDL_JobWorker *worker, SDL_Job *job)
+{
+    if (job->for_func) {
+        /* Hand off the upper halves of the range, largest first, so
+           thieves take big pieces and split them further themselves. */
+        SDL_Job *root = job->parent ? job->parent : job;
+        int start = job->for_start;
+        int end = job->for_end;
+
+        while ((Sint64) end - start > job->for_grain) {
+            const int mid = (int) (start + ((Sint64) end - start) / 2);
+            if (!SDL_SubmitRange(worker, root, mid, end)) {
+                break;
+            }
+            end = mid;
+        }
+        job->for_func(start, end, job->data);
+    } else {
+        job->func(job, job->data);
+    }
+    SDL_FinishJob(worker, job);
+}
+
+static int SDLCALL
+SDL_JobWorkerThread(void *data)
+{
+    SDL_JobWorker *worker = (SDL_JobWorker *) data;
+    SDL_JobSystem *jobs = worker->system;
+    SDL_bool woken = SDL_FALSE;
+    int spins = 0;
+
+    SDL_TLSSet(SDL_job_worker_tls, worker, NULL);
+
+    for (;;) {
+        SDL_bool done;
+        SDL_Job *job = SDL_FindJob(jobs, worker);
+
+        if (job) {
+            if (woken) {
+                /* Pass the wakeup on if there's more to do */
+                woken = SDL_FALSE;
+                SDL_AtomicSet(&jobs->waking, 0);
+                if (SDL_JobsQueued(jobs)) {
+                    SDL_WakeJobWorker(jobs);
+                }
+            }
+            SDL_RunJob(worker, job);
+            spins = 0;
+            continue;
+        }
+        if (++spins < jobs->spin_count) {
+            continue;
+        }
+        spins = 0;
+
+        if (woken) {
+            woken = SDL_FALSE;
+            SDL_AtomicSet(&jobs->waking, 0);
+        }
+
+        /* Only wait once: if the job we were woken for is gone by the time
+           we look, we still have to clear the waking flag on the way back */
+        SDL_LockMutex(jobs->sleep_lock);
+        SDL_AtomicIncRef(&jobs->sleepers);
+        if (!SDL_JobsQueued(jobs) && !SDL_AtomicGet(&jobs->shutdown)) {
+            SDL_CondWait(jobs->work_cond, jobs->sleep_lock);
+        }
+        (void)SDL_AtomicDecRef(&jobs->sleepers);
+        done = (SDL_AtomicGet(&jobs->shutdown) && !SDL_JobsQueued(jobs)) ? SDL_TRUE : SDL_FALSE;
+        SDL_UnlockMutex(jobs->sleep_lock);
+
+        if (done) {
+            break;
+        }
+        woken = SDL_TRUE;
+    }
+
+    SDL_TLSSet(SDL_job_worker_tls, NULL, NULL);
+    return 0;
+}
+
+SDL_JobSystem *
+SDL_CreateJobSystem(int num_threads)
+{
+    SDL_JobSystem *jobs;
+    int i;
+
+    if (num_threads <= 0) {
+        num_threads = SDL_max(SDL_GetCPUCount() - 1, 1);
+    }
+
+    if (!SDL_job_worker_tls) {
+        SDL_AtomicLock(&SDL_job_tls_lock);
+        if (!SDL_job_worker_tls) {
+            SDL_job_worker_tls = SDL_TLSCreate();
+        }
+        SDL_AtomicUnlock(&SDL_job_tls_lock);
+        if (!SDL_job_worker_tls) {
+            return NULL;
+        }
+    }
+
+    jobs = (SDL_JobSystem *) SDL_calloc(1, sizeof(*jobs));
+    if (!jobs) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    jobs->workers = (SDL_JobWorker **) SDL_calloc(num_threads + 1, sizeof(*jobs->workers));
+    jobs->sleep_lock = SDL_CreateMutex();
+    jobs->work_cond = SDL_CreateCond();
+    jobs->done_cond = SDL_CreateCond();
+    if (!jobs->workers || !jobs->sleep_lock || !jobs->work_cond || !jobs->done_cond) {
+        if (!jobs->workers) {
+            SDL_OutOfMemory();
+        }
+        SDL_DestroyJobSystem(jobs);
+        return NULL;
+    }
+
+    /* Spinning only helps if the thread we wait for can run meanwhile */
+    jobs->spin_count = (SDL_GetCPUCount() > 1) ? SDL_JOB_SPIN_COUNT : 1;
+
+    for (i = 0; i < num_threads + 1; i++) {
+        SDL_JobWorker *worker = (SDL_JobWorker *) SDL_calloc(1, sizeof(*worker));
+        if (!worker) {
+            break;
+        }
+        worker->deque.array = SDL_CreateJobArray(SDL_JOB_DEQUE_SIZE);
+        if (!worker->deque.array) {
+            SDL_free(worker);
+            break;
+        }
+        worker->system = jobs;
+        worker->seed = (Uint32) i * 2654435761u + 1;
+        jobs->workers[jobs->num_workers++] = worker;
+    }
+
+    /* The last deque is the helper, which doesn't get a thread */
+    if (jobs->num_workers > 0) {
+        jobs->helper = jobs->workers[jobs->num_workers - 1];
+    }
+
+    /* The workers that fail to start keep their empty deques, so the list
+       never changes under the running threads. Without any threads,
+       SDL_SubmitJob() just runs the jobs. */
+    for (i = 0; i < jobs->num_workers - 1; i++) {
+        SDL_JobWorker *worker = jobs->workers[i];
+        worker->thread = SDL_CreateThreadInternal(SDL_JobWorkerThread, "SDLJobWorker", 0, worker);
+        if (worker->thread) {
+            jobs->num_threads++;
+        }
+    }
+
+    /* Other threads only run jobs while they wait if there's a CPU left
+       over for them, otherwise they'd just take turns with the workers */
+    jobs->waiters_help = (jobs->num_threads < SDL_GetCPUCount()) ? SDL_TRUE : SDL_FALSE;
+    return jobs;
+}
+
+SDL_Job *
+SDL_SubmitJob(SDL_JobSystem *jobs, SDL_JobFunction func, void *data, SDL_Job *parent)
+{
+    SDL_JobWorker *worker;
+    SDL_Job *job;
+
+    if (!jobs) {
+        SDL_InvalidParamError("jobs");
+        return NULL;
+    }
+    if (!func) {
+        SDL_InvalidParamError("func");
+        return NULL;
+    }
+    if (parent && parent->system != jobs) {
+        SDL_SetError("Parent job belongs to a different job system");
+        return NULL;
+    }
+
+    worker = SDL_GetCurrentJobWorker(jobs);
+    job = SDL_AllocJob(jobs, worker);
+    if (!job) {
+        return NULL;
+    }
+    job->func = func;
+    job->data = data;
+    job->parent = parent;
+    if (parent) {
+        SDL_AtomicIncRef(&parent->unfinished);
+    }
+    SDL_ScheduleJob(jobs, worker, job);
+    return job;
+}
+
+void
+SDL_WaitJob(SDL_Job *job)
+{
+    SDL_JobSystem *jobs;
+    SDL_JobWorker *worker;
+    SDL_JobWorker *borrowed = NULL;
+    void *prev = NULL;
+    SDL_bool helping;
+    int spins = 0;
+
+    if (!job) {
+        return;
+    }
+    jobs = job->system;
+    worker = SDL_GetCurrentJobWorker(jobs);
+    if (worker && worker != jobs->helper) {
+        /* Workers have to keep running jobs, the one we wait for might be
+           in our own deque */
+        helping = SDL_TRUE;
+    } else {
+        helping = jobs->waiters_help;
+        if (helping && !worker && SDL_AtomicGet(&job->unfinished) > 0) {
+            worker = borrowed = SDL_BorrowJobHelper(jobs, &prev);
+        }
+    }
+
+    while (SDL_AtomicGet(&job->unfinished) > 0) {
+        if (helping) {
+            /* Help out instead of just blocking */
+            SDL_Job *other = SDL_FindJob(jobs, worker);
+            if (other) {
+                SDL_RunJob(worker, other);
+                spins = 0;
+                continue;
+            }
+            if (++spins < jobs->spin_count) {
+                continue;
+            }
+            spins = 0;
+        }
+
+        SDL_LockMutex(jobs->sleep_lock);
+        SDL_AtomicIncRef(&jobs->waiters);
+        SDL_AtomicIncRef(&job->waiting);
+        while (SDL_AtomicGet(&job->unfinished) > 0 && (!helping || !SDL_JobsQueued(jobs))) {
+            SDL_CondWait(jobs->done_cond, jobs->sleep_lock);
+        }
+        (void)SDL_AtomicDecRef(&job->waiting);
+        (void)SDL_AtomicDecRef(&jobs->waiters);
+        SDL_UnlockMutex(jobs->sleep_lock);
+    }
+
+    SDL_ReleaseJob(worker, job);
+    if (borrowed) {
+        SDL_ReturnJobHelper(jobs, prev);
+    }
+}
+
+void
+SDL_DetachJob(SDL_Job *job)
+{
+    /* The job has usually not finished yet, and then there's no need to
+       find out which worker's free list it would go on */
+    if (job && SDL_AtomicDecRef(&job->refcount)) {
+        SDL_FreeJob(SDL_GetCurrentJobWorker(job->system), job);
+    }
+}
+
+int
+SDL_ParallelFor(SDL_JobSystem *jobs, int start, int end, int grain, SDL_ParallelForFunction func, void *data)
+{
+    SDL_JobWorker *worker;
+    SDL_JobWorker *borrowed = NULL;
+    void *prev = NULL;
+    SDL_Job *root;
+
+    if (!jobs) {
+        return SDL_InvalidParamError("jobs");
+    }
+    if (!func) {
+        return SDL_InvalidParamError("func");
+    }
+    if (start >= end) {
+        return 0;
+    }
+    if (grain <= 0) {
+        /* A few pieces per thread, so stealing can even out the load */
+        grain = (int) ((((Sint64) end - start) / (4 * (jobs->num_threads + 1))));
+        grain = SDL_max(grain, 1);
+    }
+
+    worker = SDL_GetCurrentJobWorker(jobs);
+    if (!worker) {
+        worker = borrowed = SDL_BorrowJobHelper(jobs, &prev);
+    }
+    root = SDL_AllocJob(jobs, worker);
+    if (!root) {
+        if (borrowed) {
+            SDL_ReturnJobHelper(jobs, prev);
+        }
+        return -1;
+    }
+    root->for_func = func;
+    root->data = data;
+    root->for_start = start;
+    root->for_end = end;
+    root->for_grain = grain;
+
+    /* Run the range here, splitting off the parts other threads can take */
+    SDL_RunJob(worker, root);
+    SDL_WaitJob(root);
+    if (borrowed) {
+        SDL_ReturnJobHelper(jobs, prev);
+    }
+    return 0;
+}
+
+void
+SDL_DestroyJobSystem(SDL_JobSystem *jobs)
+{
+    int i;
+
+    if (!jobs) {
+        return;
+    }
+
+    if (jobs->sleep_lock && jobs->work_cond) {
+        SDL_AtomicSet(&jobs->shutdown, 1);
+        SDL_LockMutex(jobs->sleep_lock);
+        SDL_CondBroadcast(jobs->work_cond);
+        SDL_UnlockMutex(jobs->sleep_lock);
+    }
+
+    for (i = 0; i < jobs->num_workers; i++) {
+        SDL_WaitThread(jobs->workers[i]->thread, NULL);
+    }
+    for (i = 0; i < jobs->num_workers; i++) {
+        SDL_JobWorker *worker = jobs->workers[i];
+        while (worker->blocks) {
+            SDL_JobBlock *block = worker->blocks;
+            worker->blocks = block->next;
+            SDL_free(block);
+        }
+        while (worker->deque.array) {
+            SDL_JobArray *array = worker->deque.array;
+            worker->deque.array = array->retired;
+            SDL_free(array);
+        }
+        SDL_free(worker);
+    }
+    while (jobs->blocks) {
+        SDL_JobBlock *block = jobs->blocks;
+        jobs->blocks = block->next;
+        SDL_free(block);
+    }
+
+    SDL_DestroyCond(jobs->done_cond);
+    SDL_DestroyCond(jobs->work_cond);
+    SDL_DestroyMutex(jobs->sleep_lock);
+    SDL_free(jobs->workers);
+    SDL_free(jobs);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -208,6 +208,11 @@ SDL_GetErrBuf(void)
     /* Non-thread-safe global error variable */
     static SDL_error SDL_global_error;
     return &SDL_global_error;
+#elif defined(SDL_THREAD_LOCAL)
+    /* Errors are set on hot paths, so this shouldn't take a table lookup or
+       an allocation, and the buffer goes away with the thread. */
+    static SDL_THREAD_LOCAL SDL_error SDL_thread_error;
+    return &SDL_thread_error;
 #else
     static SDL_SpinLock tls_lock;
     static SDL_bool tls_being_created;
@@ -46,6 +46,18 @@
 #endif
 #include "../SDL_error_c.h"
 
+/* Compiler supported thread-local variables are much cheaper to reach than
+   SDL_TLSGet(), which has to look up a table through the thread API. */
+#if SDL_THREAD_PTHREAD && !defined(SDL_THREAD_LOCAL)
+#if defined(__clang__)
+#if __has_feature(tls)
+#define SDL_THREAD_LOCAL __thread
+#endif
+#elif defined(__GNUC__) && !defined(__APPLE__)
+#define SDL_THREAD_LOCAL __thread
+#endif
+#endif /* SDL_THREAD_PTHREAD */
+
 typedef enum SDL_ThreadState
 {
     SDL_THREAD_STATE_ALIVE,
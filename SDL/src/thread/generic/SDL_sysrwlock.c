@@ -0,0 +1,166 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+/* An implementation of reader-writer locks using a mutex and a condition variable */
+
+#include "SDL_assert.h"
+#include "SDL_thread.h"
+
+struct SDL_rwlock
+{
+    SDL_mutex *lock;
+    SDL_cond *cond;
+    int readers;
+    SDL_bool writer;
+};
+
+SDL_rwlock *
+SDL_CreateRWLock(void)
+{
+    SDL_rwlock *rwlock;
+
+    rwlock = (SDL_rwlock *) SDL_calloc(1, sizeof(*rwlock));
+    if (!rwlock) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+#if !SDL_THREADS_DISABLED
+    rwlock->lock = SDL_CreateMutex();
+    rwlock->cond = SDL_CreateCond();
+    if (!rwlock->lock || !rwlock->cond) {
+        SDL_DestroyRWLock(rwlock);
+        return NULL;
+    }
+#endif
+    return rwlock;
+}
+
+void
+SDL_DestroyRWLock(SDL_rwlock * rwlock)
+{
+    if (rwlock) {
+        if (rwlock->cond) {
+            SDL_DestroyCond(rwlock->cond);
+        }
+        if (rwlock->lock) {
+            SDL_DestroyMutex(rwlock->lock);
+        }
+        SDL_free(rwlock);
+    }
+}
+
+static int
+SDL_LockRWLock_generic(SDL_rwlock * rwlock, SDL_bool writing, SDL_bool block)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    int retval = 0;
+
+    if (rwlock == NULL) {
+        return SDL_InvalidParamError("rwlock");
+    }
+
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    /* Readers only wait for an active writer, so a steady stream of readers
+       can hold off a writer for a while. That suits the read-mostly data
+       these locks are meant for. */
+    while (rwlock->writer || (writing && rwlock->readers > 0)) {
+        if (!block) {
+            retval = SDL_MUTEX_TIMEDOUT;
+            break;
+        }
+        SDL_CondWait(rwlock->cond, rwlock->lock);
+    }
+    if (retval == 0) {
+        if (writing) {
+            rwlock->writer = SDL_TRUE;
+        } else {
+            ++rwlock->readers;
+        }
+    }
+    SDL_UnlockMutex(rwlock->lock);
+
+    return retval;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+int
+SDL_LockRWLockForReading(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock_generic(rwlock, SDL_FALSE, SDL_TRUE);
+}
+
+int
+SDL_LockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock_generic(rwlock, SDL_TRUE, SDL_TRUE);
+}
+
+int
+SDL_TryLockRWLockForReading(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock_generic(rwlock, SDL_FALSE, SDL_FALSE);
+}
+
+int
+SDL_TryLockRWLockForWriting(SDL_rwlock * rwlock)
+{
+    return SDL_LockRWLock_generic(rwlock, SDL_TRUE, SDL_FALSE);
+}
+
+int
+SDL_UnlockRWLock(SDL_rwlock * rwlock)
+{
+#if SDL_THREADS_DISABLED
+    return 0;
+#else
+    SDL_bool wake;
+
+    if (rwlock == NULL) {
+        return SDL_InvalidParamError("rwlock");
+    }
+
+    if (SDL_LockMutex(rwlock->lock) < 0) {
+        return -1;
+    }
+    if (rwlock->writer) {
+        rwlock->writer = SDL_FALSE;
+        wake = SDL_TRUE;
+    } else {
+        SDL_assert(rwlock->readers > 0);
+        --rwlock->readers;
+        wake = (rwlock->readers == 0) ? SDL_TRUE : SDL_FALSE;
+    }
+    if (wake) {
+        SDL_CondBroadcast(rwlock->cond);
+    }
+    SDL_UnlockMutex(rwlock->lock);
+
+    return 0;
+#endif /* SDL_THREADS_DISABLED */
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -24,15 +24,22 @@
 #include <pthread.h>
 
 #include "SDL_thread.h"
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
 
 #if !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX && \
     !SDL_THREAD_PTHREAD_RECURSIVE_MUTEX_NP
 #define FAKE_RECURSIVE_MUTEX 1
 #endif
 
+/* The most times a contended lock spins before sleeping in the kernel */
+#define SDL_MUTEX_MAX_SPINS 100
+
 struct SDL_mutex
 {
     pthread_mutex_t id;
+    int max_spins;  /* 0 on single CPU systems, where spinning can't help */
+    int spins;      /* running average of how long recent lockers spun */
 #if FAKE_RECURSIVE_MUTEX
     int recursive;
     pthread_t owner;
@@ -48,6 +55,7 @@ SDL_CreateMutex(void)
     /* Allocate the structure */
     mutex = (SDL_mutex *) SDL_calloc(1, sizeof(*mutex));
     if (mutex) {
+        mutex->max_spins = (SDL_GetCPUCount() > 1) ? SDL_MUTEX_MAX_SPINS : 0;
         pthread_mutexattr_init(&attr);
 #if SDL_THREAD_PTHREAD_RECURSIVE_MUTEX
         pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
@@ -76,6 +84,38 @@ SDL_DestroyMutex(SDL_mutex * mutex)
     }
 }
 
+/* Most critical sections are short, so when the mutex is busy it's usually
+   cheaper to retry for a little while than to put the thread to sleep. The
+   spin length adapts to how long the lock recently took to become free, like
+   the glibc PTHREAD_MUTEX_ADAPTIVE_NP mutexes, which can't be recursive.
+ */
+static int
+SDL_LockMutexAdaptive(SDL_mutex * mutex)
+{
+    int spins, max_spins;
+
+    if (pthread_mutex_trylock(&mutex->id) == 0) {
+        return 0;
+    }
+    if (!mutex->max_spins) {
+        return pthread_mutex_lock(&mutex->id);
+    }
+
+    max_spins = SDL_min(mutex->spins * 2 + 10, mutex->max_spins);
+    for (spins = 1; pthread_mutex_trylock(&mutex->id) != 0; ++spins) {
+        if (spins >= max_spins) {
+            int retval = pthread_mutex_lock(&mutex->id);
+            if (retval == 0) {
+                mutex->spins += (spins - mutex->spins) / 8;
+            }
+            return retval;
+        }
+        SDL_CPUPauseInstruction();
+    }
+    mutex->spins += (spins - mutex->spins) / 8;
+    return 0;
+}
+
 /* Lock the mutex */
 int
 SDL_LockMutex(SDL_mutex * mutex)
@@ -97,7 +137,7 @@ SDL_LockMutex(SDL_mutex * mutex)
            We set the locking thread id after we obtain the lock
            so unlocks from other threads will fail.
          */
-        if (pthread_mutex_lock(&mutex->id) == 0) {
+        if (SDL_LockMutexAdaptive(mutex) == 0) {
             mutex->owner = this_thread;
             mutex->recursive = 0;
         } else {
@@ -105,7 +145,7 @@ SDL_LockMutex(SDL_mutex * mutex)
         }
     }
 #else
-    if (pthread_mutex_lock(&mutex->id) != 0) {
+    if (SDL_LockMutexAdaptive(mutex) != 0) {
         return SDL_SetError("pthread_mutex_lock() failed");
     }
 #endif
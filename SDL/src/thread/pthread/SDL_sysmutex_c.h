@@ -26,6 +26,8 @@
 struct SDL_mutex
 {
     pthread_mutex_t id;
+    int max_spins;
+    int spins;
 };
 
 #endif /* SDL_mutex_c_h_ */
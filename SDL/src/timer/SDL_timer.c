@@ -34,26 +34,24 @@ typedef struct _SDL_Timer
 {
     int timerID;
     SDL_TimerCallback callback;
+    SDL_NSTimerCallback callback_ns;
     void *param;
-    Uint32 interval;
-    Uint32 scheduled;
+    Uint64 interval;        /* nanoseconds */
+    Uint64 scheduled;       /* nanoseconds, see SDL_GetTimerTicksNS() */
     SDL_atomic_t canceled;
     struct _SDL_Timer *next;
+    struct _SDL_Timer *map_next;
 } SDL_Timer;
 
-typedef struct _SDL_TimerMap
-{
-    int timerID;
-    SDL_Timer *timer;
-    struct _SDL_TimerMap *next;
-} SDL_TimerMap;
-
-/* The timers are kept in a sorted list */
+/* The timer thread keeps its timers in a binary heap ordered by scheduling
+   time, and SDL_RemoveTimer() finds them through a hash table of IDs. */
 typedef struct {
     /* Data used by the main thread */
     SDL_Thread *thread;
     SDL_atomic_t nextID;
-    SDL_TimerMap *timermap;
+    SDL_Timer **timermap;   /* buckets, a power of two of them */
+    int timermap_size;
+    int timermap_count;
     SDL_mutex *timermap_lock;
 
     /* Padding to separate cache lines between threads */
@@ -65,38 +63,131 @@ typedef struct {
     SDL_Timer *pending;
     SDL_Timer *freelist;
     SDL_atomic_t active;
+    SDL_atomic_t canceled;  /* number of timers canceled since the heap was last cleaned */
 
-    /* List of timers - this is only touched by the timer thread */
-    SDL_Timer *timers;
+    /* Heap of timers - this is only touched by the timer thread */
+    SDL_Timer **heap;
+    int heap_count;
+    int heap_size;
 } SDL_TimerData;
 
 static SDL_TimerData SDL_timer_data;
 
+#define SDL_NS_PER_MS   1000000
+
 /* The idea here is that any thread might add a timer, but a single
  * thread manages the active timer queue, sorted by scheduling time.
  *
- * Timers are removed by simply setting a canceled flag
+ * Timers are removed by simply setting a canceled flag, and the timer
+ * thread drops them when they come due, or all at once when enough of
+ * them pile up.
  */
 
+/* A nanosecond clock based on the performance counter */
+static Uint64
+SDL_GetTimerTicksNS(void)
+{
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    return (counter / frequency) * 1000000000 + ((counter % frequency) * 1000000000) / frequency;
+}
+
 static void
-SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+SDL_TimerHeapSiftUp(SDL_TimerData *data, int i)
 {
-    SDL_Timer *prev, *curr;
+    SDL_Timer *timer = data->heap[i];
 
-    prev = NULL;
-    for (curr = data->timers; curr; prev = curr, curr = curr->next) {
-        if ((Sint32)(timer->scheduled-curr->scheduled) < 0) {
+    while (i > 0) {
+        const int parent = (i - 1) / 2;
+        if (data->heap[parent]->scheduled <= timer->scheduled) {
             break;
         }
+        data->heap[i] = data->heap[parent];
+        i = parent;
     }
+    data->heap[i] = timer;
+}
 
-    /* Insert the timer here! */
-    if (prev) {
-        prev->next = timer;
-    } else {
-        data->timers = timer;
+static void
+SDL_TimerHeapSiftDown(SDL_TimerData *data, int i)
+{
+    SDL_Timer *timer = data->heap[i];
+    const int count = data->heap_count;
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && data->heap[child + 1]->scheduled < data->heap[child]->scheduled) {
+            ++child;
+        }
+        if (timer->scheduled <= data->heap[child]->scheduled) {
+            break;
+        }
+        data->heap[i] = data->heap[child];
+        i = child;
+    }
+    data->heap[i] = timer;
+}
+
+static SDL_bool
+SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
+{
+    if (data->heap_count == data->heap_size) {
+        const int size = data->heap_size ? data->heap_size * 2 : 64;
+        SDL_Timer **heap = (SDL_Timer **)SDL_realloc(data->heap, size * sizeof(*heap));
+        if (!heap) {
+            return SDL_FALSE;
+        }
+        data->heap = heap;
+        data->heap_size = size;
+    }
+
+    data->heap[data->heap_count] = timer;
+    SDL_TimerHeapSiftUp(data, data->heap_count++);
+    return SDL_TRUE;
+}
+
+static SDL_Timer *
+SDL_TimerHeapPop(SDL_TimerData *data)
+{
+    SDL_Timer *timer = data->heap[0];
+
+    if (--data->heap_count > 0) {
+        data->heap[0] = data->heap[data->heap_count];
+        SDL_TimerHeapSiftDown(data, 0);
+    }
+    return timer;
+}
+
+/* Move canceled timers out of the heap to the freelist, so they don't
+   wait there until they come due */
+static void
+SDL_CleanTimerHeap(SDL_TimerData *data, SDL_Timer **freelist_head, SDL_Timer **freelist_tail)
+{
+    int i, count = 0;
+
+    for (i = 0; i < data->heap_count; ++i) {
+        SDL_Timer *timer = data->heap[i];
+        if (SDL_AtomicGet(&timer->canceled)) {
+            timer->next = NULL;
+            if (*freelist_tail) {
+                (*freelist_tail)->next = timer;
+            } else {
+                *freelist_head = timer;
+            }
+            *freelist_tail = timer;
+        } else {
+            data->heap[count++] = timer;
+        }
+    }
+    data->heap_count = count;
+
+    for (i = count / 2 - 1; i >= 0; --i) {
+        SDL_TimerHeapSiftDown(data, i);
     }
-    timer->next = curr;
 }
 
 static int SDLCALL
@@ -105,9 +196,11 @@ SDL_TimerThread(void *_data)
     SDL_TimerData *data = (SDL_TimerData *)_data;
     SDL_Timer *pending;
     SDL_Timer *current;
+    SDL_Timer *deferred = NULL;
     SDL_Timer *freelist_head = NULL;
     SDL_Timer *freelist_tail = NULL;
-    Uint32 tick, now, interval, delay;
+    Uint64 tick, now, interval, delay;
+    SDL_bool precise;
 
     /* Threaded timer loop:
      *  1. Queue timers added by other threads
@@ -129,50 +222,75 @@ SDL_TimerThread(void *_data)
             }
         }
         SDL_AtomicUnlock(&data->lock);
+        freelist_head = NULL;
+        freelist_tail = NULL;
 
-        /* Sort the pending timers into our list */
+        /* Sort the pending timers into our heap, keeping any we don't have room for yet */
+        if (deferred) {
+            current = deferred;
+            while (current->next) {
+                current = current->next;
+            }
+            current->next = pending;
+            pending = deferred;
+            deferred = NULL;
+        }
         while (pending) {
             current = pending;
             pending = pending->next;
-            SDL_AddTimerInternal(data, current);
+            if (!SDL_AddTimerInternal(data, current)) {
+                current->next = deferred;
+                deferred = current;
+            }
         }
-        freelist_head = NULL;
-        freelist_tail = NULL;
 
         /* Check to see if we're still running, after maintenance */
         if (!SDL_AtomicGet(&data->active)) {
             break;
         }
 
+        /* Drop canceled timers once they make up half of the heap */
+        if (SDL_AtomicGet(&data->canceled) > SDL_max(data->heap_count / 2, 64)) {
+            SDL_AtomicSet(&data->canceled, 0);
+            SDL_CleanTimerHeap(data, &freelist_head, &freelist_tail);
+        }
+
         /* Initial delay if there are no timers */
-        delay = SDL_MUTEX_MAXWAIT;
+        delay = (Uint64) SDL_MUTEX_MAXWAIT * SDL_NS_PER_MS;
+        precise = SDL_FALSE;
 
-        tick = SDL_GetTicks();
+        tick = SDL_GetTimerTicksNS();
 
         /* Process all the pending timers for this tick */
-        while (data->timers) {
-            current = data->timers;
+        while (data->heap_count > 0) {
+            current = data->heap[0];
 
-            if ((Sint32)(tick-current->scheduled) < 0) {
+            if (current->scheduled > tick) {
                 /* Scheduled for the future, wait a bit */
                 delay = (current->scheduled - tick);
+                precise = current->callback_ns ? SDL_TRUE : SDL_FALSE;
                 break;
             }
 
             /* We're going to do something with this timer */
-            data->timers = current->next;
+            SDL_TimerHeapPop(data);
 
             if (SDL_AtomicGet(&current->canceled)) {
                 interval = 0;
+            } else if (current->callback_ns) {
+                interval = current->callback_ns(current->interval, current->param);
             } else {
-                interval = current->callback(current->interval, current->param);
+                interval = (Uint64) current->callback((Uint32) (current->interval / SDL_NS_PER_MS), current->param) * SDL_NS_PER_MS;
             }
 
             if (interval > 0) {
                 /* Reschedule this timer */
                 current->interval = interval;
                 current->scheduled = tick + interval;
-                SDL_AddTimerInternal(data, current);
+                if (!SDL_AddTimerInternal(data, current)) {
+                    current->next = deferred;
+                    deferred = current;
+                }
             } else {
                 if (!freelist_head) {
                     freelist_head = current;
@@ -181,13 +299,19 @@ SDL_TimerThread(void *_data)
                     freelist_tail->next = current;
                 }
                 freelist_tail = current;
+                current->next = NULL;
 
                 SDL_AtomicSet(&current->canceled, 1);
             }
         }
 
+        if (deferred) {
+            /* Out of memory, try again soon */
+            delay = SDL_min(delay, SDL_NS_PER_MS);
+        }
+
         /* Adjust the delay based on processing time */
-        now = SDL_GetTicks();
+        now = SDL_GetTimerTicksNS();
         interval = (now - tick);
         if (interval > delay) {
             delay = 0;
@@ -199,8 +323,32 @@ SDL_TimerThread(void *_data)
            immediately, but we process the timers added all at once.
            That's okay, it just means we run through the loop a few
            extra times.
+
+           The semaphore only waits in milliseconds: millisecond timers
+           round their wait up, and nanosecond timers wait for the whole
+           milliseconds and then yield until they're due.
          */
-        SDL_SemWaitTimeout(data->sem, delay);
+        if (delay >= (Uint64) SDL_MUTEX_MAXWAIT * SDL_NS_PER_MS) {
+            SDL_SemWait(data->sem);
+        } else if (!precise) {
+            SDL_SemWaitTimeout(data->sem, (Uint32) ((delay + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS));
+        } else if (delay >= SDL_NS_PER_MS) {
+            SDL_SemWaitTimeout(data->sem, (Uint32) (delay / SDL_NS_PER_MS));
+        } else if (delay > 0 && SDL_SemTryWait(data->sem) != 0) {
+            SDL_Delay(0);
+        }
+    }
+
+    /* Hand back any timers that never made it into the heap */
+    if (deferred) {
+        SDL_AtomicLock(&data->lock);
+        while (deferred) {
+            current = deferred;
+            deferred = deferred->next;
+            current->next = data->freelist;
+            data->freelist = current;
+        }
+        SDL_AtomicUnlock(&data->lock);
     }
     return 0;
 }
@@ -242,7 +390,7 @@ SDL_TimerQuit(void)
 {
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
-    SDL_TimerMap *entry;
+    int i;
 
     if (SDL_AtomicCAS(&data->active, 1, 0)) {  /* active? Move to inactive. */
         /* Shutdown the timer thread */
@@ -256,33 +404,94 @@ SDL_TimerQuit(void)
         data->sem = NULL;
 
         /* Clean up the timer entries */
-        while (data->timers) {
-            timer = data->timers;
-            data->timers = timer->next;
-            SDL_free(timer);
+        for (i = 0; i < data->heap_count; ++i) {
+            SDL_free(data->heap[i]);
         }
+        SDL_free(data->heap);
+        data->heap = NULL;
+        data->heap_count = 0;
+        data->heap_size = 0;
         while (data->freelist) {
             timer = data->freelist;
             data->freelist = timer->next;
             SDL_free(timer);
         }
-        while (data->timermap) {
-            entry = data->timermap;
-            data->timermap = entry->next;
-            SDL_free(entry);
-        }
+        SDL_free(data->timermap);
+        data->timermap = NULL;
+        data->timermap_size = 0;
+        data->timermap_count = 0;
+        SDL_AtomicSet(&data->canceled, 0);
 
         SDL_DestroyMutex(data->timermap_lock);
         data->timermap_lock = NULL;
     }
 }
 
-SDL_TimerID
-SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+/* Find a timer by ID and take it out of the map -- called with timermap_lock held */
+static SDL_Timer *
+SDL_UnmapTimer(SDL_TimerData *data, SDL_TimerID id)
+{
+    SDL_Timer **link;
+
+    if (!data->timermap) {
+        return NULL;
+    }
+
+    for (link = &data->timermap[(Uint32) id & (data->timermap_size - 1)]; *link; link = &(*link)->map_next) {
+        SDL_Timer *timer = *link;
+        if (timer->timerID == id) {
+            *link = timer->map_next;
+            --data->timermap_count;
+            return timer;
+        }
+    }
+    return NULL;
+}
+
+/* Add a timer to the map, growing it to keep about one timer per bucket -- called with timermap_lock held */
+static SDL_bool
+SDL_MapTimer(SDL_TimerData *data, SDL_Timer *timer)
+{
+    SDL_Timer **bucket;
+
+    if (data->timermap_count >= data->timermap_size) {
+        const int size = data->timermap_size ? data->timermap_size * 2 : 64;
+        SDL_Timer **timermap = (SDL_Timer **)SDL_calloc(size, sizeof(*timermap));
+        int i;
+
+        if (!timermap) {
+            if (!data->timermap) {
+                return SDL_FALSE;
+            }
+        } else {
+            /* Timer IDs are sequential, so they spread evenly over the buckets */
+            for (i = 0; i < data->timermap_size; ++i) {
+                while (data->timermap[i]) {
+                    SDL_Timer *entry = data->timermap[i];
+                    data->timermap[i] = entry->map_next;
+                    entry->map_next = timermap[(Uint32) entry->timerID & (size - 1)];
+                    timermap[(Uint32) entry->timerID & (size - 1)] = entry;
+                }
+            }
+            SDL_free(data->timermap);
+            data->timermap = timermap;
+            data->timermap_size = size;
+        }
+    }
+
+    bucket = &data->timermap[(Uint32) timer->timerID & (data->timermap_size - 1)];
+    timer->map_next = *bucket;
+    *bucket = timer;
+    ++data->timermap_count;
+    return SDL_TRUE;
+}
+
+static SDL_TimerID
+SDL_CreateTimer(Uint64 interval, SDL_TimerCallback callback, SDL_NSTimerCallback callback_ns, void *param)
 {
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
-    SDL_TimerMap *entry;
+    SDL_bool mapped;
 
     SDL_AtomicLock(&data->lock);
     if (!SDL_AtomicGet(&data->active)) {
@@ -299,7 +508,10 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     SDL_AtomicUnlock(&data->lock);
 
     if (timer) {
-        SDL_RemoveTimer(timer->timerID);
+        /* The old ID of a recycled timer can't find it anymore */
+        SDL_LockMutex(data->timermap_lock);
+        SDL_UnmapTimer(data, timer->timerID);
+        SDL_UnlockMutex(data->timermap_lock);
     } else {
         timer = (SDL_Timer *)SDL_malloc(sizeof(*timer));
         if (!timer) {
@@ -309,24 +521,20 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     }
     timer->timerID = SDL_AtomicIncRef(&data->nextID);
     timer->callback = callback;
+    timer->callback_ns = callback_ns;
     timer->param = param;
     timer->interval = interval;
-    timer->scheduled = SDL_GetTicks() + interval;
+    timer->scheduled = SDL_GetTimerTicksNS() + interval;
     SDL_AtomicSet(&timer->canceled, 0);
 
-    entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
-    if (!entry) {
+    SDL_LockMutex(data->timermap_lock);
+    mapped = SDL_MapTimer(data, timer);
+    SDL_UnlockMutex(data->timermap_lock);
+    if (!mapped) {
         SDL_free(timer);
         SDL_OutOfMemory();
         return 0;
     }
-    entry->timer = timer;
-    entry->timerID = timer->timerID;
-
-    SDL_LockMutex(data->timermap_lock);
-    entry->next = data->timermap;
-    data->timermap = entry;
-    SDL_UnlockMutex(data->timermap_lock);
 
     /* Add the timer to the pending list for the timer thread */
     SDL_AtomicLock(&data->lock);
@@ -337,38 +545,44 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     /* Wake up the timer thread if necessary */
     SDL_SemPost(data->sem);
 
-    return entry->timerID;
+    return timer->timerID;
+}
+
+SDL_TimerID
+SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    return SDL_CreateTimer((Uint64) interval * SDL_NS_PER_MS, callback, NULL, param);
+}
+
+SDL_TimerID
+SDL_AddTimerNS(Uint64 interval, SDL_NSTimerCallback callback, void *param)
+{
+    return SDL_CreateTimer(interval, NULL, callback, param);
 }
 
 SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
     SDL_TimerData *data = &SDL_timer_data;
-    SDL_TimerMap *prev, *entry;
+    SDL_Timer *timer;
     SDL_bool canceled = SDL_FALSE;
 
+    if (!data->timermap_lock) {
+        return SDL_FALSE;
+    }
+
     /* Find the timer */
     SDL_LockMutex(data->timermap_lock);
-    prev = NULL;
-    for (entry = data->timermap; entry; prev = entry, entry = entry->next) {
-        if (entry->timerID == id) {
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                data->timermap = entry->next;
-            }
-            break;
+    timer = SDL_UnmapTimer(data, id);
+    if (timer) {
+        if (!SDL_AtomicGet(&timer->canceled)) {
+            SDL_AtomicSet(&timer->canceled, 1);
+            SDL_AtomicIncRef(&data->canceled);
+            canceled = SDL_TRUE;
         }
     }
     SDL_UnlockMutex(data->timermap_lock);
 
-    if (entry) {
-        if (!SDL_AtomicGet(&entry->timer->canceled)) {
-            SDL_AtomicSet(&entry->timer->canceled, 1);
-            canceled = SDL_TRUE;
-        }
-        SDL_free(entry);
-    }
     return canceled;
 }
 
@@ -380,6 +594,8 @@ typedef struct _SDL_TimerMap
 {
     int timerID;
     int timeoutID;
+    SDL_NSTimerCallback callback_ns;
+    void *param_ns;
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
@@ -450,6 +666,44 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     return entry->timerID;
 }
 
+/* Browser timeouts are in milliseconds, so nanosecond timers are rounded up to them */
+static Uint32 SDLCALL
+SDL_Emscripten_NSTimerCallback(Uint32 interval, void *param)
+{
+    SDL_TimerMap *entry = (SDL_TimerMap *)param;
+    const Uint64 interval_ns = entry->callback_ns((Uint64) interval * 1000000, entry->param_ns);
+
+    return (Uint32) SDL_min((interval_ns + 999999) / 1000000, 0xFFFFFFFF);
+}
+
+SDL_TimerID
+SDL_AddTimerNS(Uint64 interval, SDL_NSTimerCallback callback, void *param)
+{
+    SDL_TimerData *data = &SDL_timer_data;
+    SDL_TimerMap *entry;
+    const Uint32 interval_ms = (Uint32) SDL_min((interval + 999999) / 1000000, 0xFFFFFFFF);
+
+    entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
+    if (!entry) {
+        SDL_OutOfMemory();
+        return 0;
+    }
+    entry->timerID = ++data->nextID;
+    entry->callback_ns = callback;
+    entry->param_ns = param;
+
+    entry->timeoutID = EM_ASM_INT({
+        return Browser.safeSetTimeout(function() {
+            dynCall('viiii', $0, [$1, $2, $3, $4]);
+        }, $2);
+    }, &SDL_Emscripten_TimerHelper, entry, interval_ms, &SDL_Emscripten_NSTimerCallback, entry);
+
+    entry->next = data->timermap;
+    data->timermap = entry;
+
+    return entry->timerID;
+}
+
 SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
@@ -482,6 +736,166 @@ SDL_RemoveTimer(SDL_TimerID id)
 
 #endif
 
+#if defined(SDL_TIMER_DUMMY) || defined(SDL_TIMERS_DISABLED)
+/* Without a clock there's nothing to wait on, a deadline would never pass. */
+void
+SDL_DelayPrecise(Uint64 ns)
+{
+    SDL_Delay((Uint32) SDL_min(ns / 1000000, SDL_MAX_UINT32));
+}
+#elif !defined(SDL_TIMER_UNIX)
+/* The platforms without their own version sleep through all but the last
+   couple milliseconds, in case SDL_Delay() overshoots by a scheduler
+   quantum, and yield through the rest. */
+void
+SDL_DelayPrecise(Uint64 ns)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const Uint64 deadline = start + (ns / 1000000000) * frequency + ((ns % 1000000000) * frequency) / 1000000000;
+    Uint64 now = start;
+
+    while (now < deadline) {
+        const Uint64 remaining_ms = ((deadline - now) * 1000) / frequency;
+        SDL_Delay((remaining_ms > 2) ? (Uint32) (remaining_ms - 2) : 0);
+        now = SDL_GetPerformanceCounter();
+    }
+}
+#endif
+
+struct SDL_FramePacer
+{
+    Uint64 interval;        /* all times in performance counter ticks */
+    Uint64 deadline;
+    Uint64 last_wake;
+    SDL_FramePacerStats stats;
+    double frame_mean;      /* running mean and variance of the frame time */
+    double frame_m2;
+};
+
+static Uint64
+SDL_FramePacerTicksToNS(Uint64 ticks)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    return (ticks / frequency) * 1000000000 + ((ticks % frequency) * 1000000000) / frequency;
+}
+
+SDL_FramePacer *
+SDL_CreateFramePacer(Uint64 interval_ns)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    SDL_FramePacer *pacer;
+
+    if (interval_ns == 0) {
+        SDL_InvalidParamError("interval_ns");
+        return NULL;
+    }
+
+    pacer = (SDL_FramePacer *) SDL_calloc(1, sizeof(*pacer));
+    if (!pacer) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    pacer->interval = (interval_ns / 1000000000) * frequency + ((interval_ns % 1000000000) * frequency) / 1000000000;
+    pacer->interval = SDL_max(pacer->interval, 1);
+    SDL_ResetFramePacerStats(pacer);
+    return pacer;
+}
+
+Uint64
+SDL_FramePacerWait(SDL_FramePacer *pacer)
+{
+    SDL_FramePacerStats *stats;
+    Uint64 now, frame_ns;
+    double delta;
+
+    if (!pacer) {
+        return 0;
+    }
+    stats = &pacer->stats;
+
+    now = SDL_GetPerformanceCounter();
+    if (pacer->last_wake == 0) {
+        /* The first frame just starts the schedule */
+        pacer->deadline = now;
+        pacer->last_wake = now;
+        return 0;
+    }
+
+    pacer->deadline += pacer->interval;
+    if (now >= pacer->deadline) {
+        stats->missed_frames++;
+    } else {
+        SDL_DelayPrecise(SDL_FramePacerTicksToNS(pacer->deadline - now));
+        now = SDL_GetPerformanceCounter();
+    }
+
+    if (now > pacer->deadline) {
+        const Uint64 late = now - pacer->deadline;
+        stats->wake_late_max_ns = SDL_max(stats->wake_late_max_ns, SDL_FramePacerTicksToNS(late));
+        if (late > pacer->interval / 4) {
+            /* Too far behind, start over from here rather than running
+               short frames to catch up, which would only add jitter. */
+            pacer->deadline = now;
+        }
+    }
+
+    frame_ns = SDL_FramePacerTicksToNS(now - pacer->last_wake);
+    pacer->last_wake = now;
+
+    /* Welford's algorithm, so the variance doesn't need the frame history */
+    stats->frames++;
+    delta = (double) frame_ns - pacer->frame_mean;
+    pacer->frame_mean += delta / (double) stats->frames;
+    pacer->frame_m2 += delta * ((double) frame_ns - pacer->frame_mean);
+
+    stats->frame_min_ns = SDL_min(stats->frame_min_ns, frame_ns);
+    stats->frame_max_ns = SDL_max(stats->frame_max_ns, frame_ns);
+    return frame_ns;
+}
+
+int
+SDL_GetFramePacerStats(SDL_FramePacer *pacer, SDL_FramePacerStats *stats)
+{
+    if (!pacer) {
+        return SDL_InvalidParamError("pacer");
+    }
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_memcpy(stats, &pacer->stats, sizeof(*stats));
+    if (stats->frames == 0) {
+        stats->frame_min_ns = 0;
+    } else {
+        stats->frame_avg_ns = (Uint64) pacer->frame_mean;
+        stats->jitter_ns = (Uint64) SDL_sqrt(pacer->frame_m2 / (double) stats->frames);
+    }
+    return 0;
+}
+
+void
+SDL_ResetFramePacerStats(SDL_FramePacer *pacer)
+{
+    if (!pacer) {
+        return;
+    }
+
+    SDL_zero(pacer->stats);
+    pacer->stats.interval_ns = SDL_FramePacerTicksToNS(pacer->interval);
+    pacer->stats.frame_min_ns = ~(Uint64) 0;
+    pacer->deadline = 0;
+    pacer->last_wake = 0;
+    pacer->frame_mean = 0.0;
+    pacer->frame_m2 = 0.0;
+}
+
+void
+SDL_DestroyFramePacer(SDL_FramePacer *pacer)
+{
+    SDL_free(pacer);
+}
+
 /* This is a legacy support function; SDL_GetTicks() returns a Uint32,
    which wraps back to zero every ~49 days. The newer SDL_GetTicks64()
    doesn't have this problem, so we just wrap that function and clamp to
@@ -29,6 +29,7 @@
 
 #include "SDL_timer.h"
 #include "SDL_hints.h"
+#include "SDL_atomic.h"
 #include "../SDL_timer_c.h"
 
 #ifdef __EMSCRIPTEN__
@@ -234,6 +235,105 @@ SDL_Delay(Uint32 ms)
     } while (was_error && (errno == EINTR));
 }
 
+/* SDL_DelayPrecise() sleeps until a little before the deadline and waits
+   on the clock from there. The margin follows how late the sleeps have been
+   waking up: it jumps up to any overshoot and slowly decays back down.
+   Only the last SDL_PRECISE_DELAY_SPIN of the margin is a busy wait, before
+   that it yields with zero-length sleeps, so a large margin doesn't keep a
+   core busy. */
+#define SDL_PRECISE_DELAY_MIN_SLACK   50000     /* nanoseconds */
+#define SDL_PRECISE_DELAY_MAX_SLACK   4000000
+#define SDL_PRECISE_DELAY_SPIN        200000
+static SDL_atomic_t precise_delay_slack = { 1000000 };
+
+#if HAVE_CLOCK_GETTIME && defined(TIMER_ABSTIME) && !defined(__APPLE__)
+#define SDL_PRECISE_DELAY_ABSTIME
+#endif
+
+static Uint64
+SDL_GetPreciseDelayNS(void)
+{
+#if HAVE_CLOCK_GETTIME
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0) {
+        return ((Uint64) now.tv_sec * 1000000000) + (Uint64) now.tv_nsec;
+    }
+#endif
+    {
+        const Uint64 counter = SDL_GetPerformanceCounter();
+        const Uint64 frequency = SDL_GetPerformanceFrequency();
+        return (counter / frequency) * 1000000000 + ((counter % frequency) * 1000000000) / frequency;
+    }
+}
+
+static void
+SDL_SleepUntilNS(Uint64 now, Uint64 deadline)
+{
+#ifdef SDL_PRECISE_DELAY_ABSTIME
+    struct timespec ts;
+
+    ts.tv_sec = (time_t) (deadline / 1000000000);
+    ts.tv_nsec = (long) (deadline % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Keep sleeping, the deadline doesn't move */
+    }
+#elif HAVE_NANOSLEEP
+    struct timespec ts;
+    const Uint64 ns = deadline - now;
+
+    ts.tv_sec = (time_t) (ns / 1000000000);
+    ts.tv_nsec = (long) (ns % 1000000000);
+    nanosleep(&ts, NULL);
+#else
+    SDL_Delay((Uint32) ((deadline - now) / 1000000));
+#endif
+}
+
+void
+SDL_DelayPrecise(Uint64 ns)
+{
+    Uint64 now, deadline;
+    int slack;
+
+#ifdef __EMSCRIPTEN__
+    if (emscripten_has_asyncify() && SDL_GetHintBoolean(SDL_HINT_EMSCRIPTEN_ASYNCIFY, SDL_TRUE)) {
+        /* The browser can't wait for less than a millisecond anyway */
+        emscripten_sleep((unsigned int) ((ns + 999999) / 1000000));
+        return;
+    }
+#endif
+
+    now = SDL_GetPreciseDelayNS();
+    deadline = now + ns;
+    slack = SDL_AtomicGet(&precise_delay_slack);
+
+    if (ns > (Uint64) slack) {
+        const Uint64 target = deadline - slack;
+        Sint64 overshoot;
+
+        SDL_SleepUntilNS(now, target);
+        now = SDL_GetPreciseDelayNS();
+
+        overshoot = (Sint64) (now - target);
+        if (overshoot > slack) {
+            slack = (int) SDL_min(overshoot, SDL_PRECISE_DELAY_MAX_SLACK);
+        } else {
+            slack -= (int) ((slack - overshoot) / 16);
+            slack = SDL_max(slack, SDL_PRECISE_DELAY_MIN_SLACK);
+        }
+        SDL_AtomicSet(&precise_delay_slack, slack);
+    }
+
+    while (now < deadline) {
+        if ((deadline - now) > SDL_PRECISE_DELAY_SPIN) {
+            SDL_Delay(0);
+        } else {
+            SDL_CPUPauseInstruction();
+        }
+        now = SDL_GetPreciseDelayNS();
+    }
+}
+
 #endif /* SDL_TIMER_UNIX */
 
 /* vi: set ts=4 sw=4 expandtab: */
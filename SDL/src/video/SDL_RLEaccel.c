@@ -62,9 +62,6 @@
  *
  * Encoding of surfaces with per-pixel alpha:
  *
- *   The sequence begins with a struct RLEDestFormat describing the target
- *   pixel format, to provide reliable un-encoding.
- *
  *   Each scan line is encoded twice: First all completely opaque pixels,
  *   encoded in the target format as described above, and then all
  *   partially transparent (translucent) pixels (where 1 <= alpha <= 254),
@@ -85,9 +82,16 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * While a surface is encoded, its pixels are set aside rather than freed, so
+ * locking the surface gives them back unchanged. The encodings for the
+ * destinations the surface was blitted to before are kept in a small cache,
+ * and switching back to one of them doesn't have to encode the surface again.
+ * The cache is dropped whenever the pixels could change.
  */
 
 #include "SDL_video.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
@@ -96,8 +100,67 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* The number of encodings kept for other destinations */
+#define RLE_CACHE_SIZE  4
+
+typedef struct
+{
+    Uint32 flags;               /* SDL_COPY_RLE_COLORKEY or SDL_COPY_RLE_ALPHAKEY */
+    Uint32 key;                 /* the colorkey, or the destination format */
+    void *data;
+} RLEEncoding;
+
+struct SDL_RLECache
+{
+    void *pixels;               /* the surface pixels while it's encoded */
+    RLEEncoding current;        /* what map->data was encoded for */
+    RLEEncoding unused[RLE_CACHE_SIZE];     /* most recently used first */
+};
+
+#ifdef __SSE2__
+/*
+ * Most runs are only a few pixels long, and the call to SDL_memcpy() costs
+ * more than the copy itself. Copy them 16 bytes at a time instead, with
+ * the last (or only) chunk overlapping the one before.
+ */
+static SDL_INLINE void
+RLECopyRunSSE2(Uint8 * to, const Uint8 * from, size_t len)
+{
+    if (len >= 16) {
+        const __m128i last = _mm_loadu_si128((const __m128i *)(from + len - 16));
+        Uint8 *end = to + len - 16;
+        while (to < end) {
+            _mm_storeu_si128((__m128i *)to, _mm_loadu_si128((const __m128i *)from));
+            to += 16;
+            from += 16;
+        }
+        _mm_storeu_si128((__m128i *)end, last);
+    } else if (len >= 8) {
+        const __m128i first = _mm_loadl_epi64((const __m128i *)from);
+        const __m128i last = _mm_loadl_epi64((const __m128i *)(from + len - 8));
+        _mm_storel_epi64((__m128i *)to, first);
+        _mm_storel_epi64((__m128i *)(to + len - 8), last);
+    } else {
+        while (len--) {
+            *to++ = *from++;
+        }
+    }
+}
+
+/* The blitters check for SSE2 once and keep the result in use_sse2 */
+#define PIXEL_COPY(to, from, len, bpp)                                  \
+    do {                                                                \
+        if (use_sse2) {                                                 \
+            RLECopyRunSSE2((Uint8 *)(to), (const Uint8 *)(from),        \
+                           (size_t)(len) * (bpp));                      \
+        } else {                                                        \
+            SDL_memcpy(to, from, (size_t)(len) * (bpp));                \
+        }                                                               \
+    } while(0)
+#else
 #define PIXEL_COPY(to, from, len, bpp)          \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
+#endif /* __SSE2__ */
 
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
@@ -393,6 +456,9 @@ RLEClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             Uint8 * dstbuf, SDL_Rect * srcrect, unsigned alpha)
 {
     SDL_PixelFormat *fmt = surf_dst->format;
+#ifdef __SSE2__
+    const SDL_bool use_sse2 = SDL_HasSSE2();
+#endif
 
 #define RLECLIPBLIT(bpp, Type, do_blit)                         \
     do {                                                        \
@@ -521,6 +587,9 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         RLEClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect, alpha);
     } else {
         SDL_PixelFormat *fmt = surf_src->format;
+#ifdef __SSE2__
+        const SDL_bool use_sse2 = SDL_HasSSE2();
+#endif
 
 #define RLEBLIT(bpp, Type, do_blit)                       \
         do {                                  \
@@ -612,25 +681,63 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
-/* used to save the destination format in the encoding. Designed to be
-   macro-compatible with SDL_PixelFormat but without the unneeded fields */
-typedef struct
+/* blend a run of n translucent pixels, one at a time */
+#define BLIT_TRANSL_RUN(dst, src, n, do_blend)  \
+    do {                                        \
+        int i;                                  \
+        for (i = 0; i < (int)(n); i++)          \
+            do_blend((src)[i], (dst)[i]);       \
+    } while(0)
+
+#ifdef __SSE2__
+/*
+ * BLIT_TRANSL_888, 4 pixels at a time. d + (s - d) * alpha / 256 is the
+ * same as (s * alpha + d * (256 - alpha)) / 256, where both products fit
+ * in 16 bits.
+ */
+static void
+BlitTranslRun888SSE2(Uint32 * dst, const Uint32 * src, int n)
 {
-    Uint8 BytesPerPixel;
-    Uint8 padding[3];
-    Uint32 Rmask;
-    Uint32 Gmask;
-    Uint32 Bmask;
-    Uint32 Amask;
-    Uint8 Rloss;
-    Uint8 Gloss;
-    Uint8 Bloss;
-    Uint8 Aloss;
-    Uint8 Rshift;
-    Uint8 Gshift;
-    Uint8 Bshift;
-    Uint8 Ashift;
-} RLEDestFormat;
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    const __m128i opaque = _mm_set1_epi32(0xff000000);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        /* 2 * alpha in both 16-bit halves of each pixel */
+        __m128i a = _mm_srli_epi32(s, 24);
+        __m128i rb = _mm_and_si128(d, mask);
+        __m128i ga = _mm_srli_epi16(d, 8);
+
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+        a = _mm_add_epi16(a, a);
+        /* Red and blue, then green and alpha, in the low bytes of 16-bit lanes:
+           (s - d) * alpha / 256 is (128 * (s - d)) * (2 * alpha) / 65536 */
+        rb = _mm_add_epi16(rb, _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(_mm_and_si128(s, mask), rb), 7), a));
+        ga = _mm_add_epi16(ga, _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(_mm_srli_epi16(s, 8), ga), 7), a));
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_or_si128(rb, _mm_slli_epi16(ga, 8)), opaque));
+    }
+    BLIT_TRANSL_RUN(dst, src, n, BLIT_TRANSL_888);
+}
+
+#define BLIT_TRANSL_RUN_888(dst, src, n)                        \
+    do {                                                        \
+        if (use_sse2) {                                         \
+            BlitTranslRun888SSE2(dst, src, n);                  \
+        } else {                                                \
+            BLIT_TRANSL_RUN(dst, src, n, BLIT_TRANSL_888);      \
+        }                                                       \
+    } while(0)
+#else
+#define BLIT_TRANSL_RUN_888(dst, src, n)    \
+    BLIT_TRANSL_RUN(dst, src, n, BLIT_TRANSL_888)
+#endif /* __SSE2__ */
+
+#define BLIT_TRANSL_RUN_565(dst, src, n)    \
+    BLIT_TRANSL_RUN(dst, src, n, BLIT_TRANSL_565)
+
+#define BLIT_TRANSL_RUN_555(dst, src, n)    \
+    BLIT_TRANSL_RUN(dst, src, n, BLIT_TRANSL_555)
 
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void
@@ -638,12 +745,15 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
                  Uint8 * dstbuf, SDL_Rect * srcrect)
 {
     SDL_PixelFormat *df = surf_dst->format;
+#ifdef __SSE2__
+    const SDL_bool use_sse2 = SDL_HasSSE2();
+#endif
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the translucent count type, and blend_run the macro
+     * to blend a run of pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, blend_run)             \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -696,13 +806,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             }                             \
             if(crun > right - cofs)               \
             crun = right - cofs;                  \
-            if(crun > 0) {                    \
-            Ptype *dst = (Ptype *)dstbuf + cofs;          \
-            Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
-            }                             \
+            if(crun > 0)                      \
+            blend_run((Ptype *)dstbuf + cofs,             \
+                  (Uint32 *)srcbuf + (cofs - ofs), crun);     \
             srcbuf += run * 4;                    \
             ofs += run;                       \
         }                             \
@@ -714,12 +820,12 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
         break;
     }
 }
@@ -733,6 +839,9 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     int w = surf_src->w;
     Uint8 *srcbuf, *dstbuf;
     SDL_PixelFormat *df = surf_dst->format;
+#ifdef __SSE2__
+    const SDL_bool use_sse2 = SDL_HasSSE2();
+#endif
 
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
@@ -744,7 +853,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) surf_src->map->data + sizeof(RLEDestFormat);
+    srcbuf = (Uint8 *) surf_src->map->data;
 
     {
         /* skip lines at the top if necessary */
@@ -809,10 +918,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the translucent count type, and blend_run the
+         * macro to blend a run of pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, blend_run)                \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -842,14 +951,9 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             run = ((Uint16 *)srcbuf)[1];             \
             srcbuf += 4;                     \
             if(run) {                        \
-            Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            blend_run((Ptype *)dstbuf + ofs,         \
+                  (Uint32 *)srcbuf, run);            \
+            srcbuf += run * 4;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -861,12 +965,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
             break;
         }
     }
@@ -883,9 +987,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
@@ -906,26 +1008,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -964,25 +1046,6 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 /* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
@@ -1000,24 +1063,6 @@ copy_32(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
-static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 #define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
 
 #define ISTRANSL(pixel, fmt)    \
@@ -1092,29 +1137,11 @@ RLEAlphaSurface(SDL_Surface * surface)
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (!rlebuf) {
         return SDL_OutOfMemory();
     }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    dst = rlebuf;
 
     /* Do the actual encoding */
     {
@@ -1220,13 +1247,6 @@ RLEAlphaSurface(SDL_Surface * surface)
 #undef ADD_OPAQUE_COUNTS
 #undef ADD_TRANSL_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
-    }
-
     /* reallocate the buffer to release unused memory */
     {
         Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
@@ -1384,13 +1404,6 @@ RLEColorkeySurface(SDL_Surface * surface)
 
 #undef ADD_COUNTS
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
-    }
-
     /* reallocate the buffer to release unused memory */
     {
         /* If SDL_realloc returns NULL, the original block is left intact */
@@ -1403,10 +1416,41 @@ RLEColorkeySurface(SDL_Surface * surface)
     return 0;
 }
 
+/* Take the encoding made earlier for the same colorkey or destination out of the cache */
+static void *
+RLETakeCached(SDL_RLECache * cache, Uint32 flags, Uint32 key)
+{
+    int i;
+
+    for (i = 0; i < RLE_CACHE_SIZE; i++) {
+        RLEEncoding *entry = &cache->unused[i];
+        if (entry->data && entry->flags == flags && entry->key == key) {
+            void *data = entry->data;
+            SDL_memmove(entry, entry + 1, (RLE_CACHE_SIZE - 1 - i) * sizeof(*entry));
+            SDL_zero(cache->unused[RLE_CACHE_SIZE - 1]);
+            return data;
+        }
+    }
+    return NULL;
+}
+
+/* Keep an encoding that goes out of use, the least recently used one makes room for it */
+static void
+RLEKeepCached(SDL_RLECache * cache, const RLEEncoding * encoding)
+{
+    SDL_free(cache->unused[RLE_CACHE_SIZE - 1].data);
+    SDL_memmove(&cache->unused[1], &cache->unused[0], (RLE_CACHE_SIZE - 1) * sizeof(RLEEncoding));
+    cache->unused[0] = *encoding;
+}
+
 int
 SDL_RLESurface(SDL_Surface * surface)
 {
+    SDL_BlitMap *map = surface->map;
+    SDL_RLECache *cache;
     int flags;
+    Uint32 rle_flags, key;
+    void *data;
 
     /* Clear any previous RLE conversion */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
@@ -1423,7 +1467,7 @@ SDL_RLESurface(SDL_Surface * surface)
         return -1;
     }
 
-    flags = surface->map->info.flags;
+    flags = map->info.flags;
     if (flags & SDL_COPY_COLORKEY) {
         /* ok */
     } else if ((flags & SDL_COPY_BLEND) && surface->format->Amask) {
@@ -1436,158 +1480,119 @@ SDL_RLESurface(SDL_Surface * surface)
     /* Pass on combinations not supported */
     if ((flags & SDL_COPY_MODULATE_COLOR) ||
         ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) ||
+        (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_BLEND_PREMULTIPLIED)) ||
         (flags & SDL_COPY_NEAREST)) {
         return -1;
     }
 
-    /* Encode and set up the blit */
+    /* Colorkey encodings only depend on the colorkey, alpha encodings
+       are in the format of the destination */
     if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
-        if (!surface->map->identity) {
+        if (!map->identity) {
             return -1;
         }
+        rle_flags = SDL_COPY_RLE_COLORKEY;
+        key = map->info.colorkey;
+    } else {
+        if (!map->dst) {
+            return -1;
+        }
+        rle_flags = SDL_COPY_RLE_ALPHAKEY;
+        key = map->dst->format->format;
+    }
+
+    cache = map->rle_cache;
+    if (!cache) {
+        cache = (SDL_RLECache *) SDL_calloc(1, sizeof(*cache));
+        if (!cache) {
+            return SDL_OutOfMemory();
+        }
+        map->rle_cache = cache;
+    }
+
+    /* Encode and set up the blit */
+    data = RLETakeCached(cache, rle_flags, key);
+    if (data) {
+        map->data = data;
+    } else if (rle_flags == SDL_COPY_RLE_COLORKEY) {
         if (RLEColorkeySurface(surface) < 0) {
             return -1;
         }
-        surface->map->blit = SDL_RLEBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_COLORKEY;
     } else {
         if (RLEAlphaSurface(surface) < 0) {
             return -1;
         }
-        surface->map->blit = SDL_RLEAlphaBlit;
-        surface->map->info.flags |= SDL_COPY_RLE_ALPHAKEY;
     }
-
-    /* The surface is now accelerated */
-    surface->flags |= SDL_RLEACCEL;
-
-    return (0);
-}
-
-/*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
- */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
-{
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
+    if (rle_flags == SDL_COPY_RLE_COLORKEY) {
+        map->blit = SDL_RLEBlit;
     } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
+        map->blit = SDL_RLEAlphaBlit;
     }
+    map->info.flags |= rle_flags;
 
-    surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
-    }
-    surface->flags |= SDL_SIMD_ALIGNED;
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
-
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs) {
-                goto end_function;
-            }
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
+    /* Formats without a name can't be told apart, don't keep those */
+    cache->current.flags = (key == SDL_PIXELFORMAT_UNKNOWN && rle_flags == SDL_COPY_RLE_ALPHAKEY) ? 0 : rle_flags;
+    cache->current.key = key;
 
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
+    /* Set the pixels aside until the surface is locked */
+    if (!(surface->flags & SDL_PREALLOC)) {
+        cache->pixels = surface->pixels;
+        surface->pixels = NULL;
     }
 
-end_function:
-    return (SDL_TRUE);
+    /* The surface is now accelerated */
+    surface->flags |= SDL_RLEACCEL;
+
+    return (0);
 }
 
 void
 SDL_UnRLESurface(SDL_Surface * surface, int recode)
 {
     if (surface->flags & SDL_RLEACCEL) {
-        surface->flags &= ~SDL_RLEACCEL;
-
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
+        SDL_BlitMap *map = surface->map;
+        SDL_RLECache *cache = map->rle_cache;
 
-                /* re-create the original surface */
-                surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-                surface->flags |= SDL_SIMD_ALIGNED;
+        surface->flags &= ~SDL_RLEACCEL;
 
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
+        if (cache) {
+            /* Give the pixels back, they never changed */
+            if (cache->pixels) {
+                surface->pixels = cache->pixels;
+                cache->pixels = NULL;
+            }
 
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
+            /* Keep the encoding, if the surface is going to be encoded again */
+            if (recode && map->data && cache->current.flags) {
+                cache->current.data = map->data;
+                RLEKeepCached(cache, &cache->current);
+                map->data = NULL;
             }
+            SDL_zero(cache->current);
         }
-        surface->map->info.flags &=
+        map->info.flags &=
             ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
 
-        SDL_free(surface->map->data);
-        surface->map->data = NULL;
+        SDL_free(map->data);
+        map->data = NULL;
+    }
+}
+
+void
+SDL_FreeRLECache(SDL_BlitMap * map)
+{
+    SDL_RLECache *cache = map->rle_cache;
+    int i;
+
+    /* Surfaces that are encoded still need the pixels that were set aside */
+    if (!cache || cache->pixels) {
+        return;
+    }
+    for (i = 0; i < RLE_CACHE_SIZE; i++) {
+        SDL_free(cache->unused[i].data);
     }
+    SDL_free(cache);
+    map->rle_cache = NULL;
 }
 
 #endif /* SDL_HAVE_RLE */
@@ -27,7 +27,10 @@
 /* Useful functions and variables from SDL_RLEaccel.c */
 
 extern int SDL_RLESurface(SDL_Surface * surface);
+/* recode keeps the encoding for when the surface is encoded again with the same pixels */
 extern void SDL_UnRLESurface(SDL_Surface * surface, int recode);
+/* Drops the kept encodings, once the pixels may change */
+extern void SDL_FreeRLECache(SDL_BlitMap * map);
 
 #endif /* SDL_RLEaccel_c_h_ */
 
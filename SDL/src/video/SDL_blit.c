@@ -28,6 +28,153 @@
 #include "SDL_blit_slow.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
+#include "SDL_mutex.h"
+
+/* Threads for splitting large blits into bands of rows, see SDL_HINT_BLIT_THREADS */
+#define SDL_BLIT_THREADS_MIN_PIXELS_DEFAULT  (512 * 512)
+#define SDL_BLIT_THREADS_MIN_BAND_PIXELS     (64 * 1024)
+
+static SDL_SpinLock SDL_blit_threads_lock;
+static SDL_bool SDL_blit_threads_watched;
+static SDL_atomic_t SDL_blit_threads;
+static SDL_atomic_t SDL_blit_threads_min_pixels;
+
+/* SDL_blit_jobs is replaced while holding SDL_blit_jobs_lock for writing */
+static SDL_rwlock *SDL_blit_jobs_lock;
+static SDL_JobSystem *SDL_blit_jobs;
+static int SDL_blit_jobs_threads;
+
+typedef struct
+{
+    SDL_ParallelForFunction func;
+    void *data;
+    int height;
+    int row_align;
+} SDL_BlitRowsData;
+
+static void SDLCALL
+SDL_BlitThreadsChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_AtomicSet(&SDL_blit_threads, hint ? SDL_atoi(hint) : 0);
+}
+
+static void SDLCALL
+SDL_BlitThreadsMinPixelsChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_AtomicSet(&SDL_blit_threads_min_pixels, (hint && *hint) ? SDL_atoi(hint) : SDL_BLIT_THREADS_MIN_PIXELS_DEFAULT);
+}
+
+static void SDLCALL
+SDL_BlitRowBand(int start, int end, void *data)
+{
+    const SDL_BlitRowsData *rows = (const SDL_BlitRowsData *) data;
+
+    rows->func(start * rows->row_align, SDL_min(end * rows->row_align, rows->height), rows->data);
+}
+
+void
+SDL_BlitRows(int width, int height, int row_align, SDL_ParallelForFunction func, void *data)
+{
+#if !SDL_THREADS_DISABLED
+    SDL_BlitRowsData rows;
+    int threads, bands, grain;
+
+    if (!SDL_blit_threads_watched) {
+        SDL_AtomicLock(&SDL_blit_threads_lock);
+        if (!SDL_blit_threads_watched) {
+            SDL_AddHintCallback(SDL_HINT_BLIT_THREADS, SDL_BlitThreadsChanged, NULL);
+            SDL_AddHintCallback(SDL_HINT_BLIT_THREADS_MIN_PIXELS, SDL_BlitThreadsMinPixelsChanged, NULL);
+            SDL_blit_jobs_lock = SDL_CreateRWLock();
+            SDL_MemoryBarrierRelease();
+            SDL_blit_threads_watched = SDL_TRUE;
+        }
+        SDL_AtomicUnlock(&SDL_blit_threads_lock);
+    }
+
+    threads = SDL_AtomicGet(&SDL_blit_threads);
+    bands = (height + row_align - 1) / row_align;
+    if (threads <= 1 || bands < 2 || !SDL_blit_jobs_lock ||
+        (Sint64) width * height < SDL_AtomicGet(&SDL_blit_threads_min_pixels)) {
+        goto serial;
+    }
+
+    SDL_LockRWLockForReading(SDL_blit_jobs_lock);
+    if (SDL_blit_jobs_threads != threads) {
+        SDL_UnlockRWLock(SDL_blit_jobs_lock);
+        SDL_LockRWLockForWriting(SDL_blit_jobs_lock);
+        if (SDL_blit_jobs_threads != threads) {
+            SDL_DestroyJobSystem(SDL_blit_jobs);
+            SDL_blit_jobs = SDL_CreateJobSystem(threads - 1);
+            SDL_blit_jobs_threads = threads;
+        }
+        SDL_UnlockRWLock(SDL_blit_jobs_lock);
+        SDL_LockRWLockForReading(SDL_blit_jobs_lock);
+    }
+    if (!SDL_blit_jobs || SDL_blit_jobs_threads != threads) {
+        /* Failed to start the threads, or the hint changed again meanwhile */
+        SDL_UnlockRWLock(SDL_blit_jobs_lock);
+        goto serial;
+    }
+
+    /* A few bands per thread so they even out, but not so thin that the
+       jobs cost more than the rows they convert */
+    grain = bands / (4 * threads);
+    grain = SDL_max(grain, SDL_BLIT_THREADS_MIN_BAND_PIXELS / (SDL_max(width, 1) * row_align));
+    grain = SDL_max(grain, 1);
+
+    rows.func = func;
+    rows.data = data;
+    rows.height = height;
+    rows.row_align = row_align;
+    if (SDL_ParallelFor(SDL_blit_jobs, 0, bands, grain, SDL_BlitRowBand, &rows) == 0) {
+        SDL_UnlockRWLock(SDL_blit_jobs_lock);
+        return;
+    }
+    SDL_UnlockRWLock(SDL_blit_jobs_lock);
+
+serial:
+#endif /* !SDL_THREADS_DISABLED */
+    func(0, height, data);
+}
+
+void
+SDL_QuitBlitThreads(void)
+{
+#if !SDL_THREADS_DISABLED
+    if (SDL_blit_threads_watched) {
+        SDL_DelHintCallback(SDL_HINT_BLIT_THREADS, SDL_BlitThreadsChanged, NULL);
+        SDL_DelHintCallback(SDL_HINT_BLIT_THREADS_MIN_PIXELS, SDL_BlitThreadsMinPixelsChanged, NULL);
+        SDL_DestroyJobSystem(SDL_blit_jobs);
+        SDL_blit_jobs = NULL;
+        SDL_blit_jobs_threads = 0;
+        SDL_DestroyRWLock(SDL_blit_jobs_lock);
+        SDL_blit_jobs_lock = NULL;
+        SDL_AtomicSet(&SDL_blit_threads, 0);
+        SDL_blit_threads_watched = SDL_FALSE;
+    }
+#endif
+}
+
+typedef struct
+{
+    SDL_BlitFunc blit;
+    const SDL_BlitInfo *info;
+} SDL_SoftBlitRowsData;
+
+static void SDLCALL
+SDL_SoftBlitRows(int start, int end, void *data)
+{
+    const SDL_SoftBlitRowsData *rows = (const SDL_SoftBlitRowsData *) data;
+    SDL_BlitInfo info = *rows->info;
+
+    info.src += start * info.src_pitch;
+    info.dst += start * info.dst_pitch;
+    info.src_h = end - start;
+    info.dst_h = end - start;
+    rows->blit(&info);
+}
 
 /* The general purpose software blit routine */
 static int SDLCALL
@@ -84,8 +231,18 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
             info->dst_pitch - info->dst_w * info->dst_fmt->BytesPerPixel;
         RunBlit = (SDL_BlitFunc) src->map->data;
 
-        /* Run the actual software blit */
-        RunBlit(info);
+        /* Run the actual software blit, scaled blits step through the
+           source from the top of the destination so they stay in one piece,
+           and blits within the same pixels have to copy the rows in order */
+        if (info->src_w == info->dst_w && info->src_h == info->dst_h &&
+            !SDL_BlitCopyOverlaps(info)) {
+            SDL_SoftBlitRowsData rows;
+            rows.blit = RunBlit;
+            rows.info = info;
+            SDL_BlitRows(info->dst_w, info->dst_h, 1, SDL_SoftBlitRows, &rows);
+        } else {
+            RunBlit(info);
+        }
     }
 
     /* We need to unlock the surfaces if they're locked */
@@ -130,7 +287,7 @@ static SDL_BlitFunc
 SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
                    SDL_BlitFuncEntry * entries)
 {
-    int i, flagcheck = (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_COLORKEY | SDL_COPY_NEAREST));
+    int i, flagcheck = (flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_BLEND_PREMULTIPLIED | SDL_COPY_COLORKEY | SDL_COPY_NEAREST));
     static int features = 0x7fffffff;
 
     /* Get the available CPU features */
@@ -191,49 +348,18 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
 }
 #endif /* SDL_HAVE_BLIT_AUTO */
 
-/* Figure out which of many blit routines to set up on a surface */
-int
-SDL_CalculateBlit(SDL_Surface * surface)
+static SDL_BlitFunc
+SDL_ChooseBlit(SDL_Surface * surface)
 {
     SDL_BlitFunc blit = NULL;
     SDL_BlitMap *map = surface->map;
     SDL_Surface *dst = map->dst;
 
-    /* We don't currently support blitting to < 8 bpp surfaces */
-    if (dst->format->BitsPerPixel < 8) {
-        SDL_InvalidateMap(map);
-        return SDL_SetError("Blit combination not supported");
-    }
-
-#if SDL_HAVE_RLE
-    /* Clean everything out to start */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
-    }
-#endif
-
-    map->blit = SDL_SoftBlit;
-    map->info.src_fmt = surface->format;
-    map->info.src_pitch = surface->pitch;
-    map->info.dst_fmt = dst->format;
-    map->info.dst_pitch = dst->pitch;
-
-#if SDL_HAVE_RLE
-    /* See if we can do RLE acceleration */
-    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
-        if (SDL_RLESurface(surface) == 0) {
-            return 0;
-        }
-    }
-#endif
-
-    /* Choose a standard blit function */
     if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
         blit = SDL_BlitCopy;
     } else if (surface->format->Rloss > 8 || dst->format->Rloss > 8) {
         /* Greater than 8 bits per channel not supported yet */
-        SDL_InvalidateMap(map);
-        return SDL_SetError("Blit combination not supported");
+        return NULL;
     }
 #if SDL_HAVE_BLIT_0
     else if (surface->format->BitsPerPixel < 8 &&
@@ -248,7 +374,7 @@ SDL_CalculateBlit(SDL_Surface * surface)
     }
 #endif
 #if SDL_HAVE_BLIT_A
-    else if (map->info.flags & SDL_COPY_BLEND) {
+    else if (map->info.flags & (SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED)) {
         blit = SDL_CalculateBlitA(surface);
     }
 #endif
@@ -282,6 +408,106 @@ SDL_CalculateBlit(SDL_Surface * surface)
             blit = SDL_Blit_Slow;
         }
     }
+    return blit;
+}
+
+/* The blit function only depends on the two formats, the copy flags, and
+   whether the map is an identity or the destination has a palette, so it
+   is looked up in a small hash table before searching for it */
+#define SDL_BLIT_CACHE_SIZE         256     /* a power of two */
+#define SDL_BLIT_CACHE_IDENTITY     0x80000000
+#define SDL_BLIT_CACHE_DST_PALETTE  0x40000000
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    Uint32 flags;
+    SDL_BlitFunc blit;      /* NULL if the entry is empty */
+} SDL_BlitCacheEntry;
+
+static SDL_SpinLock SDL_blit_cache_lock;
+static SDL_BlitCacheEntry SDL_blit_cache[SDL_BLIT_CACHE_SIZE];
+
+static SDL_BlitCacheEntry *
+SDL_GetBlitCacheEntry(Uint32 src_format, Uint32 dst_format, Uint32 flags)
+{
+    Uint32 hash = src_format * 0x9E3779B1u;
+    hash = (hash ^ dst_format) * 0x85EBCA77u;
+    hash = (hash ^ flags) * 0xC2B2AE3Du;
+    return &SDL_blit_cache[(hash >> 16) & (SDL_BLIT_CACHE_SIZE - 1)];
+}
+
+/* Figure out which of many blit routines to set up on a surface */
+int
+SDL_CalculateBlit(SDL_Surface * surface)
+{
+    SDL_BlitFunc blit = NULL;
+    SDL_BlitMap *map = surface->map;
+    SDL_Surface *dst = map->dst;
+    SDL_BlitCacheEntry *entry;
+    Uint32 src_format, dst_format, flags;
+
+    /* We don't currently support blitting to < 8 bpp surfaces */
+    if (dst->format->BitsPerPixel < 8) {
+        SDL_InvalidateMap(map);
+        return SDL_SetError("Blit combination not supported");
+    }
+
+#if SDL_HAVE_RLE
+    /* Clean everything out to start */
+    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
+        SDL_UnRLESurface(surface, 1);
+    }
+#endif
+
+    map->blit = SDL_SoftBlit;
+    map->info.src_fmt = surface->format;
+    map->info.src_pitch = surface->pitch;
+    map->info.dst_fmt = dst->format;
+    map->info.dst_pitch = dst->pitch;
+
+#if SDL_HAVE_RLE
+    /* See if we can do RLE acceleration */
+    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
+        if (SDL_RLESurface(surface) == 0) {
+            return 0;
+        }
+    }
+    /* The pixels may change while they aren't encoded */
+    SDL_FreeRLECache(map);
+#endif
+
+    /* Choose a standard blit function */
+    src_format = surface->format->format;
+    dst_format = dst->format->format;
+    flags = map->info.flags;
+    if (map->identity) {
+        flags |= SDL_BLIT_CACHE_IDENTITY;
+    }
+    if (dst->format->palette) {
+        flags |= SDL_BLIT_CACHE_DST_PALETTE;
+    }
+    entry = SDL_GetBlitCacheEntry(src_format, dst_format, flags);
+
+    SDL_AtomicLock(&SDL_blit_cache_lock);
+    if (entry->blit && entry->src_format == src_format &&
+        entry->dst_format == dst_format && entry->flags == flags) {
+        blit = entry->blit;
+    }
+    SDL_AtomicUnlock(&SDL_blit_cache_lock);
+
+    if (!blit) {
+        blit = SDL_ChooseBlit(surface);
+        if (blit) {
+            SDL_AtomicLock(&SDL_blit_cache_lock);
+            entry->src_format = src_format;
+            entry->dst_format = dst_format;
+            entry->flags = flags;
+            entry->blit = blit;
+            SDL_AtomicUnlock(&SDL_blit_cache_lock);
+        }
+    }
     map->data = blit;
 
     /* Make sure we have a blit function */
@@ -26,6 +26,8 @@
 #include "SDL_cpuinfo.h"
 #include "SDL_endian.h"
 #include "SDL_surface.h"
+#include "SDL_render.h"
+#include "SDL_thread.h"
 
 /* pixman ARM blitters are 32 bit only : */
 #if defined(__aarch64__)||defined(_M_ARM64)
@@ -45,6 +47,7 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_COPY_MUL                0x00000080
 #define SDL_COPY_COLORKEY           0x00000100
 #define SDL_COPY_NEAREST            0x00000200
+#define SDL_COPY_BLEND_PREMULTIPLIED 0x00000400
 #define SDL_COPY_RLE_DESIRED        0x00001000
 #define SDL_COPY_RLE_COLORKEY       0x00002000
 #define SDL_COPY_RLE_ALPHAKEY       0x00004000
@@ -90,12 +93,16 @@ typedef struct
 } SDL_BlitFuncEntry;
 
 /* Blit mapping definition */
+typedef struct SDL_RLECache SDL_RLECache;
+
 typedef struct SDL_BlitMap
 {
     SDL_Surface *dst;
+    struct SDL_BlitMap *dst_next;   /* the next map in dst->list_blitmap */
     int identity;
     SDL_blit blit;
     void *data;
+    SDL_RLECache *rle_cache;        /* RLE encodings for other destinations */
     SDL_BlitInfo info;
 
     /* the version count matches the destination; mismatch indicates
@@ -106,6 +113,13 @@ typedef struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+/* Calls func for rows [0, height), split into bands that start on a multiple
+   of row_align and run on several threads if SDL_HINT_BLIT_THREADS allows */
+extern void SDL_BlitRows(int width, int height, int row_align, SDL_ParallelForFunction func, void *data);
+extern void SDL_QuitBlitThreads(void);
+
+/* Functions found in SDL_stretch.c */
+extern int SDL_PrivateSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, const SDL_Rect * dstrect, SDL_ScaleMode scaleMode);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
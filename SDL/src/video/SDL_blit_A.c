@@ -1386,6 +1386,227 @@ BlitNtoNPixelAlpha(SDL_BlitInfo * info)
 }
 
 
+/* Premultiplied alpha blending only has to scale the destination:
+   dst = src + dst * (255 - srcA) / 255
+   The sum saturates, in case the colors are brighter than their alpha. */
+
+/* Per-byte x * a / 255, rounded, of the 4 bytes of a pixel */
+#define PREMULTIPLIED_SCALE(x, a, result)                               \
+do {                                                                    \
+    Uint32 lo = ((x) & 0x00FF00FF) * (a) + 0x00800080;                  \
+    Uint32 hi = (((x) >> 8) & 0x00FF00FF) * (a) + 0x00800080;           \
+    lo = ((lo + ((lo >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;           \
+    hi = (hi + ((hi >> 8) & 0x00FF00FF)) & 0xFF00FF00;                  \
+    result = lo | hi;                                                   \
+} while (0)
+
+/* x / 255, rounded, for x up to 255 * 255 */
+#define PREMULTIPLIED_DIV255(x) ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
+
+/* Per-byte saturated x + y */
+#define PREMULTIPLIED_ADD(x, y, result)                                 \
+do {                                                                    \
+    const Uint32 sum = ((x) & 0x7F7F7F7F) + ((y) & 0x7F7F7F7F);         \
+    const Uint32 carry = (((x) & (y)) | (((x) | (y)) & sum)) & 0x80808080; \
+    result = (sum ^ (((x) ^ (y)) & 0x80808080)) | ((carry >> 7) * 0xFF); \
+} while (0)
+
+/* fast (A)RGB8888->(A)RGB8888 blending with premultiplied pixel alpha,
+   for any byte order as long as both sides share it */
+static void
+BlitRGBtoRGBPremultipliedPixelAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const int ashift = info->src_fmt->Ashift;
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP4({
+        Uint32 s = *srcp;
+        Uint32 alpha = (s >> ashift) & 0xFF;
+        if (alpha == SDL_ALPHA_OPAQUE) {
+            *dstp = s;
+        } else if (s) {
+            Uint32 d;
+            PREMULTIPLIED_SCALE(*dstp, alpha ^ 0xFF, d);
+            PREMULTIPLIED_ADD(s, d, *dstp);
+        }
+        ++srcp;
+        ++dstp;
+        }, width);
+        /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* fast ARGB8888->ABGR8888 (or the reverse) blending with premultiplied
+   pixel alpha, swapping red and blue on the way */
+static void
+BlitRGBtoBGRPremultipliedPixelAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP4({
+        Uint32 s = *srcp;
+        Uint32 alpha = s >> 24;
+        if (alpha == SDL_ALPHA_OPAQUE) {
+            *dstp = (s & 0xFF00FF00) | ((s >> 16) & 0xFF) | ((s & 0xFF) << 16);
+        } else if (s) {
+            Uint32 d;
+            s = (s & 0xFF00FF00) | ((s >> 16) & 0xFF) | ((s & 0xFF) << 16);
+            PREMULTIPLIED_SCALE(*dstp, alpha ^ 0xFF, d);
+            PREMULTIPLIED_ADD(s, d, *dstp);
+        }
+        ++srcp;
+        ++dstp;
+        }, width);
+        /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#ifdef __SSE2__
+/* BlitRGBtoRGBPremultipliedPixelAlpha and BlitRGBtoBGRPremultipliedPixelAlpha,
+   4 pixels at a time */
+static void
+BlitRGBtoRGBPremultipliedPixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const int ashift = info->src_fmt->Ashift;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i amask = _mm_set1_epi32((int) (0xFFu << ashift));
+    const __m128i round = _mm_set1_epi16(0x80);
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    const __m128i rbmask = _mm_set1_epi32(0x00FF00FF);
+    const SDL_bool swap = (info->src_fmt->Rmask != info->dst_fmt->Rmask);
+
+    while (height--) {
+        int n = width;
+
+        while (n >= 4) {
+            __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+
+            if (swap) {
+                const __m128i rb = _mm_and_si128(s, rbmask);
+                s = _mm_or_si128(_mm_andnot_si128(rbmask, s),
+                                 _mm_or_si128(_mm_srli_epi32(rb, 16), _mm_slli_epi32(rb, 16)));
+            }
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, amask), amask)) == 0xFFFF) {
+                /* All opaque */
+                _mm_storeu_si128((__m128i *) dstp, s);
+            } else if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) != 0xFFFF) {
+                const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+                /* 255 - alpha in both 16-bit halves of each pixel */
+                __m128i inva = _mm_srl_epi32(_mm_andnot_si128(s, amask), shift);
+                __m128i lo, hi;
+
+                inva = _mm_or_si128(inva, _mm_slli_epi32(inva, 16));
+                lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(inva, inva));
+                hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(inva, inva));
+                /* x / 255, rounded */
+                lo = _mm_add_epi16(lo, round);
+                hi = _mm_add_epi16(hi, round);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+                _mm_storeu_si128((__m128i *) dstp, _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+            }
+            srcp += 4;
+            dstp += 4;
+            n -= 4;
+        }
+        while (n--) {
+            Uint32 s = *srcp;
+            Uint32 alpha = (s >> ashift) & 0xFF;
+            if (swap) {
+                s = (s & 0xFF00FF00) | ((s >> 16) & 0xFF) | ((s & 0xFF) << 16);
+            }
+            if (alpha == SDL_ALPHA_OPAQUE) {
+                *dstp = s;
+            } else if (s) {
+                Uint32 d;
+                PREMULTIPLIED_SCALE(*dstp, alpha ^ 0xFF, d);
+                PREMULTIPLIED_ADD(s, d, *dstp);
+            }
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* __SSE2__ */
+
+/* General (slow) N->N blending with premultiplied pixel alpha */
+static void
+BlitNtoNPremultipliedPixelAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_PixelFormat *dstfmt = info->dst_fmt;
+    int srcbpp;
+    int dstbpp;
+    Uint32 Pixel;
+    unsigned sR, sG, sB, sA;
+    unsigned dR, dG, dB, dA;
+
+    /* Set up some basic variables */
+    srcbpp = srcfmt->BytesPerPixel;
+    dstbpp = dstfmt->BytesPerPixel;
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP4(
+        {
+        DISEMBLE_RGBA(src, srcbpp, srcfmt, Pixel, sR, sG, sB, sA);
+        if (sA == SDL_ALPHA_OPAQUE) {
+            ASSEMBLE_RGBA(dst, dstbpp, dstfmt, sR, sG, sB, sA);
+        } else if (sR | sG | sB | sA) {
+            const unsigned inva = sA ^ 0xFF;
+            DISEMBLE_RGBA(dst, dstbpp, dstfmt, Pixel, dR, dG, dB, dA);
+            dR = sR + PREMULTIPLIED_DIV255(dR * inva);
+            dR = SDL_min(dR, 255);
+            dG = sG + PREMULTIPLIED_DIV255(dG * inva);
+            dG = SDL_min(dG, 255);
+            dB = sB + PREMULTIPLIED_DIV255(dB * inva);
+            dB = SDL_min(dB, 255);
+            dA = sA + PREMULTIPLIED_DIV255(dA * inva);
+            ASSEMBLE_RGBA(dst, dstbpp, dstfmt, dR, dG, dB, dA);
+        }
+        src += srcbpp;
+        dst += dstbpp;
+        },
+        width);
+        /* *INDENT-ON* */
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
 SDL_BlitFunc
 SDL_CalculateBlitA(SDL_Surface * surface)
 {
@@ -1477,6 +1698,36 @@ SDL_CalculateBlitA(SDL_Surface * surface)
         }
         return BlitNtoNPixelAlpha;
 
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        /* Per-pixel alpha blits with premultiplied colors */
+        if (df->BytesPerPixel == 1 && df->palette != NULL) {
+            break;
+        }
+        if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4 &&
+            sf->Rmask == df->Rmask && sf->Gmask == df->Gmask && sf->Bmask == df->Bmask &&
+            sf->Rloss == 0 && sf->Gloss == 0 && sf->Bloss == 0 &&
+            sf->Amask && sf->Aloss == 0 && (sf->Ashift % 8) == 0 &&
+            (!df->Amask || df->Amask == sf->Amask)) {
+#ifdef __SSE2__
+            if (SDL_HasSSE2()) {
+                return BlitRGBtoRGBPremultipliedPixelAlphaSSE2;
+            }
+#endif
+            return BlitRGBtoRGBPremultipliedPixelAlpha;
+        }
+        if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4 &&
+            sf->Rmask == df->Bmask && sf->Gmask == df->Gmask && sf->Bmask == df->Rmask &&
+            sf->Amask == 0xff000000 && (!df->Amask || df->Amask == sf->Amask) &&
+            sf->Gmask == 0x0000ff00 && (sf->Rmask | sf->Bmask) == 0x00ff00ff) {
+#ifdef __SSE2__
+            if (SDL_HasSSE2()) {
+                return BlitRGBtoRGBPremultipliedPixelAlphaSSE2;
+            }
+#endif
+            return BlitRGBtoBGRPremultipliedPixelAlpha;
+        }
+        return BlitNtoNPremultipliedPixelAlpha;
+
     case SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND:
         if (sf->Amask == 0) {
             /* Per-surface alpha blits */
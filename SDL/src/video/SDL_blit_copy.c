@@ -25,14 +25,99 @@
 #include "SDL_blit_copy.h"
 
 
+/* Copies at least this large bypass the cache with non-temporal stores: the
+   destination is usually a framebuffer that is only written, and streaming
+   it would otherwise evict everything else. Smaller copies go through the
+   C runtime's memcpy, which is hard to beat while the data stays cached. */
+#define SDL_BLITCOPY_STREAM_THRESHOLD   (4 * 1024 * 1024)
+
+/* The AVX copy is built with a target attribute and only runs if the CPU has AVX */
+#if defined(__SSE__) && defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX_INTRINSICS 1
+#endif
+#if defined __clang__
+# if (!__has_attribute(target))
+#   undef HAVE_AVX_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX__)
+#   undef HAVE_AVX_INTRINSICS
+# endif
+#elif defined __GNUC__
+# if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#   undef HAVE_AVX_INTRINSICS
+# endif
+#endif
+
+#if HAVE_AVX_INTRINSICS
+/* MSVC will always accept AVX intrinsics when compiling for x64 */
+#if defined(__clang__) || defined(__GNUC__)
+#define SDL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define SDL_TARGET_AVX
+#endif
+
+/* Aligns dst to 32 bytes, src has to be aligned the same way */
+SDL_TARGET_AVX static SDL_INLINE void
+SDL_memcpyAVXStream(Uint8 * dst, const Uint8 * src, int len)
+{
+    int i;
+
+    i = (int) ((32 - ((uintptr_t) dst & 31)) & 31);
+    if (i > len) {
+        i = len;
+    }
+    SDL_memcpy(dst, src, i);
+    dst += i;
+    src += i;
+    len -= i;
+
+    for (i = len / 128; i--;) {
+        const __m256i values0 = _mm256_load_si256((const __m256i *) (src + 0));
+        const __m256i values1 = _mm256_load_si256((const __m256i *) (src + 32));
+        const __m256i values2 = _mm256_load_si256((const __m256i *) (src + 64));
+        const __m256i values3 = _mm256_load_si256((const __m256i *) (src + 96));
+        _mm256_stream_si256((__m256i *) (dst + 0), values0);
+        _mm256_stream_si256((__m256i *) (dst + 32), values1);
+        _mm256_stream_si256((__m256i *) (dst + 64), values2);
+        _mm256_stream_si256((__m256i *) (dst + 96), values3);
+        src += 128;
+        dst += 128;
+    }
+
+    if (len & 127) {
+        SDL_memcpy(dst, src, len & 127);
+    }
+}
+
+SDL_TARGET_AVX static void
+SDL_BlitCopyAVXStream(Uint8 * dst, const Uint8 * src, int w, int h, int dstskip, int srcskip)
+{
+    while (h--) {
+        SDL_memcpyAVXStream(dst, src, w);
+        src += srcskip;
+        dst += dstskip;
+    }
+    _mm_sfence();
+}
+#endif /* HAVE_AVX_INTRINSICS */
+
 #ifdef __SSE__
-/* This assumes 16-byte aligned src and dst */
+/* Aligns dst to 16 bytes, src has to be aligned the same way */
 static SDL_INLINE void
 SDL_memcpySSE(Uint8 * dst, const Uint8 * src, int len)
 {
+    __m128 values[4];
     int i;
 
-    __m128 values[4];
+    i = (int) ((16 - ((uintptr_t) dst & 15)) & 15);
+    if (i > len) {
+        i = len;
+    }
+    SDL_memcpy(dst, src, i);
+    dst += i;
+    src += i;
+    len -= i;
+
     for (i = len / 64; i--;) {
         _mm_prefetch((const char *)src, _MM_HINT_NTA);
         values[0] = *(__m128 *) (src + 0);
@@ -87,10 +172,22 @@ SDL_memcpyMMX(Uint8 * dst, const Uint8 * src, int len)
 }
 #endif /* __MMX__ */
 
+SDL_bool
+SDL_BlitCopyOverlaps(const SDL_BlitInfo * info)
+{
+    const Uint8 *src = info->src;
+    const Uint8 *dst = info->dst;
+
+    if (src < dst) {
+        return (dst < (src + info->dst_h * info->src_pitch));
+    } else {
+        return (src < (dst + info->dst_h * info->dst_pitch));
+    }
+}
+
 void
 SDL_BlitCopy(SDL_BlitInfo * info)
 {
-    SDL_bool overlap;
     Uint8 *src, *dst;
     int w, h;
     int srcskip, dstskip;
@@ -103,15 +200,18 @@ SDL_BlitCopy(SDL_BlitInfo * info)
     dstskip = info->dst_pitch;
 
     /* Properly handle overlapping blits */
-    if (src < dst) {
-        overlap = (dst < (src + h*srcskip));
-    } else {
-        overlap = (src < (dst + h*dstskip));
-    }
-    if (overlap) {
+    if (SDL_BlitCopyOverlaps(info)) {
+        /* Scrolling within the same surface only overlaps between rows, not
+           within them, so it's enough to copy the rows in the right order */
+        const SDL_bool rows_overlap = (srcskip != dstskip || SDL_abs((int) (dst - src)) < w);
+
         if ( dst < src ) {
                 while ( h-- ) {
-                        SDL_memmove(dst, src, w);
+                        if (rows_overlap) {
+                            SDL_memmove(dst, src, w);
+                        } else {
+                            SDL_memcpy(dst, src, w);
+                        }
                         src += srcskip;
                         dst += dstskip;
                 }
@@ -119,7 +219,11 @@ SDL_BlitCopy(SDL_BlitInfo * info)
                 src += ((h-1) * srcskip);
                 dst += ((h-1) * dstskip);
                 while ( h-- ) {
-                        SDL_memmove(dst, src, w);
+                        if (rows_overlap) {
+                            SDL_memmove(dst, src, w);
+                        } else {
+                            SDL_memcpy(dst, src, w);
+                        }
                         src -= srcskip;
                         dst -= dstskip;
                 }
@@ -127,21 +231,34 @@ SDL_BlitCopy(SDL_BlitInfo * info)
         return;
     }
 
+    /* Streaming only pays off when the loads line up with the stores,
+       otherwise half of them straddle two cache lines */
+    if ((size_t) w * h >= SDL_BLITCOPY_STREAM_THRESHOLD) {
+#if HAVE_AVX_INTRINSICS
+        if (SDL_HasAVX() &&
+            ((uintptr_t) src & 31) == ((uintptr_t) dst & 31) && !((srcskip - dstskip) & 31)) {
+            SDL_BlitCopyAVXStream(dst, src, w, h, dstskip, srcskip);
+            return;
+        }
+#endif
+
 #ifdef __SSE__
-    if (SDL_HasSSE() &&
-        !((uintptr_t) src & 15) && !(srcskip & 15) &&
-        !((uintptr_t) dst & 15) && !(dstskip & 15)) {
-        while (h--) {
-            SDL_memcpySSE(dst, src, w);
-            src += srcskip;
-            dst += dstskip;
+        if (SDL_HasSSE() &&
+            ((uintptr_t) src & 15) == ((uintptr_t) dst & 15) && !((srcskip - dstskip) & 15)) {
+            while (h--) {
+                SDL_memcpySSE(dst, src, w);
+                src += srcskip;
+                dst += dstskip;
+            }
+            _mm_sfence();
+            return;
         }
-        return;
-    }
 #endif
+    }
 
 #ifdef __MMX__
-    if (SDL_HasMMX() && !(srcskip & 7) && !(dstskip & 7)) {
+    /* The C runtime's memcpy is faster on anything that has SSE */
+    if (SDL_HasMMX() && !SDL_HasSSE() && !(srcskip & 7) && !(dstskip & 7)) {
         while (h--) {
             SDL_memcpyMMX(dst, src, w);
             src += srcskip;
@@ -23,6 +23,7 @@
 #define SDL_blit_copy_h_
 
 void SDL_BlitCopy(SDL_BlitInfo * info);
+SDL_bool SDL_BlitCopyOverlaps(const SDL_BlitInfo * info);
 
 #endif /* SDL_blit_copy_h_ */
 
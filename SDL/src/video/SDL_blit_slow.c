@@ -107,7 +107,7 @@ SDL_Blit_Slow(SDL_BlitInfo * info)
                     srcB = (srcB * srcA) / 255;
                 }
             }
-            switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+            switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_BLEND_PREMULTIPLIED)) {
             case 0:
                 dstR = srcR;
                 dstG = srcG;
@@ -120,6 +120,19 @@ SDL_Blit_Slow(SDL_BlitInfo * info)
                 dstB = srcB + ((255 - srcA) * dstB) / 255;
                 dstA = srcA + ((255 - srcA) * dstA) / 255;
                 break;
+            case SDL_COPY_BLEND_PREMULTIPLIED:
+                /* The colors are already multiplied by srcA */
+                dstR = srcR + ((255 - srcA) * dstR) / 255;
+                if (dstR > 255)
+                    dstR = 255;
+                dstG = srcG + ((255 - srcA) * dstG) / 255;
+                if (dstG > 255)
+                    dstG = 255;
+                dstB = srcB + ((255 - srcA) * dstB) / 255;
+                if (dstB > 255)
+                    dstB = 255;
+                dstA = srcA + ((255 - srcA) * dstA) / 255;
+                break;
             case SDL_COPY_ADD:
                 dstR = srcR + dstR;
                 if (dstR > 255)
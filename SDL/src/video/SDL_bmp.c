@@ -39,6 +39,9 @@
 
 #define SAVE_32BIT_BMP
 
+/* Pixels are read and written this many bytes at a time, in bands of rows */
+#define BMP_BAND_SIZE   (256 * 1024)
+
 /* Compression encodings for BMP files */
 #ifndef BI_RGB
 #define BI_RGB      0
@@ -175,6 +178,9 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     Sint64 fp_offset = 0;
     int bmpPitch;
     int i, pad;
+    int fileStride, bandRows, bandLeft, rowsLeft;
+    Uint8 *band = NULL;
+    Uint8 *row = NULL;
     SDL_Surface *surface;
     Uint32 Rmask = 0;
     Uint32 Gmask = 0;
@@ -475,7 +481,35 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     } else {
         bits = end - surface->pitch;
     }
+
+    /* Read a band of rows at a time into a buffer, the file has them in the
+       same layout as the surface except for expanded and padded rows */
+    fileStride = (ExpandBMP ? bmpPitch : surface->pitch) + pad;
+    bandRows = SDL_max(1, SDL_min(BMP_BAND_SIZE / fileStride, surface->h));
+    band = (Uint8 *) SDL_malloc((size_t)bandRows * fileStride);
+    if (band == NULL) {
+        SDL_OutOfMemory();
+        was_error = SDL_TRUE;
+        goto done;
+    }
+    bandLeft = 0;
+    rowsLeft = surface->h;
     while (bits >= top && bits < end) {
+        if (bandLeft == 0) {
+            const size_t bandSize = (size_t)SDL_min(bandRows, rowsLeft) * fileStride;
+            /* The padding of the last row may be missing */
+            if (SDL_RWread(src, band, 1, bandSize) + pad < bandSize) {
+                if (ExpandBMP) {
+                    SDL_SetError("Error reading from BMP");
+                } else {
+                    SDL_Error(SDL_EFREAD);
+                }
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            bandLeft = SDL_min(bandRows, rowsLeft);
+            row = band;
+        }
         switch (ExpandBMP) {
         case 1:
         case 4:{
@@ -483,11 +517,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
                 int shift = (8 - ExpandBMP);
                 for (i = 0; i < surface->w; ++i) {
                     if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_SetError("Error reading from BMP");
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
+                        pixel = row[i / (8 / ExpandBMP)];
                     }
                     bits[i] = (pixel >> shift);
                     if (bits[i] >= biClrUsed) {
@@ -501,11 +531,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
             break;
 
         default:
-            if (SDL_RWread(src, bits, 1, surface->pitch) != surface->pitch) {
-                SDL_Error(SDL_EFREAD);
-                was_error = SDL_TRUE;
-                goto done;
-            }
+            SDL_memcpy(bits, row, surface->pitch);
             if (biBitCount == 8 && palette && biClrUsed < (1u << biBitCount)) {
                 for (i = 0; i < surface->w; ++i) {
                     if (bits[i] >= biClrUsed) {
@@ -537,13 +563,9 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 #endif
             break;
         }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
-            }
-        }
+        row += fileStride;
+        --bandLeft;
+        --rowsLeft;
         if (topDown) {
             bits += surface->pitch;
         } else {
@@ -554,6 +576,7 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         CorrectAlphaChannel(surface);
     }
   done:
+    SDL_free(band);
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, RW_SEEK_SET);
@@ -569,13 +592,39 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     return (surface);
 }
 
+/* Converts rows y to y + h - 1 of a surface, the same way SDL_ConvertSurface() would */
+static SDL_Surface *
+ConvertRows(SDL_Surface * surface, int y, int h, const SDL_PixelFormat * format)
+{
+    SDL_Surface *rows, *converted;
+
+    rows = SDL_CreateRGBSurfaceWithFormatFrom((Uint8 *) surface->pixels + y * surface->pitch,
+                                              surface->w, h, surface->format->BitsPerPixel,
+                                              surface->pitch, surface->format->format);
+    if (rows == NULL) {
+        return NULL;
+    }
+    if (surface->format->palette) {
+        SDL_SetSurfacePalette(rows, surface->format->palette);
+    }
+    if (surface->map->info.flags & SDL_COPY_COLORKEY) {
+        SDL_SetColorKey(rows, SDL_TRUE, surface->map->info.colorkey);
+    }
+    converted = SDL_ConvertSurface(rows, format, 0);
+    SDL_FreeSurface(rows);
+    return converted;
+}
+
 int
 SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 {
     Sint64 fp_offset;
     int i, pad;
     SDL_Surface *surface;
-    Uint8 *bits;
+    SDL_PixelFormat format;
+    SDL_bool convert = SDL_FALSE;
+    Uint8 *band;
+    int y, bandRows;
     SDL_bool save32bit = SDL_FALSE;
     SDL_bool saveLegacyBMP = SDL_FALSE;
 
@@ -641,20 +690,18 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             ) {
             surface = saveme;
         } else {
-            SDL_PixelFormat format;
-
             /* If the surface has a colorkey or alpha channel we'll save a
-               32-bit BMP with alpha channel, otherwise save a 24-bit BMP. */
+               32-bit BMP with alpha channel, otherwise save a 24-bit BMP.
+               The rows are converted a band at a time while writing them,
+               rather than making a converted copy of the whole surface. */
             if (save32bit) {
                 SDL_InitFormat(&format, SDL_PIXELFORMAT_BGRA32);
             } else {
                 SDL_InitFormat(&format, SDL_PIXELFORMAT_BGR24);
             }
-            surface = SDL_ConvertSurface(saveme, &format, 0);
-            if (!surface) {
-                SDL_SetError("Couldn't convert image to %d bpp",
-                             format.BitsPerPixel);
-            }
+            surface = saveme;
+            convert = (saveme->format->format != format.format ||
+                       (saveme->map->info.flags & SDL_COPY_COLORKEY));
         }
     } else {
         /* Set no error here because it may overwrite a more useful message from
@@ -667,7 +714,11 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
     }
 
     if (surface && (SDL_LockSurface(surface) == 0)) {
-        const int bw = surface->w * surface->format->BytesPerPixel;
+        /* The format of the pixels in the file */
+        const SDL_PixelFormat *fmt = convert ? &format : surface->format;
+        const int bw = surface->w * fmt->BytesPerPixel;
+
+        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
 
         /* Set the BMP file header values */
         bfSize = 0;             /* We'll write this when we're done */
@@ -689,13 +740,13 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         biWidth = surface->w;
         biHeight = surface->h;
         biPlanes = 1;
-        biBitCount = surface->format->BitsPerPixel;
+        biBitCount = fmt->BitsPerPixel;
         biCompression = BI_RGB;
-        biSizeImage = surface->h * surface->pitch;
+        biSizeImage = surface->h * (bw + pad);
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
-        if (surface->format->palette) {
-            biClrUsed = surface->format->palette->ncolors;
+        if (fmt->palette) {
+            biClrUsed = fmt->palette->ncolors;
         } else {
             biClrUsed = 0;
         }
@@ -745,12 +796,12 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         }
 
         /* Write the palette (in BGR color order) */
-        if (surface->format->palette) {
+        if (fmt->palette) {
             SDL_Color *colors;
             int ncolors;
 
-            colors = surface->format->palette->colors;
-            ncolors = surface->format->palette->ncolors;
+            colors = fmt->palette->colors;
+            ncolors = fmt->palette->ncolors;
             for (i = 0; i < ncolors; ++i) {
                 SDL_RWwrite(dst, &colors[i].b, 1, 1);
                 SDL_RWwrite(dst, &colors[i].g, 1, 1);
@@ -769,22 +820,47 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
             SDL_Error(SDL_EFSEEK);
         }
 
-        /* Write the bitmap image upside down */
-        bits = (Uint8 *) surface->pixels + (surface->h * surface->pitch);
-        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *) surface->pixels) {
-            bits -= surface->pitch;
-            if (SDL_RWwrite(dst, bits, 1, bw) != bw) {
-                SDL_Error(SDL_EFWRITE);
-                break;
+        /* Write the bitmap image upside down, a band of padded rows at a time.
+           A surface with empty rows has no image data to write. */
+        bandRows = 0;
+        band = NULL;
+        if (bw + pad > 0 && surface->h > 0) {
+            bandRows = SDL_max(1, SDL_min(BMP_BAND_SIZE / (bw + pad), surface->h));
+            band = (Uint8 *) SDL_calloc(bandRows, bw + pad);
+            if (band == NULL) {
+                SDL_OutOfMemory();
             }
-            if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1, 1);
+        }
+        for (y = surface->h; band && y > 0; y -= bandRows) {
+            const int rows = SDL_min(bandRows, y);
+            SDL_Surface *converted = NULL;
+            const Uint8 *bits;
+            int pitch;
+
+            if (convert) {
+                converted = ConvertRows(surface, y - rows, rows, &format);
+                if (converted == NULL) {
+                    SDL_SetError("Couldn't convert image to %d bpp",
+                                 format.BitsPerPixel);
+                    break;
                 }
+                bits = (const Uint8 *) converted->pixels;
+                pitch = converted->pitch;
+            } else {
+                bits = (const Uint8 *) surface->pixels + (y - rows) * surface->pitch;
+                pitch = surface->pitch;
+            }
+            for (i = 0; i < rows; ++i) {
+                SDL_memcpy(band + (rows - 1 - i) * (bw + pad), bits + i * pitch, bw);
+            }
+            SDL_FreeSurface(converted);
+
+            if (SDL_RWwrite(dst, band, bw + pad, rows) != (size_t)rows) {
+                SDL_Error(SDL_EFWRITE);
+                break;
             }
         }
+        SDL_free(band);
 
         /* Write the BMP file size */
         bfSize = (Uint32)(SDL_RWtell(dst) - fp_offset);
@@ -798,9 +874,6 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
 
         /* Close it up.. */
         SDL_UnlockSurface(surface);
-        if (surface != saveme) {
-            SDL_FreeSurface(surface);
-        }
     }
 
     if (freedst && dst) {
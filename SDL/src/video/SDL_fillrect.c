@@ -25,6 +25,11 @@
 #include "SDL_cpuinfo.h"
 
 
+/* Rectangles at least this large are filled with non-temporal stores, so that
+   they don't evict everything else from the cache. Smaller fills are usually
+   drawn over right away and are faster through the cache. */
+#define SDL_FILLRECT_STREAM_THRESHOLD   (4 * 1024 * 1024)
+
 #ifdef __SSE__
 /* *INDENT-OFF* */
 
@@ -47,19 +52,32 @@
 #endif
 
 #define SSE_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
-        p += 64; \
+    if (stream) { \
+        for (i = n / 64; i--;) { \
+            _mm_stream_ps((float *)(p+0), c128); \
+            _mm_stream_ps((float *)(p+16), c128); \
+            _mm_stream_ps((float *)(p+32), c128); \
+            _mm_stream_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
+    } else { \
+        for (i = n / 64; i--;) { \
+            _mm_store_ps((float *)(p+0), c128); \
+            _mm_store_ps((float *)(p+16), c128); \
+            _mm_store_ps((float *)(p+32), c128); \
+            _mm_store_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
     }
 
-#define SSE_END
+#define SSE_END \
+    if (stream) { \
+        _mm_sfence(); \
+    }
 
 #define DEFINE_SSE_FILLRECT(bpp, type) \
-static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+static SDL_INLINE void \
+SDL_FillRect##bpp##SSE_Work(Uint8 *pixels, int pitch, Uint32 color, int w, int h, const SDL_bool stream) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -94,10 +112,22 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
     } \
  \
     SSE_END; \
+} \
+ \
+static void \
+SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    SDL_FillRect##bpp##SSE_Work(pixels, pitch, color, w, h, SDL_FALSE); \
+} \
+ \
+static void \
+SDL_FillRect##bpp##SSEStream(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    SDL_FillRect##bpp##SSE_Work(pixels, pitch, color, w, h, SDL_TRUE); \
 }
 
-static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+static SDL_INLINE void
+SDL_FillRect1SSE_Work(Uint8 *pixels, int pitch, Uint32 color, int w, int h, const SDL_bool stream)
 {
     int i, n;
 
@@ -124,6 +154,18 @@ SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 
     SSE_END;
 }
+
+static void
+SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    SDL_FillRect1SSE_Work(pixels, pitch, color, w, h, SDL_FALSE);
+}
+
+static void
+SDL_FillRect1SSEStream(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    SDL_FillRect1SSE_Work(pixels, pitch, color, w, h, SDL_TRUE);
+}
 /* DEFINE_SSE_FILLRECT(1, Uint8) */
 DEFINE_SSE_FILLRECT(2, Uint16)
 DEFINE_SSE_FILLRECT(4, Uint32)
@@ -131,6 +173,177 @@ DEFINE_SSE_FILLRECT(4, Uint32)
 /* *INDENT-ON* */
 #endif /* __SSE__ */
 
+#ifdef __SSE2__
+/* 24-bit pixels repeat every 48 bytes, which is 3 SSE registers. The pattern
+   is loaded at the phase of the first aligned byte of each row. */
+static SDL_INLINE void
+SDL_FillRect3SSE2_Work(Uint8 *pixels, int pitch, Uint32 color, int w, int h, const SDL_bool stream)
+{
+    /* Also long enough for the rows that are too short for the SSE loop */
+    Uint8 pattern[66];
+    int i;
+
+    for (i = 0; i < (int) sizeof(pattern); i += 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        pattern[i + 0] = (Uint8) (color & 0xFF);
+        pattern[i + 1] = (Uint8) ((color >> 8) & 0xFF);
+        pattern[i + 2] = (Uint8) ((color >> 16) & 0xFF);
+#else
+        pattern[i + 0] = (Uint8) ((color >> 16) & 0xFF);
+        pattern[i + 1] = (Uint8) ((color >> 8) & 0xFF);
+        pattern[i + 2] = (Uint8) (color & 0xFF);
+#endif
+    }
+
+    while (h--) {
+        Uint8 *p = pixels;
+        int n = w * 3;
+        int phase = 0;
+
+        if (n >= 64) {
+            const int adjust = (int) ((16 - ((uintptr_t) p & 15)) & 15);
+            __m128i c0, c1, c2;
+
+            SDL_memcpy(p, pattern, adjust);
+            p += adjust;
+            n -= adjust;
+            phase = adjust % 3;
+
+            c0 = _mm_loadu_si128((const __m128i *) (pattern + phase));
+            c1 = _mm_loadu_si128((const __m128i *) (pattern + phase + 16));
+            c2 = _mm_loadu_si128((const __m128i *) (pattern + phase + 32));
+            if (stream) {
+                for (i = n / 48; i--;) {
+                    _mm_stream_si128((__m128i *) (p + 0), c0);
+                    _mm_stream_si128((__m128i *) (p + 16), c1);
+                    _mm_stream_si128((__m128i *) (p + 32), c2);
+                    p += 48;
+                }
+            } else {
+                for (i = n / 48; i--;) {
+                    _mm_store_si128((__m128i *) (p + 0), c0);
+                    _mm_store_si128((__m128i *) (p + 16), c1);
+                    _mm_store_si128((__m128i *) (p + 32), c2);
+                    p += 48;
+                }
+            }
+            n %= 48;
+        }
+        SDL_memcpy(p, pattern + phase, n);
+        pixels += pitch;
+    }
+
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+static void
+SDL_FillRect3SSE2(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    SDL_FillRect3SSE2_Work(pixels, pitch, color, w, h, SDL_FALSE);
+}
+
+static void
+SDL_FillRect3SSE2Stream(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    SDL_FillRect3SSE2_Work(pixels, pitch, color, w, h, SDL_TRUE);
+}
+#endif /* __SSE2__ */
+
+/* The AVX fills are built with a target attribute and only run if the CPU has AVX */
+#if defined(__SSE__) && defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX_INTRINSICS 1
+#endif
+#if defined __clang__
+# if (!__has_attribute(target))
+#   undef HAVE_AVX_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX__)
+#   undef HAVE_AVX_INTRINSICS
+# endif
+#elif defined __GNUC__
+# if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#   undef HAVE_AVX_INTRINSICS
+# endif
+#endif
+
+#if HAVE_AVX_INTRINSICS
+/* MSVC will always accept AVX intrinsics when compiling for x64 */
+#if defined(__clang__) || defined(__GNUC__)
+#define SDL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define SDL_TARGET_AVX
+#endif
+
+/* Same as the SSE fill, 128 bytes at a time with 32-byte stores.
+   'color' has already been replicated to 32 bits. */
+#define DEFINE_AVX_FILLRECT(bpp, type) \
+SDL_TARGET_AVX static SDL_INLINE void \
+SDL_FillRect##bpp##AVX_Work(Uint8 *pixels, int pitch, Uint32 color, int w, int h, const SDL_bool stream) \
+{ \
+    const __m256i c256 = _mm256_set1_epi32((int) color); \
+    int i, n; \
+ \
+    while (h--) { \
+        Uint8 *p = pixels; \
+        n = w * bpp; \
+ \
+        if (n > 127) { \
+            int adjust = (int) ((32 - ((uintptr_t) p & 31)) & 31); \
+            n -= adjust; \
+            adjust /= bpp; \
+            while (adjust--) { \
+                *((type *) p) = (type) color; \
+                p += bpp; \
+            } \
+            if (stream) { \
+                for (i = n / 128; i--;) { \
+                    _mm256_stream_si256((__m256i *) (p + 0), c256); \
+                    _mm256_stream_si256((__m256i *) (p + 32), c256); \
+                    _mm256_stream_si256((__m256i *) (p + 64), c256); \
+                    _mm256_stream_si256((__m256i *) (p + 96), c256); \
+                    p += 128; \
+                } \
+            } else { \
+                for (i = n / 128; i--;) { \
+                    _mm256_store_si256((__m256i *) (p + 0), c256); \
+                    _mm256_store_si256((__m256i *) (p + 32), c256); \
+                    _mm256_store_si256((__m256i *) (p + 64), c256); \
+                    _mm256_store_si256((__m256i *) (p + 96), c256); \
+                    p += 128; \
+                } \
+            } \
+        } \
+        for (i = (n & 127) / bpp; i--;) { \
+            *((type *) p) = (type) color; \
+            p += bpp; \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    if (stream) { \
+        _mm_sfence(); \
+    } \
+} \
+ \
+SDL_TARGET_AVX static void \
+SDL_FillRect##bpp##AVX(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    SDL_FillRect##bpp##AVX_Work(pixels, pitch, color, w, h, SDL_FALSE); \
+} \
+ \
+SDL_TARGET_AVX static void \
+SDL_FillRect##bpp##AVXStream(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    SDL_FillRect##bpp##AVX_Work(pixels, pitch, color, w, h, SDL_TRUE); \
+}
+
+DEFINE_AVX_FILLRECT(1, Uint8)
+DEFINE_AVX_FILLRECT(2, Uint16)
+DEFINE_AVX_FILLRECT(4, Uint32)
+#endif /* HAVE_AVX_INTRINSICS */
+
 static void
 SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 {
@@ -299,11 +512,11 @@ int
 SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
               Uint32 color)
 {
-    SDL_Rect clipped;
     Uint8 *pixels;
-    const SDL_Rect* rect;
     void (*fill_function)(Uint8 * pixels, int pitch, Uint32 color, int w, int h) = NULL;
-    int i;
+    void (*stream_function)(Uint8 * pixels, int pitch, Uint32 color, int w, int h) = NULL;
+    int clip_x1, clip_y1, clip_x2, clip_y2;
+    int i, bpp;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -365,9 +578,17 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
             {
                 color |= (color << 8);
                 color |= (color << 16);
+#if HAVE_AVX_INTRINSICS
+                if (SDL_HasAVX()) {
+                    fill_function = SDL_FillRect1AVX;
+                    stream_function = SDL_FillRect1AVXStream;
+                    break;
+                }
+#endif
 #ifdef __SSE__
                 if (SDL_HasSSE()) {
                     fill_function = SDL_FillRect1SSE;
+                    stream_function = SDL_FillRect1SSEStream;
                     break;
                 }
 #endif
@@ -378,9 +599,17 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         case 2:
             {
                 color |= (color << 16);
+#if HAVE_AVX_INTRINSICS
+                if (SDL_HasAVX()) {
+                    fill_function = SDL_FillRect2AVX;
+                    stream_function = SDL_FillRect2AVXStream;
+                    break;
+                }
+#endif
 #ifdef __SSE__
                 if (SDL_HasSSE()) {
                     fill_function = SDL_FillRect2SSE;
+                    stream_function = SDL_FillRect2SSEStream;
                     break;
                 }
 #endif
@@ -389,17 +618,31 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
             }
 
         case 3:
-            /* 24-bit RGB is a slow path, at least for now. */
             {
+#ifdef __SSE2__
+                if (SDL_HasSSE2()) {
+                    fill_function = SDL_FillRect3SSE2;
+                    stream_function = SDL_FillRect3SSE2Stream;
+                    break;
+                }
+#endif
                 fill_function = SDL_FillRect3;
                 break;
             }
 
         case 4:
             {
+#if HAVE_AVX_INTRINSICS
+                if (SDL_HasAVX()) {
+                    fill_function = SDL_FillRect4AVX;
+                    stream_function = SDL_FillRect4AVXStream;
+                    break;
+                }
+#endif
 #ifdef __SSE__
                 if (SDL_HasSSE()) {
                     fill_function = SDL_FillRect4SSE;
+                    stream_function = SDL_FillRect4SSEStream;
                     break;
                 }
 #endif
@@ -412,18 +655,31 @@ SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         }
     }
 
+    /* Clip the whole batch against the same bounds */
+    clip_x1 = dst->clip_rect.x;
+    clip_y1 = dst->clip_rect.y;
+    clip_x2 = dst->clip_rect.x + dst->clip_rect.w;
+    clip_y2 = dst->clip_rect.y + dst->clip_rect.h;
+    bpp = dst->format->BytesPerPixel;
+
     for (i = 0; i < count; ++i) {
-        rect = &rects[i];
-        /* Perform clipping */
-        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
+        const SDL_Rect *rect = &rects[i];
+        const int x1 = SDL_max(rect->x, clip_x1);
+        const int y1 = SDL_max(rect->y, clip_y1);
+        const int x2 = SDL_min(rect->x + rect->w, clip_x2);
+        const int y2 = SDL_min(rect->y + rect->h, clip_y2);
+
+        if (rect->w <= 0 || rect->h <= 0 || x1 >= x2 || y1 >= y2) {
             continue;
         }
-        rect = &clipped;
 
-        pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                         rect->x * dst->format->BytesPerPixel;
+        pixels = (Uint8 *) dst->pixels + y1 * dst->pitch + x1 * bpp;
 
-        fill_function(pixels, dst->pitch, color, rect->w, rect->h);
+        if (stream_function && (size_t) (x2 - x1) * (y2 - y1) * bpp >= SDL_FILLRECT_STREAM_THRESHOLD) {
+            stream_function(pixels, dst->pitch, color, x2 - x1, y2 - y1);
+        } else {
+            fill_function(pixels, dst->pitch, color, x2 - x1, y2 - y1);
+        }
     }
 
     /* We're done! */
@@ -496,13 +496,96 @@ SDL_MasksToPixelFormatEnum(int bpp, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask,
     return SDL_PIXELFORMAT_UNKNOWN;
 }
 
+/* The RGB formats are allocated once and never freed, so the common case
+   doesn't need a lock. Formats that aren't in this table use the list. */
+#define SDL_FORMAT_TABLE_SIZE   26
+
+static SDL_PixelFormat format_table[SDL_FORMAT_TABLE_SIZE];
+static SDL_atomic_t format_table_state[SDL_FORMAT_TABLE_SIZE];  /* 0 empty, 1 initializing, 2 ready */
+
 static SDL_PixelFormat *formats;
 static SDL_SpinLock formats_lock = 0;
 
+static int
+SDL_GetFormatTableIndex(Uint32 pixel_format)
+{
+    switch (pixel_format) {
+    case SDL_PIXELFORMAT_RGB332: return 0;
+    case SDL_PIXELFORMAT_XRGB4444: return 1;
+    case SDL_PIXELFORMAT_XBGR4444: return 2;
+    case SDL_PIXELFORMAT_XRGB1555: return 3;
+    case SDL_PIXELFORMAT_XBGR1555: return 4;
+    case SDL_PIXELFORMAT_ARGB4444: return 5;
+    case SDL_PIXELFORMAT_RGBA4444: return 6;
+    case SDL_PIXELFORMAT_ABGR4444: return 7;
+    case SDL_PIXELFORMAT_BGRA4444: return 8;
+    case SDL_PIXELFORMAT_ARGB1555: return 9;
+    case SDL_PIXELFORMAT_RGBA5551: return 10;
+    case SDL_PIXELFORMAT_ABGR1555: return 11;
+    case SDL_PIXELFORMAT_BGRA5551: return 12;
+    case SDL_PIXELFORMAT_RGB565: return 13;
+    case SDL_PIXELFORMAT_BGR565: return 14;
+    case SDL_PIXELFORMAT_RGB24: return 15;
+    case SDL_PIXELFORMAT_BGR24: return 16;
+    case SDL_PIXELFORMAT_XRGB8888: return 17;
+    case SDL_PIXELFORMAT_RGBX8888: return 18;
+    case SDL_PIXELFORMAT_XBGR8888: return 19;
+    case SDL_PIXELFORMAT_BGRX8888: return 20;
+    case SDL_PIXELFORMAT_ARGB8888: return 21;
+    case SDL_PIXELFORMAT_RGBA8888: return 22;
+    case SDL_PIXELFORMAT_ABGR8888: return 23;
+    case SDL_PIXELFORMAT_BGRA8888: return 24;
+    case SDL_PIXELFORMAT_ARGB2101010: return 25;
+    default: return -1;
+    }
+}
+
+static SDL_PixelFormat *
+SDL_AllocTableFormat(int index, Uint32 pixel_format)
+{
+    SDL_PixelFormat *format = &format_table[index];
+    SDL_atomic_t *state = &format_table_state[index];
+
+    while (SDL_AtomicGet(state) != 2) {
+        if (SDL_AtomicCAS(state, 0, 1)) {
+            /* The refcount starts at 1 for us */
+            SDL_InitFormat(format, pixel_format);
+            SDL_MemoryBarrierRelease();
+            SDL_AtomicSet(state, 2);
+            return format;
+        }
+        /* Another thread is filling it in */
+        SDL_CPUPauseInstruction();
+    }
+    SDL_MemoryBarrierAcquire();
+
+    /* A format still in use can't lose its palette, so it just gets another
+       reference. The last one is only dropped under the lock, see below. */
+    for ( ; ; ) {
+        const int refcount = SDL_AtomicGet((SDL_atomic_t *) &format->refcount);
+        if (refcount <= 0) {
+            break;
+        }
+        if (SDL_AtomicCAS((SDL_atomic_t *) &format->refcount, refcount, refcount + 1)) {
+            return format;
+        }
+    }
+
+    SDL_AtomicLock(&formats_lock);
+    SDL_AtomicIncRef((SDL_atomic_t *) &format->refcount);
+    SDL_AtomicUnlock(&formats_lock);
+    return format;
+}
+
 SDL_PixelFormat *
 SDL_AllocFormat(Uint32 pixel_format)
 {
     SDL_PixelFormat *format;
+    const int index = SDL_GetFormatTableIndex(pixel_format);
+
+    if (index >= 0) {
+        return SDL_AllocTableFormat(index, pixel_format);
+    }
 
     SDL_AtomicLock(&formats_lock);
 
@@ -615,6 +698,36 @@ SDL_FreeFormat(SDL_PixelFormat *format)
         return;
     }
 
+    if (format >= &format_table[0] && format < &format_table[SDL_FORMAT_TABLE_SIZE]) {
+        SDL_Palette *palette = NULL;
+
+        for ( ; ; ) {
+            const int refcount = SDL_AtomicGet((SDL_atomic_t *) &format->refcount);
+            if (refcount <= 1) {
+                break;
+            }
+            if (SDL_AtomicCAS((SDL_atomic_t *) &format->refcount, refcount, refcount - 1)) {
+                return;
+            }
+        }
+
+        /* The format stays in the table, but the next user gets it without
+           a palette, just like a newly allocated one. Nobody can take a new
+           reference while we hold the lock, so nobody can set a palette
+           that we would throw away. */
+        SDL_AtomicLock(&formats_lock);
+        if (SDL_AtomicDecRef((SDL_atomic_t *) &format->refcount)) {
+            palette = format->palette;
+            format->palette = NULL;
+        }
+        SDL_AtomicUnlock(&formats_lock);
+
+        if (palette) {
+            SDL_FreePalette(palette);
+        }
+        return;
+    }
+
     SDL_AtomicLock(&formats_lock);
 
     if (--format->refcount > 0) {
@@ -1024,58 +1137,20 @@ SDL_AllocBlitMap(void)
 }
 
 
-typedef struct SDL_ListNode
-{
-    void *entry;
-    struct SDL_ListNode *next;
-} SDL_ListNode;
-
+/* Each map is linked into the list of maps of its destination surface, so
+   that pointing a map at a new destination doesn't allocate anything */
 void
 SDL_InvalidateAllBlitMap(SDL_Surface *surface)
 {
-    SDL_ListNode *l = surface->list_blitmap;
+    SDL_BlitMap *map = (SDL_BlitMap *) surface->list_blitmap;
 
     surface->list_blitmap = NULL;
 
-    while (l) {
-        SDL_ListNode *tmp = l;
-        SDL_InvalidateMap((SDL_BlitMap *)l->entry);
-        l = l->next;
-        SDL_free(tmp);
-    }
-}
-
-static void SDL_ListAdd(SDL_ListNode **head, void *ent);
-static void SDL_ListRemove(SDL_ListNode **head, void *ent);
-
-void
-SDL_ListAdd(SDL_ListNode **head, void *ent)
-{
-    SDL_ListNode *node = SDL_malloc(sizeof (*node));
-
-    if (node == NULL) {
-        SDL_OutOfMemory();
-        return;
-    }
-
-    node->entry = ent;
-    node->next = *head;
-    *head = node;
-}
-
-void
-SDL_ListRemove(SDL_ListNode **head, void *ent)
-{
-    SDL_ListNode **ptr = head;
-
-    while (*ptr) {
-        if ((*ptr)->entry == ent) {
-            SDL_ListNode *tmp = *ptr;
-            *ptr = (*ptr)->next;
-            SDL_free(tmp);
-            return;
-        }
-        ptr = &(*ptr)->next;
+    while (map) {
+        SDL_BlitMap *next = map->dst_next;
+        map->dst = NULL;    /* already unlinked */
+        SDL_InvalidateMap(map);
+        map = next;
     }
 }
 
@@ -1087,9 +1162,17 @@ SDL_InvalidateMap(SDL_BlitMap * map)
     }
     if (map->dst) {
         /* Un-register from the destination surface */
-        SDL_ListRemove((SDL_ListNode **)&(map->dst->list_blitmap), map);
+        SDL_BlitMap **prev = (SDL_BlitMap **) &map->dst->list_blitmap;
+        while (*prev) {
+            if (*prev == map) {
+                *prev = map->dst_next;
+                break;
+            }
+            prev = &(*prev)->dst_next;
+        }
     }
     map->dst = NULL;
+    map->dst_next = NULL;
     map->src_palette_version = 0;
     map->dst_palette_version = 0;
     SDL_free(map->info.table);
@@ -1103,13 +1186,8 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     SDL_PixelFormat *dstfmt;
     SDL_BlitMap *map;
 
-    /* Clear out any previous mapping */
+    /* Clear out any previous mapping, SDL_CalculateBlit() takes care of RLE */
     map = src->map;
-#if SDL_HAVE_RLE
-    if ((src->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(src, 1);
-    }
-#endif
     SDL_InvalidateMap(map);
 
     /* Figure out what kind of mapping we're doing */
@@ -1159,7 +1237,8 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
 
     if (map->dst) {
         /* Register BlitMap to the destination surface, to be invalidated when needed */
-        SDL_ListAdd((SDL_ListNode **)&(map->dst->list_blitmap), map);
+        map->dst_next = (SDL_BlitMap *) dst->list_blitmap;
+        dst->list_blitmap = map;
     }
 
     if (dstfmt->palette) {
@@ -1183,6 +1262,9 @@ SDL_FreeBlitMap(SDL_BlitMap * map)
 {
     if (map) {
         SDL_InvalidateMap(map);
+#if SDL_HAVE_RLE
+        SDL_FreeRLECache(map);
+#endif
         SDL_free(map);
     }
 }
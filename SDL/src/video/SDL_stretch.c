@@ -26,24 +26,24 @@
 
 static int SDL_LowerSoftStretchNearest(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
 static int SDL_LowerSoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
-static int SDL_UpperSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, const SDL_Rect * dstrect, SDL_ScaleMode scaleMode);
+static int SDL_LowerSoftStretchArea(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
 
 int
 SDL_SoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
                 SDL_Surface *dst, const SDL_Rect *dstrect)
 {
-    return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, SDL_ScaleModeNearest);
+    return SDL_PrivateSoftStretch(src, srcrect, dst, dstrect, SDL_ScaleModeNearest);
 }
 
 int
 SDL_SoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect,
                       SDL_Surface *dst, const SDL_Rect *dstrect)
 {
-    return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, SDL_ScaleModeLinear);
+    return SDL_PrivateSoftStretch(src, srcrect, dst, dstrect, SDL_ScaleModeLinear);
 }
 
-static int
-SDL_UpperSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
+int
+SDL_PrivateSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
                 SDL_Surface * dst, const SDL_Rect * dstrect, SDL_ScaleMode scaleMode)
 {
     int ret;
@@ -121,6 +121,11 @@ SDL_UpperSoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
 
     if (scaleMode == SDL_ScaleModeNearest) {
         ret = SDL_LowerSoftStretchNearest(src, srcrect, dst, dstrect);
+    } else if (scaleMode == SDL_ScaleModeBest &&
+               srcrect->w >= dstrect->w && srcrect->h >= dstrect->h &&
+               (srcrect->w > 2 * dstrect->w || srcrect->h > 2 * dstrect->h)) {
+        /* Bilinear filtering skips source pixels when reducing by more than 2x */
+        ret = SDL_LowerSoftStretchArea(src, srcrect, dst, dstrect);
     } else {
         ret = SDL_LowerSoftStretchLinear(src, srcrect, dst, dstrect);
     }
@@ -346,6 +351,23 @@ scale_mat(const Uint32 *src, int src_w, int src_h, int src_pitch,
 #  define HAVE_SSE2_INTRINSICS 1
 #endif
 
+/* The AVX2 kernels are built with a target attribute and only run if the CPU has AVX2 */
+#if defined(HAVE_SSE2_INTRINSICS) && defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#  define HAVE_AVX2_INTRINSICS 1
+#endif
+#if defined __clang__
+#  if (!__has_attribute(target))
+#    undef HAVE_AVX2_INTRINSICS
+#  endif
+#  if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX2__)
+#    undef HAVE_AVX2_INTRINSICS
+#  endif
+#elif defined __GNUC__
+#  if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#    undef HAVE_AVX2_INTRINSICS
+#  endif
+#endif
+
 #if defined(__ARM_NEON)
 #  define HAVE_NEON_INTRINSICS 1
 #  define CAST_uint8x8_t  (uint8x8_t)
@@ -544,6 +566,132 @@ scale_mat_SSE(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *ds
 }
 #endif
 
+#if defined(HAVE_AVX2_INTRINSICS)
+
+static SDL_INLINE int
+hasAVX2()
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+/* Same arithmetic as scale_mat_SSE, so the output is identical, but 4 pixels
+   at a time: each 128-bit lane interpolates 2 pixels. */
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static int
+scale_mat_AVX2(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    /* Interleave { x0, x1 } channels so that _mm256_madd_epi16 can do the horizontal interpolation */
+    const __m256i shuffle = _mm256_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15,
+                                             0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+    const __m256i zero256 = _mm256_setzero_si256();
+
+    BILINEAR___START
+
+    for (i = 0; i < dst_h; i++) {
+        int nb_block4;
+        __m128i v_frac_h0;
+        __m128i v_frac_h1;
+        __m128i zero;
+        __m256i v256_frac_h0;
+        __m256i v256_frac_h1;
+
+        BILINEAR___HEIGHT
+
+        nb_block4 = middle / 4;
+
+        v_frac_h0 = _mm_set1_epi16(frac_h0);
+        v_frac_h1 = _mm_set1_epi16(frac_h1);
+        zero = _mm_setzero_si128();
+        v256_frac_h0 = _mm256_set1_epi16(frac_h0);
+        v256_frac_h1 = _mm256_set1_epi16(frac_h1);
+
+        while (left_pad_w--) {
+            INTERPOL_BILINEAR_SSE(src_h0, src_h1, FRAC_ZERO, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+
+        while (nb_block4--) {
+            int index_w[4], frac_w[4];
+            __m256i x_0, x_1, k_lo, k_hi, v_frac_w_lo, v_frac_w_hi, e;
+            int j;
+
+            for (j = 0; j < 4; j++) {
+                index_w[j] = 4 * SRC_INDEX(fp_sum_w);
+                frac_w[j] = FRAC(fp_sum_w);
+                frac_w[j] = (frac_w[j] << 16) | (FRAC_ONE - frac_w[j]);
+                fp_sum_w += fp_step_w;
+            }
+
+            /* Lane 0: { x00 x01 } of pixels 0 and 1, lane 1: pixels 2 and 3 */
+            x_0 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h0 + index_w[0])),
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h0 + index_w[1])))),
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h0 + index_w[2])),
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h0 + index_w[3]))), 1);
+            x_1 = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h1 + index_w[0])),
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h1 + index_w[1])))),
+                    _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h1 + index_w[2])),
+                                       _mm_loadl_epi64((const __m128i *)((const Uint8 *)src_h1 + index_w[3]))), 1);
+            x_0 = _mm256_shuffle_epi8(x_0, shuffle);
+            x_1 = _mm256_shuffle_epi8(x_1, shuffle);
+
+            /* Interpolation vertical: k_lo holds pixels 0 and 2, k_hi pixels 1 and 3 */
+            k_lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_0, zero256), v256_frac_h1),
+                                    _mm256_mullo_epi16(_mm256_unpacklo_epi8(x_1, zero256), v256_frac_h0));
+            k_hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_0, zero256), v256_frac_h1),
+                                    _mm256_mullo_epi16(_mm256_unpackhi_epi8(x_1, zero256), v256_frac_h0));
+
+            /* Interpolation horizontal */
+            v_frac_w_lo = _mm256_setr_epi32(frac_w[0], frac_w[0], frac_w[0], frac_w[0],
+                                             frac_w[2], frac_w[2], frac_w[2], frac_w[2]);
+            v_frac_w_hi = _mm256_setr_epi32(frac_w[1], frac_w[1], frac_w[1], frac_w[1],
+                                             frac_w[3], frac_w[3], frac_w[3], frac_w[3]);
+            k_lo = _mm256_srli_epi32(_mm256_madd_epi16(k_lo, v_frac_w_lo), PRECISION * 2);
+            k_hi = _mm256_srli_epi32(_mm256_madd_epi16(k_hi, v_frac_w_hi), PRECISION * 2);
+
+            /* Store 4 pixels */
+            e = _mm256_packs_epi32(k_lo, k_hi);
+            e = _mm256_packus_epi16(e, e);
+            e = _mm256_permute4x64_epi64(e, _MM_SHUFFLE(2, 0, 2, 0));
+            _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(e));
+            dst += 4;
+        }
+
+        /* Last points */
+        middle &= 0x3;
+        while (middle--) {
+            const Uint32 *s_00_01;
+            const Uint32 *s_10_11;
+            int index_w = 4 * SRC_INDEX(fp_sum_w);
+            int frac_w = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+            s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            INTERPOL_BILINEAR_SSE(s_00_01, s_10_11, frac_w, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+
+        while (right_pad_w--) {
+            int index_w = 4 * (src_w - 2);
+            const Uint32 *s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            const Uint32 *s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            INTERPOL_BILINEAR_SSE(s_00_01, s_10_11, FRAC_ONE, v_frac_h0, v_frac_h1, dst, zero);
+            dst += 1;
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif
+
 #if defined(HAVE_NEON_INTRINSICS)
 
 static SDL_INLINE int
@@ -833,6 +981,12 @@ SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     }
 #endif
 
+#if defined(HAVE_AVX2_INTRINSICS)
+    if (ret == -1 && hasAVX2()) {
+        ret = scale_mat_AVX2(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+    }
+#endif
+
 #if defined(HAVE_SSE2_INTRINSICS)
     if (ret == -1 && hasSSE2()) {
         ret = scale_mat_SSE(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
@@ -846,6 +1000,167 @@ SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     return ret;
 }
 
+/* Area averaging (box filter), for large reductions: each destination pixel is
+   the average of all the source pixels it covers, partially covered pixels
+   being weighted by their coverage. */
+
+/* The weights of one destination pixel add up to 1 << AREA_PRECISION */
+#define AREA_PRECISION  15
+
+typedef struct area_span_t {
+    int first;      /* first source pixel */
+    int count;      /* number of source pixels */
+    int weights;    /* index of the weight of the first source pixel */
+} area_span_t;
+
+static void
+get_area_spans(int src_nb, int dst_nb, area_span_t *spans, Uint16 *weights)
+{
+    int i, j, k = 0;
+
+    for (i = 0; i < dst_nb; i++) {
+        /* In 1/dst_nb source pixel units, destination pixel i covers [start, end) */
+        const Sint64 start = (Sint64)i * src_nb;
+        const Sint64 end = start + src_nb;
+        Sint64 covered = 0;
+        int sum = 0;
+
+        spans[i].first = (int)(start / dst_nb);
+        spans[i].count = (int)((end - 1) / dst_nb) - spans[i].first + 1;
+        spans[i].weights = k;
+        for (j = spans[i].first; j < spans[i].first + spans[i].count; j++) {
+            int w;
+            covered += SDL_min(end, (Sint64)(j + 1) * dst_nb) - SDL_max(start, (Sint64)j * dst_nb);
+            /* Round the running sum, so that the weights add up exactly */
+            w = (int)((covered << AREA_PRECISION) / src_nb) - sum;
+            sum += w;
+            weights[k++] = (Uint16)w;
+        }
+    }
+}
+
+/* acc[i] += src[i] * weight, for n bytes */
+static void
+area_accumulate(const Uint8 *src, Uint32 *acc, int n, Uint32 weight)
+{
+#if defined(HAVE_SSE2_INTRINSICS)
+    if (hasSSE2()) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i w = _mm_set1_epi16((short)weight);
+        __m128i *a = (__m128i *)acc;
+
+        while (n >= 16) {
+            const __m128i x = _mm_loadu_si128((const __m128i *)src);
+            const __m128i x_lo = _mm_unpacklo_epi8(x, zero);
+            const __m128i x_hi = _mm_unpackhi_epi8(x, zero);
+            /* 16 x 16 -> 32 bits unsigned multiply */
+            const __m128i p_lo_l = _mm_mullo_epi16(x_lo, w);
+            const __m128i p_lo_h = _mm_mulhi_epu16(x_lo, w);
+            const __m128i p_hi_l = _mm_mullo_epi16(x_hi, w);
+            const __m128i p_hi_h = _mm_mulhi_epu16(x_hi, w);
+            _mm_storeu_si128(a + 0, _mm_add_epi32(_mm_loadu_si128(a + 0), _mm_unpacklo_epi16(p_lo_l, p_lo_h)));
+            _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(p_lo_l, p_lo_h)));
+            _mm_storeu_si128(a + 2, _mm_add_epi32(_mm_loadu_si128(a + 2), _mm_unpacklo_epi16(p_hi_l, p_hi_h)));
+            _mm_storeu_si128(a + 3, _mm_add_epi32(_mm_loadu_si128(a + 3), _mm_unpackhi_epi16(p_hi_l, p_hi_h)));
+            src += 16;
+            a += 4;
+            n -= 16;
+        }
+        acc = (Uint32 *)a;
+    }
+#endif
+#if defined(HAVE_NEON_INTRINSICS)
+    if (hasNEON()) {
+        while (n >= 16) {
+            const uint8x16_t x = vld1q_u8(src);
+            const uint16x8_t x_lo = vmovl_u8(vget_low_u8(x));
+            const uint16x8_t x_hi = vmovl_u8(vget_high_u8(x));
+            vst1q_u32(acc + 0, vmlal_n_u16(vld1q_u32(acc + 0), vget_low_u16(x_lo), (uint16_t)weight));
+            vst1q_u32(acc + 4, vmlal_n_u16(vld1q_u32(acc + 4), vget_high_u16(x_lo), (uint16_t)weight));
+            vst1q_u32(acc + 8, vmlal_n_u16(vld1q_u32(acc + 8), vget_low_u16(x_hi), (uint16_t)weight));
+            vst1q_u32(acc + 12, vmlal_n_u16(vld1q_u32(acc + 12), vget_high_u16(x_hi), (uint16_t)weight));
+            src += 16;
+            acc += 16;
+            n -= 16;
+        }
+    }
+#endif
+    while (n--) {
+        *acc++ += *src++ * weight;
+    }
+}
+
+static int
+scale_mat_area(const Uint32 *src, int src_w, int src_h, int src_pitch,
+        Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    int i, j, k, c;
+    Uint32 *acc;
+    area_span_t *spans_w, *spans_h;
+    Uint16 *weights_w, *weights_h;
+    Uint8 *data;
+
+    data = (Uint8 *)SDL_malloc(src_w * 4 * sizeof(Uint32) +
+                               (dst_w + dst_h) * sizeof(area_span_t) +
+                               (src_w + dst_w + src_h + dst_h) * sizeof(Uint16));
+    if (!data) {
+        return SDL_OutOfMemory();
+    }
+    acc = (Uint32 *)data;
+    spans_w = (area_span_t *)(acc + src_w * 4);
+    spans_h = spans_w + dst_w;
+    weights_w = (Uint16 *)(spans_h + dst_h);
+    weights_h = weights_w + src_w + dst_w;
+    get_area_spans(src_w, dst_w, spans_w, weights_w);
+    get_area_spans(src_h, dst_h, spans_h, weights_h);
+
+    for (i = 0; i < dst_h; i++) {
+        const area_span_t *span_h = &spans_h[i];
+        Uint8 *d = (Uint8 *)dst + i * dst_pitch;
+
+        /* Vertical: sum up the source rows, in 8.AREA_PRECISION fixed point */
+        SDL_memset(acc, 0, src_w * 4 * sizeof(Uint32));
+        for (j = 0; j < span_h->count; j++) {
+            const Uint16 weight = weights_h[span_h->weights + j];
+            if (weight) {
+                area_accumulate((const Uint8 *)src + (span_h->first + j) * src_pitch, acc, src_w * 4, weight);
+            }
+        }
+
+        /* Horizontal: drop 7 bits of precision so that the sums fit 32 bits */
+        for (k = 0; k < dst_w; k++) {
+            const area_span_t *span_w = &spans_w[k];
+            const Uint32 *a = acc + span_w->first * 4;
+            const Uint16 *weight = weights_w + span_w->weights;
+            Uint32 sum[4] = { 0, 0, 0, 0 };
+
+            for (j = 0; j < span_w->count; j++, a += 4) {
+                for (c = 0; c < 4; c++) {
+                    sum[c] += ((a[c] + (1 << 6)) >> 7) * weight[j];
+                }
+            }
+            for (c = 0; c < 4; c++) {
+                *d++ = (Uint8)((sum[c] + (1 << (2 * AREA_PRECISION - 8))) >> (2 * AREA_PRECISION - 7));
+            }
+        }
+    }
+
+    SDL_free(data);
+    return 0;
+}
+
+int
+SDL_LowerSoftStretchArea(SDL_Surface *s, const SDL_Rect *srcrect,
+                SDL_Surface *d, const SDL_Rect *dstrect)
+{
+    int src_pitch = s->pitch;
+    int dst_pitch = d->pitch;
+    Uint32 *src = (Uint32 *) ((Uint8 *)s->pixels + srcrect->x * 4 + srcrect->y * src_pitch);
+    Uint32 *dst = (Uint32 *) ((Uint8 *)d->pixels + dstrect->x * 4 + dstrect->y * dst_pitch);
+
+    return scale_mat_area(src, srcrect->w, srcrect->h, src_pitch, dst, dstrect->w, dstrect->h, dst_pitch);
+}
+
 
 #define SDL_SCALE_NEAREST__START                                                        \
     int i;                                                                              \
@@ -858,6 +1173,7 @@ SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     incx = (src_w << 16) / dst_w;                                                       \
     dst_gap   = dst_pitch - bpp * dst_w;                                                \
     posy = incy / 2;                                                                    \
+    srcy = -1;                                                                          \
 
 #define SDL_SCALE_NEAREST__HEIGHT                                                       \
     srcy = (posy >> 16);                                                                \
@@ -866,6 +1182,16 @@ SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     posx = incx / 2;                                                                    \
     n = dst_w;
 
+/* When upscaling, consecutive destination rows sample the same source row:
+   copy the previous destination row instead of sampling it again. */
+#define SDL_SCALE_NEAREST__DUPLICATE_ROW                                                \
+    if ((int)(posy >> 16) == srcy) {                                                    \
+        SDL_memcpy(dst, (const Uint8 *)dst - dst_pitch, bpp * dst_w);                   \
+        dst = (Uint32 *)((Uint8 *)dst + dst_pitch);                                     \
+        posy += incy;                                                                   \
+        continue;                                                                       \
+    }
+
 
 static int
 scale_mat_nearest_1(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
@@ -874,6 +1200,7 @@ scale_mat_nearest_1(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
     Uint32 bpp = 1;
     SDL_SCALE_NEAREST__START
     for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
         SDL_SCALE_NEAREST__HEIGHT
         while (n--) {
             const Uint8 *src;
@@ -895,6 +1222,7 @@ scale_mat_nearest_2(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
     Uint32 bpp = 2;
     SDL_SCALE_NEAREST__START
     for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
         SDL_SCALE_NEAREST__HEIGHT
         while (n--) {
             const Uint16 *src;
@@ -916,6 +1244,7 @@ scale_mat_nearest_3(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
     Uint32 bpp = 3;
     SDL_SCALE_NEAREST__START
     for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
         SDL_SCALE_NEAREST__HEIGHT
         while (n--) {
             const Uint8 *src;
@@ -939,6 +1268,7 @@ scale_mat_nearest_4(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
     Uint32 bpp = 4;
     SDL_SCALE_NEAREST__START
     for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
         SDL_SCALE_NEAREST__HEIGHT
         while (n--) {
             const Uint32 *src;
@@ -953,6 +1283,109 @@ scale_mat_nearest_4(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
     return 0;
 }
 
+#if defined(HAVE_AVX2_INTRINSICS)
+#if defined(__clang__) || defined(__GNUC__)
+__attribute__((target("avx2")))
+#endif
+static int
+scale_mat_nearest_4_AVX2(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
+        Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    Uint32 bpp = 4;
+    SDL_SCALE_NEAREST__START
+    for (i = 0; i < dst_h; i++) {
+        __m256i v_posx, v_incx;
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
+        SDL_SCALE_NEAREST__HEIGHT
+
+        /* Gather 8 pixels at a time */
+        v_posx = _mm256_add_epi32(_mm256_set1_epi32(posx), _mm256_mullo_epi32(_mm256_set1_epi32(incx), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        v_incx = _mm256_set1_epi32(incx * 8);
+        while (n >= 8) {
+            const __m256i srcx = _mm256_srli_epi32(v_posx, 16);
+            _mm256_storeu_si256((__m256i *)dst, _mm256_i32gather_epi32((const int *)src_h0, srcx, 4));
+            v_posx = _mm256_add_epi32(v_posx, v_incx);
+            posx += incx * 8;
+            dst += 8;
+            n -= 8;
+        }
+
+        while (n--) {
+            *dst++ = src_h0[posx >> 16];
+            posx += incx;
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif
+
+#if defined(HAVE_SSE2_INTRINSICS)
+static int
+scale_mat_nearest_4_SSE(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
+        Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    Uint32 bpp = 4;
+    SDL_SCALE_NEAREST__START
+    for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
+        SDL_SCALE_NEAREST__HEIGHT
+
+        /* Store 4 pixels at a time */
+        while (n >= 4) {
+            const Uint32 x0 = src_h0[posx >> 16];
+            const Uint32 x1 = src_h0[(posx + incx) >> 16];
+            const Uint32 x2 = src_h0[(posx + incx * 2) >> 16];
+            const Uint32 x3 = src_h0[(posx + incx * 3) >> 16];
+            _mm_storeu_si128((__m128i *)dst, _mm_setr_epi32(x0, x1, x2, x3));
+            posx += incx * 4;
+            dst += 4;
+            n -= 4;
+        }
+
+        while (n--) {
+            *dst++ = src_h0[posx >> 16];
+            posx += incx;
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif
+
+#if defined(HAVE_NEON_INTRINSICS)
+static int
+scale_mat_nearest_4_NEON(const Uint32 *src_ptr, int src_w, int src_h, int src_pitch,
+        Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+{
+    Uint32 bpp = 4;
+    SDL_SCALE_NEAREST__START
+    for (i = 0; i < dst_h; i++) {
+        SDL_SCALE_NEAREST__DUPLICATE_ROW
+        SDL_SCALE_NEAREST__HEIGHT
+
+        /* Store 4 pixels at a time */
+        while (n >= 4) {
+            uint32x4_t x = vdupq_n_u32(src_h0[posx >> 16]);
+            x = vsetq_lane_u32(src_h0[(posx + incx) >> 16], x, 1);
+            x = vsetq_lane_u32(src_h0[(posx + incx * 2) >> 16], x, 2);
+            x = vsetq_lane_u32(src_h0[(posx + incx * 3) >> 16], x, 3);
+            vst1q_u32(dst, x);
+            posx += incx * 4;
+            dst += 4;
+            n -= 4;
+        }
+
+        while (n--) {
+            *dst++ = src_h0[posx >> 16];
+            posx += incx;
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif
+
 int
 SDL_LowerSoftStretchNearest(SDL_Surface *s, const SDL_Rect *srcrect,
                 SDL_Surface *d, const SDL_Rect *dstrect)
@@ -970,6 +1403,21 @@ SDL_LowerSoftStretchNearest(SDL_Surface *s, const SDL_Rect *srcrect,
     Uint32 *dst = (Uint32 *) ((Uint8 *)d->pixels + dstrect->x * bpp + dstrect->y * dst_pitch);
 
     if (bpp == 4) {
+#if defined(HAVE_NEON_INTRINSICS)
+        if (hasNEON()) {
+            return scale_mat_nearest_4_NEON(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        }
+#endif
+#if defined(HAVE_AVX2_INTRINSICS)
+        if (hasAVX2()) {
+            return scale_mat_nearest_4_AVX2(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        }
+#endif
+#if defined(HAVE_SSE2_INTRINSICS)
+        if (hasSSE2()) {
+            return scale_mat_nearest_4_SSE(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        }
+#endif
         return scale_mat_nearest_4(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
     } else if (bpp == 3) {
         return scale_mat_nearest_3(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
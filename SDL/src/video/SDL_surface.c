@@ -511,7 +511,7 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     status = 0;
     flags = surface->map->info.flags;
     surface->map->info.flags &=
-        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL);
+        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_BLEND_PREMULTIPLIED);
     switch (blendMode) {
     case SDL_BLENDMODE_NONE:
         break;
@@ -527,6 +527,9 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     case SDL_BLENDMODE_MUL:
         surface->map->info.flags |= SDL_COPY_MUL;
         break;
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        surface->map->info.flags |= SDL_COPY_BLEND_PREMULTIPLIED;
+        break;
     default:
         status = SDL_Unsupported();
         break;
@@ -551,7 +554,7 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     }
 
     switch (surface->map->
-            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_BLEND_PREMULTIPLIED)) {
     case SDL_COPY_BLEND:
         *blendMode = SDL_BLENDMODE_BLEND;
         break;
@@ -564,6 +567,9 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     case SDL_COPY_MUL:
         *blendMode = SDL_BLENDMODE_MUL;
         break;
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        *blendMode = SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+        break;
     default:
         *blendMode = SDL_BLENDMODE_NONE;
         break;
@@ -571,6 +577,32 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
     return 0;
 }
 
+int
+SDL_SetSurfacePremultiplied(SDL_Surface * surface, SDL_bool premultiplied)
+{
+    SDL_BlendMode blendMode;
+
+    if (!surface) {
+        return SDL_InvalidParamError("surface");
+    }
+
+    if (premultiplied) {
+        surface->flags |= SDL_PREMULTIPLIED;
+    } else {
+        surface->flags &= ~SDL_PREMULTIPLIED;
+    }
+
+    /* Keep alpha blending consistent with the pixels */
+    SDL_GetSurfaceBlendMode(surface, &blendMode);
+    if (premultiplied && blendMode == SDL_BLENDMODE_BLEND) {
+        return SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    }
+    if (!premultiplied && blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        return SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+    }
+    return 0;
+}
+
 SDL_bool
 SDL_SetClipRect(SDL_Surface * surface, const SDL_Rect * rect)
 {
@@ -921,7 +953,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
     static const Uint32 complex_copy_flags = (
         SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
         SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL |
-        SDL_COPY_COLORKEY
+        SDL_COPY_BLEND_PREMULTIPLIED | SDL_COPY_COLORKEY
     );
 
     if (srcrect->w > SDL_MAX_UINT16 || srcrect->h > SDL_MAX_UINT16 ||
@@ -949,7 +981,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
              src->format->BytesPerPixel == 4 &&
              src->format->format != SDL_PIXELFORMAT_ARGB2101010) {
             /* fast path */
-            return SDL_SoftStretchLinear(src, srcrect, dst, dstrect);
+            return SDL_PrivateSoftStretch(src, srcrect, dst, dstrect, scaleMode);
         } else {
             /* Use intermediate surface(s) */
             SDL_Surface *tmp1 = NULL;
@@ -1002,7 +1034,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
             if (is_complex_copy_flags || src->format->format != dst->format->format) {
                 SDL_Rect tmprect;
                 SDL_Surface *tmp2 = SDL_CreateRGBSurfaceWithFormat(flags, dstrect->w, dstrect->h, 0, src->format->format);
-                SDL_SoftStretchLinear(src, &srcrect2, tmp2, NULL);
+                SDL_PrivateSoftStretch(src, &srcrect2, tmp2, NULL, scaleMode);
 
                 SDL_SetSurfaceColorMod(tmp2, r, g, b);
                 SDL_SetSurfaceAlphaMod(tmp2, alpha);
@@ -1015,7 +1047,7 @@ SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
                 ret = SDL_LowerBlit(tmp2, &tmprect, dst, dstrect);
                 SDL_FreeSurface(tmp2);
             } else {
-                ret = SDL_SoftStretchLinear(src, &srcrect2, dst, dstrect);
+                ret = SDL_PrivateSoftStretch(src, &srcrect2, dst, dstrect, scaleMode);
             }
 
             SDL_FreeSurface(tmp1);
@@ -1037,6 +1069,8 @@ SDL_LockSurface(SDL_Surface * surface)
             SDL_UnRLESurface(surface, 1);
             surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
         }
+        /* The pixels may change, encodings made from them are stale */
+        SDL_FreeRLECache(surface->map);
 #endif
     }
 
@@ -1216,7 +1250,7 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     convert->map->info.a = copy_color.a;
     convert->map->info.flags =
         (copy_flags &
-         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND
+         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED
            | SDL_COPY_RLE_DESIRED | SDL_COPY_RLE_COLORKEY |
            SDL_COPY_RLE_ALPHAKEY));
     surface->map->info.r = copy_color.r;
@@ -1305,6 +1339,10 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
         (copy_flags & SDL_COPY_MODULATE_ALPHA)) {
         SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_BLEND);
     }
+    /* The pixels were copied as they are, so they stay premultiplied */
+    if ((surface->flags & SDL_PREMULTIPLIED) && format->Amask) {
+        SDL_SetSurfacePremultiplied(convert, SDL_TRUE);
+    }
     if ((copy_flags & SDL_COPY_RLE_DESIRED) || (flags & SDL_RLEACCEL)) {
         SDL_SetSurfaceRLE(convert, SDL_RLEACCEL);
     }
@@ -1507,6 +1545,80 @@ int SDL_PremultiplyAlpha(int width, int height,
     return 0;
 }
 
+/*
+ * Premultiply the alpha of a surface in place
+ */
+int
+SDL_PremultiplySurfaceAlpha(SDL_Surface * surface)
+{
+    SDL_PixelFormat *fmt;
+    int x, y;
+
+    if (!surface) {
+        return SDL_InvalidParamError("surface");
+    }
+    if (surface->flags & SDL_PREMULTIPLIED) {
+        return 0;
+    }
+
+    fmt = surface->format;
+    if (SDL_ISPIXELFORMAT_INDEXED(fmt->format) ||
+        SDL_ISPIXELFORMAT_FOURCC(fmt->format) ||
+        fmt->Rloss > 8 || fmt->Gloss > 8 || fmt->Bloss > 8) {
+        return SDL_SetError("Unsupported surface format");
+    }
+
+    /* Without an alpha channel the pixels are already premultiplied */
+    if (fmt->Amask) {
+        if (SDL_LockSurface(surface) < 0) {
+            return -1;
+        }
+
+        if (fmt->BytesPerPixel == 4 && fmt->Aloss == 0 && (fmt->Ashift % 8) == 0 &&
+            fmt->Rloss == 0 && fmt->Gloss == 0 && fmt->Bloss == 0) {
+            /* The color bytes are multiplied two at a time, with x / 255
+               rounded the same way as the blitters do it */
+            for (y = 0; y < surface->h; ++y) {
+                Uint32 *pixels = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+                for (x = 0; x < surface->w; ++x) {
+                    const Uint32 pixel = pixels[x];
+                    const Uint32 a = (pixel & fmt->Amask) >> fmt->Ashift;
+                    Uint32 lo, hi;
+
+                    if (a == 0xFF) {
+                        continue;
+                    }
+                    lo = (pixel & ~fmt->Amask & 0x00FF00FF) * a + 0x00800080;
+                    lo = ((lo + ((lo >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                    hi = ((pixel & ~fmt->Amask) >> 8 & 0x00FF00FF) * a + 0x00800080;
+                    hi = (hi + ((hi >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+                    pixels[x] = lo | hi | (pixel & fmt->Amask);
+                }
+            }
+        } else {
+            const int bpp = fmt->BytesPerPixel;
+            for (y = 0; y < surface->h; ++y) {
+                Uint8 *buf = (Uint8 *)surface->pixels + y * surface->pitch;
+                for (x = 0; x < surface->w; ++x) {
+                    Uint32 Pixel;
+                    unsigned r, g, b, a;
+
+                    DISEMBLE_RGBA(buf, bpp, fmt, Pixel, r, g, b, a);
+                    r = (r * a + 127) / 255;
+                    g = (g * a + 127) / 255;
+                    b = (b * a + 127) / 255;
+                    ASSEMBLE_RGBA(buf, bpp, fmt, r, g, b, a);
+                    buf += bpp;
+                }
+            }
+        }
+
+        SDL_UnlockSurface(surface);
+    }
+
+    return SDL_SetSurfacePremultiplied(surface, SDL_TRUE);
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -23,6 +23,7 @@
 #include "SDL_endian.h"
 #include "SDL_video.h"
 #include "SDL_pixels_c.h"
+#include "SDL_blit.h"
 #include "SDL_yuv_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
@@ -393,31 +394,62 @@ static SDL_bool yuv_rgb_std(
     return SDL_FALSE;
 }
 
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    int width;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    SDL_atomic_t converted;
+} YUVtoRGBRows;
+
+static void SDLCALL
+SDL_ConvertPixels_YUV_to_RGB_Rows(int start, int end, void *data)
+{
+    YUVtoRGBRows *rows = (YUVtoRGBRows *) data;
+    const int uv_start = IsPlanar2x2Format(rows->src_format) ? (start / 2) : start;
+    const Uint8 *y = rows->y + start * rows->y_stride;
+    const Uint8 *u = rows->u + uv_start * rows->uv_stride;
+    const Uint8 *v = rows->v + uv_start * rows->uv_stride;
+    Uint8 *rgb = rows->rgb + start * rows->rgb_stride;
+
+    if (yuv_rgb_sse(rows->src_format, rows->dst_format, rows->width, end - start, y, u, v, rows->y_stride, rows->uv_stride, rgb, rows->rgb_stride, rows->yuv_type) ||
+        yuv_rgb_std(rows->src_format, rows->dst_format, rows->width, end - start, y, u, v, rows->y_stride, rows->uv_stride, rgb, rows->rgb_stride, rows->yuv_type)) {
+        SDL_AtomicSet(&rows->converted, 1);
+    }
+}
+
 int
 SDL_ConvertPixels_YUV_to_RGB(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
          Uint32 dst_format, void *dst, int dst_pitch)
 {
-    const Uint8 *y = NULL;
-    const Uint8 *u = NULL;
-    const Uint8 *v = NULL;
-    Uint32 y_stride = 0;
-    Uint32 uv_stride = 0;
-    YCbCrType yuv_type = YCBCR_601;
-
-    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
-        return -1;
-    }
+    YUVtoRGBRows rows;
 
-    if (GetYUVConversionType(width, height, &yuv_type) < 0) {
+    SDL_zero(rows);
+    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &rows.y, &rows.u, &rows.v, &rows.y_stride, &rows.uv_stride) < 0) {
         return -1;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
+    if (GetYUVConversionType(width, height, &rows.yuv_type) < 0) {
+        return -1;
     }
 
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
+    /* The 4:2:0 formats share each chroma row between two rows of pixels */
+    rows.src_format = src_format;
+    rows.dst_format = dst_format;
+    rows.width = width;
+    rows.rgb = (Uint8 *)dst;
+    rows.rgb_stride = dst_pitch;
+    SDL_BlitRows(width, height, IsPlanar2x2Format(src_format) ? 2 : 1, SDL_ConvertPixels_YUV_to_RGB_Rows, &rows);
+    if (SDL_AtomicGet(&rows.converted)) {
         return 0;
     }
 
@@ -448,97 +480,649 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
     return SDL_SetError("Unsupported YUV conversion");
 }
 
-struct RGB2YUVFactors
+/* Fixed-point RGB to YUV coefficients, scaled by 1 << RGB2YUV_SHIFT.
+   The tables are in R, G, B order; RGB2YUV_GetCoefficients() reorders them
+   by the position of each channel within the source pixel. */
+#define RGB2YUV_SHIFT   14
+#define RGB2YUV_ROUND   (1 << (RGB2YUV_SHIFT - 1))
+
+typedef struct RGB2YUVCoefficients
 {
     int y_offset;
-    float y[3]; /* Rfactor, Gfactor, Bfactor */
-    float u[3]; /* Rfactor, Gfactor, Bfactor */
-    float v[3]; /* Rfactor, Gfactor, Bfactor */
-};
+    int y[3]; /* bits 0-7, bits 8-15, bits 16-23 */
+    int u[3];
+    int v[3];
+} RGB2YUVCoefficients;
 
-static int
-SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+static void
+RGB2YUV_GetCoefficients(int width, int height, Uint32 src_format, RGB2YUVCoefficients *cvt)
 {
-    const int src_pitch_x_2    = src_pitch * 2;
-    const int height_half      = height / 2;
-    const int height_remainder = (height & 0x1);
-    const int width_half       = width / 2;
-    const int width_remainder  = (width & 0x1);
-    int i, j;
- 
-    static struct RGB2YUVFactors RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] =
+    static const RGB2YUVCoefficients RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] =
     {
         /* ITU-T T.871 (JPEG) */
         {
             0,
-            {  0.2990f,  0.5870f,  0.1140f },
-            { -0.1687f, -0.3313f,  0.5000f },
-            {  0.5000f, -0.4187f, -0.0813f },
+            {  4899,  9617,  1868 },
+            { -2764, -5428,  8192 },
+            {  8192, -6860, -1332 },
         },
         /* ITU-R BT.601-7 */
         {
             16,
-            {  0.2568f,  0.5041f,  0.0979f },
-            { -0.1482f, -0.2910f,  0.4392f },
-            {  0.4392f, -0.3678f, -0.0714f },
+            {  4207,  8259,  1604 },
+            { -2428, -4768,  7196 },
+            {  7196, -6026, -1170 },
         },
         /* ITU-R BT.709-6 */
         {
             16,
-            { 0.1826f,  0.6142f,  0.0620f },
-            {-0.1006f, -0.3386f,  0.4392f },
-            { 0.4392f, -0.3989f, -0.0403f },
+            {  2992, 10063,  1016 },
+            { -1648, -5548,  7196 },
+            {  7196, -6536,  -660 },
         },
     };
-    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[SDL_GetYUVConversionModeForResolution(width, height)];
-
-#define MAKE_Y(r, g, b) (Uint8)((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset)
-#define MAKE_U(r, g, b) (Uint8)((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 128)
-#define MAKE_V(r, g, b) (Uint8)((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 128)
-
-#define READ_2x2_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 p3 = ((const Uint32 *)next_row)[2 * i];                                                    \
-        const Uint32 p4 = ((const Uint32 *)next_row)[2 * i + 1];                                                \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000) + (p3 & 0x00ff0000) + (p4 & 0x00ff0000)) >> 18; \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00) + (p3 & 0x0000ff00) + (p4 & 0x0000ff00)) >> 10; \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff) + (p3 & 0x000000ff) + (p4 & 0x000000ff)) >> 2;  \
-
-#define READ_2x1_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)next_row)[2 * i];                                                    \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17;                                         \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;                                          \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;                                          \
-
-#define READ_1x2_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17;                                         \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;                                          \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;                                          \
-
-#define READ_1x1_PIXEL                                                                                          \
-        const Uint32 p = ((const Uint32 *)curr_row)[2 * i];                                                     \
-        const Uint32 r = (p & 0x00ff0000) >> 16;                                                                \
-        const Uint32 g = (p & 0x0000ff00) >> 8;                                                                 \
-        const Uint32 b = (p & 0x000000ff);                                                                      \
-
-#define READ_TWO_RGB_PIXELS                                                                                     \
-        const Uint32 p = ((const Uint32 *)curr_row)[2 * i];                                                     \
-        const Uint32 r = (p & 0x00ff0000) >> 16;                                                                \
-        const Uint32 g = (p & 0x0000ff00) >> 8;                                                                 \
-        const Uint32 b = (p & 0x000000ff);                                                                      \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 r1 = (p1 & 0x00ff0000) >> 16;                                                              \
-        const Uint32 g1 = (p1 & 0x0000ff00) >> 8;                                                               \
-        const Uint32 b1 = (p1 & 0x000000ff);                                                                    \
-        const Uint32 R = (r + r1)/2;                                                                            \
-        const Uint32 G = (g + g1)/2;                                                                            \
-        const Uint32 B = (b + b1)/2;                                                                            \
-
-#define READ_ONE_RGB_PIXEL  READ_1x1_PIXEL
+    const RGB2YUVCoefficients *table = &RGB2YUVFactorTables[SDL_GetYUVConversionModeForResolution(width, height)];
+    const int r = (src_format == SDL_PIXELFORMAT_ABGR8888 || src_format == SDL_PIXELFORMAT_XBGR8888) ? 0 : 2;
+    const int b = 2 - r;
+
+    cvt->y_offset = table->y_offset;
+    cvt->y[r] = table->y[0]; cvt->y[1] = table->y[1]; cvt->y[b] = table->y[2];
+    cvt->u[r] = table->u[0]; cvt->u[1] = table->u[1]; cvt->u[b] = table->u[2];
+    cvt->v[r] = table->v[0]; cvt->v[1] = table->v[1]; cvt->v[b] = table->v[2];
+}
+
+static SDL_INLINE Uint8
+RGB2YUV_Saturate(int value)
+{
+    return (Uint8)((value > 255) ? 255 : value);
+}
+
+/* All of these are non-negative before the shift, so no sign handling is needed */
+#define MAKE_Y(c0, c1, c2) RGB2YUV_Saturate(((cvt->y[0] * (int)(c0) + cvt->y[1] * (int)(c1) + cvt->y[2] * (int)(c2) + RGB2YUV_ROUND) >> RGB2YUV_SHIFT) + cvt->y_offset)
+#define MAKE_U(c0, c1, c2) RGB2YUV_Saturate((cvt->u[0] * (int)(c0) + cvt->u[1] * (int)(c1) + cvt->u[2] * (int)(c2) + RGB2YUV_ROUND + (128 << RGB2YUV_SHIFT)) >> RGB2YUV_SHIFT)
+#define MAKE_V(c0, c1, c2) RGB2YUV_Saturate((cvt->v[0] * (int)(c0) + cvt->v[1] * (int)(c1) + cvt->v[2] * (int)(c2) + RGB2YUV_ROUND + (128 << RGB2YUV_SHIFT)) >> RGB2YUV_SHIFT)
+
+#define PIXEL_C0(p) ((p) & 0xff)
+#define PIXEL_C1(p) (((p) >> 8) & 0xff)
+#define PIXEL_C2(p) (((p) >> 16) & 0xff)
+
+#ifdef __SSE2__
+/* Coefficients laid out for _mm_madd_epi16(): a pixel masked with 0x00ff00ff
+   gives (c0, c2) pairs, and c1 is paired with a constant 1 that picks up the
+   rounding term. */
+typedef struct RGB2YUVFactorsSSE2
+{
+    __m128i y02, y1r;
+    __m128i u02, u1r;
+    __m128i v02, v1r;
+    __m128i y_offset;
+} RGB2YUVFactorsSSE2;
+
+static SDL_INLINE void
+RGB2YUV_GetFactorsSSE2(const RGB2YUVCoefficients *cvt, RGB2YUVFactorsSSE2 *k)
+{
+    k->y02 = _mm_set1_epi32((cvt->y[2] << 16) | (cvt->y[0] & 0xffff));
+    k->y1r = _mm_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->y[1] & 0xffff));
+    k->u02 = _mm_set1_epi32((cvt->u[2] << 16) | (cvt->u[0] & 0xffff));
+    k->u1r = _mm_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->u[1] & 0xffff));
+    k->v02 = _mm_set1_epi32((cvt->v[2] << 16) | (cvt->v[0] & 0xffff));
+    k->v1r = _mm_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->v[1] & 0xffff));
+    k->y_offset = _mm_set1_epi16((short)cvt->y_offset);
+}
+
+static SDL_INLINE __m128i
+RGB2YUV_Dot_SSE2(__m128i c02, __m128i c1, __m128i k02, __m128i k1r)
+{
+    c1 = _mm_or_si128(c1, _mm_set1_epi32(0x10000));
+    return _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(c02, k02), _mm_madd_epi16(c1, k1r)), RGB2YUV_SHIFT);
+}
+
+/* Converts 16 pixels to 16 Y values */
+static SDL_INLINE __m128i
+RGB2YUV_Y16_SSE2(const Uint32 *src, const RGB2YUVFactorsSSE2 *k)
+{
+    const __m128i mask02 = _mm_set1_epi32(0x00ff00ff);
+    const __m128i mask1 = _mm_set1_epi32(0xff);
+    __m128i y[4];
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        const __m128i p = _mm_loadu_si128((const __m128i *)(src + 4 * i));
+        y[i] = RGB2YUV_Dot_SSE2(_mm_and_si128(p, mask02), _mm_and_si128(_mm_srli_epi32(p, 8), mask1), k->y02, k->y1r);
+    }
+    return _mm_packus_epi16(_mm_add_epi16(_mm_packs_epi32(y[0], y[1]), k->y_offset),
+                            _mm_add_epi16(_mm_packs_epi32(y[2], y[3]), k->y_offset));
+}
+
+/* Sums the channels of 4 pixels from each row and adds adjacent pixels,
+   leaving the two (c0, c2) and c1 sums in the low 64 bits */
+static SDL_INLINE void
+RGB2YUV_Sum2x2_SSE2(const Uint32 *row0, const Uint32 *row1, __m128i *c02, __m128i *c1)
+{
+    const __m128i mask02 = _mm_set1_epi32(0x00ff00ff);
+    const __m128i mask1 = _mm_set1_epi32(0xff);
+    const __m128i p0 = _mm_loadu_si128((const __m128i *)row0);
+    const __m128i p1 = _mm_loadu_si128((const __m128i *)row1);
+    __m128i s02 = _mm_add_epi32(_mm_and_si128(p0, mask02), _mm_and_si128(p1, mask02));
+    __m128i s1 = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask1), _mm_and_si128(_mm_srli_epi32(p1, 8), mask1));
+
+    s02 = _mm_add_epi32(s02, _mm_srli_epi64(s02, 32));
+    s1 = _mm_add_epi32(s1, _mm_srli_epi64(s1, 32));
+    *c02 = _mm_shuffle_epi32(s02, _MM_SHUFFLE(3, 1, 2, 0));
+    *c1 = _mm_shuffle_epi32(s1, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/* Converts 16 pixels of two rows to 8 U values in the low half and 8 V values in the high half */
+static SDL_INLINE __m128i
+RGB2YUV_UV8_SSE2(const Uint32 *row0, const Uint32 *row1, const RGB2YUVFactorsSSE2 *k)
+{
+    const __m128i uv_offset = _mm_set1_epi16(128);
+    __m128i u[2], v[2];
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        __m128i a02, a1, b02, b1, c02, c1;
+
+        RGB2YUV_Sum2x2_SSE2(row0 + 8 * i, row1 + 8 * i, &a02, &a1);
+        RGB2YUV_Sum2x2_SSE2(row0 + 8 * i + 4, row1 + 8 * i + 4, &b02, &b1);
+        c02 = _mm_srli_epi16(_mm_unpacklo_epi64(a02, b02), 2);
+        c1 = _mm_srli_epi32(_mm_unpacklo_epi64(a1, b1), 2);
+        u[i] = RGB2YUV_Dot_SSE2(c02, c1, k->u02, k->u1r);
+        v[i] = RGB2YUV_Dot_SSE2(c02, c1, k->v02, k->v1r);
+    }
+    return _mm_packus_epi16(_mm_add_epi16(_mm_packs_epi32(u[0], u[1]), uv_offset),
+                            _mm_add_epi16(_mm_packs_epi32(v[0], v[1]), uv_offset));
+}
+#endif /* __SSE2__ */
+
+/* The AVX2 encoders are built with a target attribute and only run if the CPU has AVX2 */
+#if defined(__SSE2__) && defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H)
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+#if defined __clang__
+# if (!__has_attribute(target))
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+# if (defined(_MSC_VER) || defined(__SCE__)) && !defined(__AVX2__)
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+#elif defined __GNUC__
+# if (__GNUC__ < 4) || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
+#   undef HAVE_AVX2_INTRINSICS
+# endif
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+/* MSVC will always accept AVX2 intrinsics when compiling for x64 */
+#if defined(__clang__) || defined(__GNUC__)
+#define SDL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SDL_TARGET_AVX2
+#endif
+
+/* Same arithmetic as the SSE2 encoders, so the output is identical, on twice
+   as many pixels. The 256-bit packs work within each 128-bit lane, so the
+   results are put back in order with a cross-lane permute. */
+typedef struct RGB2YUVFactorsAVX2
+{
+    __m256i y02, y1r;
+    __m256i u02, u1r;
+    __m256i v02, v1r;
+    __m256i y_offset;
+} RGB2YUVFactorsAVX2;
+
+SDL_TARGET_AVX2 static SDL_INLINE void
+RGB2YUV_GetFactorsAVX2(const RGB2YUVCoefficients *cvt, RGB2YUVFactorsAVX2 *k)
+{
+    k->y02 = _mm256_set1_epi32((cvt->y[2] << 16) | (cvt->y[0] & 0xffff));
+    k->y1r = _mm256_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->y[1] & 0xffff));
+    k->u02 = _mm256_set1_epi32((cvt->u[2] << 16) | (cvt->u[0] & 0xffff));
+    k->u1r = _mm256_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->u[1] & 0xffff));
+    k->v02 = _mm256_set1_epi32((cvt->v[2] << 16) | (cvt->v[0] & 0xffff));
+    k->v1r = _mm256_set1_epi32((RGB2YUV_ROUND << 16) | (cvt->v[1] & 0xffff));
+    k->y_offset = _mm256_set1_epi16((short)cvt->y_offset);
+}
+
+SDL_TARGET_AVX2 static SDL_INLINE __m256i
+RGB2YUV_Dot_AVX2(__m256i c02, __m256i c1, __m256i k02, __m256i k1r)
+{
+    c1 = _mm256_or_si256(c1, _mm256_set1_epi32(0x10000));
+    return _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(c02, k02), _mm256_madd_epi16(c1, k1r)), RGB2YUV_SHIFT);
+}
+
+/* Packs two pairs of 8 values, each in order, to 32 bytes in order */
+SDL_TARGET_AVX2 static SDL_INLINE __m256i
+RGB2YUV_Pack32_AVX2(__m256i a0, __m256i a1, __m256i b0, __m256i b1, __m256i offset)
+{
+    const __m256i packed = _mm256_packus_epi16(_mm256_add_epi16(_mm256_packs_epi32(a0, a1), offset),
+                                               _mm256_add_epi16(_mm256_packs_epi32(b0, b1), offset));
+    return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+/* Converts 32 pixels to 32 Y values */
+SDL_TARGET_AVX2 static SDL_INLINE __m256i
+RGB2YUV_Y32_AVX2(const Uint32 *src, const RGB2YUVFactorsAVX2 *k)
+{
+    const __m256i mask02 = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i mask1 = _mm256_set1_epi32(0xff);
+    __m256i y[4];
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        const __m256i p = _mm256_loadu_si256((const __m256i *)(src + 8 * i));
+        y[i] = RGB2YUV_Dot_AVX2(_mm256_and_si256(p, mask02), _mm256_and_si256(_mm256_srli_epi32(p, 8), mask1), k->y02, k->y1r);
+    }
+    return RGB2YUV_Pack32_AVX2(y[0], y[1], y[2], y[3], k->y_offset);
+}
+
+/* Sums the channels of 8 pixels from each row and adds adjacent pixels,
+   leaving the (c0, c2) and c1 sums in the low 64 bits of each lane */
+SDL_TARGET_AVX2 static SDL_INLINE void
+RGB2YUV_Sum2x2_AVX2(const Uint32 *row0, const Uint32 *row1, __m256i *c02, __m256i *c1)
+{
+    const __m256i mask02 = _mm256_set1_epi32(0x00ff00ff);
+    const __m256i mask1 = _mm256_set1_epi32(0xff);
+    const __m256i p0 = _mm256_loadu_si256((const __m256i *)row0);
+    const __m256i p1 = _mm256_loadu_si256((const __m256i *)row1);
+    __m256i s02 = _mm256_add_epi32(_mm256_and_si256(p0, mask02), _mm256_and_si256(p1, mask02));
+    __m256i s1 = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(p0, 8), mask1), _mm256_and_si256(_mm256_srli_epi32(p1, 8), mask1));
+
+    s02 = _mm256_add_epi32(s02, _mm256_srli_epi64(s02, 32));
+    s1 = _mm256_add_epi32(s1, _mm256_srli_epi64(s1, 32));
+    *c02 = _mm256_shuffle_epi32(s02, _MM_SHUFFLE(3, 1, 2, 0));
+    *c1 = _mm256_shuffle_epi32(s1, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/* Converts 32 pixels of two rows to 16 U values in the low half and 16 V values in the high half */
+SDL_TARGET_AVX2 static SDL_INLINE __m256i
+RGB2YUV_UV16_AVX2(const Uint32 *row0, const Uint32 *row1, const RGB2YUVFactorsAVX2 *k)
+{
+    const __m256i uv_offset = _mm256_set1_epi16(128);
+    __m256i u[2], v[2];
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        __m256i a02, a1, b02, b1, c02, c1;
+
+        RGB2YUV_Sum2x2_AVX2(row0 + 16 * i, row1 + 16 * i, &a02, &a1);
+        RGB2YUV_Sum2x2_AVX2(row0 + 16 * i + 8, row1 + 16 * i + 8, &b02, &b1);
+        /* The unpack leaves the blocks in 0, 1, 4, 5, 2, 3, 6, 7 order */
+        c02 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a02, b02), _MM_SHUFFLE(3, 1, 2, 0));
+        c1 = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a1, b1), _MM_SHUFFLE(3, 1, 2, 0));
+        c02 = _mm256_srli_epi16(c02, 2);
+        c1 = _mm256_srli_epi32(c1, 2);
+        u[i] = RGB2YUV_Dot_AVX2(c02, c1, k->u02, k->u1r);
+        v[i] = RGB2YUV_Dot_AVX2(c02, c1, k->v02, k->v1r);
+    }
+    return RGB2YUV_Pack32_AVX2(u[0], u[1], v[0], v[1], uv_offset);
+}
+
+/* Converts whole blocks of 32 pixels and returns how many pixels were done */
+SDL_TARGET_AVX2 static int
+RGB2YUV_Row_Y_AVX2(const Uint32 *src, Uint8 *dst, int width, const RGB2YUVCoefficients *cvt)
+{
+    RGB2YUVFactorsAVX2 k;
+    int i;
+
+    RGB2YUV_GetFactorsAVX2(cvt, &k);
+    for (i = 0; i + 32 <= width; i += 32) {
+        _mm256_storeu_si256((__m256i *)(dst + i), RGB2YUV_Y32_AVX2(src + i, &k));
+    }
+    return i;
+}
+
+SDL_TARGET_AVX2 static int
+RGB2YUV_Row_UV_AVX2(const Uint32 *row0, const Uint32 *row1, Uint8 *plane_u, Uint8 *plane_v, int uv_step, int width, const RGB2YUVCoefficients *cvt)
+{
+    RGB2YUVFactorsAVX2 k;
+    int i;
+
+    RGB2YUV_GetFactorsAVX2(cvt, &k);
+    for (i = 0; i + 32 <= width; i += 32) {
+        const __m256i uv = RGB2YUV_UV16_AVX2(row0 + i, row1 + i, &k);
+        const __m128i u = _mm256_castsi256_si128(uv);
+        const __m128i v = _mm256_extracti128_si256(uv, 1);
+
+        if (uv_step == 1) {
+            _mm_storeu_si128((__m128i *)plane_u, u);
+            _mm_storeu_si128((__m128i *)plane_v, v);
+        } else if (plane_u < plane_v) {
+            _mm_storeu_si128((__m128i *)plane_u, _mm_unpacklo_epi8(u, v));
+            _mm_storeu_si128((__m128i *)(plane_u + 16), _mm_unpackhi_epi8(u, v));
+        } else {
+            _mm_storeu_si128((__m128i *)plane_v, _mm_unpacklo_epi8(v, u));
+            _mm_storeu_si128((__m128i *)(plane_v + 16), _mm_unpackhi_epi8(v, u));
+        }
+        plane_u += 16 * uv_step;
+        plane_v += 16 * uv_step;
+    }
+    return i;
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#ifdef __ARM_NEON
+static SDL_INLINE int32x4_t
+RGB2YUV_Dot_NEON(uint32x4_t c0, uint32x4_t c1, uint32x4_t c2, const int *k)
+{
+    int32x4_t sum = vdupq_n_s32(RGB2YUV_ROUND);
+    sum = vmlaq_n_s32(sum, vreinterpretq_s32_u32(c0), k[0]);
+    sum = vmlaq_n_s32(sum, vreinterpretq_s32_u32(c1), k[1]);
+    sum = vmlaq_n_s32(sum, vreinterpretq_s32_u32(c2), k[2]);
+    return vshrq_n_s32(sum, RGB2YUV_SHIFT);
+}
+
+/* Converts 8 pixels to 8 Y values */
+static SDL_INLINE uint8x8_t
+RGB2YUV_Y8_NEON(const Uint32 *src, const RGB2YUVCoefficients *cvt)
+{
+    const uint32x4_t mask = vdupq_n_u32(0xff);
+    int32x4_t y[2];
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        const uint32x4_t p = vld1q_u32(src + 4 * i);
+        y[i] = RGB2YUV_Dot_NEON(vandq_u32(p, mask), vandq_u32(vshrq_n_u32(p, 8), mask), vandq_u32(vshrq_n_u32(p, 16), mask), cvt->y);
+    }
+    return vqmovun_s16(vaddq_s16(vcombine_s16(vmovn_s32(y[0]), vmovn_s32(y[1])), vdupq_n_s16((short)cvt->y_offset)));
+}
+
+/* Averages one channel of 8 pixels from each row down to 4 values */
+static SDL_INLINE uint32x4_t
+RGB2YUV_Avg2x2_NEON(uint32x4_t a0, uint32x4_t a1, uint32x4_t b0, uint32x4_t b1, int shift)
+{
+    const uint32x4_t mask = vdupq_n_u32(0xff);
+    const int32x4_t right = vdupq_n_s32(-shift);
+    const uint32x4_t a = vaddq_u32(vandq_u32(vshlq_u32(a0, right), mask), vandq_u32(vshlq_u32(a1, right), mask));
+    const uint32x4_t b = vaddq_u32(vandq_u32(vshlq_u32(b0, right), mask), vandq_u32(vshlq_u32(b1, right), mask));
+    return vshrq_n_u32(vcombine_u32(vpadd_u32(vget_low_u32(a), vget_high_u32(a)),
+                                    vpadd_u32(vget_low_u32(b), vget_high_u32(b))), 2);
+}
+
+/* Converts 16 pixels of two rows to 8 U and 8 V values */
+static SDL_INLINE uint8x8x2_t
+RGB2YUV_UV8_NEON(const Uint32 *row0, const Uint32 *row1, const RGB2YUVCoefficients *cvt)
+{
+    const int16x8_t uv_offset = vdupq_n_s16(128);
+    int32x4_t u[2], v[2];
+    uint8x8x2_t uv;
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        const uint32x4_t a0 = vld1q_u32(row0 + 8 * i);
+        const uint32x4_t b0 = vld1q_u32(row0 + 8 * i + 4);
+        const uint32x4_t a1 = vld1q_u32(row1 + 8 * i);
+        const uint32x4_t b1 = vld1q_u32(row1 + 8 * i + 4);
+        const uint32x4_t c0 = RGB2YUV_Avg2x2_NEON(a0, a1, b0, b1, 0);
+        const uint32x4_t c1 = RGB2YUV_Avg2x2_NEON(a0, a1, b0, b1, 8);
+        const uint32x4_t c2 = RGB2YUV_Avg2x2_NEON(a0, a1, b0, b1, 16);
+        u[i] = RGB2YUV_Dot_NEON(c0, c1, c2, cvt->u);
+        v[i] = RGB2YUV_Dot_NEON(c0, c1, c2, cvt->v);
+    }
+    uv.val[0] = vqmovun_s16(vaddq_s16(vcombine_s16(vmovn_s32(u[0]), vmovn_s32(u[1])), uv_offset));
+    uv.val[1] = vqmovun_s16(vaddq_s16(vcombine_s16(vmovn_s32(v[0]), vmovn_s32(v[1])), uv_offset));
+    return uv;
+}
+#endif /* __ARM_NEON */
+
+static void
+RGB2YUV_Row_Y(const Uint32 *src, Uint8 *dst, int width, const RGB2YUVCoefficients *cvt)
+{
+    int i = 0;
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        i = RGB2YUV_Row_Y_AVX2(src, dst, width, cvt);
+    }
+#endif
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        RGB2YUVFactorsSSE2 k;
+
+        RGB2YUV_GetFactorsSSE2(cvt, &k);
+        for (; i + 16 <= width; i += 16) {
+            _mm_storeu_si128((__m128i *)(dst + i), RGB2YUV_Y16_SSE2(src + i, &k));
+        }
+    }
+#endif
+#ifdef __ARM_NEON
+    if (SDL_HasNEON()) {
+        for (; i + 8 <= width; i += 8) {
+            vst1_u8(dst + i, RGB2YUV_Y8_NEON(src + i, cvt));
+        }
+    }
+#endif
+    for (; i < width; ++i) {
+        const Uint32 p = src[i];
+        dst[i] = MAKE_Y(PIXEL_C0(p), PIXEL_C1(p), PIXEL_C2(p));
+    }
+}
+
+/* Averages each 2x2 block of row0 and row1 into one U and one V value.
+   Pass the same row twice for the last row of an odd height, and the
+   last column of an odd width is paired with itself. */
+static void
+RGB2YUV_Row_UV(const Uint32 *row0, const Uint32 *row1, Uint8 *plane_u, Uint8 *plane_v, int uv_step, int width, const RGB2YUVCoefficients *cvt)
+{
+    int i = 0;
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        i = RGB2YUV_Row_UV_AVX2(row0, row1, plane_u, plane_v, uv_step, width, cvt);
+        plane_u += (i / 2) * uv_step;
+        plane_v += (i / 2) * uv_step;
+    }
+#endif
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        RGB2YUVFactorsSSE2 k;
+
+        RGB2YUV_GetFactorsSSE2(cvt, &k);
+        for (; i + 16 <= width; i += 16) {
+            const __m128i uv = RGB2YUV_UV8_SSE2(row0 + i, row1 + i, &k);
+            const __m128i vu = _mm_srli_si128(uv, 8);
+
+            if (uv_step == 1) {
+                _mm_storel_epi64((__m128i *)plane_u, uv);
+                _mm_storel_epi64((__m128i *)plane_v, vu);
+            } else if (plane_u < plane_v) {
+                _mm_storeu_si128((__m128i *)plane_u, _mm_unpacklo_epi8(uv, vu));
+            } else {
+                _mm_storeu_si128((__m128i *)plane_v, _mm_unpacklo_epi8(vu, uv));
+            }
+            plane_u += 8 * uv_step;
+            plane_v += 8 * uv_step;
+        }
+    }
+#endif
+#ifdef __ARM_NEON
+    if (SDL_HasNEON()) {
+        for (; i + 16 <= width; i += 16) {
+            uint8x8x2_t uv = RGB2YUV_UV8_NEON(row0 + i, row1 + i, cvt);
+
+            if (uv_step == 1) {
+                vst1_u8(plane_u, uv.val[0]);
+                vst1_u8(plane_v, uv.val[1]);
+            } else if (plane_u < plane_v) {
+                vst2_u8(plane_u, uv);
+            } else {
+                const uint8x8_t u = uv.val[0];
+                uv.val[0] = uv.val[1];
+                uv.val[1] = u;
+                vst2_u8(plane_v, uv);
+            }
+            plane_u += 8 * uv_step;
+            plane_v += 8 * uv_step;
+        }
+    }
+#endif
+    for (; i < width; i += 2) {
+        const int i1 = (i + 1 < width) ? (i + 1) : i;
+        const Uint32 p1 = row0[i];
+        const Uint32 p2 = row0[i1];
+        const Uint32 p3 = row1[i];
+        const Uint32 p4 = row1[i1];
+        const Uint32 c0 = (PIXEL_C0(p1) + PIXEL_C0(p2) + PIXEL_C0(p3) + PIXEL_C0(p4)) >> 2;
+        const Uint32 c1 = (PIXEL_C1(p1) + PIXEL_C1(p2) + PIXEL_C1(p3) + PIXEL_C1(p4)) >> 2;
+        const Uint32 c2 = (PIXEL_C2(p1) + PIXEL_C2(p2) + PIXEL_C2(p3) + PIXEL_C2(p4)) >> 2;
+        *plane_u = MAKE_U(c0, c1, c2);
+        *plane_v = MAKE_V(c0, c1, c2);
+        plane_u += uv_step;
+        plane_v += uv_step;
+    }
+}
+
+/* Writes one row of YUY2, UYVY or YVYU, sharing U and V between each pair of pixels */
+static void
+RGB2YUV_Row_Packed(const Uint32 *src, Uint8 *dst, int width, Uint32 dst_format, const RGB2YUVCoefficients *cvt)
+{
+    int y0, u, y1, v;
+    int i = 0;
+
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_UYVY:
+        u = 0; y0 = 1; v = 2; y1 = 3;
+        break;
+    case SDL_PIXELFORMAT_YVYU:
+        y0 = 0; v = 1; y1 = 2; u = 3;
+        break;
+    default: /* SDL_PIXELFORMAT_YUY2 */
+        y0 = 0; u = 1; y1 = 2; v = 3;
+        break;
+    }
+
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        RGB2YUVFactorsSSE2 k;
+
+        RGB2YUV_GetFactorsSSE2(cvt, &k);
+        for (; i + 16 <= width; i += 16) {
+            const __m128i y = RGB2YUV_Y16_SSE2(src + i, &k);
+            const __m128i uv = RGB2YUV_UV8_SSE2(src + i, src + i, &k);
+            const __m128i vu = _mm_srli_si128(uv, 8);
+            __m128i lo, hi;
+
+            if (dst_format == SDL_PIXELFORMAT_UYVY) {
+                const __m128i c = _mm_unpacklo_epi8(uv, vu);
+                lo = _mm_unpacklo_epi8(c, y);
+                hi = _mm_unpackhi_epi8(c, y);
+            } else if (dst_format == SDL_PIXELFORMAT_YVYU) {
+                const __m128i c = _mm_unpacklo_epi8(vu, uv);
+                lo = _mm_unpacklo_epi8(y, c);
+                hi = _mm_unpackhi_epi8(y, c);
+            } else {
+                const __m128i c = _mm_unpacklo_epi8(uv, vu);
+                lo = _mm_unpacklo_epi8(y, c);
+                hi = _mm_unpackhi_epi8(y, c);
+            }
+            _mm_storeu_si128((__m128i *)dst, lo);
+            _mm_storeu_si128((__m128i *)(dst + 16), hi);
+            dst += 32;
+        }
+    }
+#endif
+#ifdef __ARM_NEON
+    if (SDL_HasNEON()) {
+        for (; i + 16 <= width; i += 16) {
+            const uint8x8x2_t y = vuzp_u8(RGB2YUV_Y8_NEON(src + i, cvt), RGB2YUV_Y8_NEON(src + i + 8, cvt));
+            const uint8x8x2_t uv = RGB2YUV_UV8_NEON(src + i, src + i, cvt);
+            uint8x8x4_t out;
+
+            out.val[y0] = y.val[0];
+            out.val[y1] = y.val[1];
+            out.val[u] = uv.val[0];
+            out.val[v] = uv.val[1];
+            vst4_u8(dst, out);
+            dst += 32;
+        }
+    }
+#endif
+    for (; i < width; i += 2) {
+        const Uint32 p1 = src[i];
+        const Uint32 p2 = (i + 1 < width) ? src[i + 1] : p1;
+        const Uint32 c0 = (PIXEL_C0(p1) + PIXEL_C0(p2)) >> 1;
+        const Uint32 c1 = (PIXEL_C1(p1) + PIXEL_C1(p2)) >> 1;
+        const Uint32 c2 = (PIXEL_C2(p1) + PIXEL_C2(p2)) >> 1;
+        dst[y0] = MAKE_Y(PIXEL_C0(p1), PIXEL_C1(p1), PIXEL_C2(p1));
+        dst[u] = MAKE_U(c0, c1, c2);
+        dst[y1] = MAKE_Y(PIXEL_C0(p2), PIXEL_C1(p2), PIXEL_C2(p2));
+        dst[v] = MAKE_V(c0, c1, c2);
+        dst += 4;
+    }
+}
+
+#undef MAKE_Y
+#undef MAKE_U
+#undef MAKE_V
+#undef PIXEL_C0
+#undef PIXEL_C1
+#undef PIXEL_C2
+
+typedef struct
+{
+    RGB2YUVCoefficients cvt;
+    int width;
+    Uint32 dst_format;
+    const Uint8 *src;
+    int src_pitch;
+    Uint8 *plane_y;
+    Uint8 *plane_u;
+    Uint8 *plane_v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    int uv_step;
+} RGBtoYUVRows;
+
+/* Rows of a YV12, IYUV, NV12 or NV21 image, start is always even */
+static void SDLCALL
+SDL_ConvertPixels_XRGB8888_to_YUV_Planar(int start, int end, void *data)
+{
+    const RGBtoYUVRows *rows = (const RGBtoYUVRows *) data;
+    const Uint8 *curr_row = rows->src + start * rows->src_pitch;
+    Uint8 *plane_y = rows->plane_y + start * rows->y_stride;
+    Uint8 *plane_u = rows->plane_u + (start / 2) * rows->uv_stride;
+    Uint8 *plane_v = rows->plane_v + (start / 2) * rows->uv_stride;
+    int j;
+
+    for (j = start; j < end; j += 2) {
+        const Uint8 *next_row = (j + 1 < end) ? (curr_row + rows->src_pitch) : curr_row;
+
+        RGB2YUV_Row_Y((const Uint32 *)curr_row, plane_y, rows->width, &rows->cvt);
+        if (next_row != curr_row) {
+            RGB2YUV_Row_Y((const Uint32 *)next_row, plane_y + rows->y_stride, rows->width, &rows->cvt);
+        }
+        RGB2YUV_Row_UV((const Uint32 *)curr_row, (const Uint32 *)next_row, plane_u, plane_v, rows->uv_step, rows->width, &rows->cvt);
+
+        plane_y += 2 * rows->y_stride;
+        plane_u += rows->uv_stride;
+        plane_v += rows->uv_stride;
+        curr_row += 2 * rows->src_pitch;
+    }
+}
+
+/* Rows of a YUY2, UYVY or YVYU image */
+static void SDLCALL
+SDL_ConvertPixels_XRGB8888_to_YUV_Packed(int start, int end, void *data)
+{
+    const RGBtoYUVRows *rows = (const RGBtoYUVRows *) data;
+    int j;
+
+    for (j = start; j < end; j++) {
+        RGB2YUV_Row_Packed((const Uint32 *)(rows->src + j * rows->src_pitch), rows->plane_y + j * rows->y_stride, rows->width, rows->dst_format, &rows->cvt);
+    }
+}
+
+/* Converts ARGB8888, XRGB8888, ABGR8888 or XBGR8888 directly, the alpha channel is ignored */
+static int
+SDL_ConvertPixels_XRGB8888_to_YUV(int width, int height, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+{
+    RGBtoYUVRows rows;
+
+    SDL_zero(rows);
+    RGB2YUV_GetCoefficients(width, height, src_format, &rows.cvt);
+    rows.width = width;
+    rows.dst_format = dst_format;
+    rows.src = (const Uint8 *)src;
+    rows.src_pitch = src_pitch;
 
     switch (dst_format) 
     {
@@ -546,239 +1130,33 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
     case SDL_PIXELFORMAT_IYUV:
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
-        {
-            const Uint8 *curr_row, *next_row;
-            
-            Uint8 *plane_y;
-            Uint8 *plane_u;
-            Uint8 *plane_v;
-            Uint8 *plane_interleaved_uv;
-            Uint32 y_stride, uv_stride, y_skip, uv_skip;
-
-            GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
-                         (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
-                         &y_stride, &uv_stride);
-            plane_interleaved_uv = (plane_y + height * y_stride);
-            y_skip = (y_stride - width);
-
-            curr_row = (const Uint8*)src;
-
-            /* Write Y plane */
-            for (j = 0; j < height; j++) {
-                for (i = 0; i < width; i++) {
-                    const Uint32 p1 = ((const Uint32 *)curr_row)[i];
-                    const Uint32 r = (p1 & 0x00ff0000) >> 16;
-                    const Uint32 g = (p1 & 0x0000ff00) >> 8;
-                    const Uint32 b = (p1 & 0x000000ff);
-                    *plane_y++ = MAKE_Y(r, g, b);
-                }
-                plane_y += y_skip;
-                curr_row += src_pitch;
-            }
-
-            curr_row = (const Uint8*)src;
-            next_row = (const Uint8*)src;
-            next_row += src_pitch;
-
-            if (dst_format == SDL_PIXELFORMAT_YV12 || dst_format == SDL_PIXELFORMAT_IYUV)
-            {
-                /* Write UV planes, not interleaved */
-                uv_skip = (uv_stride - (width + 1)/2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    plane_u += uv_skip;
-                    plane_v += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    plane_u += uv_skip;
-                    plane_v += uv_skip;
-                }
-            }
-            else if (dst_format == SDL_PIXELFORMAT_NV12)
-            {
-                uv_skip = (uv_stride - ((width + 1)/2)*2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    plane_interleaved_uv += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                }
-            } 
-            else /* dst_format == SDL_PIXELFORMAT_NV21 */
-            {
-                uv_skip = (uv_stride - ((width + 1)/2)*2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    plane_interleaved_uv += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                }
-            }
-        }
+        GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
+                     (const Uint8 **)&rows.plane_y, (const Uint8 **)&rows.plane_u, (const Uint8 **)&rows.plane_v,
+                     &rows.y_stride, &rows.uv_stride);
+        rows.uv_step = (dst_format == SDL_PIXELFORMAT_NV12 || dst_format == SDL_PIXELFORMAT_NV21) ? 2 : 1;
+        SDL_BlitRows(width, height, 2, SDL_ConvertPixels_XRGB8888_to_YUV_Planar, &rows);
         break;
 
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
         {
-            const Uint8 *curr_row = (const Uint8*) src;
-            Uint8 *plane           = (Uint8*) dst;
             const int row_size = (4 * ((width + 1) / 2));
-            int plane_skip;
 
             if (dst_pitch < row_size) {
                 return SDL_SetError("Destination pitch is too small, expected at least %d\n", row_size);
             }
-            plane_skip = (dst_pitch - row_size);
 
             /* Write YUV plane, packed */
-            if (dst_format == SDL_PIXELFORMAT_YUY2) 
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* Y U Y1 V */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                        *plane++ = MAKE_V(R, G, B);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* Y U Y V */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
-            } 
-            else if (dst_format == SDL_PIXELFORMAT_UYVY)
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* U Y V Y1 */
-                        *plane++ = MAKE_U(R, G, B);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* U Y V Y */
-                        *plane++ = MAKE_U(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
-            }
-            else if (dst_format == SDL_PIXELFORMAT_YVYU)
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* Y V Y1 U */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                        *plane++ = MAKE_U(R, G, B);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* Y V Y U */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
-            }
+            rows.plane_y = (Uint8 *)dst;
+            rows.y_stride = dst_pitch;
+            SDL_BlitRows(width, height, 1, SDL_ConvertPixels_XRGB8888_to_YUV_Packed, &rows);
         }
         break;
 
     default:
         return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
     }
-#undef MAKE_Y
-#undef MAKE_U
-#undef MAKE_V
-#undef READ_2x2_PIXELS
-#undef READ_2x1_PIXELS
-#undef READ_1x2_PIXELS
-#undef READ_1x1_PIXEL
-#undef READ_TWO_RGB_PIXELS
-#undef READ_ONE_RGB_PIXEL
     return 0;
 }
 
@@ -810,12 +1188,13 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
     }
 #endif
 
-    /* ARGB8888 to FOURCC */
-    if (src_format == SDL_PIXELFORMAT_ARGB8888) {
-        return SDL_ConvertPixels_ARGB8888_to_YUV(width, height, src, src_pitch, dst_format, dst, dst_pitch);
+    /* 32-bit RGB to FOURCC */
+    if (src_format == SDL_PIXELFORMAT_ARGB8888 || src_format == SDL_PIXELFORMAT_XRGB8888 ||
+        src_format == SDL_PIXELFORMAT_ABGR8888 || src_format == SDL_PIXELFORMAT_XBGR8888) {
+        return SDL_ConvertPixels_XRGB8888_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
     }
 
-    /* not ARGB8888 to FOURCC : need an intermediate conversion */
+    /* other RGB to FOURCC : need an intermediate conversion */
     {
         int ret;
         void *tmp;
@@ -834,7 +1213,7 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
         }
 
         /* convert tmp/ARGB8888 to dst/FOURCC */
-        ret = SDL_ConvertPixels_ARGB8888_to_YUV(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch);
+        ret = SDL_ConvertPixels_XRGB8888_to_YUV(width, height, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch, dst_format, dst, dst_pitch);
         SDL_free(tmp);
         return ret;
     }
@@ -296,6 +296,7 @@ struct _TTF_Font {
     hb_direction_t hb_direction;
 #endif
     int render_sdf;
+    int render_premultiplied;
 
     /* Extra layout setting for wrapped text */
     int horizontal_align;
@@ -3499,6 +3500,12 @@ static SDL_Surface* TTF_Render_Internal(TTF_Font *font, const char *text, const
         Draw_Line(font, textbuf, 0, ystart + font->strikethrough_top_row, width, font->line_thickness, color, render_mode);
     }
 
+    if (font->render_premultiplied && render_mode == RENDER_BLENDED) {
+        if (SDL_PremultiplySurfaceAlpha(textbuf) < 0) {
+            goto failure;
+        }
+    }
+
     if (utf8_alloc) {
         SDL_stack_free(utf8_alloc);
     }
@@ -3899,6 +3906,12 @@ static SDL_Surface* TTF_Render_Wrapped_Internal(TTF_Font *font, const char *text
         }
     }
 
+    if (font->render_premultiplied && render_mode == RENDER_BLENDED) {
+        if (SDL_PremultiplySurfaceAlpha(textbuf) < 0) {
+            goto failure;
+        }
+    }
+
     if (strLines) {
         SDL_free(strLines);
     }
@@ -4123,6 +4136,20 @@ SDL_bool TTF_GetFontSDF(const TTF_Font *font)
     return font->render_sdf;
 }
 
+int TTF_SetFontPremultipliedAlpha(TTF_Font *font, SDL_bool on_off)
+{
+    TTF_CHECK_POINTER(font, -1);
+    /* The glyph cache holds coverage only, the colors are applied per render */
+    font->render_premultiplied = on_off;
+    return 0;
+}
+
+SDL_bool TTF_GetFontPremultipliedAlpha(const TTF_Font *font)
+{
+    TTF_CHECK_POINTER(font, SDL_FALSE);
+    return font->render_premultiplied;
+}
+
 void TTF_SetFontWrappedAlign(TTF_Font *font, int align)
 {
     TTF_CHECK_POINTER(font,);
@@ -900,6 +900,33 @@ extern DECLSPEC int TTF_SetFontSDF(TTF_Font *font, SDL_bool on_off);
  */
 extern DECLSPEC SDL_bool TTF_GetFontSDF(const TTF_Font *font);
 
+/**
+ * Enable premultiplied alpha output (with the Blended APIs)
+ *
+ * The colors of the returned surfaces are multiplied by their alpha, and the
+ * surfaces are marked with SDL_SetSurfacePremultiplied(), so that they are
+ * blitted with SDL_BLENDMODE_BLEND_PREMULTIPLIED.
+ *
+ * \param font TTF_Font handle
+ * \param on_off boolean on/off
+ *
+ * \returns 0 if successful, -1 on error
+ *
+ * \sa TTF_GetFontPremultipliedAlpha
+ */
+extern DECLSPEC int TTF_SetFontPremultipliedAlpha(TTF_Font *font, SDL_bool on_off);
+
+/**
+ * Tell whether premultiplied alpha output is enabled
+ *
+ * \param font TTF_Font handle
+ *
+ * \returns boolean on/off
+ *
+ * \sa TTF_SetFontPremultipliedAlpha
+ */
+extern DECLSPEC SDL_bool TTF_GetFontPremultipliedAlpha(const TTF_Font *font);
+
 /**
  * Report SDL_ttf errors
  *
@@ -968,6 +968,959 @@ int audio_openCloseAudioDeviceConnected()
 }
 
 
+/**
+ * \brief Opens devices in low-latency mode on the dummy and disk drivers and checks their timing statistics.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ */
+int audio_lowLatencyStats()
+{
+    const char *drivers[] = { "dummy", "disk" };
+    int result;
+    int i;
+    int totalDelay;
+    SDL_AudioDeviceID id;
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceStats stats;
+    Uint64 expectedPeriod;
+
+    /* Negative cases */
+    result = SDL_GetAudioDeviceStats(0, &stats);
+    SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(0, ...)");
+    SDLTest_AssertCheck(result < 0, "Validate result value; expected: <0 got: %d", result);
+
+    /* Stop SDL audio subsystem */
+    SDL_QuitSubSystem( SDL_INIT_AUDIO );
+    SDLTest_AssertPass("Call to SDL_QuitSubSystem(SDL_INIT_AUDIO)");
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOW_LATENCY, "1");
+    SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_LOW_LATENCY, \"1\")");
+
+    for (i = 0; i < SDL_arraysize(drivers); i++) {
+        result = SDL_AudioInit(drivers[i]);
+        SDLTest_AssertPass("Call to SDL_AudioInit('%s')", drivers[i]);
+        if (result != 0) {
+            SDLTest_Log("Audio driver '%s' not available, skipping", drivers[i]);
+            continue;
+        }
+
+        SDL_memset(&desired, 0, sizeof(desired));
+        desired.freq = 48000;
+        desired.format = AUDIO_S16SYS;
+        desired.channels = 2;
+        desired.samples = 0;
+        desired.callback = _audio_testCallback;
+        desired.userdata = NULL;
+
+        id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+        SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, ...) on '%s'", drivers[i]);
+        SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >1, got: %i", id);
+        if (id <= 1) {
+            SDL_AudioQuit();
+            continue;
+        }
+        SDLTest_AssertCheck(obtained.samples == 128, "Validate default low-latency period; expected: 128, got: %i", obtained.samples);
+
+        _audio_testCallbackCounter = 0;
+        SDL_PauseAudioDevice(id, 0);
+        SDLTest_AssertPass("Call to SDL_PauseAudioDevice(%i, 0)", id);
+
+        /* Wait for a few dozen periods */
+        totalDelay = 0;
+        do {
+            SDL_Delay(10);
+            totalDelay += 10;
+        } while (_audio_testCallbackCounter < 20 && totalDelay < 2000);
+        SDLTest_AssertCheck(_audio_testCallbackCounter >= 20, "Verify callback counter; expected: >=20 got: %d", _audio_testCallbackCounter);
+
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(%i, ...)", id);
+        SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+        SDLTest_AssertCheck(stats.low_latency == SDL_TRUE, "Validate low_latency flag; expected: SDL_TRUE got: %d", stats.low_latency);
+        expectedPeriod = ((Uint64) obtained.samples * 1000000000) / obtained.freq;
+        SDLTest_AssertCheck(stats.period_ns > expectedPeriod - 1000 && stats.period_ns < expectedPeriod + 1000,
+            "Validate period; expected: ~%" SDL_PRIu64 " got: %" SDL_PRIu64, expectedPeriod, stats.period_ns);
+        SDLTest_AssertCheck(stats.wakeups > 0, "Validate wakeups; expected: >0 got: %" SDL_PRIu64, stats.wakeups);
+        SDLTest_AssertCheck(stats.callbacks > 0, "Validate callbacks; expected: >0 got: %" SDL_PRIu64, stats.callbacks);
+        SDLTest_AssertCheck(stats.callback_max_ns >= stats.callback_ns, "Validate callback_max_ns >= callback_ns");
+        SDLTest_AssertCheck(stats.callback_min_ns <= stats.callback_avg_ns && stats.callback_avg_ns <= stats.callback_max_ns,
+            "Validate callback_min_ns <= callback_avg_ns <= callback_max_ns; got: %" SDL_PRIu64 " %" SDL_PRIu64 " %" SDL_PRIu64,
+            stats.callback_min_ns, stats.callback_avg_ns, stats.callback_max_ns);
+        SDLTest_AssertCheck(stats.late_wakeups <= stats.wakeups, "Validate late_wakeups <= wakeups");
+        SDLTest_AssertCheck(stats.overruns == 0, "Validate overruns on a playback device; expected: 0 got: %" SDL_PRIu64, stats.overruns);
+        SDLTest_AssertCheck(stats.wake_jitter_max_ns >= stats.wake_jitter_ns, "Validate wake_jitter_max_ns >= wake_jitter_ns");
+        SDLTest_Log("'%s': wakeups=%" SDL_PRIu64 " underruns=%" SDL_PRIu64 " callback_max_ns=%" SDL_PRIu64 " wake_jitter_max_ns=%" SDL_PRIu64,
+            drivers[i], stats.wakeups, stats.underruns, stats.callback_max_ns, stats.wake_jitter_max_ns);
+
+        result = SDL_GetAudioDeviceStats(id, NULL);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(%i, NULL)", id);
+        SDLTest_AssertCheck(result < 0, "Validate result value; expected: <0 got: %d", result);
+
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+        SDL_AudioQuit();
+        SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    }
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOW_LATENCY, "0");
+
+    /* Restart audio again */
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks the queue backlog reported for a device fed with SDL_QueueAudio.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ */
+int audio_deviceStatsQueue()
+{
+    Uint8 buffer[4096];
+    int result;
+    SDL_AudioDeviceID id;
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceStats stats;
+    Uint32 queued;
+
+    SDL_SetHint(SDL_HINT_AUDIO_STATS_LOG_INTERVAL, "50");
+    SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_STATS_LOG_INTERVAL, \"50\")");
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    result = SDL_AudioInit("dummy");
+    SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+    if (result != 0) {
+        SDLTest_Log("Skipping: dummy driver not available: %s", SDL_GetError());
+        SDL_SetHint(SDL_HINT_AUDIO_STATS_LOG_INTERVAL, "0");
+        _audioSetUp(NULL);
+        return TEST_SKIPPED;
+    }
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 22050;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 512;
+    desired.callback = NULL;
+
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, ...)");
+    SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >1, got: %i", id);
+    if (id > 1) {
+        /* The device starts paused, so nothing drains the queue. */
+        SDL_memset(buffer, 0, sizeof(buffer));
+        result = SDL_QueueAudio(id, buffer, sizeof(buffer));
+        SDLTest_AssertPass("Call to SDL_QueueAudio(%i, ...)", id);
+        SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(%i, ...)", id);
+        SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+        queued = SDL_GetQueuedAudioSize(id);
+        SDLTest_AssertCheck(stats.queued_bytes == queued, "Validate queued_bytes; expected: %u got: %u", (unsigned int) queued, (unsigned int) stats.queued_bytes);
+        SDLTest_AssertCheck(stats.queued_bytes == sizeof(buffer), "Validate queued_bytes; expected: %u got: %u", (unsigned int) sizeof(buffer), (unsigned int) stats.queued_bytes);
+
+        /* Let the device drain the queue (and log a few times). */
+        SDL_PauseAudioDevice(id, 0);
+        SDL_Delay(200);
+
+        result = SDL_GetAudioDeviceStats(id, &stats);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(%i, ...)", id);
+        SDLTest_AssertCheck(stats.queued_bytes == 0, "Validate queued_bytes after draining; expected: 0 got: %u", (unsigned int) stats.queued_bytes);
+        SDLTest_AssertCheck(stats.callbacks > 0, "Validate callbacks; expected: >0 got: %" SDL_PRIu64, stats.callbacks);
+
+        SDL_CloseAudioDevice(id);
+        SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+    }
+
+    SDL_SetHint(SDL_HINT_AUDIO_STATS_LOG_INTERVAL, "0");
+
+    /* Restore the default driver for the remaining tests */
+    SDL_AudioQuit();
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+
+/* Fills the buffer with the constant Sint16 sample in userdata. */
+static void SDLCALL _audio_constantS16Callback(void *userdata, Uint8 *stream, int len)
+{
+    Sint16 *samples = (Sint16 *) stream;
+    int i;
+    for (i = 0; i < len / (int) sizeof(Sint16); i++) {
+        samples[i] = *(const Sint16 *) userdata;
+    }
+}
+
+/* Fills the buffer with the constant float sample in userdata. */
+static void SDLCALL _audio_constantF32Callback(void *userdata, Uint8 *stream, int len)
+{
+    float *samples = (float *) stream;
+    int i;
+    for (i = 0; i < len / (int) sizeof(float); i++) {
+        samples[i] = *(const float *) userdata;
+    }
+}
+
+/**
+ * \brief Mixes two logical devices onto one physical device of the disk driver and checks the output.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenAudioDevice
+ * \sa https://wiki.libsdl.org/SDL_SetAudioDeviceGain
+ */
+int audio_logicalDevicesMix()
+{
+    const Sint16 s16_value = 8192;  /* 0.25 as float */
+    const float f32_value = 0.25f;
+    const float expected[4] = { 0.0f, 0.125f, 0.25f, 0.375f };
+    int counts[4] = { 0, 0, 0, 0 };
+    int unexpected = 0;
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceStats stats;
+    SDL_AudioDeviceID id1, id2;
+    SDL_RWops *rw;
+    float gain = 0.0f;
+    float sample;
+    int result;
+    int i;
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "1");
+    SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, \"1\")");
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    result = SDL_AudioInit("disk");
+    SDLTest_AssertPass("Call to SDL_AudioInit('disk')");
+    if (result != 0) {
+        SDLTest_Log("Skipping: disk driver not available: %s", SDL_GetError());
+        SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "0");
+        _audioSetUp(NULL);
+        return TEST_SKIPPED;
+    }
+
+    /* The first device sets up the physical device: stereo at 44100 Hz. */
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 44100;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 512;
+    desired.callback = _audio_constantS16Callback;
+    desired.userdata = (void *) &s16_value;
+    id1 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, S16 stereo)");
+    SDLTest_AssertCheck(id1 > 1, "Validate device ID; expected: >1, got: %i", id1);
+
+    /* The second one needs its format and channels converted. */
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 1;
+    desired.samples = 256;
+    desired.callback = _audio_constantF32Callback;
+    desired.userdata = (void *) &f32_value;
+    id2 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, F32 mono)");
+    SDLTest_AssertCheck(id2 > 1 && id2 != id1, "Validate device ID; expected: >1 and not %i, got: %i", id1, id2);
+
+    if (id1 > 1 && id2 > 1) {
+        result = SDL_GetAudioDeviceGain(id1, &gain);
+        SDLTest_AssertCheck(result == 0 && gain == 1.0f, "Validate default gain; expected: 1.0, got: %f", gain);
+        result = SDL_SetAudioDeviceGain(id1, 0.5f);
+        SDLTest_AssertPass("Call to SDL_SetAudioDeviceGain(%i, 0.5)", id1);
+        SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+        result = SDL_GetAudioDeviceGain(id1, &gain);
+        SDLTest_AssertCheck(result == 0 && gain == 0.5f, "Validate gain; expected: 0.5, got: %f", gain);
+
+        SDL_PauseAudioDevice(id1, 0);
+        SDL_PauseAudioDevice(id2, 0);
+        SDLTest_AssertCheck(SDL_GetAudioDeviceStatus(id2) == SDL_AUDIO_PLAYING, "Validate device status is SDL_AUDIO_PLAYING");
+        SDL_Delay(300);
+
+        result = SDL_GetAudioDeviceStats(id2, &stats);
+        SDLTest_AssertPass("Call to SDL_GetAudioDeviceStats(%i, ...)", id2);
+        SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0 got: %d", result);
+        SDLTest_AssertCheck(stats.wakeups > 0, "Validate wakeups of the mixing thread; expected: >0 got: %" SDL_PRIu64, stats.wakeups);
+    }
+
+    /* Closing the last logical device closes the physical device and its file. */
+    SDL_CloseAudioDevice(id1);
+    SDL_CloseAudioDevice(id2);
+    SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+    rw = SDL_RWFromFile("sdlaudio.raw", "rb");
+    SDLTest_AssertCheck(rw != NULL, "Validate the disk driver wrote sdlaudio.raw");
+    if (rw != NULL) {
+        while (SDL_RWread(rw, &sample, sizeof(sample), 1) == 1) {
+            for (i = 0; i < SDL_arraysize(expected); i++) {
+                if (SDL_fabs(sample - expected[i]) < 0.0001) {
+                    counts[i]++;
+                    break;
+                }
+            }
+            if (i == SDL_arraysize(expected)) {
+                unexpected++;
+            }
+        }
+        SDL_RWclose(rw);
+
+        SDLTest_AssertCheck(counts[3] > 0, "Validate mixed samples (0.125 + 0.25) were written; got: %d", counts[3]);
+        SDLTest_AssertCheck(unexpected == 0, "Validate there were no unexpected samples; got: %d", unexpected);
+    }
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "0");
+
+    /* Restore the default driver for the remaining tests */
+    SDL_AudioQuit();
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks sharing the dummy driver's only device and the gain functions with invalid input.
+ *
+ * \sa https://wiki.libsdl.org/SDL_SetAudioDeviceGain
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceGain
+ */
+int audio_logicalDevicesNegative()
+{
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceID id1, id2, id3;
+    float gain;
+    int result;
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    result = SDL_AudioInit("dummy");
+    SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+    if (result != 0) {
+        SDLTest_Log("Skipping: dummy driver not available: %s", SDL_GetError());
+        _audioSetUp(NULL);
+        return TEST_SKIPPED;
+    }
+
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 22050;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 512;
+    desired.callback = NULL;
+
+    /* A regular device has no gain. */
+    id1 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id1 > 1, "Validate device ID; expected: >1, got: %i", id1);
+    result = SDL_SetAudioDeviceGain(id1, 0.5f);
+    SDLTest_AssertCheck(result == -1, "Validate SDL_SetAudioDeviceGain() on a regular device fails; got: %d", result);
+    result = SDL_GetAudioDeviceGain(id1, &gain);
+    SDLTest_AssertCheck(result == -1, "Validate SDL_GetAudioDeviceGain() on a regular device fails; got: %d", result);
+
+    /* The dummy driver only has one device, which a logical device can't share with it. */
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "1");
+    id2 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id2 == 0, "Validate opening a logical device next to a regular one fails; got: %i", id2);
+    SDL_CloseAudioDevice(id1);
+
+    /* ...but logical devices share it among themselves. */
+    id2 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id2 > 1, "Validate device ID; expected: >1, got: %i", id2);
+    id3 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id3 > 1 && id3 != id2, "Validate device ID; expected: >1 and not %i, got: %i", id2, id3);
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "0");
+    id1 = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id1 == 0, "Validate opening a regular device next to logical ones fails; got: %i", id1);
+
+    result = SDL_SetAudioDeviceGain(id2, -1.0f);
+    SDLTest_AssertCheck(result == -1, "Validate negative gain fails; got: %d", result);
+    result = SDL_GetAudioDeviceGain(id2, NULL);
+    SDLTest_AssertCheck(result == -1, "Validate NULL gain pointer fails; got: %d", result);
+    result = SDL_SetAudioDeviceGain(0, 1.0f);
+    SDLTest_AssertCheck(result == -1, "Validate invalid device ID fails; got: %d", result);
+    result = SDL_SetAudioDeviceGain(id3, 2.0f);
+    SDLTest_AssertCheck(result == 0, "Validate gain above 1.0 works; got: %d", result);
+
+    /* Closing in open order leaves the physical device to the second one for a while. */
+    SDL_PauseAudioDevice(id3, 0);
+    SDL_CloseAudioDevice(id2);
+    SDL_Delay(50);
+    SDLTest_AssertCheck(SDL_GetAudioDeviceStatus(id3) == SDL_AUDIO_PLAYING, "Validate remaining device is still playing");
+    SDL_CloseAudioDevice(id3);
+    SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+    /* Restore the default driver for the remaining tests */
+    SDL_AudioQuit();
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+
+/* The device a callback closes from the mixing thread, and whether it did. */
+typedef struct
+{
+    SDL_AudioDeviceID id;
+    SDL_atomic_t closed;
+} _audioSelfClose;
+
+/* Closes its own logical device from the mixing thread. */
+static void SDLCALL
+_audio_selfCloseCallback(void *userdata, Uint8 *stream, int len)
+{
+    _audioSelfClose *data = (_audioSelfClose *) userdata;
+    SDL_memset(stream, 0, len);
+    if (SDL_AtomicCAS(&data->closed, 0, 1)) {
+        SDL_CloseAudioDevice(data->id);
+    }
+}
+
+/**
+ * \brief Closes the last logical device on a physical device from its own callback.
+ *
+ * \sa https://wiki.libsdl.org/SDL_CloseAudioDevice
+ */
+int audio_logicalDevicesCloseInCallback()
+{
+    SDL_AudioSpec desired, obtained;
+    _audioSelfClose data;
+    SDL_AudioDeviceID id;
+    int result;
+    int i;
+
+    SDL_AudioQuit();
+    SDLTest_AssertPass("Call to SDL_AudioQuit()");
+    result = SDL_AudioInit("dummy");
+    SDLTest_AssertPass("Call to SDL_AudioInit('dummy')");
+    if (result != 0) {
+        SDLTest_Log("Skipping: dummy driver not available: %s", SDL_GetError());
+        _audioSetUp(NULL);
+        return TEST_SKIPPED;
+    }
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "1");
+    SDL_memset(&desired, 0, sizeof(desired));
+    desired.freq = 22050;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 512;
+    desired.callback = _audio_selfCloseCallback;
+    desired.userdata = &data;
+    SDL_AtomicSet(&data.closed, 0);
+    data.id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(data.id > 1, "Validate device ID; expected: >1, got: %i", data.id);
+
+    if (data.id > 1) {
+        SDL_PauseAudioDevice(data.id, 0);
+        for (i = 0; (i < 100) && !SDL_AtomicGet(&data.closed); i++) {
+            SDL_Delay(10);
+        }
+        SDLTest_AssertCheck(SDL_AtomicGet(&data.closed) == 1, "Validate the callback closed its device");
+        SDL_Delay(50);
+        SDLTest_AssertCheck(SDL_GetAudioDeviceStatus(data.id) == SDL_AUDIO_STOPPED, "Validate the device is closed");
+    }
+
+    /* The physical device closed in its own callback is gone; opening again sets up a new one. */
+    desired.callback = NULL;
+    id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >1, got: %i", id);
+    SDL_CloseAudioDevice(id);
+    SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+    SDL_SetHint(SDL_HINT_AUDIO_LOGICAL_DEVICES, "0");
+
+    /* Restore the default driver for the remaining tests */
+    SDL_AudioQuit();
+    _audioSetUp(NULL);
+
+    return TEST_COMPLETED;
+}
+
+
+/* Writes a little-endian value to a byte buffer. */
+static Uint8 *
+_audioPutLE(Uint8 *p, Uint32 value, int bytes)
+{
+    int i;
+    for (i = 0; i < bytes; i++) {
+        *p++ = (Uint8) (value >> (i * 8));
+    }
+    return p;
+}
+
+/* Builds a WAVE file in memory with random sample data. ADPCM blocks get valid
+ * block headers. Returns the size of the file in bytes; buf must be large
+ * enough for a 44 byte header, the extension and datalen bytes of data.
+ */
+static size_t
+_audioBuildWave(Uint8 *buf, Uint16 tag, Uint16 channels, Uint16 blockalign, Uint16 bits, const Uint8 *ext, Uint16 extlen, Uint32 datalen)
+{
+    Uint8 *p = buf;
+    Uint8 *data;
+    Uint32 i, c;
+    const Uint32 fmtlen = 18 + extlen;
+    const Uint32 riffsize = 4 + 8 + fmtlen + 8 + datalen;
+
+    p = _audioPutLE(p, 0x46464952, 4); /* "RIFF" */
+    p = _audioPutLE(p, riffsize, 4);
+    p = _audioPutLE(p, 0x45564157, 4); /* "WAVE" */
+    p = _audioPutLE(p, 0x20746D66, 4); /* "fmt " */
+    p = _audioPutLE(p, fmtlen, 4);
+    p = _audioPutLE(p, tag, 2);
+    p = _audioPutLE(p, channels, 2);
+    p = _audioPutLE(p, 22050, 4);
+    p = _audioPutLE(p, 22050 * blockalign, 4);
+    p = _audioPutLE(p, blockalign, 2);
+    p = _audioPutLE(p, bits, 2);
+    p = _audioPutLE(p, extlen, 2);
+    SDL_memcpy(p, ext, extlen);
+    p += extlen;
+    p = _audioPutLE(p, 0x61746164, 4); /* "data" */
+    p = _audioPutLE(p, datalen, 4);
+
+    data = p;
+    for (i = 0; i < datalen; i++) {
+        data[i] = SDLTest_RandomUint8();
+    }
+
+    /* Fix up the block headers. */
+    for (i = 0; i + blockalign <= datalen && (tag == 0x0002 || tag == 0x0011); i += blockalign) {
+        for (c = 0; c < channels; c++) {
+            if (tag == 0x0002) {
+                data[i + c] = SDLTest_RandomIntegerInRange(0, 6);  /* coefficient index */
+            } else {
+                data[i + c * 4 + 2] = SDLTest_RandomIntegerInRange(0, 88);  /* step index */
+                data[i + c * 4 + 3] = 0;
+            }
+        }
+    }
+
+    return (size_t) (data - buf) + datalen;
+}
+
+/* Loads a WAVE file with SDL_LoadWAV_RW and checks that streaming it gives the same data. */
+static void
+_audioCheckWaveStream(const char *name, SDL_RWops *src, SDL_bool memory)
+{
+    SDL_AudioSpec refspec, spec;
+    Uint8 *refbuf = NULL;
+    Uint32 reflen = 0;
+    Uint8 *buf;
+    SDL_WaveStream *stream;
+    Sint64 length, frame;
+    int framesize, total, got, i;
+
+    SDL_RWseek(src, 0, RW_SEEK_SET);
+    SDL_LoadWAV_RW(src, 0, &refspec, &refbuf, &reflen);
+    SDLTest_AssertPass("Call to SDL_LoadWAV_RW(%s)", name);
+    SDLTest_AssertCheck(refbuf != NULL, "Validate SDL_LoadWAV_RW result");
+    if (refbuf == NULL) {
+        return;
+    }
+
+    SDL_RWseek(src, 0, RW_SEEK_SET);
+    stream = SDL_WaveStreamOpen(src, 0, &spec);
+    SDLTest_AssertPass("Call to SDL_WaveStreamOpen(%s, %s)", name, memory ? "memory" : "file");
+    SDLTest_AssertCheck(stream != NULL, "Validate stream; got: %s", stream ? "non-NULL" : SDL_GetError());
+    if (stream == NULL) {
+        SDL_FreeWAV(refbuf);
+        return;
+    }
+
+    SDLTest_AssertCheck(spec.format == refspec.format, "Validate format; expected: 0x%x got: 0x%x", refspec.format, spec.format);
+    SDLTest_AssertCheck(spec.channels == refspec.channels, "Validate channels; expected: %d got: %d", refspec.channels, spec.channels);
+    SDLTest_AssertCheck(spec.freq == refspec.freq, "Validate freq; expected: %d got: %d", refspec.freq, spec.freq);
+
+    framesize = (SDL_AUDIO_BITSIZE(spec.format) / 8) * spec.channels;
+    length = SDL_WaveStreamLength(stream);
+    SDLTest_AssertPass("Call to SDL_WaveStreamLength()");
+    SDLTest_AssertCheck(length * framesize == reflen, "Validate length; expected: %u bytes got: %d frames", (unsigned int) reflen, (int) length);
+
+    /* Read everything in odd sized chunks. */
+    buf = (Uint8 *) SDL_malloc(reflen + 4096);
+    SDLTest_AssertCheck(buf != NULL, "Validate buffer allocation");
+    if (buf == NULL) {
+        SDL_WaveStreamClose(stream);
+        SDL_FreeWAV(refbuf);
+        return;
+    }
+    total = 0;
+    do {
+        got = SDL_WaveStreamRead(stream, buf + total, 1000);
+        SDLTest_AssertCheck(got >= 0 && got % framesize == 0, "Validate read; got: %d", got);
+        total += got > 0 ? got : 0;
+    } while (got > 0 && total <= (int) reflen);
+    SDLTest_AssertCheck(total == (int) reflen, "Validate total read; expected: %u got: %d", (unsigned int) reflen, total);
+    SDLTest_AssertCheck(SDL_memcmp(buf, refbuf, SDL_min((Uint32) total, reflen)) == 0, "Validate streamed data matches SDL_LoadWAV_RW");
+    SDLTest_AssertCheck(SDL_WaveStreamTell(stream) == length, "Validate position at end of stream");
+
+    /* Seek around and compare. */
+    for (i = 0; i < 8 && length > 0; i++) {
+        const int count = SDLTest_RandomIntegerInRange(1, 600);
+        frame = (i == 0) ? 0 : (i == 1) ? length - 1 : SDLTest_RandomIntegerInRange(0, (Sint32) (length - 1));
+        got = SDL_WaveStreamSeek(stream, frame);
+        SDLTest_AssertCheck(got == 0, "Validate seek to frame %d", (int) frame);
+        SDLTest_AssertCheck(SDL_WaveStreamTell(stream) == frame, "Validate position after seek");
+        got = SDL_WaveStreamRead(stream, buf, count * framesize);
+        SDLTest_AssertCheck(got == SDL_min(count, (int) (length - frame)) * framesize, "Validate read after seek; got: %d", got);
+        SDLTest_AssertCheck(got <= 0 || SDL_memcmp(buf, refbuf + frame * framesize, got) == 0, "Validate data after seek to frame %d", (int) frame);
+    }
+
+    got = SDL_WaveStreamSeek(stream, length + 1);
+    SDLTest_AssertCheck(got == -1, "Validate seek past the end fails");
+
+    SDL_free(buf);
+    SDL_WaveStreamClose(stream);
+    SDLTest_AssertPass("Call to SDL_WaveStreamClose()");
+    SDL_FreeWAV(refbuf);
+}
+
+/**
+ * \brief Streams WAVE files with several encodings and compares with SDL_LoadWAV_RW.
+ *
+ * \sa https://wiki.libsdl.org/SDL_WaveStreamOpen
+ * \sa https://wiki.libsdl.org/SDL_WaveStreamRead
+ * \sa https://wiki.libsdl.org/SDL_WaveStreamSeek
+ */
+int audio_waveStreamRead()
+{
+    /* wSamplesPerBlock, wNumCoef and the 7 preset coefficient pairs. */
+    const Uint8 msadpcm_ext[32] = {
+        244, 0, 7, 0,
+        0, 1, 0, 0,  0, 2, 0, 0xff,  0, 0, 0, 0,  0xc0, 0, 0x40, 0,
+        0xf0, 0, 0, 0,  0xcc, 1, 0x30, 0xff,  0x88, 1, 0x18, 0xff
+    };
+    const Uint8 imaadpcm_ext[2] = { 249, 0 };
+    const size_t bufsize = 64 * 1024;
+    Uint8 *wave;
+    size_t wavelen;
+    SDL_RWops *rw;
+
+    wave = (Uint8 *) SDL_malloc(bufsize);
+    SDLTest_AssertCheck(wave != NULL, "Validate buffer allocation");
+    if (wave == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Stereo MS ADPCM with a truncated last block. */
+    wavelen = _audioBuildWave(wave, 0x0002, 2, 256, 4, msadpcm_ext, sizeof(msadpcm_ext), 256 * 20 + 100);
+    rw = SDL_RWFromConstMem(wave, (int) wavelen);
+    _audioCheckWaveStream("MS ADPCM", rw, SDL_TRUE);
+    SDL_RWclose(rw);
+
+    /* Stereo IMA ADPCM. */
+    wavelen = _audioBuildWave(wave, 0x0011, 2, 256, 4, imaadpcm_ext, sizeof(imaadpcm_ext), 256 * 30);
+    rw = SDL_RWFromConstMem(wave, (int) wavelen);
+    _audioCheckWaveStream("IMA ADPCM", rw, SDL_TRUE);
+    SDL_RWclose(rw);
+
+    /* 24-bit PCM gets expanded to 32 bits. */
+    wavelen = _audioBuildWave(wave, 0x0001, 2, 6, 24, NULL, 0, 6 * 5000);
+    rw = SDL_RWFromConstMem(wave, (int) wavelen);
+    _audioCheckWaveStream("24-bit PCM", rw, SDL_TRUE);
+    SDL_RWclose(rw);
+
+    /* mu-law gets expanded to 16 bits. */
+    wavelen = _audioBuildWave(wave, 0x0007, 1, 1, 8, NULL, 0, 12345);
+    rw = SDL_RWFromConstMem(wave, (int) wavelen);
+    _audioCheckWaveStream("mu-law", rw, SDL_TRUE);
+    SDL_RWclose(rw);
+
+    /* Truncated 16-bit PCM, the data chunk claims more than there is. */
+    wavelen = _audioBuildWave(wave, 0x0001, 2, 4, 16, NULL, 0, 4 * 3000);
+    rw = SDL_RWFromConstMem(wave, (int) wavelen - 4 * 1000);
+    _audioCheckWaveStream("truncated 16-bit PCM", rw, SDL_TRUE);
+    SDL_RWclose(rw);
+
+    SDL_free(wave);
+
+    /* A file on disk. */
+    rw = SDL_RWFromFile("sample.wav", "rb");
+    if (rw == NULL) {
+        SDLTest_Log("sample.wav not found, skipping file test");
+    } else {
+        _audioCheckWaveStream("sample.wav", rw, SDL_FALSE);
+        SDL_RWclose(rw);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Feeds a WAVE stream into an SDL_AudioStream.
+ *
+ * \sa https://wiki.libsdl.org/SDL_WaveStreamPut
+ */
+int audio_waveStreamPut()
+{
+    const Uint8 imaadpcm_ext[2] = { 249, 0 };
+    const size_t bufsize = 32 * 1024;
+    Uint8 *wave, *buf;
+    size_t wavelen;
+    SDL_AudioSpec refspec, spec;
+    Uint8 *refbuf = NULL;
+    Uint32 reflen = 0;
+    SDL_AudioStream *audiostream;
+    SDL_WaveStream *stream;
+    int result, total = 0;
+
+    wave = (Uint8 *) SDL_malloc(bufsize);
+    buf = (Uint8 *) SDL_malloc(bufsize * 4);
+    SDLTest_AssertCheck(wave != NULL && buf != NULL, "Validate buffer allocation");
+    if (wave == NULL || buf == NULL) {
+        SDL_free(wave);
+        SDL_free(buf);
+        return TEST_ABORTED;
+    }
+
+    wavelen = _audioBuildWave(wave, 0x0011, 2, 256, 4, imaadpcm_ext, sizeof(imaadpcm_ext), 256 * 20);
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &refspec, &refbuf, &reflen);
+    SDLTest_AssertCheck(refbuf != NULL, "Validate SDL_LoadWAV_RW result");
+
+    /* freesrc closes the RWops with the stream. */
+    stream = SDL_WaveStreamOpen(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec);
+    SDLTest_AssertPass("Call to SDL_WaveStreamOpen()");
+    SDLTest_AssertCheck(stream != NULL, "Validate stream");
+
+    audiostream = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, spec.format, spec.channels, spec.freq);
+    SDLTest_AssertCheck(audiostream != NULL, "Validate audio stream");
+
+    if (stream != NULL && audiostream != NULL && refbuf != NULL) {
+        do {
+            result = SDL_WaveStreamPut(stream, audiostream, 3000);
+            SDLTest_AssertCheck(result >= 0, "Validate SDL_WaveStreamPut result; got: %d", result);
+            total += result > 0 ? result : 0;
+        } while (result > 0);
+        SDLTest_AssertCheck(total == (int) reflen, "Validate total put; expected: %u got: %d", (unsigned int) reflen, total);
+
+        SDL_AudioStreamFlush(audiostream);
+        result = SDL_AudioStreamGet(audiostream, buf, (int) (bufsize * 4));
+        SDLTest_AssertPass("Call to SDL_AudioStreamGet()");
+        SDLTest_AssertCheck(result == (int) reflen, "Validate converted length; expected: %u got: %d", (unsigned int) reflen, result);
+        SDLTest_AssertCheck(result > 0 && SDL_memcmp(buf, refbuf, SDL_min((Uint32) result, reflen)) == 0, "Validate audio stream data matches SDL_LoadWAV_RW");
+    }
+
+    SDL_FreeAudioStream(audiostream);
+    SDL_WaveStreamClose(stream);
+    SDL_FreeWAV(refbuf);
+    SDL_free(wave);
+    SDL_free(buf);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Negative tests for the SDL_WaveStream functions.
+ *
+ * \sa https://wiki.libsdl.org/SDL_WaveStreamOpen
+ */
+int audio_waveStreamNegative()
+{
+    const Uint8 garbage[64] = { 'R', 'I', 'F', 'F', 56, 0, 0, 0, 'N', 'O', 'P', 'E' };
+    SDL_AudioSpec spec;
+    SDL_WaveStream *stream;
+    Uint8 buf[16];
+    int result;
+
+    stream = SDL_WaveStreamOpen(NULL, 0, &spec);
+    SDLTest_AssertCheck(stream == NULL, "Validate NULL source fails");
+
+    stream = SDL_WaveStreamOpen(SDL_RWFromConstMem(garbage, sizeof(garbage)), 1, NULL);
+    SDLTest_AssertCheck(stream == NULL, "Validate NULL spec fails");
+
+    stream = SDL_WaveStreamOpen(SDL_RWFromConstMem(garbage, sizeof(garbage)), 1, &spec);
+    SDLTest_AssertCheck(stream == NULL, "Validate non-WAVE data fails");
+
+    result = SDL_WaveStreamRead(NULL, buf, sizeof(buf));
+    SDLTest_AssertCheck(result == -1, "Validate SDL_WaveStreamRead(NULL) fails");
+    result = SDL_WaveStreamSeek(NULL, 0);
+    SDLTest_AssertCheck(result == -1, "Validate SDL_WaveStreamSeek(NULL) fails");
+    SDLTest_AssertCheck(SDL_WaveStreamTell(NULL) == -1, "Validate SDL_WaveStreamTell(NULL) fails");
+    SDLTest_AssertCheck(SDL_WaveStreamLength(NULL) == -1, "Validate SDL_WaveStreamLength(NULL) fails");
+    result = SDL_WaveStreamPut(NULL, NULL, 0);
+    SDLTest_AssertCheck(result == -1, "Validate SDL_WaveStreamPut(NULL) fails");
+
+    SDL_WaveStreamClose(NULL);
+    SDLTest_AssertPass("Call to SDL_WaveStreamClose(NULL)");
+
+    return TEST_COMPLETED;
+}
+
+
+/* Loads a WAVE file on one and on four threads and compares the output. */
+static void
+_audioCompareDecodeThreads(const char *name, const Uint8 *wave, size_t wavelen)
+{
+    SDL_AudioSpec spec;
+    Uint8 *serial_buf = NULL, *threaded_buf = NULL;
+    Uint32 serial_len = 0, threaded_len = 0;
+
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "1");
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec, &serial_buf, &serial_len);
+    SDLTest_AssertCheck(serial_buf != NULL, "%s: Validate loading on one thread, got: %s", name, serial_buf ? "ok" : SDL_GetError());
+
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "4");
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec, &threaded_buf, &threaded_len);
+    SDLTest_AssertCheck(threaded_buf != NULL, "%s: Validate loading on four threads, got: %s", name, threaded_buf ? "ok" : SDL_GetError());
+
+    if (serial_buf != NULL && threaded_buf != NULL) {
+        SDLTest_AssertCheck(serial_len == threaded_len, "%s: Validate output size, expected: %u, got: %u", name, (unsigned int) serial_len, (unsigned int) threaded_len);
+        SDLTest_AssertCheck(serial_len == threaded_len && SDL_memcmp(serial_buf, threaded_buf, serial_len) == 0, "%s: Validate threaded output matches", name);
+    }
+
+    SDL_FreeWAV(serial_buf);
+    SDL_FreeWAV(threaded_buf);
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "0");
+}
+
+/**
+ * \brief Checks that decoding ADPCM blocks on several threads gives the same data as decoding them on one.
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_adpcmDecodeThreads()
+{
+    /* wSamplesPerBlock (filled in below), wNumCoef and the 7 preset coefficient pairs. */
+    Uint8 msadpcm_ext[32] = {
+        0, 0, 7, 0,
+        0, 1, 0, 0,  0, 2, 0, 0xff,  0, 0, 0, 0,  0xc0, 0, 0x40, 0,
+        0xf0, 0, 0, 0,  0xcc, 1, 0x30, 0xff,  0x88, 1, 0x18, 0xff
+    };
+    Uint8 imaadpcm_ext[2];
+    const Uint32 blocks = 2400;
+    const size_t bufsize = 128 + 256 * blocks + 256;
+    Uint16 channels, blockalign, spb;
+    Uint8 *wave;
+    size_t wavelen;
+    char name[32];
+
+    wave = (Uint8 *) SDL_malloc(bufsize);
+    SDLTest_AssertCheck(wave != NULL, "Validate buffer allocation");
+    if (wave == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Enough blocks to decode more than 2 MB, plus a truncated last block. */
+    for (channels = 1; channels <= 2; channels++) {
+        blockalign = 256;
+        spb = (blockalign - 7 * channels) * 2 / channels + 2;
+        msadpcm_ext[0] = (Uint8) spb;
+        msadpcm_ext[1] = (Uint8) (spb >> 8);
+        wavelen = _audioBuildWave(wave, 0x0002, channels, blockalign, 4, msadpcm_ext, sizeof(msadpcm_ext), blockalign * blocks + 100);
+        SDL_snprintf(name, sizeof(name), "MS ADPCM, %d channels", (int) channels);
+        _audioCompareDecodeThreads(name, wave, wavelen);
+    }
+
+    for (channels = 1; channels <= 5; channels += 2) {
+        blockalign = 4 * channels * (256 / (4 * channels));
+        spb = (blockalign - 4 * channels) * 2 / channels + 1;
+        imaadpcm_ext[0] = (Uint8) spb;
+        imaadpcm_ext[1] = (Uint8) (spb >> 8);
+        wavelen = _audioBuildWave(wave, 0x0011, channels, blockalign, 4, imaadpcm_ext, sizeof(imaadpcm_ext), blockalign * blocks + 4 * channels + 8);
+        SDL_snprintf(name, sizeof(name), "IMA ADPCM, %d channels", (int) channels);
+        _audioCompareDecodeThreads(name, wave, wavelen);
+    }
+
+    SDL_free(wave);
+
+    return TEST_COMPLETED;
+}
+
+/* Decodes a WAVE file and checks the length and an FNV-1a hash of the samples. */
+static void
+_audioCheckDecodeHash(const char *name, const Uint8 *wave, size_t wavelen, Uint32 expected_len, Uint32 expected_hash)
+{
+    SDL_AudioSpec spec;
+    Uint8 *buf = NULL;
+    Uint32 len = 0;
+    Uint32 hash = 2166136261u;
+    Uint32 i;
+
+    SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec, &buf, &len);
+    SDLTest_AssertPass("Call to SDL_LoadWAV_RW(%s)", name);
+    SDLTest_AssertCheck(buf != NULL, "Validate SDL_LoadWAV_RW result; got: %s", buf ? "non-NULL" : SDL_GetError());
+    if (buf == NULL) {
+        return;
+    }
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ buf[i]) * 16777619u;
+    }
+    SDLTest_AssertCheck(len == expected_len, "Validate %s length; expected: %u got: %u", name, (unsigned int) expected_len, (unsigned int) len);
+    SDLTest_AssertCheck(hash == expected_hash, "Validate %s samples; expected hash: 0x%08x got: 0x%08x", name, (unsigned int) expected_hash, (unsigned int) hash);
+    SDL_FreeWAV(buf);
+}
+
+/**
+ * \brief Checks that the ADPCM decoders give exactly the samples the original decoders gave.
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_adpcmDecodeGolden()
+{
+    /* The expected results are those of the straightforward decoders from
+       before they were optimized, for WAVE data made from a fixed seed. */
+    static const struct {
+        Uint16 tag;
+        Uint16 channels;
+        Uint16 blockalign;
+        Uint32 blocks;
+        Uint32 extra;
+        Uint32 len;
+        Uint32 hash;
+    } cases[] = {
+        { 0x0002, 1, 256, 40, 100, 40000, 0x9f50ab05 },
+        { 0x0002, 2, 512, 20, 37, 40000, 0x544156f4 },
+        { 0x0011, 1, 256, 40, 12, 40400, 0xd7dc4359 },
+        { 0x0011, 2, 512, 20, 16, 40400, 0xb889c484 },
+        { 0x0011, 5, 240, 30, 28, 26700, 0xf8ea7c5f }
+    };
+    /* wSamplesPerBlock (filled in below), wNumCoef and the 7 preset coefficient pairs. */
+    Uint8 msadpcm_ext[32] = {
+        0, 0, 7, 0,
+        0, 1, 0, 0,  0, 2, 0, 0xff,  0, 0, 0, 0,  0xc0, 0, 0x40, 0,
+        0xf0, 0, 0, 0,  0xcc, 1, 0x30, 0xff,  0x88, 1, 0x18, 0xff
+    };
+    Uint8 imaadpcm_ext[2];
+    Uint8 *wave;
+    size_t wavelen;
+    char name[32];
+    int i;
+
+    wave = (Uint8 *) SDL_malloc(128 + 512 * 20 + 100);
+    SDLTest_AssertCheck(wave != NULL, "Validate buffer allocation");
+    if (wave == NULL) {
+        return TEST_ABORTED;
+    }
+
+    SDLTest_FuzzerInit(0x0123456789ABCDEFULL);
+    for (i = 0; i < (int) SDL_arraysize(cases); i++) {
+        const Uint16 channels = cases[i].channels;
+        const Uint16 blockalign = cases[i].blockalign;
+        const Uint32 datalen = blockalign * cases[i].blocks + cases[i].extra;
+        Uint16 spb;
+
+        if (cases[i].tag == 0x0002) {
+            spb = (blockalign - 7 * channels) * 2 / channels + 2;
+            msadpcm_ext[0] = (Uint8) spb;
+            msadpcm_ext[1] = (Uint8) (spb >> 8);
+            wavelen = _audioBuildWave(wave, 0x0002, channels, blockalign, 4, msadpcm_ext, sizeof(msadpcm_ext), datalen);
+            SDL_snprintf(name, sizeof(name), "MS ADPCM, %d channels", (int) channels);
+        } else {
+            spb = (blockalign - 4 * channels) * 2 / channels + 1;
+            imaadpcm_ext[0] = (Uint8) spb;
+            imaadpcm_ext[1] = (Uint8) (spb >> 8);
+            wavelen = _audioBuildWave(wave, 0x0011, channels, blockalign, 4, imaadpcm_ext, sizeof(imaadpcm_ext), datalen);
+            SDL_snprintf(name, sizeof(name), "IMA ADPCM, %d channels", (int) channels);
+        }
+        _audioCheckDecodeHash(name, wave, wavelen, cases[i].len, cases[i].hash);
+    }
+
+    SDL_free(wave);
+
+    return TEST_COMPLETED;
+}
+
 
 /* ================= Test Case References ================== */
 
@@ -1022,11 +1975,43 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_lowLatencyStats, "audio_lowLatencyStats", "Opens low-latency devices on the dummy and disk drivers and checks timing statistics.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_deviceStatsQueue, "audio_deviceStatsQueue", "Checks the queue backlog reported by SDL_GetAudioDeviceStats.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_waveStreamRead, "audio_waveStreamRead", "Streams WAVE files and compares with SDL_LoadWAV_RW.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_waveStreamPut, "audio_waveStreamPut", "Feeds a WAVE stream into an SDL_AudioStream.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_waveStreamNegative, "audio_waveStreamNegative", "Negative tests for the SDL_WaveStream functions.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_adpcmDecodeThreads, "audio_adpcmDecodeThreads", "Compares ADPCM decoding on one and on several threads.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_logicalDevicesMix, "audio_logicalDevicesMix", "Mixes logical devices onto one physical device.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_logicalDevicesNegative, "audio_logicalDevicesNegative", "Negative tests around logical devices and their gain.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_adpcmDecodeGolden, "audio_adpcmDecodeGolden", "Checks the ADPCM decoders against known output.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_logicalDevicesCloseInCallback, "audio_logicalDevicesCloseInCallback", "Closes the last logical device from its own callback.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, &audioTest19, &audioTest20, &audioTest21,
+    &audioTest22, &audioTest23, &audioTest24, &audioTest25, NULL
 };
 
 /* Audio test suite (global) */
@@ -5,6 +5,7 @@
 #include <stdio.h>
 
 #include "SDL.h"
+#include "SDL_syswm.h"
 #include "SDL_test.h"
 
 /* ================= Test Case Implementation ================== */
@@ -175,6 +176,373 @@ events_addDelEventWatchWithUserdata(void *arg)
 }
 
 
+/**
+ * @brief Pushes more events than the lock-free ring holds, with a SysWM
+ *        event in the middle, and checks they come back in order.
+ *
+ * @sa http://wiki.libsdl.org/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/SDL_PeepEvents
+ */
+int
+events_pushManyInOrder(void *arg)
+{
+   const int total = 3000;
+   SDL_SysWMmsg msg;
+   SDL_Event event;
+   SDL_Event events[64];
+   Uint8 state;
+   int expected = 0, syswm = 0, result, i;
+
+   state = SDL_EventState(SDL_SYSWMEVENT, SDL_ENABLE);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   SDL_zero(msg);
+   msg.subsystem = SDL_SYSWM_UNKNOWN;
+   for (i = 0; i < total; i++) {
+      SDL_zero(event);
+      if (i == total / 2) {
+         event.type = SDL_SYSWMEVENT;
+         event.syswm.msg = &msg;
+      } else {
+         event.type = SDL_USEREVENT;
+         event.user.code = i;
+      }
+      result = SDL_PushEvent(&event);
+      if (result != 1) {
+         SDLTest_AssertCheck(result == 1, "Check result from SDL_PushEvent, expected: 1, got: %d", result);
+         break;
+      }
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent() %d times", total);
+
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_SYSWMEVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == total, "Check number of queued events, expected: %d, got: %d", total, result);
+
+   for (;;) {
+      result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_SYSWMEVENT, SDL_USEREVENT);
+      if (result <= 0) {
+         break;
+      }
+      for (i = 0; i < result; i++) {
+         if (events[i].type == SDL_SYSWMEVENT) {
+            SDLTest_AssertCheck(expected == total / 2, "Check position of the SysWM event, expected: %d, got: %d", total / 2, expected);
+            SDLTest_AssertCheck(events[i].syswm.msg != NULL && events[i].syswm.msg != &msg, "Check that the SysWM message was copied");
+            syswm++;
+         } else if (events[i].user.code != expected) {
+            SDLTest_AssertCheck(events[i].user.code == expected, "Check event order, expected: %d, got: %d", expected, events[i].user.code);
+            expected = events[i].user.code;
+         }
+         expected++;
+      }
+   }
+   SDLTest_AssertCheck(expected == total, "Check number of events read, expected: %d, got: %d", total, expected);
+   SDLTest_AssertCheck(syswm == 1, "Check number of SysWM events read, expected: 1, got: %d", syswm);
+
+   /* The emptied list gave most of its memory back; another burst needs it again */
+   for (i = 0; i < total; i++) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+   }
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == total, "Check number of queued events after the list was trimmed, expected: %d, got: %d", total, result);
+   SDL_FlushEvent(SDL_USEREVENT);
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 0, "Check that the queue is empty, got: %d events", result);
+
+   SDL_EventState(SDL_SYSWMEVENT, state);
+   return TEST_COMPLETED;
+}
+
+#define _EVENTS_PUSH_THREADS 4
+#define _EVENTS_PER_THREAD   5000
+
+/* Pushes user events of its own type, numbered in the order they're sent */
+static int SDLCALL
+_events_pushThread(void *data)
+{
+   const int thread = (int)(intptr_t)data;
+   SDL_Event event;
+   int i;
+
+   for (i = 0; i < _EVENTS_PER_THREAD; i++) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT + thread;
+      event.user.code = i;
+      while (SDL_PushEvent(&event) != 1) {
+         SDL_Delay(1);
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief Reads events while several threads push them, taking one event type
+ *        at a time, and checks each thread's events arrive in order.
+ *
+ * @sa http://wiki.libsdl.org/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/SDL_PeepEvents
+ */
+int
+events_pushFromThreads(void *arg)
+{
+   SDL_Thread *threads[_EVENTS_PUSH_THREADS];
+   int expected[_EVENTS_PUSH_THREADS];
+   SDL_Event events[64];
+   Uint32 deadline;
+   int received = 0, errors = 0, pass = 0, result, i, t;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   for (t = 0; t < _EVENTS_PUSH_THREADS; t++) {
+      expected[t] = 0;
+      threads[t] = SDL_CreateThread(_events_pushThread, "EventPusher", (void *)(intptr_t)t);
+      SDLTest_AssertCheck(threads[t] != NULL, "Check that SDL_CreateThread() succeeded");
+   }
+
+   deadline = SDL_GetTicks() + 30000;
+   while (received < _EVENTS_PUSH_THREADS * _EVENTS_PER_THREAD && !SDL_TICKS_PASSED(SDL_GetTicks(), deadline)) {
+      const Uint32 type = SDL_USEREVENT + (pass++ % _EVENTS_PUSH_THREADS);
+      result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, type, type);
+      for (i = 0; i < result; i++) {
+         t = events[i].type - SDL_USEREVENT;
+         if (events[i].user.code != expected[t]) {
+            errors++;
+         }
+         expected[t] = events[i].user.code + 1;
+         received++;
+      }
+   }
+
+   for (t = 0; t < _EVENTS_PUSH_THREADS; t++) {
+      if (threads[t] != NULL) {
+         SDL_WaitThread(threads[t], NULL);
+      }
+   }
+
+   SDLTest_AssertCheck(received == _EVENTS_PUSH_THREADS * _EVENTS_PER_THREAD, "Check number of events read, expected: %d, got: %d", _EVENTS_PUSH_THREADS * _EVENTS_PER_THREAD, received);
+   SDLTest_AssertCheck(errors == 0, "Check that each thread's events arrived in order, got %d out of order", errors);
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_USEREVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 0, "Check that the queue is empty, got: %d events", result);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Peeks at and removes a SysWM event, and checks its message is copied.
+ *
+ * @sa http://wiki.libsdl.org/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/SDL_PeepEvents
+ */
+int
+events_peekAndGetSysWMEvent(void *arg)
+{
+   SDL_SysWMmsg msg;
+   SDL_Event event, peeked1, peeked2, got;
+   Uint8 state;
+   int result;
+
+   state = SDL_EventState(SDL_SYSWMEVENT, SDL_ENABLE);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   SDL_zero(msg);
+   msg.version.major = 12;
+   msg.version.minor = 34;
+   msg.subsystem = SDL_SYSWM_UNKNOWN;
+   SDL_zero(event);
+   event.type = SDL_SYSWMEVENT;
+   event.syswm.msg = &msg;
+   result = SDL_PushEvent(&event);
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PushEvent, expected: 1, got: %d", result);
+   msg.version.major = 0;
+
+   result = SDL_PeepEvents(&peeked1, 1, SDL_PEEKEVENT, SDL_SYSWMEVENT, SDL_SYSWMEVENT);
+   SDLTest_AssertCheck(result == 1, "Check result from first SDL_PeepEvents(SDL_PEEKEVENT), expected: 1, got: %d", result);
+   result = SDL_PeepEvents(&peeked2, 1, SDL_PEEKEVENT, SDL_SYSWMEVENT, SDL_SYSWMEVENT);
+   SDLTest_AssertCheck(result == 1, "Check result from second SDL_PeepEvents(SDL_PEEKEVENT), expected: 1, got: %d", result);
+   SDLTest_AssertCheck(peeked1.syswm.msg != peeked2.syswm.msg, "Check that each peek gets its own message");
+   SDLTest_AssertCheck(peeked1.syswm.msg->version.major == 12 && peeked1.syswm.msg->version.minor == 34, "Check first peeked message");
+   SDLTest_AssertCheck(peeked2.syswm.msg->version.major == 12 && peeked2.syswm.msg->version.minor == 34, "Check second peeked message");
+
+   result = SDL_PeepEvents(&got, 1, SDL_GETEVENT, SDL_SYSWMEVENT, SDL_SYSWMEVENT);
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PeepEvents(SDL_GETEVENT), expected: 1, got: %d", result);
+   SDLTest_AssertCheck(got.syswm.msg != NULL && got.syswm.msg != &msg, "Check that the message was copied");
+   if (got.syswm.msg) {
+      SDLTest_AssertCheck(got.syswm.msg->version.major == 12 && got.syswm.msg->version.minor == 34,
+                          "Check message version, expected: 12.34, got: %d.%d", got.syswm.msg->version.major, got.syswm.msg->version.minor);
+   }
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_SYSWMEVENT, SDL_SYSWMEVENT);
+   SDLTest_AssertCheck(result == 0, "Check that the queue is empty, got: %d events", result);
+
+   SDL_EventState(SDL_SYSWMEVENT, state);
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Removes a batch of events of a range of types with SDL_DrainEvents().
+ *
+ * @sa http://wiki.libsdl.org/SDL_DrainEvents
+ */
+int
+events_drainEvents(void *arg)
+{
+   SDL_Event event;
+   SDL_Event events[64];
+   int result, i, user = 0, other = 0;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   result = SDL_DrainEvents(NULL, 1, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result < 0, "Check result from SDL_DrainEvents(NULL), expected: <0, got: %d", result);
+
+   for (i = 0; i < 40; i++) {
+      SDL_zero(event);
+      event.type = (i % 4 == 3) ? SDL_USEREVENT + 1 : SDL_USEREVENT;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent() 40 times");
+
+   result = SDL_DrainEvents(events, 0, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_DrainEvents() with no room, expected: 0, got: %d", result);
+
+   result = SDL_DrainEvents(events, 20, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 20, "Check result from first SDL_DrainEvents(), expected: 20, got: %d", result);
+   for (i = 0; i < result; i++) {
+      if (events[i].type == SDL_USEREVENT && events[i].user.code % 4 != 3 && events[i].user.code / 4 * 3 + events[i].user.code % 4 == user) {
+         user++;
+      }
+   }
+   result = SDL_DrainEvents(events, SDL_arraysize(events), SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 10, "Check result from second SDL_DrainEvents(), expected: 10, got: %d", result);
+   for (i = 0; i < result; i++) {
+      if (events[i].type == SDL_USEREVENT && events[i].user.code % 4 != 3 && events[i].user.code / 4 * 3 + events[i].user.code % 4 == user) {
+         user++;
+      }
+   }
+   SDLTest_AssertCheck(user == 30, "Check that the events arrived in order, expected: 30, got: %d", user);
+
+   result = SDL_DrainEvents(events, SDL_arraysize(events), SDL_USEREVENT + 1, SDL_USEREVENT + 1);
+   for (i = 0; i < result; i++) {
+      if (events[i].type == SDL_USEREVENT + 1 && events[i].user.code == other * 4 + 3) {
+         other++;
+      }
+   }
+   SDLTest_AssertCheck(other == 10, "Check the other events, expected: 10, got: %d", other);
+
+   /* More events than the lock-free ring holds, so some of them wait on the list */
+   for (i = 0; i < 1500; i++) {
+      SDL_zero(event);
+      event.type = (i % 3 == 2) ? SDL_USEREVENT + 1 : SDL_USEREVENT;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+   }
+   user = 0;
+   other = 0;
+   while ((result = SDL_DrainEvents(events, SDL_arraysize(events), SDL_USEREVENT, SDL_USEREVENT)) > 0) {
+      for (i = 0; i < result; i++) {
+         if (events[i].type == SDL_USEREVENT && events[i].user.code == user / 2 * 3 + user % 2) {
+            user++;
+         }
+      }
+   }
+   SDLTest_AssertCheck(user == 1000, "Check that the events arrived in order, expected: 1000, got: %d", user);
+   while ((result = SDL_DrainEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0) {
+      for (i = 0; i < result; i++) {
+         if (events[i].type == SDL_USEREVENT + 1 && events[i].user.code == other * 3 + 2) {
+            other++;
+         }
+      }
+   }
+   SDLTest_AssertCheck(other == 500, "Check the other events, expected: 500, got: %d", other);
+
+   return TEST_COMPLETED;
+}
+
+static void
+_events_pushMouseMotion(Uint32 windowID, Sint32 x, Sint32 y, Sint32 xrel, Sint32 yrel)
+{
+   SDL_Event event;
+
+   SDL_zero(event);
+   event.type = SDL_MOUSEMOTION;
+   event.motion.windowID = windowID;
+   event.motion.x = x;
+   event.motion.y = y;
+   event.motion.xrel = xrel;
+   event.motion.yrel = yrel;
+   SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Checks that SDL_HINT_EVENT_COALESCE merges consecutive motion events.
+ *
+ * @sa http://wiki.libsdl.org/SDL_HINT_EVENT_COALESCE
+ */
+int
+events_coalesceMotion(void *arg)
+{
+   SDL_Event event;
+   SDL_Event events[16];
+   Uint8 state;
+   int result;
+
+   state = SDL_EventState(SDL_MOUSEMOTION, SDL_ENABLE);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   /* Off by default */
+   _events_pushMouseMotion(1000, 10, 10, 1, 1);
+   _events_pushMouseMotion(1000, 12, 13, 2, 3);
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_MOUSEMOTION, SDL_MOUSEMOTION);
+   SDLTest_AssertCheck(result == 2, "Check number of events without coalescing, expected: 2, got: %d", result);
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCE, "1");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_COALESCE, \"1\")");
+
+   _events_pushMouseMotion(1000, 10, 10, 1, 1);
+   _events_pushMouseMotion(1000, 12, 13, 2, 3);
+   _events_pushMouseMotion(1000, 15, 17, 3, 4);
+   _events_pushMouseMotion(1001, 50, 50, 5, 5);   /* another window */
+   _events_pushMouseMotion(1000, 20, 20, 5, 3);
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   SDL_PushEvent(&event);
+   _events_pushMouseMotion(1000, 21, 21, 1, 1);   /* not merged across the user event */
+   _events_pushMouseMotion(1000, 23, 22, 2, 1);
+
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_MOUSEMOTION, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 5, "Check number of events with coalescing, expected: 5, got: %d", result);
+   if (result == 5) {
+      SDLTest_AssertCheck(events[0].type == SDL_MOUSEMOTION && events[0].motion.windowID == 1000 &&
+                          events[0].motion.x == 15 && events[0].motion.y == 17 &&
+                          events[0].motion.xrel == 6 && events[0].motion.yrel == 8,
+                          "Check first merged event, expected: 15,17 (6,8), got: %d,%d (%d,%d)",
+                          events[0].motion.x, events[0].motion.y, events[0].motion.xrel, events[0].motion.yrel);
+      SDLTest_AssertCheck(events[1].type == SDL_MOUSEMOTION && events[1].motion.windowID == 1001,
+                          "Check that motion in another window wasn't merged");
+      SDLTest_AssertCheck(events[2].type == SDL_MOUSEMOTION && events[2].motion.xrel == 5,
+                          "Check third event, expected xrel: 5, got: %d", events[2].motion.xrel);
+      SDLTest_AssertCheck(events[3].type == SDL_USEREVENT, "Check that the user event kept its place");
+      SDLTest_AssertCheck(events[4].type == SDL_MOUSEMOTION && events[4].motion.x == 23 &&
+                          events[4].motion.xrel == 3 && events[4].motion.yrel == 2,
+                          "Check last merged event, expected: 23 (3,2), got: %d (%d,%d)",
+                          events[4].motion.x, events[4].motion.xrel, events[4].motion.yrel);
+   }
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCE, "0");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_COALESCE, \"0\")");
+   SDL_EventState(SDL_MOUSEMOTION, state);
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Events test cases */
@@ -187,9 +555,25 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pushManyInOrder, "events_pushManyInOrder", "Pushes more events than fit on the lock-free ring and checks their order", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_pushFromThreads, "events_pushFromThreads", "Pushes events from several threads while reading them by type", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_peekAndGetSysWMEvent, "events_peekAndGetSysWMEvent", "Peeks at and removes a SysWM event and checks its message", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest7 =
+        { (SDLTest_TestCaseFp)events_drainEvents, "events_drainEvents", "Removes batches of events with SDL_DrainEvents", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest8 =
+        { (SDLTest_TestCaseFp)events_coalesceMotion, "events_coalesceMotion", "Checks that consecutive motion events are merged when enabled", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6,
+    &eventsTest7, &eventsTest8, NULL
 };
 
 /* Events test suite (global) */
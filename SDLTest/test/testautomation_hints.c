@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "SDL.h"
 #include "SDL_test.h"
@@ -149,6 +150,211 @@ hints_setHint(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_GetHint and SDL_GetHintBoolean while the environment changes
+ */
+int
+hints_environment(void *arg)
+{
+  const char *name = "SDL_TEST_HINT_ENVIRONMENT";
+  const char *value;
+
+  SDL_SetHint(name, "0");
+  SDLTest_AssertPass("Call to SDL_SetHint(%s, \"0\")", name);
+  SDLTest_AssertCheck(SDL_GetHintBoolean(name, SDL_TRUE) == SDL_FALSE, "Verify boolean value");
+
+  /* Environment variables take precedence over normal priority hints */
+  SDL_setenv(name, "1", 1);
+  SDLTest_AssertPass("Call to SDL_setenv(%s, \"1\")", name);
+  value = SDL_GetHint(name);
+  SDLTest_AssertCheck(value && SDL_strcmp(value, "1") == 0, "Verify value, expected: 1, got: %s", value ? value : "null");
+  SDLTest_AssertCheck(SDL_GetHintBoolean(name, SDL_FALSE) == SDL_TRUE, "Verify boolean value from the environment");
+  SDLTest_AssertCheck(SDL_SetHint(name, "2") == SDL_FALSE, "Verify normal priority can't replace the environment");
+
+  SDL_setenv(name, "false", 1);
+  SDLTest_AssertPass("Call to SDL_setenv(%s, \"false\")", name);
+  value = SDL_GetHint(name);
+  SDLTest_AssertCheck(value && SDL_strcmp(value, "false") == 0, "Verify value, expected: false, got: %s", value ? value : "null");
+  SDLTest_AssertCheck(SDL_GetHintBoolean(name, SDL_TRUE) == SDL_FALSE, "Verify boolean value from the environment");
+
+  SDLTest_AssertCheck(SDL_SetHintWithPriority(name, "0", SDL_HINT_OVERRIDE) == SDL_TRUE, "Verify override priority replaces the environment");
+  SDLTest_AssertCheck(SDL_GetHintBoolean(name, SDL_TRUE) == SDL_FALSE, "Verify overridden boolean value");
+
+#if defined(HAVE_UNSETENV)
+  unsetenv(name);
+#else
+  SDL_setenv(name, "", 1);
+#endif
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Call to SDL_GetHintHandle and reading hints through the handle
+ */
+int
+hints_hintHandle(void *arg)
+{
+  const char *name = "SDL_TEST_HINT_HANDLE";
+  SDL_HintHandle *handle;
+  Uint32 generation, generation2;
+  const char *value, *old_value;
+
+  handle = SDL_GetHintHandle(NULL);
+  SDLTest_AssertPass("Call to SDL_GetHintHandle(NULL)");
+  SDLTest_AssertCheck(handle == NULL, "Verify NULL name gives no handle");
+
+  handle = SDL_GetHintHandle(name);
+  SDLTest_AssertPass("Call to SDL_GetHintHandle(%s)", name);
+  SDLTest_AssertCheck(handle != NULL, "Verify a handle was returned");
+  if (handle == NULL) {
+    return TEST_ABORTED;
+  }
+  SDLTest_AssertCheck(SDL_GetHintHandle(name) == handle, "Verify the same name gives the same handle");
+
+  value = SDL_GetHintHandleValue(handle);
+  SDLTest_AssertCheck(value == NULL, "Verify unset hint has no value, got: %s", value ? value : "null");
+  SDLTest_AssertCheck(SDL_GetHintHandleBoolean(handle, SDL_TRUE) == SDL_TRUE, "Verify unset boolean gives the default");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, -5) == -5, "Verify unset integer gives the default");
+  SDLTest_AssertCheck(SDL_GetHintHandleFloat(handle, 2.5f) == 2.5f, "Verify unset float gives the default");
+
+  generation = SDL_GetHintHandleGeneration(handle);
+  SDL_SetHint(name, "42");
+  SDLTest_AssertPass("Call to SDL_SetHint(%s, \"42\")", name);
+  generation2 = SDL_GetHintHandleGeneration(handle);
+  SDLTest_AssertCheck(generation2 != generation, "Verify the generation changed");
+  value = SDL_GetHintHandleValue(handle);
+  SDLTest_AssertCheck(value && SDL_strcmp(value, "42") == 0, "Verify value, expected: 42, got: %s", value ? value : "null");
+  SDLTest_AssertCheck(SDL_GetHintHandleBoolean(handle, SDL_FALSE) == SDL_TRUE, "Verify boolean value");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, 0) == 42, "Verify integer value, got: %d", SDL_GetHintHandleInt(handle, 0));
+  SDLTest_AssertCheck(SDL_GetHintHandleFloat(handle, 0.0f) == 42.0f, "Verify float value");
+
+  SDL_SetHint(name, "42");
+  SDLTest_AssertCheck(SDL_GetHintHandleGeneration(handle) == generation2, "Verify setting the same value keeps the generation");
+
+  /* Strings that were returned stay valid after the hint changes */
+  old_value = SDL_GetHint(name);
+  SDL_SetHint(name, "0.25");
+  SDLTest_AssertCheck(SDL_GetHintHandleGeneration(handle) != generation2, "Verify the generation changed again");
+  SDLTest_AssertCheck(SDL_strcmp(old_value, "42") == 0, "Verify the previous value is intact, got: %s", old_value);
+  SDLTest_AssertCheck(SDL_GetHintHandleBoolean(handle, SDL_TRUE) == SDL_FALSE, "Verify boolean value");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, 1) == 0, "Verify integer value");
+  SDLTest_AssertCheck(SDL_GetHintHandleFloat(handle, 0.0f) == 0.25f, "Verify float value");
+
+  SDL_SetHint(name, "");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, 3) == 3, "Verify empty integer gives the default");
+
+  /* Environment variables take precedence over normal priority hints */
+  generation = SDL_GetHintHandleGeneration(handle);
+  SDL_setenv(name, "7", 1);
+  SDLTest_AssertPass("Call to SDL_setenv(%s, \"7\")", name);
+  SDLTest_AssertCheck(SDL_GetHintHandleGeneration(handle) != generation, "Verify the generation changed with the environment");
+  value = SDL_GetHint(name);
+  SDLTest_AssertCheck(value && SDL_strcmp(value, "7") == 0, "Verify SDL_GetHint value, expected: 7, got: %s", value ? value : "null");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, 0) == 7, "Verify integer value from the environment");
+  SDLTest_AssertCheck(SDL_SetHint(name, "8") == SDL_FALSE, "Verify normal priority can't replace the environment");
+  SDLTest_AssertCheck(SDL_SetHintWithPriority(name, "9", SDL_HINT_OVERRIDE) == SDL_TRUE, "Verify override priority replaces the environment");
+  SDLTest_AssertCheck(SDL_GetHintHandleInt(handle, 0) == 9, "Verify overridden integer value, got: %d", SDL_GetHintHandleInt(handle, 0));
+
+#if defined(HAVE_UNSETENV)
+  unsetenv(name);
+#else
+  SDL_setenv(name, "", 1);
+#endif
+
+  return TEST_COMPLETED;
+}
+
+#define HINT_THREADS_READERS    3
+#define HINT_THREADS_CHANGES    20000
+
+typedef struct
+{
+  SDL_HintHandle *handle;
+  SDL_atomic_t done;
+  SDL_atomic_t errors;
+} HintThreadsData;
+
+/* The values set are "1", "22" and "333": a string with the wrong length or
+   mixed digits was freed or changed while it was being read */
+static SDL_bool
+_checkHintThreadsValue(const char *value)
+{
+  int i, length;
+
+  if (value == NULL) {
+    return SDL_TRUE;
+  }
+  length = value[0] - '0';
+  if (length < 1 || length > 3) {
+    return SDL_FALSE;
+  }
+  for (i = 0; i < length; i++) {
+    if (value[i] != value[0]) {
+      return SDL_FALSE;
+    }
+  }
+  return value[length] == '\0' ? SDL_TRUE : SDL_FALSE;
+}
+
+static int SDLCALL
+_hintThreadsReader(void *arg)
+{
+  HintThreadsData *data = (HintThreadsData *)arg;
+
+  while (!SDL_AtomicGet(&data->done)) {
+    const char *value = SDL_GetHint("SDL_TEST_HINT_THREADS");
+    const char *handle_value = SDL_GetHintHandleValue(data->handle);
+    const int number = SDL_GetHintHandleInt(data->handle, 1);
+
+    if (!_checkHintThreadsValue(value) || !_checkHintThreadsValue(handle_value) ||
+        (number != 1 && number != 22 && number != 333) ||
+        !_checkHintThreadsValue(value) || !_checkHintThreadsValue(handle_value)) {
+      SDL_AtomicIncRef(&data->errors);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Call to SDL_GetHint and the handle functions while another thread sets the hint
+ */
+int
+hints_threads(void *arg)
+{
+  static const char *values[] = { "1", "22", "333" };
+  HintThreadsData data;
+  SDL_Thread *threads[HINT_THREADS_READERS];
+  int i;
+
+  data.handle = SDL_GetHintHandle("SDL_TEST_HINT_THREADS");
+  SDLTest_AssertCheck(data.handle != NULL, "Verify a handle was returned");
+  if (data.handle == NULL) {
+    return TEST_ABORTED;
+  }
+  SDL_AtomicSet(&data.done, 0);
+  SDL_AtomicSet(&data.errors, 0);
+
+  for (i = 0; i < HINT_THREADS_READERS; i++) {
+    threads[i] = SDL_CreateThread(_hintThreadsReader, "HintReader", &data);
+    SDLTest_AssertCheck(threads[i] != NULL, "Verify reader thread %d was created", i);
+  }
+  for (i = 0; i < HINT_THREADS_CHANGES; i++) {
+    SDL_SetHint("SDL_TEST_HINT_THREADS", values[i % SDL_arraysize(values)]);
+    if ((i % 1000) == 0) {
+      SDL_Delay(1);
+    }
+  }
+  SDL_AtomicSet(&data.done, 1);
+  for (i = 0; i < HINT_THREADS_READERS; i++) {
+    SDL_WaitThread(threads[i], NULL);
+  }
+
+  SDLTest_AssertCheck(SDL_AtomicGet(&data.errors) == 0, "Verify readers saw whole values, errors: %d", SDL_AtomicGet(&data.errors));
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Hints test cases */
@@ -158,9 +364,18 @@ static const SDLTest_TestCaseReference hintsTest1 =
 static const SDLTest_TestCaseReference hintsTest2 =
         { (SDLTest_TestCaseFp)hints_setHint, "hints_setHint", "Call to SDL_SetHint", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference hintsTest3 =
+        { (SDLTest_TestCaseFp)hints_environment, "hints_environment", "Call to SDL_GetHint while the environment changes", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference hintsTest4 =
+        { (SDLTest_TestCaseFp)hints_hintHandle, "hints_hintHandle", "Call to SDL_GetHintHandle", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference hintsTest5 =
+        { (SDLTest_TestCaseFp)hints_threads, "hints_threads", "Call to SDL_GetHint while another thread sets the hint", TEST_ENABLED };
+
 /* Sequence of Hints test cases */
 static const SDLTest_TestCaseReference *hintsTests[] =  {
-    &hintsTest1, &hintsTest2, NULL
+    &hintsTest1, &hintsTest2, &hintsTest3, &hintsTest4, &hintsTest5, NULL
 };
 
 /* Hints test suite (global) */
@@ -0,0 +1,353 @@
+/**
+ * Job system test suite
+ */
+
+#include <stdio.h>
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+/* Helpers */
+
+#define NUM_COUNTERS 1000
+
+static SDL_atomic_t _jobCounters[NUM_COUNTERS];
+static SDL_atomic_t _jobsDone;
+static SDL_JobSystem *_jobSystem;
+
+static void
+_resetJobCounters(void)
+{
+    int i;
+    for (i = 0; i < NUM_COUNTERS; i++) {
+        SDL_AtomicSet(&_jobCounters[i], 0);
+    }
+    SDL_AtomicSet(&_jobsDone, 0);
+}
+
+static int
+_checkJobCounters(int start, int end, int expected)
+{
+    int i;
+    for (i = start; i < end; i++) {
+        const int value = SDL_AtomicGet(&_jobCounters[i]);
+        if (value != expected) {
+            SDLTest_AssertCheck(SDL_FALSE, "Check counter %d, expected: %d, got: %d", i, expected, value);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void SDLCALL
+_countJob(SDL_Job *job, void *data)
+{
+    SDL_AtomicIncRef(&_jobCounters[(int) (intptr_t) data]);
+    SDL_AtomicIncRef(&_jobsDone);
+}
+
+/* Spawns two children until the depth runs out */
+static void SDLCALL
+_treeJob(SDL_Job *job, void *data)
+{
+    const int depth = (int) (intptr_t) data;
+    if (depth > 0) {
+        SDL_DetachJob(SDL_SubmitJob(_jobSystem, _treeJob, (void *) (intptr_t) (depth - 1), job));
+        SDL_DetachJob(SDL_SubmitJob(_jobSystem, _treeJob, (void *) (intptr_t) (depth - 1), job));
+    }
+    SDL_AtomicIncRef(&_jobsDone);
+}
+
+/* Waits for its own children instead of leaving them to the parent */
+static void SDLCALL
+_waitingJob(SDL_Job *job, void *data)
+{
+    SDL_Job *children[10];
+    int i;
+
+    for (i = 0; i < SDL_arraysize(children); i++) {
+        children[i] = SDL_SubmitJob(_jobSystem, _countJob, (void *) (intptr_t) ((int) (intptr_t) data + i), NULL);
+    }
+    for (i = 0; i < SDL_arraysize(children); i++) {
+        SDL_WaitJob(children[i]);
+    }
+}
+
+/* Submits counting jobs as its children */
+static void SDLCALL
+_spawnCountJobs(SDL_Job *job, void *data)
+{
+    int i;
+    for (i = 1; i < NUM_COUNTERS; i++) {
+        SDL_DetachJob(SDL_SubmitJob(_jobSystem, _countJob, (void *) (intptr_t) i, job));
+    }
+    _countJob(job, (void *) (intptr_t) 0);
+}
+
+/* Submits jobs that wait for their own children as its children */
+static void SDLCALL
+_spawnWaitingJobs(SDL_Job *job, void *data)
+{
+    int i;
+    for (i = 0; i < 50; i++) {
+        SDL_DetachJob(SDL_SubmitJob(_jobSystem, _waitingJob, (void *) (intptr_t) (1 + i * 10), job));
+    }
+    _countJob(job, (void *) (intptr_t) 0);
+}
+
+static void SDLCALL
+_countRange(int start, int end, void *data)
+{
+    const int offset = (int) (intptr_t) data;
+    int i;
+
+    for (i = start; i < end; i++) {
+        SDL_AtomicIncRef(&_jobCounters[i + offset]);
+    }
+}
+
+/* Runs SDL_ParallelFor() from inside a job */
+static void SDLCALL
+_parallelForJob(SDL_Job *job, void *data)
+{
+    SDL_ParallelFor(_jobSystem, 0, NUM_COUNTERS, 3, _countRange, NULL);
+}
+
+/* Test case functions */
+
+/**
+ * @brief Submits jobs from the test thread and waits for each of them.
+ *
+ * @sa http://wiki.libsdl.org/SDL_SubmitJob
+ * @sa http://wiki.libsdl.org/SDL_WaitJob
+ */
+int
+jobs_submitAndWait(void *arg)
+{
+    SDL_Job *jobs[NUM_COUNTERS];
+    int threads, i;
+
+    for (threads = 1; threads <= 4; threads *= 2) {
+        _resetJobCounters();
+        _jobSystem = SDL_CreateJobSystem(threads);
+        SDLTest_AssertPass("Call to SDL_CreateJobSystem(%d)", threads);
+        SDLTest_AssertCheck(_jobSystem != NULL, "Check result, expected: non-NULL");
+        if (!_jobSystem) {
+            return TEST_ABORTED;
+        }
+
+        for (i = 0; i < NUM_COUNTERS; i++) {
+            jobs[i] = SDL_SubmitJob(_jobSystem, _countJob, (void *) (intptr_t) i, NULL);
+        }
+        SDLTest_AssertPass("Call to SDL_SubmitJob() %d times", NUM_COUNTERS);
+
+        /* Wait for them in reverse, so some are waited for before they run */
+        for (i = NUM_COUNTERS - 1; i >= 0; i--) {
+            SDLTest_AssertCheck(jobs[i] != NULL, "Check job %d, expected: non-NULL", i);
+            SDL_WaitJob(jobs[i]);
+            if (SDL_AtomicGet(&_jobCounters[i]) != 1) {
+                SDLTest_AssertCheck(SDL_FALSE, "Check job %d ran once after SDL_WaitJob(), got: %d runs", i, SDL_AtomicGet(&_jobCounters[i]));
+                break;
+            }
+        }
+        SDLTest_AssertPass("Call to SDL_WaitJob() %d times", NUM_COUNTERS);
+        SDLTest_AssertCheck(_checkJobCounters(0, NUM_COUNTERS, 1), "Check every job ran once");
+
+        SDL_DestroyJobSystem(_jobSystem);
+        SDLTest_AssertPass("Call to SDL_DestroyJobSystem()");
+        _jobSystem = NULL;
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks that waiting for a parent job waits for all its children.
+ *
+ * @sa http://wiki.libsdl.org/SDL_SubmitJob
+ * @sa http://wiki.libsdl.org/SDL_DetachJob
+ */
+int
+jobs_parentAndChildren(void *arg)
+{
+    const int depth = 10;
+    const int tree_size = (1 << (depth + 1)) - 1;
+    SDL_Job *parent;
+    int i, done;
+
+    _resetJobCounters();
+    _jobSystem = SDL_CreateJobSystem(3);
+    SDLTest_AssertPass("Call to SDL_CreateJobSystem(3)");
+    SDLTest_AssertCheck(_jobSystem != NULL, "Check result, expected: non-NULL");
+    if (!_jobSystem) {
+        return TEST_ABORTED;
+    }
+
+    /* A tree of detached jobs */
+    SDL_WaitJob(SDL_SubmitJob(_jobSystem, _treeJob, (void *) (intptr_t) depth, NULL));
+    done = SDL_AtomicGet(&_jobsDone);
+    SDLTest_AssertCheck(done == tree_size, "Check jobs in the tree, expected: %d, got: %d", tree_size, done);
+
+    /* A parent with lots of children */
+    _resetJobCounters();
+    parent = SDL_SubmitJob(_jobSystem, _spawnCountJobs, NULL, NULL);
+    SDLTest_AssertCheck(parent != NULL, "Check parent job, expected: non-NULL");
+    SDL_WaitJob(parent);
+    SDLTest_AssertPass("Call to SDL_WaitJob() for the parent job");
+    SDLTest_AssertCheck(_checkJobCounters(0, NUM_COUNTERS, 1), "Check every child ran before the parent finished");
+
+    /* Jobs that wait for their own children */
+    for (i = 0; i < 10; i++) {
+        _resetJobCounters();
+        SDL_WaitJob(SDL_SubmitJob(_jobSystem, _spawnWaitingJobs, NULL, NULL));
+        if (!_checkJobCounters(0, 501, 1)) {
+            break;
+        }
+    }
+    SDLTest_AssertCheck(i == 10, "Check every job ran once with jobs waiting inside jobs");
+
+    SDL_DestroyJobSystem(_jobSystem);
+    SDLTest_AssertPass("Call to SDL_DestroyJobSystem()");
+    _jobSystem = NULL;
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks that SDL_ParallelFor() visits every index exactly once.
+ *
+ * @sa http://wiki.libsdl.org/SDL_ParallelFor
+ */
+int
+jobs_parallelFor(void *arg)
+{
+    const int grains[] = { 0, 1, 7, 100, NUM_COUNTERS, NUM_COUNTERS * 2 };
+    const int threads[] = { 1, 3, 0 };
+    int t, g, result;
+
+    for (t = 0; t < SDL_arraysize(threads); t++) {
+        _jobSystem = SDL_CreateJobSystem(threads[t]);
+        SDLTest_AssertPass("Call to SDL_CreateJobSystem(%d)", threads[t]);
+        SDLTest_AssertCheck(_jobSystem != NULL, "Check result, expected: non-NULL");
+        if (!_jobSystem) {
+            return TEST_ABORTED;
+        }
+
+        for (g = 0; g < SDL_arraysize(grains); g++) {
+            _resetJobCounters();
+            result = SDL_ParallelFor(_jobSystem, 0, NUM_COUNTERS, grains[g], _countRange, NULL);
+            SDLTest_AssertCheck(result == 0, "Check SDL_ParallelFor(0, %d, grain %d) result, expected: 0, got: %d", NUM_COUNTERS, grains[g], result);
+            SDLTest_AssertCheck(_checkJobCounters(0, NUM_COUNTERS, 1), "Check every index was visited once with grain %d", grains[g]);
+        }
+
+        /* A range with negative indices */
+        _resetJobCounters();
+        result = SDL_ParallelFor(_jobSystem, -500, 300, 9, _countRange, (void *) (intptr_t) 500);
+        SDLTest_AssertCheck(result == 0, "Check SDL_ParallelFor(-500, 300) result, expected: 0, got: %d", result);
+        SDLTest_AssertCheck(_checkJobCounters(0, 800, 1), "Check every index of a negative range was visited once");
+        SDLTest_AssertCheck(_checkJobCounters(800, NUM_COUNTERS, 0), "Check indices outside the range weren't visited");
+
+        /* Empty ranges don't call the function */
+        _resetJobCounters();
+        result = SDL_ParallelFor(_jobSystem, 10, 10, 1, _countRange, NULL);
+        SDLTest_AssertCheck(result == 0, "Check SDL_ParallelFor() result with an empty range, expected: 0, got: %d", result);
+        result = SDL_ParallelFor(_jobSystem, 20, 10, 1, _countRange, NULL);
+        SDLTest_AssertCheck(result == 0, "Check SDL_ParallelFor() result with a reversed range, expected: 0, got: %d", result);
+        SDLTest_AssertCheck(_checkJobCounters(0, NUM_COUNTERS, 0), "Check no index was visited for empty ranges");
+
+        /* From inside a job */
+        _resetJobCounters();
+        SDL_WaitJob(SDL_SubmitJob(_jobSystem, _parallelForJob, NULL, NULL));
+        SDLTest_AssertCheck(_checkJobCounters(0, NUM_COUNTERS, 1), "Check every index was visited once from inside a job");
+
+        SDL_DestroyJobSystem(_jobSystem);
+        SDLTest_AssertPass("Call to SDL_DestroyJobSystem()");
+        _jobSystem = NULL;
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Passes invalid parameters to the job system functions.
+ *
+ * @sa http://wiki.libsdl.org/SDL_SubmitJob
+ * @sa http://wiki.libsdl.org/SDL_ParallelFor
+ */
+int
+jobs_invalidParams(void *arg)
+{
+    SDL_JobSystem *other;
+    SDL_Job *job, *parent;
+    int result;
+
+    SDL_ClearError();
+    job = SDL_SubmitJob(NULL, _countJob, NULL, NULL);
+    SDLTest_AssertCheck(job == NULL, "Check SDL_SubmitJob() with a NULL job system, expected: NULL");
+    SDLTest_AssertCheck(*SDL_GetError() != '\0', "Check that an error was set");
+    result = SDL_ParallelFor(NULL, 0, 10, 1, _countRange, NULL);
+    SDLTest_AssertCheck(result == -1, "Check SDL_ParallelFor() with a NULL job system, expected: -1, got: %d", result);
+
+    SDL_WaitJob(NULL);
+    SDLTest_AssertPass("Call to SDL_WaitJob(NULL)");
+    SDL_DetachJob(NULL);
+    SDLTest_AssertPass("Call to SDL_DetachJob(NULL)");
+    SDL_DestroyJobSystem(NULL);
+    SDLTest_AssertPass("Call to SDL_DestroyJobSystem(NULL)");
+
+    _jobSystem = SDL_CreateJobSystem(1);
+    other = SDL_CreateJobSystem(1);
+    SDLTest_AssertCheck(_jobSystem != NULL && other != NULL, "Check two job systems were created");
+    if (!_jobSystem || !other) {
+        SDL_DestroyJobSystem(_jobSystem);
+        SDL_DestroyJobSystem(other);
+        return TEST_ABORTED;
+    }
+
+    job = SDL_SubmitJob(_jobSystem, NULL, NULL, NULL);
+    SDLTest_AssertCheck(job == NULL, "Check SDL_SubmitJob() with a NULL function, expected: NULL");
+    result = SDL_ParallelFor(_jobSystem, 0, 10, 1, NULL, NULL);
+    SDLTest_AssertCheck(result == -1, "Check SDL_ParallelFor() with a NULL function, expected: -1, got: %d", result);
+
+    /* A parent has to belong to the same job system */
+    _resetJobCounters();
+    parent = SDL_SubmitJob(other, _countJob, (void *) (intptr_t) 0, NULL);
+    job = SDL_SubmitJob(_jobSystem, _countJob, (void *) (intptr_t) 1, parent);
+    SDLTest_AssertCheck(job == NULL, "Check SDL_SubmitJob() with a parent from another job system, expected: NULL");
+    SDL_WaitJob(parent);
+    SDLTest_AssertCheck(_checkJobCounters(1, 2, 0), "Check the rejected job didn't run");
+
+    SDL_DestroyJobSystem(other);
+    SDL_DestroyJobSystem(_jobSystem);
+    _jobSystem = NULL;
+
+    return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Job system test cases */
+static const SDLTest_TestCaseReference jobsTest1 =
+        { (SDLTest_TestCaseFp)jobs_submitAndWait, "jobs_submitAndWait", "Submits jobs and waits for each of them", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference jobsTest2 =
+        { (SDLTest_TestCaseFp)jobs_parentAndChildren, "jobs_parentAndChildren", "Checks that parent jobs finish after their children", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference jobsTest3 =
+        { (SDLTest_TestCaseFp)jobs_parallelFor, "jobs_parallelFor", "Checks that SDL_ParallelFor visits every index exactly once", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference jobsTest4 =
+        { (SDLTest_TestCaseFp)jobs_invalidParams, "jobs_invalidParams", "Passes invalid parameters to the job system functions", TEST_ENABLED };
+
+/* Sequence of Job system test cases */
+static const SDLTest_TestCaseReference *jobsTests[] =  {
+    &jobsTest1, &jobsTest2, &jobsTest3, &jobsTest4, NULL
+};
+
+/* Job system test suite (global) */
+SDLTest_TestSuiteReference jobsTestSuite = {
+    "Jobs",
+    NULL,
+    jobsTests,
+    NULL
+};
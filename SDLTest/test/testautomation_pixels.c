@@ -502,6 +502,116 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Formats that the rest of the tests barely use, so their references come from us */
+static const Uint32 _sharedPixelFormats[] = {
+  SDL_PIXELFORMAT_BGRA5551, SDL_PIXELFORMAT_ABGR4444, SDL_PIXELFORMAT_BGR565
+};
+
+static int SDLCALL
+_allocFreeFormatsThread(void *data)
+{
+  int i, j;
+
+  for (i = 0; i < 20000; i++) {
+    SDL_PixelFormat *formats[SDL_arraysize(_sharedPixelFormats)];
+    for (j = 0; j < (int)SDL_arraysize(_sharedPixelFormats); j++) {
+      formats[j] = SDL_AllocFormat(_sharedPixelFormats[(i + j) % SDL_arraysize(_sharedPixelFormats)]);
+      if (formats[j] == NULL) {
+        return -1;
+      }
+    }
+    for (j = 0; j < (int)SDL_arraysize(_sharedPixelFormats); j++) {
+      SDL_FreeFormat(formats[j]);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Call to SDL_AllocFormat and SDL_FreeFormat for formats that are shared
+ *
+ * @sa http://wiki.libsdl.org/SDL_AllocFormat
+ * @sa http://wiki.libsdl.org/SDL_FreeFormat
+ */
+int
+pixels_sharedFormats(void *arg)
+{
+  SDL_Thread *threads[4];
+  SDL_PixelFormat *result, *result2;
+  SDL_Palette *palette;
+  Uint32 format;
+  int i, status;
+
+  /* RGB formats are shared, indexed ones are not */
+  for (i = 0; i < _numRGBPixelFormats; i++) {
+    format = _RGBPixelFormats[i];
+    result = SDL_AllocFormat(format);
+    result2 = SDL_AllocFormat(format);
+    SDLTest_AssertPass("Call to SDL_AllocFormat() twice for %s", _RGBPixelFormatsVerbose[i]);
+    SDLTest_AssertCheck(result != NULL && result2 != NULL, "Verify results are not NULL");
+    if (result != NULL && result2 != NULL) {
+      if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+        SDLTest_AssertCheck(result != result2, "Verify indexed format is not shared");
+      } else {
+        SDLTest_AssertCheck(result == result2, "Verify RGB format is shared");
+        SDLTest_AssertCheck(result->refcount >= 2, "Verify value of result.refcount; expected: >=2, got %d", result->refcount);
+      }
+    }
+    SDL_FreeFormat(result);
+    SDL_FreeFormat(result2);
+  }
+
+  /* The palette of a shared format lives as long as the format is in use */
+  format = _sharedPixelFormats[0];
+  result = SDL_AllocFormat(format);
+  SDLTest_AssertCheck(result != NULL, "Verify result is not NULL");
+  if (result == NULL) {
+    return TEST_ABORTED;
+  }
+  SDLTest_AssertCheck(result->refcount == 1, "Verify value of result.refcount; expected: 1, got %d", result->refcount);
+  SDLTest_AssertCheck(result->palette == NULL, "Verify value of result.palette is NULL");
+  palette = SDL_AllocPalette(16);
+  SDLTest_AssertCheck(palette != NULL, "Verify palette is not NULL");
+  if (palette == NULL) {
+    SDL_FreeFormat(result);
+    return TEST_ABORTED;
+  }
+  status = SDL_SetPixelFormatPalette(result, palette);
+  SDLTest_AssertCheck(status == 0, "Verify result from SDL_SetPixelFormatPalette(), expected: 0, got: %d", status);
+  SDL_FreePalette(palette);
+  result2 = SDL_AllocFormat(format);
+  SDLTest_AssertCheck(result2 == result, "Verify format is shared");
+  SDLTest_AssertCheck(result2 != NULL && result2->palette == palette, "Verify palette is kept while the format is in use");
+  SDL_FreeFormat(result);
+  SDL_FreeFormat(result2);
+  result = SDL_AllocFormat(format);
+  SDLTest_AssertCheck(result != NULL && result->palette == NULL, "Verify palette is dropped with the last reference");
+  SDL_FreeFormat(result);
+
+  /* Threads taking and dropping the same formats */
+  for (i = 0; i < (int)SDL_arraysize(threads); i++) {
+    threads[i] = SDL_CreateThread(_allocFreeFormatsThread, "AllocFreeFormats", NULL);
+    SDLTest_AssertCheck(threads[i] != NULL, "Verify thread %d was created", i);
+  }
+  for (i = 0; i < (int)SDL_arraysize(threads); i++) {
+    status = -1;
+    SDL_WaitThread(threads[i], &status);
+    SDLTest_AssertCheck(status == 0, "Verify thread %d allocated every format, got: %d", i, status);
+  }
+  for (i = 0; i < (int)SDL_arraysize(_sharedPixelFormats); i++) {
+    result = SDL_AllocFormat(_sharedPixelFormats[i]);
+    SDLTest_AssertCheck(result != NULL, "Verify result is not NULL");
+    if (result != NULL) {
+      SDLTest_AssertCheck(result->refcount == 1, "Verify every reference was dropped, expected: 1, got %d", result->refcount);
+      SDLTest_AssertCheck(result->format == _sharedPixelFormats[i], "Verify value of result.format; expected: %u, got %u",
+                          _sharedPixelFormats[i], result->format);
+      SDL_FreeFormat(result);
+    }
+  }
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -517,9 +627,12 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_sharedFormats, "pixels_sharedFormats", "Call to SDL_AllocFormat and SDL_FreeFormat for shared formats", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, NULL
 };
 
 /* Pixels test suite (global) */
@@ -440,6 +440,78 @@ int platform_testSetErrorInvalidInput(void *arg)
    return TEST_COMPLETED;
 }
 
+/* !
+ * \brief Tests SDL_SetErrorCode and SDL_GetErrorCode
+ * \sa
+ * http://wiki.libsdl.org/SDL_SetErrorCode
+ * http://wiki.libsdl.org/SDL_GetErrorCode
+ */
+int platform_testSetErrorCode(void *arg)
+{
+   const char *testError = "Testing";
+   const char *lastError;
+   SDL_errorcode code;
+   char buffer[64];
+   int result;
+
+   /* Reset */
+   SDL_ClearError();
+   SDLTest_AssertPass("SDL_ClearError()");
+   code = SDL_GetErrorCode();
+   SDLTest_AssertCheck(code == SDL_ENOERROR,
+             "SDL_GetErrorCode(): expected SDL_ENOERROR, got: %i", (int) code);
+
+   /* Set a code and check that the message comes with it */
+   result = SDL_SetErrorCode(SDL_ENOMEM);
+   SDLTest_AssertPass("SDL_SetErrorCode(SDL_ENOMEM)");
+   SDLTest_AssertCheck(result == -1, "SDL_SetErrorCode: expected -1, got: %i", result);
+   code = SDL_GetErrorCode();
+   SDLTest_AssertCheck(code == SDL_ENOMEM,
+             "SDL_GetErrorCode(): expected SDL_ENOMEM, got: %i", (int) code);
+   lastError = SDL_GetError();
+   SDLTest_AssertCheck(SDL_strcmp(lastError, "Out of memory") == 0,
+             "SDL_GetError(): expected message 'Out of memory', was message: '%s'",
+             lastError);
+   SDL_GetErrorMsg(buffer, sizeof(buffer));
+   SDLTest_AssertCheck(SDL_strcmp(buffer, "Out of memory") == 0,
+             "SDL_GetErrorMsg(): expected message 'Out of memory', was message: '%s'",
+             buffer);
+
+   /* The internal SDL_Error() sets codes too */
+   result = SDL_Unsupported();
+   SDLTest_AssertPass("SDL_Unsupported()");
+   SDLTest_AssertCheck(result == -1, "SDL_Unsupported: expected -1, got: %i", result);
+   code = SDL_GetErrorCode();
+   SDLTest_AssertCheck(code == SDL_UNSUPPORTED,
+             "SDL_GetErrorCode(): expected SDL_UNSUPPORTED, got: %i", (int) code);
+
+   /* A message replaces the code */
+   result = SDL_SetError("%s", testError);
+   SDLTest_AssertPass("SDL_SetError()");
+   SDLTest_AssertCheck(result == -1, "SDL_SetError: expected -1, got: %i", result);
+   code = SDL_GetErrorCode();
+   SDLTest_AssertCheck(code == SDL_EMESSAGE,
+             "SDL_GetErrorCode(): expected SDL_EMESSAGE, got: %i", (int) code);
+   lastError = SDL_GetError();
+   SDLTest_AssertCheck(SDL_strcmp(lastError, testError) == 0,
+             "SDL_GetError(): expected message '%s', was message: '%s'",
+             testError,
+             lastError);
+
+   /* Clean up */
+   SDL_ClearError();
+   SDLTest_AssertPass("SDL_ClearError()");
+   code = SDL_GetErrorCode();
+   SDLTest_AssertCheck(code == SDL_ENOERROR,
+             "SDL_GetErrorCode(): expected SDL_ENOERROR, got: %i", (int) code);
+   lastError = SDL_GetError();
+   SDLTest_AssertCheck(lastError[0] == '\0',
+             "SDL_GetError(): expected empty message, was message: '%s'",
+             lastError);
+
+   return TEST_COMPLETED;
+}
+
 /* !
  * \brief Tests SDL_GetPowerInfo
  * \sa
@@ -554,6 +626,9 @@ static const SDLTest_TestCaseReference platformTest10 =
 static const SDLTest_TestCaseReference platformTest11 =
         { (SDLTest_TestCaseFp)platform_testGetPowerInfo, "platform_testGetPowerInfo", "Tests SDL_GetPowerInfo function", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference platformTest12 =
+        { (SDLTest_TestCaseFp)platform_testSetErrorCode, "platform_testSetErrorCode", "Tests SDL_SetErrorCode and SDL_GetErrorCode", TEST_ENABLED };
+
 /* Sequence of Platform test cases */
 static const SDLTest_TestCaseReference *platformTests[] =  {
     &platformTest1,
@@ -567,6 +642,7 @@ static const SDLTest_TestCaseReference *platformTests[] =  {
     &platformTest9,
     &platformTest10,
     &platformTest11,
+    &platformTest12,
     NULL
 };
 
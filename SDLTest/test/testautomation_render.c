@@ -766,6 +766,211 @@ render_testBlitBlend (void *arg)
 }
 
 
+#define COPYEX_TEXTURE_W    10
+#define COPYEX_TEXTURE_H    6
+#define COPYEX_TARGET_SIZE  32
+#define COPYEX_BACKGROUND   0xFF204060
+
+/* The pixel at x, y of the texture once flipped */
+static Uint32
+_copyExTexel(const Uint32 *texels, int x, int y, SDL_RendererFlip flip)
+{
+   if (flip & SDL_FLIP_HORIZONTAL) {
+      x = COPYEX_TEXTURE_W - 1 - x;
+   }
+   if (flip & SDL_FLIP_VERTICAL) {
+      y = COPYEX_TEXTURE_H - 1 - y;
+   }
+   return texels[y * COPYEX_TEXTURE_W + x];
+}
+
+/* Bilinear filtering between the texel centers, clamped to the edges */
+static Uint32
+_copyExBilinear(const Uint32 *texels, double u, double v, SDL_RendererFlip flip)
+{
+   const int x = (int)SDL_floor(u - 0.5);
+   const int y = (int)SDL_floor(v - 0.5);
+   const double fx = (u - 0.5) - x;
+   const double fy = (v - 0.5) - y;
+   const int x0 = SDL_clamp(x, 0, COPYEX_TEXTURE_W - 1);
+   const int x1 = SDL_clamp(x + 1, 0, COPYEX_TEXTURE_W - 1);
+   const int y0 = SDL_clamp(y, 0, COPYEX_TEXTURE_H - 1);
+   const int y1 = SDL_clamp(y + 1, 0, COPYEX_TEXTURE_H - 1);
+   Uint32 pixel = 0;
+   int shift;
+
+   for (shift = 0; shift < 32; shift += 8) {
+      const double c00 = (_copyExTexel(texels, x0, y0, flip) >> shift) & 0xFF;
+      const double c01 = (_copyExTexel(texels, x1, y0, flip) >> shift) & 0xFF;
+      const double c10 = (_copyExTexel(texels, x0, y1, flip) >> shift) & 0xFF;
+      const double c11 = (_copyExTexel(texels, x1, y1, flip) >> shift) & 0xFF;
+      const double c = (c00 * (1.0 - fx) + c01 * fx) * (1.0 - fy) + (c10 * (1.0 - fx) + c11 * fx) * fy;
+      pixel |= (Uint32)(c + 0.5) << shift;
+   }
+   return pixel;
+}
+
+static Uint32
+_copyExModulate(Uint32 pixel, const Uint8 *mod)
+{
+   Uint32 result = pixel & 0xFF000000;
+   int i;
+
+   for (i = 0; i < 3; ++i) {
+      const int shift = 16 - i * 8;
+      result |= (((pixel >> shift) & 0xFF) * mod[i] / 255) << shift;
+   }
+   return result;
+}
+
+static SDL_bool
+_copyExClose(Uint32 a, Uint32 b, int allowable_error)
+{
+   int shift;
+
+   for (shift = 0; shift < 32; shift += 8) {
+      if (SDL_abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF)) > allowable_error) {
+         return SDL_FALSE;
+      }
+   }
+   return SDL_TRUE;
+}
+
+/* Distance of x to the nearest integer */
+static double
+_copyExEdgeDistance(double x)
+{
+   return SDL_fabs(x - SDL_floor(x + 0.5));
+}
+
+/* Expected pixel at x, y of the target, or 0 if it depends on rounding */
+static Uint32
+_copyExExpected(const Uint32 *texels, const SDL_Rect *rect, int x, int y, double angle, SDL_RendererFlip flip, SDL_ScaleMode scaleMode, const Uint8 *mod)
+{
+   /* Rotate the pixel center back around the center of the rectangle */
+   const double radians = angle * M_PI / 180.0;
+   const double dx = (x + 0.5) - (rect->x + rect->w / 2.0);
+   const double dy = (y + 0.5) - (rect->y + rect->h / 2.0);
+   const double u = dx * SDL_cos(radians) + dy * SDL_sin(radians) + rect->w / 2.0;
+   const double v = -dx * SDL_sin(radians) + dy * SDL_cos(radians) + rect->h / 2.0;
+   const double margin = 0.01;
+
+   if (u < -margin || u > COPYEX_TEXTURE_W + margin || v < -margin || v > COPYEX_TEXTURE_H + margin) {
+      return COPYEX_BACKGROUND;
+   }
+   if (u < margin || u > COPYEX_TEXTURE_W - margin || v < margin || v > COPYEX_TEXTURE_H - margin) {
+      return 0;
+   }
+   if (scaleMode == SDL_ScaleModeNearest) {
+      if (_copyExEdgeDistance(u) < margin || _copyExEdgeDistance(v) < margin) {
+         return 0;
+      }
+      return _copyExModulate(_copyExTexel(texels, (int)u, (int)v, flip), mod);
+   }
+   return _copyExModulate(_copyExBilinear(texels, u, v, flip), mod);
+}
+
+/**
+ * @brief Tests rotated and flipped copies against reference pixels.
+ *
+ * \sa
+ * http://wiki.libsdl.org/SDL_RenderCopyEx
+ * http://wiki.libsdl.org/SDL_SetTextureScaleMode
+ */
+int
+render_testCopyEx(void *arg)
+{
+   static const double angles[] = { 0.0, 90.0, 180.0, 270.0, -90.0, 30.0, 200.0 };
+   static const SDL_RendererFlip flips[] = { SDL_FLIP_NONE, SDL_FLIP_HORIZONTAL, SDL_FLIP_VERTICAL, SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL };
+   static const Uint8 mods[2][3] = { { 255, 255, 255 }, { 128, 200, 64 } };
+   const SDL_Rect rect = { 11, 13, COPYEX_TEXTURE_W, COPYEX_TEXTURE_H };
+   Uint32 texels[COPYEX_TEXTURE_W * COPYEX_TEXTURE_H];
+   Uint32 pixels[COPYEX_TARGET_SIZE * COPYEX_TARGET_SIZE];
+   SDL_Surface *target;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   int scaleMode, a, f, m, x, y, ret;
+
+   for (y = 0; y < COPYEX_TEXTURE_H; ++y) {
+      for (x = 0; x < COPYEX_TEXTURE_W; ++x) {
+         texels[y * COPYEX_TEXTURE_W + x] = 0xFF000000 | ((x * 25) << 16) | ((y * 40) << 8) | ((x * 7 + y * 29) & 0xFF);
+      }
+   }
+
+   /* Render to a surface, so that the software renderer is used whatever the video driver */
+   target = SDL_CreateRGBSurfaceWithFormat(0, COPYEX_TARGET_SIZE, COPYEX_TARGET_SIZE, 32, RENDER_COMPARE_FORMAT);
+   SDLTest_AssertCheck(target != NULL, "Verify SDL_CreateRGBSurfaceWithFormat() result");
+   if (target == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(target);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer() result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   texture = SDL_CreateTexture(swrenderer, RENDER_COMPARE_FORMAT, SDL_TEXTUREACCESS_STATIC, COPYEX_TEXTURE_W, COPYEX_TEXTURE_H);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture() result");
+   if (texture == NULL) {
+      SDL_DestroyRenderer(swrenderer);
+      SDL_FreeSurface(target);
+      return TEST_ABORTED;
+   }
+   SDL_UpdateTexture(texture, NULL, texels, COPYEX_TEXTURE_W * sizeof(Uint32));
+   SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+
+   for (scaleMode = SDL_ScaleModeNearest; scaleMode <= SDL_ScaleModeLinear; ++scaleMode) {
+      SDL_SetTextureScaleMode(texture, (SDL_ScaleMode)scaleMode);
+      for (a = 0; a < (int)SDL_arraysize(angles); ++a) {
+         for (f = 0; f < (int)SDL_arraysize(flips); ++f) {
+            for (m = 0; m < (int)SDL_arraysize(mods); ++m) {
+               int checked = 0, mismatches = 0, first_x = -1, first_y = -1;
+               Uint32 first_pixel = 0, first_expected = 0;
+               /* Multiples of 90 degrees map texels to pixels exactly */
+               const int allowable_error = (SDL_fmod(angles[a], 90.0) == 0.0) ? 0 : 2;
+
+               SDL_SetTextureColorMod(texture, mods[m][0], mods[m][1], mods[m][2]);
+               SDL_SetRenderDrawColor(swrenderer, 0x20, 0x40, 0x60, 0xFF);
+               SDL_RenderClear(swrenderer);
+               ret = SDL_RenderCopyEx(swrenderer, texture, NULL, &rect, angles[a], NULL, flips[f]);
+               SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopyEx, expected: 0, got: %i", ret);
+               ret = SDL_RenderReadPixels(swrenderer, NULL, RENDER_COMPARE_FORMAT, pixels, COPYEX_TARGET_SIZE * sizeof(Uint32));
+               SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+               for (y = 0; y < COPYEX_TARGET_SIZE; ++y) {
+                  for (x = 0; x < COPYEX_TARGET_SIZE; ++x) {
+                     const Uint32 pixel = pixels[y * COPYEX_TARGET_SIZE + x];
+                     const Uint32 expected = _copyExExpected(texels, &rect, x, y, angles[a], flips[f], (SDL_ScaleMode)scaleMode, mods[m]);
+                     if (expected == 0) {
+                        continue;
+                     }
+                     ++checked;
+                     if (!_copyExClose(pixel, expected, allowable_error)) {
+                        if (mismatches++ == 0) {
+                           first_x = x;
+                           first_y = y;
+                           first_pixel = pixel;
+                           first_expected = expected;
+                        }
+                     }
+                  }
+               }
+               SDLTest_AssertCheck(mismatches == 0 && checked > COPYEX_TARGET_SIZE * COPYEX_TARGET_SIZE / 2,
+                                   "Validate %s copy at %g degrees, flip %d, color mod %d: %d of %d pixels differ, first at %d,%d: 0x%08" SDL_PRIX32 " instead of 0x%08" SDL_PRIX32,
+                                   (scaleMode == SDL_ScaleModeNearest) ? "nearest" : "linear", angles[a], (int)flips[f], m,
+                                   mismatches, checked, first_x, first_y, first_pixel, first_expected);
+            }
+         }
+      }
+   }
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(target);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Checks to see if functionality is supported. Helper function.
  */
@@ -1085,9 +1290,12 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testCopyEx, "render_testCopyEx", "Tests rotated and flipped copies", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, NULL
 };
 
 /* Render test suite (global) */
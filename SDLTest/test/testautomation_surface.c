@@ -589,6 +589,981 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests SDL_FillRects() on a 24-bit surface, with rows of various widths and alignments
+ */
+int
+surface_testFillRects24(void *arg)
+{
+    const Uint8 r = 0x12, g = 0x34, b = 0x56;
+    SDL_Rect rects[4];
+    SDL_Surface *surface;
+    Uint32 color;
+    int ret, x, y, i;
+
+    surface = SDL_CreateRGBSurfaceWithFormat(0, 301, 37, 24, SDL_PIXELFORMAT_RGB24);
+    SDLTest_AssertCheck(surface != NULL, "Verify 24-bit surface is not NULL");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+
+    rects[0].x = 0; rects[0].y = 0; rects[0].w = 301; rects[0].h = 5;
+    rects[1].x = 3; rects[1].y = 7; rects[1].w = 21; rects[1].h = 4;
+    rects[2].x = 250; rects[2].y = 13; rects[2].w = 100; rects[2].h = 100;
+    rects[3].x = -5; rects[3].y = 20; rects[3].w = 7; rects[3].h = 0;
+    for (i = 0; i < 4; i++) {
+        /* Every starting alignment of the rest of the surface */
+        SDL_FillRect(surface, NULL, 0);
+        rects[1].x = 3 + i;
+        rects[2].x = 250 - i * 17;
+
+        color = SDL_MapRGB(surface->format, r, g, b);
+        ret = SDL_FillRects(surface, rects, SDL_arraysize(rects), color);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects(), expected: 0, got: %i", ret);
+
+        for (y = 0; y < surface->h; y++) {
+            for (x = 0; x < surface->w; x++) {
+                const SDL_Point point = { x, y };
+                const SDL_bool inside = SDL_PointInRect(&point, &rects[0]) || SDL_PointInRect(&point, &rects[1]) ||
+                                        SDL_PointInRect(&point, &rects[2]) || SDL_PointInRect(&point, &rects[3]);
+                Uint8 *pixel = (Uint8 *)surface->pixels + y * surface->pitch + x * 3;
+                Uint8 pr, pg, pb;
+
+                SDL_GetRGB(pixel[0] | (pixel[1] << 8) | (pixel[2] << 16), surface->format, &pr, &pg, &pb);
+                if (inside ? (pr != r || pg != g || pb != b) : (pr || pg || pb)) {
+                    SDLTest_AssertCheck(SDL_FALSE, "Verify pixel at %d,%d, expected: %s, got: %02x%02x%02x",
+                                        x, y, inside ? "filled" : "black", pr, pg, pb);
+                    SDL_FreeSurface(surface);
+                    return TEST_ABORTED;
+                }
+            }
+        }
+    }
+    SDLTest_AssertPass("Verified all pixels");
+
+    SDL_FreeSurface(surface);
+    return TEST_COMPLETED;
+}
+
+/* Checks that the pixels in rects are color and the others are 0 */
+static SDL_bool
+_checkFillRects(SDL_Surface *surface, const SDL_Rect *rects, int count, Uint32 color)
+{
+    const int bpp = surface->format->BytesPerPixel;
+    int x, y, i;
+
+    for (y = 0; y < surface->h; y++) {
+        const Uint8 *row = (const Uint8 *)surface->pixels + y * surface->pitch;
+        for (x = 0; x < surface->w; x++) {
+            const SDL_Point point = { x, y };
+            SDL_bool inside = SDL_FALSE;
+            Uint32 pixel;
+
+            for (i = 0; i < count && !inside; i++) {
+                inside = SDL_PointInRect(&point, &rects[i]);
+            }
+            switch (bpp) {
+            case 1:
+                pixel = row[x];
+                break;
+            case 2:
+                pixel = ((const Uint16 *)row)[x];
+                break;
+            default:
+                pixel = ((const Uint32 *)row)[x];
+                break;
+            }
+            if (pixel != (inside ? color : 0)) {
+                SDLTest_AssertCheck(SDL_FALSE, "Verify %d-bit pixel at %d,%d, expected: 0x%" SDL_PRIx32 ", got: 0x%" SDL_PRIx32,
+                                    bpp * 8, x, y, inside ? color : 0, pixel);
+                return SDL_FALSE;
+            }
+        }
+    }
+    return SDL_TRUE;
+}
+
+/**
+ * @brief Tests SDL_FillRects() on 8, 16 and 32-bit surfaces, with rows of various widths and alignments
+ */
+int
+surface_testFillRects(void *arg)
+{
+    const Uint32 formats[] = { SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ARGB8888 };
+    const Uint32 colors[] = { 0x5A, 0xA55A, 0x12345678 };
+    SDL_Rect rects[4];
+    SDL_Surface *surface;
+    int ret, f, i, bpp;
+
+    for (f = 0; f < (int)SDL_arraysize(formats); f++) {
+        /* More than 4 MB, so that filling the whole surface uses non-temporal stores */
+        bpp = SDL_BYTESPERPIXEL(formats[f]);
+        surface = SDL_CreateRGBSurfaceWithFormat(0, 1031, 4 * 1024 * 1024 / (1031 * bpp) + 1, bpp * 8, formats[f]);
+        SDLTest_AssertCheck(surface != NULL, "Verify %d-bit surface is not NULL", bpp * 8);
+        if (surface == NULL) {
+            return TEST_ABORTED;
+        }
+
+        rects[0].x = 0; rects[0].y = 0; rects[0].w = surface->w; rects[0].h = 3;
+        rects[1].x = 3; rects[1].y = 5; rects[1].w = 21; rects[1].h = 4;
+        rects[2].x = 250; rects[2].y = 11; rects[2].w = 1000; rects[2].h = 9;
+        rects[3].x = 500; rects[3].y = 30; rects[3].w = 1; rects[3].h = 40;
+        for (i = 0; i < 4; i++) {
+            /* Every starting alignment of the rows */
+            SDL_FillRect(surface, NULL, 0);
+            rects[1].x = 3 + i;
+            rects[2].x = 250 - i * 17;
+
+            ret = SDL_FillRects(surface, rects, SDL_arraysize(rects), colors[f]);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects(), expected: 0, got: %i", ret);
+            if (!_checkFillRects(surface, rects, SDL_arraysize(rects), colors[f])) {
+                SDL_FreeSurface(surface);
+                return TEST_ABORTED;
+            }
+        }
+
+        rects[0].x = 0; rects[0].y = 0; rects[0].w = surface->w; rects[0].h = surface->h;
+        ret = SDL_FillRect(surface, NULL, colors[f]);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect(), expected: 0, got: %i", ret);
+        if (!_checkFillRects(surface, rects, 1, colors[f])) {
+            SDL_FreeSurface(surface);
+            return TEST_ABORTED;
+        }
+        SDLTest_AssertPass("Verified all %d-bit pixels", bpp * 8);
+
+        SDL_FreeSurface(surface);
+    }
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests SDL_PremultiplySurfaceAlpha() and blitting with SDL_BLENDMODE_BLEND_PREMULTIPLIED
+ */
+int
+surface_testBlitPremultiplied(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB565
+    };
+    const Uint8 dr = 0x40, dg = 0x80, db = 0xC0;
+    SDL_Surface *src, *dst;
+    SDL_BlendMode mode;
+    Uint32 *pixels;
+    int ret, i, x, y;
+
+    /* Every alpha value along the rows, a few colors down the columns */
+    src = SDL_CreateRGBSurfaceWithFormat(0, 256, 4, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    if (src == NULL) {
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < src->h; y++) {
+        pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+        for (x = 0; x < src->w; x++) {
+            pixels[x] = ((Uint32)x << 24) | (0xFF0000 >> (y * 4)) | (y * 0x3F);
+        }
+    }
+
+    ret = SDL_PremultiplySurfaceAlpha(src);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplySurfaceAlpha(), expected: 0, got: %i", ret);
+    SDL_GetSurfaceBlendMode(src, &mode);
+    SDLTest_AssertCheck(mode == SDL_BLENDMODE_BLEND_PREMULTIPLIED, "Verify blend mode, expected: %i, got: %i",
+                        (int)SDL_BLENDMODE_BLEND_PREMULTIPLIED, (int)mode);
+    SDLTest_AssertCheck((src->flags & SDL_PREMULTIPLIED) != 0, "Verify surface is marked as premultiplied");
+
+    for (i = 0; i < (int)SDL_arraysize(formats); i++) {
+        dst = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, 0, formats[i]);
+        SDLTest_AssertCheck(dst != NULL, "Verify destination surface is not NULL");
+        if (dst == NULL) {
+            SDL_FreeSurface(src);
+            return TEST_ABORTED;
+        }
+        SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, dr, dg, db));
+        ret = SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(), expected: 0, got: %i", ret);
+
+        for (y = 0; y < dst->h; y++) {
+            for (x = 0; x < dst->w; x++) {
+                /* Straight alpha blending of the original color is the expected result */
+                const Uint32 spixel = ((Uint32)x << 24) | (0xFF0000 >> (y * 4)) | (y * 0x3F);
+                const int sa = x;
+                const int er = ((int)((spixel >> 16) & 0xFF) * sa + dr * (255 - sa)) / 255;
+                const int eg = ((int)((spixel >> 8) & 0xFF) * sa + dg * (255 - sa)) / 255;
+                const int eb = ((int)(spixel & 0xFF) * sa + db * (255 - sa)) / 255;
+                const int tolerance = (formats[i] == SDL_PIXELFORMAT_RGB565) ? 12 : 3;
+                Uint8 *pixel = (Uint8 *)dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel;
+                Uint32 value = 0;
+                Uint8 pr, pg, pb;
+
+                SDL_memcpy(&value, pixel, dst->format->BytesPerPixel);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                value >>= 8 * (4 - dst->format->BytesPerPixel);
+#endif
+                SDL_GetRGB(value, dst->format, &pr, &pg, &pb);
+                if (SDL_abs(pr - er) > tolerance || SDL_abs(pg - eg) > tolerance || SDL_abs(pb - eb) > tolerance) {
+                    SDLTest_AssertCheck(SDL_FALSE, "Verify %s pixel at %d,%d, expected: %02x%02x%02x, got: %02x%02x%02x",
+                                        SDL_GetPixelFormatName(formats[i]), x, y, er, eg, eb, pr, pg, pb);
+                    SDL_FreeSurface(dst);
+                    SDL_FreeSurface(src);
+                    return TEST_ABORTED;
+                }
+            }
+        }
+        SDLTest_AssertPass("Verified all %s pixels", SDL_GetPixelFormatName(formats[i]));
+        SDL_FreeSurface(dst);
+    }
+
+    SDL_FreeSurface(src);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that RLE blits match plain blits, across destination formats and pixel updates
+ */
+int
+surface_testBlitRLE(void *arg)
+{
+    /* The same sprite drawn to alternating destinations hits the cached encodings */
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_XRGB8888
+    };
+    SDL_Surface *src, *plain, *rle_dst, *plain_dst;
+    SDL_Rect rect;
+    Uint32 *pixels;
+    int ret, i, x, y;
+
+    /* Transparent, opaque and translucent runs */
+    src = SDL_CreateRGBSurfaceWithFormat(0, 64, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    if (src == NULL) {
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < src->h; y++) {
+        pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+        for (x = 0; x < src->w; x++) {
+            const int run = (x + y) % 7;
+            const Uint32 alpha = (run < 2) ? 0 : (run < 4) ? 255 : (Uint32)((x * 16 + y * 3) & 0xFF);
+            pixels[x] = (alpha << 24) | ((Uint32)x << 18) | ((Uint32)y << 10) | (Uint32)((x ^ y) * 4);
+        }
+    }
+    plain = SDL_DuplicateSurface(src);
+    SDLTest_AssertCheck(plain != NULL, "Verify duplicated surface is not NULL");
+    if (plain == NULL) {
+        SDL_FreeSurface(src);
+        return TEST_ABORTED;
+    }
+    SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceBlendMode(plain, SDL_BLENDMODE_BLEND);
+    ret = SDL_SetSurfaceRLE(src, 1);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceRLE(), expected: 0, got: %i", ret);
+
+    for (i = 0; i < (int)SDL_arraysize(formats); i++) {
+        const int tolerance = (formats[i] == SDL_PIXELFORMAT_RGB565) ? 12 : 3;
+
+        rle_dst = SDL_CreateRGBSurfaceWithFormat(0, 48, 24, 0, formats[i]);
+        plain_dst = SDL_CreateRGBSurfaceWithFormat(0, 48, 24, 0, formats[i]);
+        SDLTest_AssertCheck(rle_dst != NULL && plain_dst != NULL, "Verify destination surfaces are not NULL");
+        if (rle_dst == NULL || plain_dst == NULL) {
+            SDL_FreeSurface(rle_dst);
+            SDL_FreeSurface(plain_dst);
+            SDL_FreeSurface(plain);
+            SDL_FreeSurface(src);
+            return TEST_ABORTED;
+        }
+        SDL_FillRect(rle_dst, NULL, SDL_MapRGB(rle_dst->format, 0x40, 0x80, 0xC0));
+        SDL_FillRect(plain_dst, NULL, SDL_MapRGB(plain_dst->format, 0x40, 0x80, 0xC0));
+
+        /* Clipped on the left and the right */
+        rect.x = -5;
+        rect.y = 3;
+        ret = SDL_BlitSurface(src, NULL, rle_dst, &rect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(), expected: 0, got: %i", ret);
+        rect.x = -5;
+        rect.y = 3;
+        SDL_BlitSurface(plain, NULL, plain_dst, &rect);
+        SDLTest_AssertCheck(SDL_HasSurfaceRLE(src), "Verify source surface is RLE encoded");
+
+        for (y = 0; y < rle_dst->h; y++) {
+            for (x = 0; x < rle_dst->w; x++) {
+                const int bpp = rle_dst->format->BytesPerPixel;
+                Uint32 rle_value = 0, plain_value = 0;
+                Uint8 r1, g1, b1, r2, g2, b2;
+
+                SDL_memcpy(&rle_value, (Uint8 *)rle_dst->pixels + y * rle_dst->pitch + x * bpp, bpp);
+                SDL_memcpy(&plain_value, (Uint8 *)plain_dst->pixels + y * plain_dst->pitch + x * bpp, bpp);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                rle_value >>= 8 * (4 - bpp);
+                plain_value >>= 8 * (4 - bpp);
+#endif
+                SDL_GetRGB(rle_value, rle_dst->format, &r1, &g1, &b1);
+                SDL_GetRGB(plain_value, plain_dst->format, &r2, &g2, &b2);
+                if (SDL_abs(r1 - r2) > tolerance || SDL_abs(g1 - g2) > tolerance || SDL_abs(b1 - b2) > tolerance) {
+                    SDLTest_AssertCheck(SDL_FALSE, "Verify %s pixel at %d,%d, expected: %02x%02x%02x, got: %02x%02x%02x",
+                                        SDL_GetPixelFormatName(formats[i]), x, y, r2, g2, b2, r1, g1, b1);
+                    SDL_FreeSurface(rle_dst);
+                    SDL_FreeSurface(plain_dst);
+                    SDL_FreeSurface(plain);
+                    SDL_FreeSurface(src);
+                    return TEST_ABORTED;
+                }
+            }
+        }
+        SDLTest_AssertPass("Verified all %s pixels", SDL_GetPixelFormatName(formats[i]));
+        SDL_FreeSurface(rle_dst);
+        SDL_FreeSurface(plain_dst);
+    }
+
+    /* Locking gives back the original pixels, and changes to them are encoded again */
+    ret = SDL_LockSurface(src);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_LockSurface(), expected: 0, got: %i", ret);
+    for (y = 0; y < src->h; y++) {
+        ret = SDL_memcmp((Uint8 *)src->pixels + y * src->pitch, (Uint8 *)plain->pixels + y * plain->pitch, src->w * 4);
+        SDLTest_AssertCheck(ret == 0, "Verify locked pixels of row %d are unchanged", y);
+    }
+    pixels = (Uint32 *)src->pixels;
+    for (x = 0; x < src->w; x++) {
+        pixels[x] = 0xFF00FF00;
+    }
+    SDL_UnlockSurface(src);
+
+    rle_dst = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, 0, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(rle_dst != NULL, "Verify destination surface is not NULL");
+    if (rle_dst == NULL) {
+        SDL_FreeSurface(plain);
+        SDL_FreeSurface(src);
+        return TEST_ABORTED;
+    }
+    SDL_FillRect(rle_dst, NULL, 0);
+    ret = SDL_BlitSurface(src, NULL, rle_dst, NULL);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface(), expected: 0, got: %i", ret);
+    pixels = (Uint32 *)rle_dst->pixels;
+    for (x = 0; x < rle_dst->w; x++) {
+        if ((pixels[x] & 0x00FFFFFF) != 0x0000FF00) {
+            SDLTest_AssertCheck(SDL_FALSE, "Verify updated pixel at %d,0, expected: 00ff00, got: %06x", x, pixels[x] & 0x00FFFFFF);
+            break;
+        }
+    }
+    SDLTest_AssertPass("Verified updated pixels");
+
+    SDL_FreeSurface(rle_dst);
+    SDL_FreeSurface(plain);
+    SDL_FreeSurface(src);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests saving and loading bitmaps spanning several bands of rows, with conversion
+ */
+int
+surface_testSaveLoadBitmapLarge(void *arg)
+{
+    const int w = 643, h = 480;
+    const size_t size = (size_t)w * h * 4 + 1024;
+    const Uint32 emptyFormats[] = { SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_RGB565 };
+    SDL_bool colorkey;
+    Uint8 *buffer;
+    int i;
+
+    buffer = (Uint8 *)SDL_malloc(size);
+    SDLTest_AssertCheck(buffer != NULL, "Verify buffer is not NULL");
+    if (buffer == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* A 24-bit bitmap, and a 32-bit one for the colorkey */
+    for (colorkey = SDL_FALSE; colorkey <= SDL_TRUE; colorkey++) {
+        SDL_Surface *face, *rface, *converted;
+        SDL_RWops *rw;
+        Uint32 *pixels;
+        int ret, x, y;
+
+        face = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_XRGB8888);
+        SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+        if (face == NULL) {
+            SDL_free(buffer);
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < h; y++) {
+            pixels = (Uint32 *)((Uint8 *)face->pixels + y * face->pitch);
+            for (x = 0; x < w; x++) {
+                pixels[x] = ((x % 7) == 0) ? 0x00FF00FF : (Uint32)(x * 0x10305 + y * 0x3001);
+            }
+        }
+        if (colorkey) {
+            SDL_SetColorKey(face, SDL_TRUE, 0x00FF00FF);
+        }
+
+        rw = SDL_RWFromMem(buffer, (int)size);
+        ret = SDL_SaveBMP_RW(face, rw, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW, expected: 0, got: %i", ret);
+        SDL_RWseek(rw, 0, RW_SEEK_SET);
+        rface = SDL_LoadBMP_RW(rw, 1);
+        SDLTest_AssertCheck(rface != NULL, "Verify result from SDL_LoadBMP_RW is not NULL");
+        if (rface == NULL) {
+            SDL_FreeSurface(face);
+            SDL_free(buffer);
+            return TEST_ABORTED;
+        }
+        SDLTest_AssertCheck(rface->format->BitsPerPixel == (colorkey ? 32 : 24),
+                            "Verify depth of loaded surface, expected: %i, got: %i",
+                            colorkey ? 32 : 24, rface->format->BitsPerPixel);
+        SDLTest_AssertCheck(rface->w == w && rface->h == h, "Verify size of loaded surface, expected: %ix%i, got: %ix%i",
+                            w, h, rface->w, rface->h);
+
+        converted = SDL_ConvertSurfaceFormat(rface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDLTest_AssertCheck(converted != NULL, "Verify converted surface is not NULL");
+        if (converted != NULL && converted->w == w && converted->h == h) {
+            for (y = 0; y < h; y++) {
+                const Uint32 *expected = (const Uint32 *)((Uint8 *)face->pixels + y * face->pitch);
+                pixels = (Uint32 *)((Uint8 *)converted->pixels + y * converted->pitch);
+                for (x = 0; x < w; x++) {
+                    Uint32 value = expected[x] | 0xFF000000;
+                    if (colorkey && expected[x] == 0x00FF00FF) {
+                        value = 0x00FF00FF;
+                    }
+                    if (pixels[x] != value) {
+                        SDLTest_AssertCheck(SDL_FALSE, "Verify pixel at %d,%d, expected: %08x, got: %08x",
+                                            x, y, value, pixels[x]);
+                        y = h;
+                        break;
+                    }
+                }
+            }
+            SDLTest_AssertPass("Verified loaded pixels");
+        }
+
+        SDL_FreeSurface(converted);
+        SDL_FreeSurface(rface);
+        SDL_FreeSurface(face);
+    }
+
+    /* Surfaces with empty rows, saved as they are and with conversion */
+    for (i = 0; i < (int)SDL_arraysize(emptyFormats); i++) {
+        const Uint32 format = emptyFormats[i];
+        SDL_Surface *face;
+        SDL_RWops *rw;
+        Sint64 end;
+        Uint32 fileSize, offBits;
+        int ret;
+
+        face = SDL_CreateRGBSurfaceWithFormat(0, 0, 4, 0, format);
+        SDLTest_AssertCheck(face != NULL, "Verify 0x4 %s surface is not NULL", SDL_GetPixelFormatName(format));
+        if (face == NULL) {
+            SDL_free(buffer);
+            return TEST_ABORTED;
+        }
+
+        rw = SDL_RWFromMem(buffer, (int)size);
+        ret = SDL_SaveBMP_RW(face, rw, 0);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SaveBMP_RW of 0x4 %s surface, expected: 0, got: %i",
+                            SDL_GetPixelFormatName(format), ret);
+        end = SDL_RWtell(rw);
+        SDL_RWseek(rw, 2, RW_SEEK_SET);
+        fileSize = SDL_ReadLE32(rw);
+        SDL_RWseek(rw, 10, RW_SEEK_SET);
+        offBits = SDL_ReadLE32(rw);
+        SDLTest_AssertCheck(fileSize == end && offBits == end,
+                            "Verify bitmap has no image data, expected file size and offset: %i, got: %i, %i",
+                            (int)end, (int)fileSize, (int)offBits);
+        SDL_RWclose(rw);
+        SDL_FreeSurface(face);
+    }
+
+    SDL_free(buffer);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that blits pick the right function when alternating between destinations
+ */
+int
+surface_testBlitMapCache(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGBA4444, SDL_PIXELFORMAT_XRGB8888,
+        SDL_PIXELFORMAT_INDEX8
+    };
+    SDL_Surface *src, *dst[SDL_arraysize(formats)];
+    Uint32 *pixels;
+    int ret, round, i, x, y;
+
+    src = SDL_CreateRGBSurfaceWithFormat(0, 32, 8, 0, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    if (src == NULL) {
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < src->h; y++) {
+        pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+        for (x = 0; x < src->w; x++) {
+            pixels[x] = 0xFF000000 | ((Uint32)(x * 8) << 16) | ((Uint32)(y * 32) << 8) | (Uint32)((x ^ y) * 8);
+        }
+    }
+
+    /* The same source drawn to every destination in turn, so the blit map
+       changes and the blit functions come from the cache after the first
+       round. Copies, then color modulation, then a colorkey. */
+    SDL_memset(dst, 0, sizeof(dst));
+    for (round = 0; round < 6; round++) {
+        const SDL_bool colormod = (round == 2 || round == 3);
+        const SDL_bool colorkey = (round >= 4);
+
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+        SDL_SetSurfaceColorMod(src, colormod ? 0x80 : 0xFF, 0xFF, colormod ? 0x40 : 0xFF);
+        SDL_SetColorKey(src, colorkey, 0xFF000000);
+
+        for (i = 0; i < (int)SDL_arraysize(formats); i++) {
+            SDL_PixelFormat *fmt;
+            int tolerance;
+
+            if (colormod && SDL_ISPIXELFORMAT_INDEXED(formats[i])) {
+                /* There is no blitter for color modulation into a palette */
+                continue;
+            }
+            if (dst[i] == NULL || (round % 2) == 0) {
+                SDL_FreeSurface(dst[i]);
+                dst[i] = SDL_CreateRGBSurfaceWithFormat(0, src->w, src->h, 0, formats[i]);
+                SDLTest_AssertCheck(dst[i] != NULL, "Verify destination surface is not NULL");
+                if (dst[i] == NULL) {
+                    continue;
+                }
+            }
+            fmt = dst[i]->format;
+            tolerance = (fmt->palette != NULL) ? 0 : (1 << SDL_max(fmt->Rloss, SDL_max(fmt->Gloss, fmt->Bloss)));
+            SDL_FillRect(dst[i], NULL, SDL_MapRGB(fmt, 0x10, 0x20, 0x30));
+            ret = SDL_BlitSurface(src, NULL, dst[i], NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface() to %s, expected: 0, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), ret);
+
+            for (y = 0; y < src->h; y++) {
+                for (x = 0; x < src->w; x++) {
+                    const Uint32 src_value = ((Uint32 *)((Uint8 *)src->pixels + y * src->pitch))[x];
+                    const int bpp = fmt->BytesPerPixel;
+                    Uint32 value = 0;
+                    Uint8 r, g, b, er, eg, eb;
+
+                    SDL_GetRGB(src_value, src->format, &er, &eg, &eb);
+                    if (colorkey && src_value == 0xFF000000) {
+                        er = 0x10;
+                        eg = 0x20;
+                        eb = 0x30;
+                    } else if (colormod) {
+                        er = (Uint8)((er * 0x80) / 255);
+                        eb = (Uint8)((eb * 0x40) / 255);
+                    }
+                    if (fmt->palette != NULL) {
+                        /* The closest palette entry, looked up the same way */
+                        SDL_GetRGB(SDL_MapRGB(fmt, er, eg, eb), fmt, &er, &eg, &eb);
+                    }
+
+                    SDL_memcpy(&value, (Uint8 *)dst[i]->pixels + y * dst[i]->pitch + x * bpp, bpp);
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                    value >>= 8 * (4 - bpp);
+#endif
+                    SDL_GetRGB(value, fmt, &r, &g, &b);
+                    if (SDL_abs(r - er) > tolerance || SDL_abs(g - eg) > tolerance || SDL_abs(b - eb) > tolerance) {
+                        SDLTest_AssertCheck(SDL_FALSE, "Verify %s pixel at %d,%d in round %d, expected: %02x%02x%02x, got: %02x%02x%02x",
+                                            SDL_GetPixelFormatName(formats[i]), x, y, round, er, eg, eb, r, g, b);
+                        y = src->h;
+                        break;
+                    }
+                }
+            }
+        }
+        SDLTest_AssertPass("Verified blits of round %d", round);
+    }
+
+    for (i = 0; i < (int)SDL_arraysize(formats); i++) {
+        SDL_FreeSurface(dst[i]);
+    }
+    SDL_FreeSurface(src);
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests nearest neighbour stretching for every pixel size, scaling up and down
+ */
+int
+surface_testSoftStretchNearest(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_INDEX8
+    };
+    const int sizes[][4] = {
+        { 37, 23, 100, 61 }, { 100, 61, 37, 23 }, { 64, 64, 64, 64 }, { 50, 40, 49, 81 }, { 9, 7, 203, 5 }
+    };
+    SDL_Surface *src, *dst;
+    SDL_Rect srcrect, dstrect;
+    int i, j, ret, x, y, c;
+
+    for (i = 0; i < (int)SDL_arraysize(formats); i++) {
+        for (j = 0; j < (int)SDL_arraysize(sizes); j++) {
+            const int src_w = sizes[j][0], src_h = sizes[j][1];
+            const int dst_w = sizes[j][2], dst_h = sizes[j][3];
+            const Uint32 incx = ((Uint32)src_w << 16) / dst_w;
+            const Uint32 incy = ((Uint32)src_h << 16) / dst_h;
+            int bpp, errors = 0;
+
+            /* Both rectangles are inside larger surfaces */
+            src = SDL_CreateRGBSurfaceWithFormat(0, src_w + 6, src_h + 4, 0, formats[i]);
+            dst = SDL_CreateRGBSurfaceWithFormat(0, dst_w + 10, dst_h + 8, 0, formats[i]);
+            SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify surfaces are not NULL");
+            if (src == NULL || dst == NULL) {
+                SDL_FreeSurface(src);
+                SDL_FreeSurface(dst);
+                return TEST_ABORTED;
+            }
+            bpp = src->format->BytesPerPixel;
+            for (y = 0; y < src->h; y++) {
+                Uint8 *row = (Uint8 *)src->pixels + y * src->pitch;
+                for (x = 0; x < src->w * bpp; x++) {
+                    row[x] = (Uint8)(x * 7 + y * 13);
+                }
+            }
+            SDL_memset(dst->pixels, 0xAB, dst->h * dst->pitch);
+
+            srcrect.x = 3;
+            srcrect.y = 2;
+            srcrect.w = src_w;
+            srcrect.h = src_h;
+            dstrect.x = 5;
+            dstrect.y = 4;
+            dstrect.w = dst_w;
+            dstrect.h = dst_h;
+            ret = SDL_SoftStretch(src, &srcrect, dst, &dstrect);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretch(), expected: 0, got: %i", ret);
+
+            /* The source pixel under the centre of each destination pixel, in 16.16 fixed point */
+            for (y = 0; y < dst->h && errors == 0; y++) {
+                const Uint8 *row = (const Uint8 *)dst->pixels + y * dst->pitch;
+                const int sy = srcrect.y + (int)((incy / 2 + (y - dstrect.y) * incy) >> 16);
+                for (x = 0; x < dst->w && errors == 0; x++) {
+                    const int sx = srcrect.x + (int)((incx / 2 + (x - dstrect.x) * incx) >> 16);
+                    const SDL_bool inside = (x >= dstrect.x && x < dstrect.x + dst_w && y >= dstrect.y && y < dstrect.y + dst_h);
+                    for (c = 0; c < bpp; c++) {
+                        const Uint8 expected = inside ? ((const Uint8 *)src->pixels)[sy * src->pitch + sx * bpp + c] : 0xAB;
+                        if (row[x * bpp + c] != expected) {
+                            SDLTest_AssertCheck(SDL_FALSE, "Verify %s %dx%d -> %dx%d byte %d of pixel %d,%d, expected: %02x, got: %02x",
+                                                SDL_GetPixelFormatName(formats[i]), src_w, src_h, dst_w, dst_h, c, x, y,
+                                                expected, row[x * bpp + c]);
+                            errors++;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (errors == 0) {
+                SDLTest_AssertPass("Verified %s %dx%d -> %dx%d", SDL_GetPixelFormatName(formats[i]), src_w, src_h, dst_w, dst_h);
+            }
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+        }
+    }
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that SDL_ScaleModeBest averages every source pixel when reducing a lot
+ */
+int
+surface_testScaleModeBest(void *arg)
+{
+    const int sizes[][4] = { { 96, 60, 16, 12 }, { 100, 70, 16, 12 }, { 333, 17, 41, 5 } };
+    SDL_Surface *target, *src;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    Uint32 *pixels;
+    int i, ret, x, y, c;
+
+    for (i = 0; i < (int)SDL_arraysize(sizes); i++) {
+        const int src_w = sizes[i][0], src_h = sizes[i][1];
+        const int dst_w = sizes[i][2], dst_h = sizes[i][3];
+        int errors = 0;
+
+        /* A pattern that bilinear filtering would alias */
+        src = SDL_CreateRGBSurfaceWithFormat(0, src_w, src_h, 0, SDL_PIXELFORMAT_ARGB8888);
+        target = SDL_CreateRGBSurfaceWithFormat(0, dst_w, dst_h, 0, SDL_PIXELFORMAT_ARGB8888);
+        SDLTest_AssertCheck(src != NULL && target != NULL, "Verify surfaces are not NULL");
+        if (src == NULL || target == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(target);
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < src_h; y++) {
+            pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+            for (x = 0; x < src_w; x++) {
+                const Uint32 r = ((x + y) & 1) ? 0xFF : 0x00;
+                const Uint32 g = (Uint32)(x * 255 / (src_w - 1));
+                const Uint32 b = (Uint32)((x * y) & 0xFF);
+                pixels[x] = 0xFF000000 | (r << 16) | (g << 8) | b;
+            }
+        }
+
+        renderer = SDL_CreateSoftwareRenderer(target);
+        SDLTest_AssertCheck(renderer != NULL, "Verify renderer is not NULL");
+        if (renderer == NULL) {
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(target);
+            return TEST_ABORTED;
+        }
+        texture = SDL_CreateTextureFromSurface(renderer, src);
+        SDLTest_AssertCheck(texture != NULL, "Verify texture is not NULL");
+        if (texture != NULL) {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+            ret = SDL_SetTextureScaleMode(texture, SDL_ScaleModeBest);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetTextureScaleMode(), expected: 0, got: %i", ret);
+            ret = SDL_RenderCopy(renderer, texture, NULL, NULL);
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_RenderCopy(), expected: 0, got: %i", ret);
+            SDL_RenderFlush(renderer);
+            SDL_DestroyTexture(texture);
+        }
+        SDL_DestroyRenderer(renderer);
+
+        /* Each destination pixel is the average of the source area it covers */
+        for (y = 0; y < dst_h && errors == 0; y++) {
+            const double y0 = (double)y * src_h / dst_h, y1 = (double)(y + 1) * src_h / dst_h;
+            pixels = (Uint32 *)((Uint8 *)target->pixels + y * target->pitch);
+            for (x = 0; x < dst_w && errors == 0; x++) {
+                const double x0 = (double)x * src_w / dst_w, x1 = (double)(x + 1) * src_w / dst_w;
+                double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+                int sx, sy;
+
+                for (sy = (int)y0; sy < src_h && sy < y1; sy++) {
+                    const double wy = SDL_min(y1, sy + 1.0) - SDL_max(y0, (double)sy);
+                    const Uint32 *row = (const Uint32 *)((const Uint8 *)src->pixels + sy * src->pitch);
+                    for (sx = (int)x0; sx < src_w && sx < x1; sx++) {
+                        const double w = wy * (SDL_min(x1, sx + 1.0) - SDL_max(x0, (double)sx));
+                        for (c = 0; c < 4; c++) {
+                            sum[c] += w * ((row[sx] >> (8 * c)) & 0xFF);
+                        }
+                    }
+                }
+                for (c = 0; c < 4; c++) {
+                    const int expected = (int)(sum[c] / ((x1 - x0) * (y1 - y0)) + 0.5);
+                    const int actual = (int)((pixels[x] >> (8 * c)) & 0xFF);
+                    if (SDL_abs(actual - expected) > 1) {
+                        SDLTest_AssertCheck(SDL_FALSE, "Verify %dx%d -> %dx%d channel %d of pixel %d,%d, expected: %d, got: %d",
+                                            src_w, src_h, dst_w, dst_h, c, x, y, expected, actual);
+                        errors++;
+                        break;
+                    }
+                }
+            }
+        }
+        if (errors == 0) {
+            SDLTest_AssertPass("Verified %dx%d -> %dx%d", src_w, src_h, dst_w, dst_h);
+        }
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(target);
+    }
+    return TEST_COMPLETED;
+}
+
+/* Blit and conversion cases run by surface_testBlitThreads */
+#define BLIT_THREADS_CASES  9
+#define BLIT_THREADS_W      640
+#define BLIT_THREADS_H      480
+
+static SDL_Surface *
+_createBlitThreadsSource(void)
+{
+    SDL_Surface *src;
+    Uint32 *pixels;
+    int x, y;
+
+    src = SDL_CreateRGBSurfaceWithFormat(0, BLIT_THREADS_W, BLIT_THREADS_H, 0, SDL_PIXELFORMAT_ARGB8888);
+    if (src == NULL) {
+        return NULL;
+    }
+    for (y = 0; y < src->h; y++) {
+        pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+        for (x = 0; x < src->w; x++) {
+            pixels[x] = ((x % 13) == 0) ? 0x00FF00FF : (Uint32)(x * 0x01020305 + y * 0x00300701);
+        }
+    }
+    return src;
+}
+
+static SDL_Surface *
+_createBlitThreadsTarget(Uint32 format, int w, int h)
+{
+    SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, format);
+    if (dst != NULL) {
+        SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, 0x40, 0x80, 0xC0));
+    }
+    return dst;
+}
+
+/* Fills results[] with the output of every case, returns 0 or -1 if a surface couldn't be created */
+static int
+_runBlitThreadsCases(SDL_Surface **results)
+{
+    const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_RGB24 };
+    SDL_Surface *src, *yuv;
+    SDL_Rect srcrect, dstrect;
+    int i, ret;
+
+    SDL_memset(results, 0, BLIT_THREADS_CASES * sizeof(*results));
+    src = _createBlitThreadsSource();
+    if (src == NULL) {
+        return -1;
+    }
+
+    /* Copy, conversion, blend with alpha mod and colorkey, partly clipped */
+    for (i = 0; i < 4; i++) {
+        results[i] = _createBlitThreadsTarget(formats[i], BLIT_THREADS_W + 60, BLIT_THREADS_H + 20);
+        if (results[i] == NULL) {
+            SDL_FreeSurface(src);
+            return -1;
+        }
+        SDL_SetSurfaceBlendMode(src, (i == 2) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        SDL_SetSurfaceAlphaMod(src, (i == 2) ? 0x80 : 0xFF);
+        SDL_SetColorKey(src, (i == 3) ? SDL_TRUE : SDL_FALSE, 0x00FF00FF);
+        dstrect.x = 7;
+        dstrect.y = 35;
+        ret = SDL_BlitSurface(src, NULL, results[i], &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface() to %s, expected: 0, got: %i",
+                            SDL_GetPixelFormatName(formats[i]), ret);
+    }
+    SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+    SDL_SetSurfaceAlphaMod(src, 0xFF);
+    SDL_SetColorKey(src, SDL_FALSE, 0);
+
+    results[4] = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_ABGR8888, 0);
+
+    /* RGB to NV12 and back, the NV12 planes are stored as an 8-bit surface */
+    results[5] = yuv = SDL_CreateRGBSurfaceWithFormat(0, BLIT_THREADS_W, BLIT_THREADS_H * 3 / 2, 0, SDL_PIXELFORMAT_INDEX8);
+    results[6] = _createBlitThreadsTarget(SDL_PIXELFORMAT_ARGB8888, BLIT_THREADS_W, BLIT_THREADS_H);
+    if (results[4] == NULL || yuv == NULL || results[6] == NULL || yuv->pitch != BLIT_THREADS_W) {
+        SDL_FreeSurface(src);
+        return -1;
+    }
+    ret = SDL_ConvertPixels(src->w, src->h, src->format->format, src->pixels, src->pitch,
+                            SDL_PIXELFORMAT_NV12, yuv->pixels, yuv->pitch);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels() to NV12, expected: 0, got: %i", ret);
+    ret = SDL_ConvertPixels(src->w, src->h, SDL_PIXELFORMAT_NV12, yuv->pixels, yuv->pitch,
+                            results[6]->format->format, results[6]->pixels, results[6]->pitch);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels() from NV12, expected: 0, got: %i", ret);
+
+    /* Blits within the same surface, down and to the right, then up and to the left */
+    for (i = 7; i < 9; i++) {
+        results[i] = SDL_DuplicateSurface(src);
+        if (results[i] == NULL) {
+            SDL_FreeSurface(src);
+            return -1;
+        }
+        SDL_SetSurfaceBlendMode(results[i], SDL_BLENDMODE_NONE);
+        srcrect.x = (i == 7) ? 0 : 3;
+        srcrect.y = (i == 7) ? 0 : 5;
+        srcrect.w = BLIT_THREADS_W - 3;
+        srcrect.h = BLIT_THREADS_H - 5;
+        dstrect.x = (i == 7) ? 3 : 0;
+        dstrect.y = (i == 7) ? 5 : 0;
+        ret = SDL_BlitSurface(results[i], &srcrect, results[i], &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface() within a surface, expected: 0, got: %i", ret);
+    }
+
+    SDL_FreeSurface(src);
+    return 0;
+}
+
+static void
+_freeBlitThreadsCases(SDL_Surface **results)
+{
+    int i;
+
+    for (i = 0; i < BLIT_THREADS_CASES; i++) {
+        SDL_FreeSurface(results[i]);
+    }
+}
+
+/* Returns the first row that differs, or -1 if the pixels are the same */
+static int
+_compareSurfaceRows(SDL_Surface *a, SDL_Surface *b)
+{
+    int y;
+
+    if (a->w != b->w || a->h != b->h || a->format->format != b->format->format) {
+        return 0;
+    }
+    for (y = 0; y < a->h; y++) {
+        if (SDL_memcmp((Uint8 *)a->pixels + y * a->pitch, (Uint8 *)b->pixels + y * b->pitch,
+                       a->w * a->format->BytesPerPixel) != 0) {
+            return y;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Tests that blits and conversions split across threads match the ones on the calling thread
+ */
+int
+surface_testBlitThreads(void *arg)
+{
+    const char *threads_hints[] = { "2", "4" };
+    SDL_Surface *serial[BLIT_THREADS_CASES];
+    SDL_Surface *threaded[BLIT_THREADS_CASES];
+    SDL_Surface *src, *copy;
+    SDL_Rect srcrect, dstrect;
+    int i, j, row;
+
+    SDL_SetHint(SDL_HINT_BLIT_THREADS, "1");
+    if (_runBlitThreadsCases(serial) < 0) {
+        SDLTest_AssertCheck(SDL_FALSE, "Verify surfaces were created");
+        _freeBlitThreadsCases(serial);
+        return TEST_ABORTED;
+    }
+
+    /* Every blit is large enough to split into a few bands */
+    SDL_SetHint(SDL_HINT_BLIT_THREADS_MIN_PIXELS, "0");
+    for (i = 0; i < (int)SDL_arraysize(threads_hints); i++) {
+        SDL_SetHint(SDL_HINT_BLIT_THREADS, threads_hints[i]);
+        SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_BLIT_THREADS, \"%s\")", threads_hints[i]);
+        if (_runBlitThreadsCases(threaded) < 0) {
+            SDLTest_AssertCheck(SDL_FALSE, "Verify surfaces were created");
+            _freeBlitThreadsCases(threaded);
+            break;
+        }
+        for (j = 0; j < BLIT_THREADS_CASES; j++) {
+            row = _compareSurfaceRows(threaded[j], serial[j]);
+            SDLTest_AssertCheck(row < 0, "Verify case %d on %s threads matches the serial result, first different row: %d",
+                                j, threads_hints[i], row);
+        }
+        _freeBlitThreadsCases(threaded);
+    }
+
+    /* The blits within a surface match blits from a copy of it */
+    src = _createBlitThreadsSource();
+    if (src != NULL) {
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+    }
+    for (i = 7; src != NULL && i < 9; i++) {
+        copy = SDL_DuplicateSurface(src);
+        if (copy == NULL) {
+            break;
+        }
+        srcrect.x = (i == 7) ? 0 : 3;
+        srcrect.y = (i == 7) ? 0 : 5;
+        srcrect.w = BLIT_THREADS_W - 3;
+        srcrect.h = BLIT_THREADS_H - 5;
+        dstrect.x = (i == 7) ? 3 : 0;
+        dstrect.y = (i == 7) ? 5 : 0;
+        SDL_BlitSurface(src, &srcrect, copy, &dstrect);
+        row = _compareSurfaceRows(copy, serial[i]);
+        SDLTest_AssertCheck(row < 0, "Verify overlapping blit %d matches a blit from a copy, first different row: %d", i, row);
+        SDL_FreeSurface(copy);
+    }
+    SDL_FreeSurface(src);
+
+    SDL_SetHint(SDL_HINT_BLIT_THREADS, "0");
+    SDL_SetHint(SDL_HINT_BLIT_THREADS_MIN_PIXELS, "");
+    _freeBlitThreadsCases(serial);
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -631,11 +1606,40 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testFillRects24, "surface_testFillRects24", "Tests filling rects on a 24-bit surface.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testBlitPremultiplied, "surface_testBlitPremultiplied", "Tests blitting surfaces with premultiplied alpha.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testBlitRLE, "surface_testBlitRLE", "Tests RLE blits to changing destinations.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testSaveLoadBitmapLarge, "surface_testSaveLoadBitmapLarge", "Tests saving and loading large and empty bitmaps with conversion.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testBlitThreads, "surface_testBlitThreads", "Tests blits split across threads against blits on one thread.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest18 =
+        { (SDLTest_TestCaseFp)surface_testBlitMapCache, "surface_testBlitMapCache", "Tests blits from one surface to alternating destinations.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest19 =
+        { (SDLTest_TestCaseFp)surface_testSoftStretchNearest, "surface_testSoftStretchNearest", "Tests nearest neighbour stretching.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest20 =
+        { (SDLTest_TestCaseFp)surface_testScaleModeBest, "surface_testScaleModeBest", "Tests area averaging with SDL_ScaleModeBest.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest21 =
+        { (SDLTest_TestCaseFp)surface_testFillRects, "surface_testFillRects", "Tests filling rects on 8, 16 and 32-bit surfaces.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14,
+    &surfaceTest15, &surfaceTest16, &surfaceTest17, &surfaceTest18,
+    &surfaceTest19, &surfaceTest20, &surfaceTest21, NULL
 };
 
 /* Surface test suite (global) */
@@ -172,6 +172,191 @@ timer_addRemoveTimer(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Counts its calls and fires every 500 us until it has run 20 times */
+Uint64 SDLCALL _timerTestNSCallback(Uint64 interval, void *param)
+{
+  SDL_atomic_t *calls = (SDL_atomic_t *)param;
+
+  if (SDL_AtomicIncRef(calls) + 1 >= 20) {
+    return 0;
+  }
+  return interval;
+}
+
+/* Records the order timers fire in */
+static SDL_atomic_t _timerOrderNext;
+static int _timerOrder[8];
+
+Uint32 SDLCALL _timerTestOrderCallback(Uint32 interval, void *param)
+{
+  const int slot = SDL_AtomicIncRef(&_timerOrderNext);
+  if (slot < (int)SDL_arraysize(_timerOrder)) {
+    _timerOrder[slot] = (int)(intptr_t)param;
+  }
+  return 0;
+}
+
+/**
+ * @brief Call to SDL_AddTimerNS with a sub-millisecond interval
+ */
+int
+timer_addTimerNS(void *arg)
+{
+  SDL_atomic_t calls;
+  SDL_TimerID id;
+  Uint64 start, elapsed_us;
+  int i;
+
+  SDL_AtomicSet(&calls, 0);
+  start = SDL_GetPerformanceCounter();
+  id = SDL_AddTimerNS(500000, _timerTestNSCallback, &calls);
+  SDLTest_AssertPass("Call to SDL_AddTimerNS(500000, ...)");
+  SDLTest_AssertCheck(id > 0, "Check result value, expected: >0, got: %d", id);
+
+  for (i = 0; i < 1000 && SDL_AtomicGet(&calls) < 20; i++) {
+    SDL_Delay(1);
+  }
+  elapsed_us = (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+  SDLTest_AssertCheck(SDL_AtomicGet(&calls) == 20, "Check callback count, expected: 20, got: %d", SDL_AtomicGet(&calls));
+  SDLTest_AssertCheck(elapsed_us >= 10000, "Check 20 calls 500 us apart took at least 10 ms, got: %d us", (int)elapsed_us);
+
+  SDLTest_AssertCheck(SDL_RemoveTimer(id) == SDL_FALSE, "Check that the finished timer can't be removed");
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Adds and removes many timers, and checks that timers fire in order
+ */
+int
+timer_manyTimers(void *arg)
+{
+  SDL_TimerID ids[2000];
+  int i, removed = 0;
+
+  /* Reset state */
+  _paramCheck = 0;
+  _timerCallbackCalled = 0;
+
+  for (i = 0; i < (int)SDL_arraysize(ids); i++) {
+    ids[i] = SDL_AddTimer(100000 + i, _timerTestCallback, NULL);
+    if (ids[i] <= 0) {
+      SDLTest_AssertCheck(ids[i] > 0, "Check result value of SDL_AddTimer, expected: >0, got: %d", ids[i]);
+      return TEST_ABORTED;
+    }
+  }
+  SDLTest_AssertPass("Call to SDL_AddTimer() %d times", (int)SDL_arraysize(ids));
+
+  /* Remove them in a scattered order */
+  for (i = 0; i < (int)SDL_arraysize(ids); i++) {
+    const int index = (i * 7919) % (int)SDL_arraysize(ids);
+    if (SDL_RemoveTimer(ids[index])) {
+      removed++;
+    }
+  }
+  SDLTest_AssertCheck(removed == (int)SDL_arraysize(ids), "Check number of removed timers, expected: %d, got: %d", (int)SDL_arraysize(ids), removed);
+  SDLTest_AssertCheck(SDL_RemoveTimer(ids[0]) == SDL_FALSE, "Check that a removed timer can't be removed again");
+  SDLTest_AssertCheck(_timerCallbackCalled == 0, "Check callback WAS NOT called, expected: 0, got: %i", _timerCallbackCalled);
+
+  /* Timers added out of order fire by due time */
+  SDL_AtomicSet(&_timerOrderNext, 0);
+  SDL_AddTimer(40, _timerTestOrderCallback, (void *)(intptr_t)3);
+  SDL_AddTimer(10, _timerTestOrderCallback, (void *)(intptr_t)1);
+  SDL_AddTimer(70, _timerTestOrderCallback, (void *)(intptr_t)4);
+  SDL_AddTimer(25, _timerTestOrderCallback, (void *)(intptr_t)2);
+  SDL_Delay(200);
+  SDLTest_AssertCheck(SDL_AtomicGet(&_timerOrderNext) == 4, "Check number of timers fired, expected: 4, got: %d", SDL_AtomicGet(&_timerOrderNext));
+  SDLTest_AssertCheck(_timerOrder[0] == 1 && _timerOrder[1] == 2 && _timerOrder[2] == 3 && _timerOrder[3] == 4,
+                      "Check order of timers, expected: 1 2 3 4, got: %d %d %d %d",
+                      _timerOrder[0], _timerOrder[1], _timerOrder[2], _timerOrder[3]);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Call to SDL_DelayPrecise
+ */
+int
+timer_delayPrecise(void *arg)
+{
+  const Uint64 testDelays[] = { 0, 100000, 1500000, 10000000 };
+  const Uint64 marginOfError = 5000000;
+  const Uint64 frequency = SDL_GetPerformanceFrequency();
+  int i;
+
+  for (i = 0; i < (int)SDL_arraysize(testDelays); i++) {
+    const Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 elapsed;
+
+    SDL_DelayPrecise(testDelays[i]);
+    elapsed = ((SDL_GetPerformanceCounter() - start) * 1000000000) / frequency;
+    SDLTest_AssertPass("Call to SDL_DelayPrecise(%" SDL_PRIu64 ")", testDelays[i]);
+    SDLTest_AssertCheck(elapsed >= testDelays[i], "Check elapsed time, expected: >=%" SDL_PRIu64 ", got: %" SDL_PRIu64, testDelays[i], elapsed);
+    SDLTest_AssertCheck(elapsed < testDelays[i] + marginOfError, "Check elapsed time, expected: <%" SDL_PRIu64 ", got: %" SDL_PRIu64, testDelays[i] + marginOfError, elapsed);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * @brief Paces frames with SDL_CreateFramePacer and checks the statistics
+ */
+int
+timer_framePacer(void *arg)
+{
+  const Uint64 interval = 5000000;
+  SDL_FramePacer *pacer;
+  SDL_FramePacerStats stats;
+  Uint64 frame;
+  int i, result;
+
+  pacer = SDL_CreateFramePacer(0);
+  SDLTest_AssertCheck(pacer == NULL, "Check that a zero interval is rejected");
+
+  result = SDL_GetFramePacerStats(NULL, &stats);
+  SDLTest_AssertCheck(result < 0, "Check result of SDL_GetFramePacerStats(NULL), expected: <0, got: %d", result);
+
+  pacer = SDL_CreateFramePacer(interval);
+  SDLTest_AssertCheck(pacer != NULL, "Call to SDL_CreateFramePacer(%" SDL_PRIu64 ")", interval);
+  if (pacer == NULL) {
+    return TEST_ABORTED;
+  }
+
+  frame = SDL_FramePacerWait(pacer);
+  SDLTest_AssertCheck(frame == 0, "Check first frame time, expected: 0, got: %" SDL_PRIu64, frame);
+  for (i = 0; i < 20; i++) {
+    SDL_FramePacerWait(pacer);
+  }
+
+  result = SDL_GetFramePacerStats(pacer, &stats);
+  SDLTest_AssertCheck(result == 0, "Check result of SDL_GetFramePacerStats, expected: 0, got: %d", result);
+  SDLTest_AssertCheck(stats.frames == 20, "Check number of frames, expected: 20, got: %" SDL_PRIu64, stats.frames);
+  SDLTest_AssertCheck(stats.interval_ns > interval - 1000 && stats.interval_ns <= interval,
+                      "Check interval, expected: %" SDL_PRIu64 ", got: %" SDL_PRIu64, interval, stats.interval_ns);
+  SDLTest_AssertCheck(stats.frame_min_ns <= stats.frame_avg_ns && stats.frame_avg_ns <= stats.frame_max_ns,
+                      "Check frame times, expected: min <= avg <= max, got: %" SDL_PRIu64 " %" SDL_PRIu64 " %" SDL_PRIu64,
+                      stats.frame_min_ns, stats.frame_avg_ns, stats.frame_max_ns);
+  SDLTest_AssertCheck(stats.frame_avg_ns > interval / 2 && stats.frame_avg_ns < interval * 2,
+                      "Check average frame time, expected: ~%" SDL_PRIu64 ", got: %" SDL_PRIu64, interval, stats.frame_avg_ns);
+
+  /* A long stall is counted as missed and doesn't cause a burst of frames */
+  SDL_Delay(20);
+  SDL_FramePacerWait(pacer);
+  frame = SDL_FramePacerWait(pacer);
+  SDL_GetFramePacerStats(pacer, &stats);
+  SDLTest_AssertCheck(stats.missed_frames >= 1, "Check missed frames, expected: >=1, got: %" SDL_PRIu64, stats.missed_frames);
+  SDLTest_AssertCheck(frame > interval / 2, "Check frame time after a stall, expected: >%" SDL_PRIu64 ", got: %" SDL_PRIu64, interval / 2, frame);
+
+  SDL_ResetFramePacerStats(pacer);
+  SDL_GetFramePacerStats(pacer, &stats);
+  SDLTest_AssertCheck(stats.frames == 0 && stats.frame_min_ns == 0, "Check statistics after SDL_ResetFramePacerStats");
+
+  SDL_DestroyFramePacer(pacer);
+  SDLTest_AssertPass("Call to SDL_DestroyFramePacer()");
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Timer test cases */
@@ -187,9 +372,21 @@ static const SDLTest_TestCaseReference timerTest3 =
 static const SDLTest_TestCaseReference timerTest4 =
         { (SDLTest_TestCaseFp)timer_addRemoveTimer, "timer_addRemoveTimer", "Call to SDL_AddTimer and SDL_RemoveTimer", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference timerTest5 =
+        { (SDLTest_TestCaseFp)timer_addTimerNS, "timer_addTimerNS", "Call to SDL_AddTimerNS with a sub-millisecond interval", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference timerTest6 =
+        { (SDLTest_TestCaseFp)timer_manyTimers, "timer_manyTimers", "Adds and removes many timers and checks their order", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference timerTest7 =
+        { (SDLTest_TestCaseFp)timer_delayPrecise, "timer_delayPrecise", "Call to SDL_DelayPrecise", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference timerTest8 =
+        { (SDLTest_TestCaseFp)timer_framePacer, "timer_framePacer", "Paces frames with SDL_CreateFramePacer and checks the statistics", TEST_ENABLED };
+
 /* Sequence of Timer test cases */
 static const SDLTest_TestCaseReference *timerTests[] =  {
-    &timerTest1, &timerTest2, &timerTest3, &timerTest4, NULL
+    &timerTest1, &timerTest2, &timerTest3, &timerTest4, &timerTest5, &timerTest6, &timerTest7, &timerTest8, NULL
 };
 
 /* Timer test suite (global) */
@@ -0,0 +1,234 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for plain surface copies: blits between two surfaces of the same
+   format at a few common framebuffer sizes, and scrolls a surface onto itself,
+   then reports the time per blit and the throughput. Each blit is checked
+   against a reference copy first, and the program fails if one is wrong. */
+
+#include "SDL.h"
+
+static int iterations = 20;
+static const Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+
+typedef struct
+{
+    const char *name;
+    int width;
+    int height;
+} Size;
+
+static const Size sizes[] = {
+    { "256x256", 256, 256 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "4K", 3840, 2160 },
+};
+
+static SDL_Surface *
+CreateSurface(int width, int height)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 0, format);
+    Uint32 seed = 1;
+    int i;
+
+    if (surface) {
+        Uint8 *pixels = (Uint8 *) surface->pixels;
+        for (i = 0; i < surface->h * surface->pitch; ++i) {
+            seed = seed * 1103515245 + 12345;
+            pixels[i] = (Uint8) (seed >> 16);
+        }
+    }
+    return surface;
+}
+
+/* Blits once and compares the destination with rows copied from snapshots
+   of both surfaces, which is also right when the rectangles overlap.
+   The rectangles must already be inside the surfaces. */
+static SDL_bool
+verify(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect)
+{
+    const int bpp = SDL_BYTESPERPIXEL(format);
+    const size_t src_size = (size_t) src->h * src->pitch;
+    const size_t dst_size = (size_t) dst->h * dst->pitch;
+    Uint8 *src_copy = (Uint8 *) SDL_malloc(src_size);
+    Uint8 *expected = (Uint8 *) SDL_malloc(dst_size);
+    SDL_Rect rect = *dstrect;
+    SDL_bool result = SDL_FALSE;
+    int y;
+
+    if (src_copy && expected) {
+        SDL_memcpy(src_copy, src->pixels, src_size);
+        SDL_memcpy(expected, dst->pixels, dst_size);
+        for (y = 0; y < srcrect->h; ++y) {
+            SDL_memcpy(expected + (size_t) (dstrect->y + y) * dst->pitch + dstrect->x * bpp,
+                       src_copy + (size_t) (srcrect->y + y) * src->pitch + srcrect->x * bpp,
+                       (size_t) srcrect->w * bpp);
+        }
+        if (SDL_BlitSurface(src, srcrect, dst, &rect) == 0) {
+            result = (SDL_memcmp(dst->pixels, expected, dst_size) == 0) ? SDL_TRUE : SDL_FALSE;
+        }
+    }
+    SDL_free(src_copy);
+    SDL_free(expected);
+    return result;
+}
+
+/* Milliseconds per blit, or -1 if the blit is wrong */
+static double
+run(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect)
+{
+    SDL_Rect rect;
+    Uint64 start, elapsed;
+    int i;
+
+    /* Also warms up, the first touch of the destination pages is slow */
+    if (!verify(src, srcrect, dst, dstrect)) {
+        return -1.0;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        /* SDL_BlitSurface() clips the destination rectangle in place */
+        rect = *dstrect;
+        if (SDL_BlitSurface(src, srcrect, dst, &rect) < 0) {
+            SDL_Log("Blit failed: %s\n", SDL_GetError());
+            break;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    return (double) elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+static SDL_bool
+report(const char *name, const char *kind, int width, int height, double ms)
+{
+    const double bytes = (double) width * height * SDL_BYTESPERPIXEL(format);
+
+    if (ms < 0.0) {
+        SDL_Log("%-8s %-8s WRONG RESULT\n", name, kind);
+        return SDL_FALSE;
+    }
+    SDL_Log("%-8s %-8s %8.3f ms %7.2f GB/s\n", name, kind, ms, bytes / (SDL_max(ms, 0.000001) * 1000000.0));
+    return SDL_TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_bool ok = SDL_TRUE;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    iterations = SDL_max(iterations, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%s, %d iterations, SSE %s, AVX %s\n", SDL_GetPixelFormatName(format), iterations,
+            SDL_HasSSE() ? "yes" : "no", SDL_HasAVX() ? "yes" : "no");
+    for (i = 0; i < (int) SDL_arraysize(sizes); ++i) {
+        const Size *size = &sizes[i];
+        SDL_Surface *src = CreateSurface(size->width, size->height);
+        SDL_Surface *dst = CreateSurface(size->width, size->height);
+        SDL_Rect srcrect, dstrect;
+
+        if (!src || !dst) {
+            SDL_Log("Couldn't create %s surfaces: %s\n", size->name, SDL_GetError());
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            break;
+        }
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+        SDL_SetSurfaceBlendMode(dst, SDL_BLENDMODE_NONE);
+
+        srcrect.x = 0;
+        srcrect.y = 0;
+        srcrect.w = size->width;
+        srcrect.h = size->height;
+        dstrect = srcrect;
+        ok &= report(size->name, "copy", srcrect.w, srcrect.h, run(src, &srcrect, dst, &dstrect));
+
+        /* Rows that don't start at the same alignment in both surfaces */
+        srcrect.x = 1;
+        srcrect.w = size->width - 4;
+        dstrect.x = 3;
+        dstrect.w = srcrect.w;
+        ok &= report(size->name, "offset", srcrect.w, srcrect.h, run(src, &srcrect, dst, &dstrect));
+
+        /* Same 16-byte alignment in both surfaces, but not at the start of
+           the rows: large copies take the SSE streaming copy */
+        srcrect.x = 1;
+        srcrect.w = size->width - 5;
+        dstrect.x = 5;
+        dstrect.w = srcrect.w;
+        ok &= report(size->name, "shifted", srcrect.w, srcrect.h, run(src, &srcrect, dst, &dstrect));
+
+        /* Same 32-byte alignment, large copies take the AVX streaming copy
+           if the CPU has AVX, which has to match the SSE and memcpy results */
+        srcrect.x = 1;
+        srcrect.w = size->width - 9;
+        dstrect.x = 9;
+        dstrect.w = srcrect.w;
+        ok &= report(size->name, "shift32", srcrect.w, srcrect.h, run(src, &srcrect, dst, &dstrect));
+
+        /* Scroll up by one row, the way a terminal or a log view would */
+        srcrect.x = 0;
+        srcrect.w = size->width;
+        dstrect.x = 0;
+        dstrect.w = srcrect.w;
+        srcrect.y = 1;
+        srcrect.h = size->height - 1;
+        dstrect.h = srcrect.h;
+        ok &= report(size->name, "scroll", srcrect.w, srcrect.h, run(dst, &srcrect, dst, &dstrect));
+
+        /* Scroll down, which has to copy the rows from the bottom up */
+        srcrect.y = 0;
+        dstrect.y = 1;
+        ok &= report(size->name, "scrolldn", srcrect.w, srcrect.h, run(dst, &srcrect, dst, &dstrect));
+
+        /* Scroll right, each row overlaps itself */
+        srcrect.w = size->width - 5;
+        srcrect.h = size->height;
+        dstrect.x = 5;
+        dstrect.y = 0;
+        dstrect.w = srcrect.w;
+        dstrect.h = srcrect.h;
+        ok &= report(size->name, "hscroll", srcrect.w, srcrect.h, run(dst, &srcrect, dst, &dstrect));
+
+        /* And back to the left */
+        srcrect.x = 5;
+        dstrect.x = 0;
+        ok &= report(size->name, "hscrollb", srcrect.w, srcrect.h, run(dst, &srcrect, dst, &dstrect));
+
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
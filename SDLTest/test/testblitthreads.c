@@ -0,0 +1,190 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for SDL_HINT_BLIT_THREADS: converts a large image between a few
+   RGB and YUV formats with an increasing number of threads and reports the
+   speedup over converting on one thread. */
+
+#include "SDL.h"
+
+static int width = 3840;
+static int height = 2160;
+static int iterations = 10;
+
+typedef struct
+{
+    const char *name;
+    Uint32 src_format;
+    Uint32 dst_format;
+    SDL_BlendMode blend;    /* blit with this instead of SDL_ConvertPixels() */
+} Conversion;
+
+static const Conversion conversions[] = {
+    { "ARGB8888 -> RGB24", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24, SDL_BLENDMODE_INVALID },
+    { "ARGB8888 -> ABGR8888", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_BLENDMODE_INVALID },
+    { "RGB565 -> ARGB8888", SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_INVALID },
+    { "ARGB8888 blend RGB888", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND },
+    { "ARGB8888 -> NV12", SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_NV12, SDL_BLENDMODE_INVALID },
+    { "NV12 -> ARGB8888", SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_INVALID },
+    { "YUY2 -> RGB24", SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_RGB24, SDL_BLENDMODE_INVALID },
+};
+
+static int
+GetPitch(Uint32 format)
+{
+    if (format == SDL_PIXELFORMAT_NV12) {
+        return width;
+    }
+    if (format == SDL_PIXELFORMAT_YUY2) {
+        return 4 * ((width + 1) / 2);
+    }
+    return width * SDL_BYTESPERPIXEL(format);
+}
+
+static void *
+CreatePixels(Uint32 format)
+{
+    /* Enough for any of the formats above, including the NV12 chroma plane */
+    const size_t size = (size_t) GetPitch(format) * (height + 1) * 2;
+    Uint8 *pixels = (Uint8 *) SDL_malloc(size);
+    Uint32 seed = 1;
+    size_t i;
+
+    if (pixels) {
+        for (i = 0; i < size; ++i) {
+            seed = seed * 1103515245 + 12345;
+            pixels[i] = (Uint8) (seed >> 16);
+        }
+    }
+    return pixels;
+}
+
+/* Milliseconds per conversion */
+static double
+run(const Conversion *conversion, void *src, void *dst)
+{
+    const int src_pitch = GetPitch(conversion->src_format);
+    const int dst_pitch = GetPitch(conversion->dst_format);
+    SDL_Surface *src_surface = NULL;
+    SDL_Surface *dst_surface = NULL;
+    Uint64 start, elapsed;
+    int i;
+
+    if (conversion->blend != SDL_BLENDMODE_INVALID) {
+        src_surface = SDL_CreateRGBSurfaceWithFormatFrom(src, width, height, 0, src_pitch, conversion->src_format);
+        dst_surface = SDL_CreateRGBSurfaceWithFormatFrom(dst, width, height, 0, dst_pitch, conversion->dst_format);
+        if (!src_surface || !dst_surface) {
+            SDL_Log("Couldn't create surfaces: %s\n", SDL_GetError());
+            SDL_FreeSurface(src_surface);
+            SDL_FreeSurface(dst_surface);
+            return 0.0;
+        }
+        SDL_SetSurfaceBlendMode(src_surface, conversion->blend);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        int result;
+
+        if (src_surface) {
+            result = SDL_BlitSurface(src_surface, NULL, dst_surface, NULL);
+        } else {
+            result = SDL_ConvertPixels(width, height, conversion->src_format, src, src_pitch,
+                                       conversion->dst_format, dst, dst_pitch);
+        }
+        if (result < 0) {
+            SDL_Log("%s failed: %s\n", conversion->name, SDL_GetError());
+            break;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    SDL_FreeSurface(src_surface);
+    SDL_FreeSurface(dst_surface);
+    return (double) elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int max_threads = SDL_max(SDL_GetCPUCount(), 4);
+    void *src = NULL;
+    void *dst = NULL;
+    int num_threads, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+            width = SDL_atoi(argv[++i]);
+            height = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--threads N] [--size width height] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    max_threads = SDL_max(max_threads, 1);
+    width = SDL_max(width, 1);
+    height = SDL_max(height, 1);
+    iterations = SDL_max(iterations, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    /* Split every conversion in this benchmark, whatever its size */
+    SDL_SetHint(SDL_HINT_BLIT_THREADS_MIN_PIXELS, "0");
+
+    SDL_Log("%d CPUs, %dx%d pixels\n", SDL_GetCPUCount(), width, height);
+    for (i = 0; i < (int) SDL_arraysize(conversions); ++i) {
+        const Conversion *conversion = &conversions[i];
+        double single = 0.0;
+
+        src = CreatePixels(conversion->src_format);
+        dst = CreatePixels(conversion->dst_format);
+        if (!src || !dst) {
+            SDL_Log("Out of memory\n");
+            break;
+        }
+
+        for (num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+            char value[16];
+            double ms;
+
+            SDL_snprintf(value, sizeof(value), "%d", num_threads);
+            SDL_SetHint(SDL_HINT_BLIT_THREADS, value);
+            ms = run(conversion, src, dst);
+            if (num_threads == 1) {
+                single = ms;
+            }
+            SDL_Log("%-22s %2d threads: %8.2f ms (%.2fx)\n",
+                    conversion->name, num_threads, ms, single / SDL_max(ms, 0.001));
+        }
+
+        SDL_free(src);
+        SDL_free(dst);
+        src = dst = NULL;
+    }
+    SDL_free(src);
+    SDL_free(dst);
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
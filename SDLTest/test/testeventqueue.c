@@ -0,0 +1,161 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for the event queue under contention: several threads push user
+   events while the main thread polls them, and checks that each thread's
+   events come out in the order they were pushed. */
+
+#include "SDL.h"
+
+static int num_events = 200000;
+static SDL_atomic_t full_retries;
+
+static int SDLCALL
+pusher(void *data)
+{
+    const int thread = (int) (intptr_t) data;
+    SDL_Event event;
+    int i;
+
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    event.user.code = thread;
+    for (i = 0; i < num_events; i++) {
+        event.user.data1 = (void *) (intptr_t) i;
+        while (SDL_PushEvent(&event) != 1) {
+            /* The queue is full, give the consumer a chance to catch up */
+            SDL_AtomicIncRef(&full_retries);
+            SDL_Delay(0);
+        }
+    }
+    return 0;
+}
+
+static int
+bench(int threads, int batch)
+{
+    SDL_Thread **thread_list;
+    int *expected;
+    SDL_Event *events;
+    const int total = threads * num_events;
+    int received = 0, errors = 0, polls = 0;
+    Uint64 start, elapsed;
+    int i, result;
+
+    thread_list = (SDL_Thread **) SDL_calloc(threads, sizeof(*thread_list));
+    expected = (int *) SDL_calloc(threads, sizeof(*expected));
+    events = (SDL_Event *) SDL_calloc(batch, sizeof(*events));
+    if (!thread_list || !expected || !events) {
+        SDL_free(thread_list);
+        SDL_free(expected);
+        SDL_free(events);
+        SDL_Log("Out of memory\n");
+        return 1;
+    }
+
+    SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+    SDL_AtomicSet(&full_retries, 0);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < threads; i++) {
+        thread_list[i] = SDL_CreateThread(pusher, "EventPusher", (void *) (intptr_t) i);
+    }
+
+    while (received < total) {
+        if (batch == 1) {
+            result = SDL_PollEvent(events);
+        } else {
+            result = SDL_PeepEvents(events, batch, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+        }
+        ++polls;
+        for (i = 0; i < result; i++) {
+            const int code = events[i].user.code;
+            const int value = (int) (intptr_t) events[i].user.data1;
+            if (events[i].type != SDL_USEREVENT || code < 0 || code >= threads) {
+                continue;
+            }
+            if (value != expected[code]) {
+                errors++;
+            }
+            expected[code] = value + 1;
+            received++;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    for (i = 0; i < threads; i++) {
+        SDL_WaitThread(thread_list[i], NULL);
+    }
+
+    {
+        const double seconds = (double) elapsed / SDL_GetPerformanceFrequency();
+        SDL_Log("%2d pushers, %s: %8.3f ms, %6.2f M events/s, %d polls, %d full retries%s\n",
+                threads, (batch == 1) ? "SDL_PollEvent " : "SDL_PeepEvents",
+                seconds * 1000.0, total / seconds / 1000000.0, polls,
+                SDL_AtomicGet(&full_retries), errors ? ", OUT OF ORDER!" : "");
+    }
+
+    SDL_free(thread_list);
+    SDL_free(expected);
+    SDL_free(events);
+    return errors ? 1 : 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int threads = 0;
+    int batch = 64;
+    int retval = 0;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            num_events = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--threads N] [--events N] [--batch N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    num_events = SDL_max(num_events, 1);
+    batch = SDL_max(batch, 1);
+
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d CPUs, %d events per pusher\n", SDL_GetCPUCount(), num_events);
+
+    if (threads > 0) {
+        retval |= bench(threads, 1);
+        retval |= bench(threads, batch);
+    } else {
+        for (threads = 1; threads <= 8; threads *= 2) {
+            retval |= bench(threads, 1);
+            retval |= bench(threads, batch);
+        }
+    }
+
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
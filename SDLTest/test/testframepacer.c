@@ -0,0 +1,163 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for frame pacing: runs a loop with a bit of simulated work per
+   frame, limited once with the usual SDL_Delay() frame limiter and once with
+   an SDL_FramePacer, and compares the frame time statistics. */
+
+#include "SDL.h"
+
+static Uint64 frequency;
+
+static Uint64
+ticks_to_ns(Uint64 ticks)
+{
+    return (ticks / frequency) * 1000000000 + ((ticks % frequency) * 1000000000) / frequency;
+}
+
+/* Busy work that takes a varying fraction of the frame */
+static void
+simulate_work(int frame, Uint64 interval_ns)
+{
+    const Uint64 work_ns = interval_ns / 4 + (interval_ns / 4) * (Uint64) ((frame * 7919) % 100) / 100;
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    while (ticks_to_ns(SDL_GetPerformanceCounter() - start) < work_ns) {
+        /* spin */
+    }
+}
+
+/* Frames within a quarter millisecond of the target, a single preempted
+   frame can dominate the jitter on a busy machine. */
+static SDL_bool
+on_time(Uint64 frame_ns, Uint64 interval_ns)
+{
+    const Uint64 diff = (frame_ns > interval_ns) ? (frame_ns - interval_ns) : (interval_ns - frame_ns);
+    return (diff < 250000) ? SDL_TRUE : SDL_FALSE;
+}
+
+static void
+log_stats(const char *name, const SDL_FramePacerStats *stats, int on_time_frames)
+{
+    SDL_Log("%-14s %5" SDL_PRIu64 " frames, frame time %8.3f/%8.3f/%8.3f ms (min/avg/max), jitter %7.1f us, %5d on time, %" SDL_PRIu64 " missed\n",
+            name, stats->frames, stats->frame_min_ns / 1000000.0, stats->frame_avg_ns / 1000000.0,
+            stats->frame_max_ns / 1000000.0, stats->jitter_ns / 1000.0, on_time_frames, stats->missed_frames);
+}
+
+/* The classic limiter: sleep for whatever is left of the frame in whole milliseconds */
+static void
+bench_delay(int frames, Uint64 interval_ns)
+{
+    SDL_FramePacerStats stats;
+    double mean = 0.0, m2 = 0.0;
+    Uint64 last = SDL_GetPerformanceCounter();
+    int i, on_time_frames = 0;
+
+    SDL_zero(stats);
+    stats.interval_ns = interval_ns;
+    stats.frame_min_ns = ~(Uint64) 0;
+    for (i = 0; i < frames; i++) {
+        const Uint64 frame_start = SDL_GetPerformanceCounter();
+        Uint64 now, frame_ns, busy_ns;
+        double delta;
+
+        simulate_work(i, interval_ns);
+        busy_ns = ticks_to_ns(SDL_GetPerformanceCounter() - frame_start);
+        if (busy_ns < interval_ns) {
+            SDL_Delay((Uint32) ((interval_ns - busy_ns) / 1000000));
+        } else {
+            stats.missed_frames++;
+        }
+
+        now = SDL_GetPerformanceCounter();
+        frame_ns = ticks_to_ns(now - last);
+        last = now;
+        if (on_time(frame_ns, interval_ns)) {
+            on_time_frames++;
+        }
+
+        stats.frames++;
+        delta = (double) frame_ns - mean;
+        mean += delta / (double) stats.frames;
+        m2 += delta * ((double) frame_ns - mean);
+        stats.frame_min_ns = SDL_min(stats.frame_min_ns, frame_ns);
+        stats.frame_max_ns = SDL_max(stats.frame_max_ns, frame_ns);
+    }
+    stats.frame_avg_ns = (Uint64) mean;
+    stats.jitter_ns = (Uint64) SDL_sqrt(m2 / (double) stats.frames);
+    log_stats("SDL_Delay", &stats, on_time_frames);
+}
+
+static int
+bench_pacer(int frames, Uint64 interval_ns)
+{
+    SDL_FramePacerStats stats;
+    SDL_FramePacer *pacer = SDL_CreateFramePacer(interval_ns);
+    int i, on_time_frames = 0;
+
+    if (!pacer) {
+        SDL_Log("Couldn't create frame pacer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_FramePacerWait(pacer);
+    for (i = 0; i < frames; i++) {
+        simulate_work(i, interval_ns);
+        if (on_time(SDL_FramePacerWait(pacer), interval_ns)) {
+            on_time_frames++;
+        }
+    }
+
+    SDL_GetFramePacerStats(pacer, &stats);
+    log_stats("SDL_FramePacer", &stats, on_time_frames);
+    SDL_DestroyFramePacer(pacer);
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int fps = 60;
+    int seconds = 3;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            fps = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--fps N] [--seconds N]\n", argv[0]);
+            return 1;
+        }
+    }
+    fps = SDL_max(fps, 1);
+    seconds = SDL_max(seconds, 1);
+
+    if (SDL_Init(SDL_INIT_TIMER) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    frequency = SDL_GetPerformanceFrequency();
+
+    SDL_Log("%d fps for %d seconds, target frame time %.3f ms\n", fps, seconds, 1000.0 / fps);
+    bench_delay(fps * seconds, 1000000000 / fps);
+    i = bench_pacer(fps * seconds, 1000000000 / fps);
+
+    SDL_Quit();
+    return i;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,445 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for SDL_JobSystem: runs lots of small jobs, a tree of jobs that
+   spawn child jobs, and an SDL_ParallelFor() sum, and compares the
+   throughput with a simple thread pool sharing one mutex-protected queue.
+   Every run also checks that all the work was done. */
+
+#include "SDL.h"
+
+static int num_jobs = 200000;
+static int work_per_job = 200;
+
+static Uint64
+do_work(Uint64 seed)
+{
+    int i;
+    for (i = 0; i < work_per_job; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return seed;
+}
+
+/* The mutex-queue pool to compare with */
+
+typedef void (*PoolFunction)(void *data);
+
+typedef struct PoolTask
+{
+    PoolFunction func;
+    void *data;
+    struct PoolTask *next;
+} PoolTask;
+
+typedef struct Pool
+{
+    SDL_mutex *lock;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    PoolTask *head;
+    PoolTask *tail;
+    PoolTask *free_tasks;
+    int pending;
+    SDL_bool shutdown;
+    int num_threads;
+    SDL_Thread **threads;
+} Pool;
+
+static int SDLCALL
+pool_thread(void *data)
+{
+    Pool *pool = (Pool *) data;
+
+    SDL_LockMutex(pool->lock);
+    for (;;) {
+        PoolTask *task;
+        while (!pool->head && !pool->shutdown) {
+            SDL_CondWait(pool->work_cond, pool->lock);
+        }
+        if (!pool->head) {
+            break;
+        }
+        task = pool->head;
+        pool->head = task->next;
+        if (!pool->head) {
+            pool->tail = NULL;
+        }
+        SDL_UnlockMutex(pool->lock);
+
+        task->func(task->data);
+
+        SDL_LockMutex(pool->lock);
+        task->next = pool->free_tasks;
+        pool->free_tasks = task;
+        if (--pool->pending == 0) {
+            SDL_CondBroadcast(pool->done_cond);
+        }
+    }
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
+
+static Pool *
+pool_create(int num_threads)
+{
+    Pool *pool = (Pool *) SDL_calloc(1, sizeof(*pool));
+    int i;
+
+    pool->lock = SDL_CreateMutex();
+    pool->work_cond = SDL_CreateCond();
+    pool->done_cond = SDL_CreateCond();
+    pool->num_threads = num_threads;
+    pool->threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof(*pool->threads));
+    for (i = 0; i < num_threads; i++) {
+        pool->threads[i] = SDL_CreateThread(pool_thread, "PoolWorker", pool);
+    }
+    return pool;
+}
+
+static void
+pool_submit(Pool *pool, PoolFunction func, void *data)
+{
+    PoolTask *task;
+
+    SDL_LockMutex(pool->lock);
+    task = pool->free_tasks;
+    if (task) {
+        pool->free_tasks = task->next;
+    } else {
+        task = (PoolTask *) SDL_malloc(sizeof(*task));
+    }
+    task->func = func;
+    task->data = data;
+    task->next = NULL;
+    if (pool->tail) {
+        pool->tail->next = task;
+    } else {
+        pool->head = task;
+    }
+    pool->tail = task;
+    pool->pending++;
+    SDL_CondSignal(pool->work_cond);
+    SDL_UnlockMutex(pool->lock);
+}
+
+static void
+pool_wait(Pool *pool)
+{
+    SDL_LockMutex(pool->lock);
+    while (pool->pending > 0) {
+        SDL_CondWait(pool->done_cond, pool->lock);
+    }
+    SDL_UnlockMutex(pool->lock);
+}
+
+static void
+pool_destroy(Pool *pool)
+{
+    int i;
+
+    SDL_LockMutex(pool->lock);
+    pool->shutdown = SDL_TRUE;
+    SDL_CondBroadcast(pool->work_cond);
+    SDL_UnlockMutex(pool->lock);
+    for (i = 0; i < pool->num_threads; i++) {
+        SDL_WaitThread(pool->threads[i], NULL);
+    }
+    while (pool->free_tasks) {
+        PoolTask *task = pool->free_tasks;
+        pool->free_tasks = task->next;
+        SDL_free(task);
+    }
+    SDL_DestroyCond(pool->done_cond);
+    SDL_DestroyCond(pool->work_cond);
+    SDL_DestroyMutex(pool->lock);
+    SDL_free(pool->threads);
+    SDL_free(pool);
+}
+
+/* The workloads */
+
+static SDL_atomic_t jobs_done;
+static SDL_atomic_t work_sink;
+
+static void
+small_task(void *data)
+{
+    SDL_AtomicAdd(&work_sink, (int) do_work((Uint64) (uintptr_t) data));
+    SDL_AtomicIncRef(&jobs_done);
+}
+
+static void SDLCALL
+small_job(SDL_Job *job, void *data)
+{
+    small_task(data);
+}
+
+/* Submits all the small jobs as its children, so waiting for it waits for all of them */
+static void SDLCALL
+submit_small_jobs(SDL_Job *job, void *data)
+{
+    SDL_JobSystem *jobs = (SDL_JobSystem *) data;
+    int i;
+
+    for (i = 0; i < num_jobs; i++) {
+        SDL_DetachJob(SDL_SubmitJob(jobs, small_job, (void *) (intptr_t) i, job));
+    }
+}
+
+/* A binary tree of jobs, each node spawns its two children */
+static Pool *tree_pool;
+static SDL_JobSystem *tree_jobs;
+
+static void
+tree_task(void *data)
+{
+    const int depth = (int) (intptr_t) data;
+    if (depth > 0) {
+        pool_submit(tree_pool, tree_task, (void *) (intptr_t) (depth - 1));
+        pool_submit(tree_pool, tree_task, (void *) (intptr_t) (depth - 1));
+    }
+    small_task(data);
+}
+
+static void SDLCALL
+tree_job(SDL_Job *job, void *data)
+{
+    const int depth = (int) (intptr_t) data;
+    if (depth > 0) {
+        SDL_DetachJob(SDL_SubmitJob(tree_jobs, tree_job, (void *) (intptr_t) (depth - 1), job));
+        SDL_DetachJob(SDL_SubmitJob(tree_jobs, tree_job, (void *) (intptr_t) (depth - 1), job));
+    }
+    small_task(data);
+}
+
+typedef struct
+{
+    const Uint32 *values;
+    SDL_atomic_t sum;
+} SumData;
+
+static void SDLCALL
+sum_range(int start, int end, void *data)
+{
+    SumData *sum = (SumData *) data;
+    Uint32 total = 0;
+    int i;
+    for (i = start; i < end; i++) {
+        total += sum->values[i];
+    }
+    SDL_AtomicAdd(&sum->sum, (int) total);
+}
+
+static double
+elapsed_ms(Uint64 start)
+{
+    return (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static int
+check(const char *what, int expected)
+{
+    const int done = SDL_AtomicGet(&jobs_done);
+    if (done != expected) {
+        SDL_Log("%s: %d jobs ran, expected %d!\n", what, done, expected);
+        return 1;
+    }
+    return 0;
+}
+
+static void
+pool_small_jobs(Pool *pool)
+{
+    int i;
+    for (i = 0; i < num_jobs; i++) {
+        pool_submit(pool, small_task, (void *) (intptr_t) i);
+    }
+    pool_wait(pool);
+}
+
+static void
+jobs_small_jobs(SDL_JobSystem *jobs)
+{
+    SDL_WaitJob(SDL_SubmitJob(jobs, submit_small_jobs, jobs, NULL));
+}
+
+static void
+pool_tree(Pool *pool, int depth)
+{
+    tree_pool = pool;
+    pool_submit(pool, tree_task, (void *) (intptr_t) depth);
+    pool_wait(pool);
+}
+
+static void
+jobs_tree(SDL_JobSystem *jobs, int depth)
+{
+    tree_jobs = jobs;
+    SDL_WaitJob(SDL_SubmitJob(jobs, tree_job, (void *) (intptr_t) depth, NULL));
+}
+
+static int
+bench(int threads)
+{
+    SDL_JobSystem *jobs;
+    Pool *pool;
+    Uint64 start;
+    double pool_ms, jobs_ms;
+    const int depth = 16;
+    const int tree_size = (1 << (depth + 1)) - 1;
+    int retval = 0;
+
+    jobs = SDL_CreateJobSystem(threads);
+    if (!jobs) {
+        SDL_Log("Couldn't create job system: %s\n", SDL_GetError());
+        return 1;
+    }
+    pool = pool_create(threads);
+
+    /* Run everything once first, so neither side is timed while it
+       allocates its tasks and the pages under them */
+    pool_small_jobs(pool);
+    jobs_small_jobs(jobs);
+    pool_tree(pool, depth);
+    jobs_tree(jobs, depth);
+
+    /* Small independent jobs submitted from one thread */
+    SDL_AtomicSet(&jobs_done, 0);
+    start = SDL_GetPerformanceCounter();
+    pool_small_jobs(pool);
+    pool_ms = elapsed_ms(start);
+    retval |= check("pool, small jobs", num_jobs);
+
+    SDL_AtomicSet(&jobs_done, 0);
+    start = SDL_GetPerformanceCounter();
+    jobs_small_jobs(jobs);
+    jobs_ms = elapsed_ms(start);
+    retval |= check("job system, small jobs", num_jobs);
+
+    SDL_Log("%2d threads, %7d small jobs: mutex pool %8.3f ms, job system %8.3f ms (%.2fx)\n",
+            threads, num_jobs, pool_ms, jobs_ms, pool_ms / jobs_ms);
+
+    /* Jobs spawning jobs */
+    SDL_AtomicSet(&jobs_done, 0);
+    start = SDL_GetPerformanceCounter();
+    pool_tree(pool, depth);
+    pool_ms = elapsed_ms(start);
+    retval |= check("pool, job tree", tree_size);
+
+    SDL_AtomicSet(&jobs_done, 0);
+    start = SDL_GetPerformanceCounter();
+    jobs_tree(jobs, depth);
+    jobs_ms = elapsed_ms(start);
+    retval |= check("job system, job tree", tree_size);
+
+    SDL_Log("%2d threads, %7d tree jobs:  mutex pool %8.3f ms, job system %8.3f ms (%.2fx)\n",
+            threads, tree_size, pool_ms, jobs_ms, pool_ms / jobs_ms);
+
+    pool_destroy(pool);
+    SDL_DestroyJobSystem(jobs);
+    return retval;
+}
+
+static int
+bench_parallel_for(int threads)
+{
+    const int count = 16 * 1024 * 1024;
+    Uint32 *values = (Uint32 *) SDL_malloc(count * sizeof(*values));
+    SDL_JobSystem *jobs = SDL_CreateJobSystem(threads);
+    SumData sum;
+    Uint32 expected = 0;
+    Uint64 start;
+    double serial_ms, parallel_ms;
+    int i, retval = 0;
+
+    if (!values || !jobs) {
+        SDL_Log("Couldn't set up SDL_ParallelFor() benchmark: %s\n", SDL_GetError());
+        SDL_free(values);
+        SDL_DestroyJobSystem(jobs);
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        values[i] = (Uint32) do_work(i);
+        expected += values[i];
+    }
+    sum.values = values;
+
+    SDL_AtomicSet(&sum.sum, 0);
+    start = SDL_GetPerformanceCounter();
+    sum_range(0, count, &sum);
+    serial_ms = elapsed_ms(start);
+
+    SDL_AtomicSet(&sum.sum, 0);
+    start = SDL_GetPerformanceCounter();
+    SDL_ParallelFor(jobs, 0, count, 0, sum_range, &sum);
+    parallel_ms = elapsed_ms(start);
+    if ((Uint32) SDL_AtomicGet(&sum.sum) != expected) {
+        SDL_Log("SDL_ParallelFor() sum is wrong!\n");
+        retval = 1;
+    }
+
+    SDL_Log("%2d threads, SDL_ParallelFor sum of %d values: serial %8.3f ms, parallel %8.3f ms (%.2fx)\n",
+            threads, count, serial_ms, parallel_ms, serial_ms / parallel_ms);
+
+    SDL_DestroyJobSystem(jobs);
+    SDL_free(values);
+    return retval;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int threads = 0;
+    int retval = 0;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            num_jobs = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--work") == 0 && i + 1 < argc) {
+            work_per_job = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--threads N] [--jobs N] [--work N]\n", argv[0]);
+            return 1;
+        }
+    }
+    num_jobs = SDL_max(num_jobs, 1);
+    work_per_job = SDL_max(work_per_job, 0);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d CPUs, %d iterations of work per job\n", SDL_GetCPUCount(), work_per_job);
+
+    if (threads > 0) {
+        retval |= bench(threads);
+        retval |= bench_parallel_for(threads);
+    } else {
+        for (threads = 1; threads <= 8; threads *= 2) {
+            retval |= bench(threads);
+        }
+        retval |= bench_parallel_for(0);
+    }
+
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
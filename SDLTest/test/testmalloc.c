@@ -0,0 +1,141 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Multi-threaded SDL_malloc() benchmark: every thread keeps a working set
+   of small blocks and keeps replacing random ones with blocks of random
+   size, the way events, vertex arrays and audio packets churn through
+   memory. The C library malloc() runs the same pattern for comparison. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define SLOTS 256
+
+static int max_size = 512;
+static int iterations = 1000000;
+static SDL_bool use_sdl;
+
+static int SDLCALL
+worker(void *data)
+{
+    void *slots[SLOTS];
+    Uint32 seed = (Uint32) (uintptr_t) data * 2654435761u + 1;
+    int i;
+
+    SDL_zeroa(slots);
+    for (i = 0; i < iterations; ++i) {
+        int slot;
+        size_t size;
+
+        seed = seed * 1103515245 + 12345;
+        slot = (seed >> 8) % SLOTS;
+        size = 1 + (seed >> 16) % max_size;
+
+        if (use_sdl) {
+            SDL_free(slots[slot]);
+            slots[slot] = SDL_malloc(size);
+        } else {
+            free(slots[slot]);
+            slots[slot] = malloc(size);
+        }
+        if (!slots[slot]) {
+            return -1;
+        }
+        *(Uint8 *) slots[slot] = (Uint8) i;
+    }
+    for (i = 0; i < SLOTS; ++i) {
+        if (use_sdl) {
+            SDL_free(slots[i]);
+        } else {
+            free(slots[i]);
+        }
+    }
+    return 0;
+}
+
+static double
+run(SDL_bool sdl, int num_threads)
+{
+    SDL_Thread **threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof(*threads));
+    Uint64 start, elapsed;
+    int i, status, failed = 0;
+
+    if (!threads) {
+        SDL_Log("Out of memory\n");
+        return 0.0;
+    }
+
+    use_sdl = sdl;
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_threads; ++i) {
+        threads[i] = SDL_CreateThread(worker, "worker", (void *) (uintptr_t) i);
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], &status);
+        if (status != 0) {
+            failed = 1;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    SDL_free(threads);
+
+    if (failed) {
+        SDL_Log("Allocation failed\n");
+        return 0.0;
+    }
+    /* Millions of malloc/free pairs per second */
+    return (double) iterations * num_threads * SDL_GetPerformanceFrequency() / elapsed / 1000000.0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int max_threads = SDL_max(SDL_GetCPUCount(), 2);
+    int num_threads, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            max_size = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--threads N] [--size max-bytes] [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    max_threads = SDL_max(max_threads, 1);
+    max_size = SDL_max(max_size, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d CPUs, blocks of 1 to %d bytes\n", SDL_GetCPUCount(), max_size);
+    for (num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        const double sdl_rate = run(SDL_TRUE, num_threads);
+        const double libc_rate = run(SDL_FALSE, num_threads);
+        SDL_Log("%2d threads: SDL_malloc %7.2f M/s, malloc %7.2f M/s (%.2fx)\n",
+                num_threads, sdl_rate, libc_rate, sdl_rate / SDL_max(libc_rate, 0.001));
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,136 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for the timer scheduler: adds and removes lots of timers, the
+   way games use them for short-lived timeouts, then lets them all fire and
+   measures how late they were. */
+
+#include "SDL.h"
+
+static Uint64 frequency;
+static SDL_atomic_t fired;
+static SDL_atomic_t late_us_total;
+static SDL_atomic_t late_us_max;
+
+typedef struct
+{
+    Uint64 due;
+} TimerInfo;
+
+static Uint32 SDLCALL
+timeout_callback(Uint32 interval, void *param)
+{
+    return 0;
+}
+
+static Uint64 SDLCALL
+fire_callback(Uint64 interval, void *param)
+{
+    TimerInfo *info = (TimerInfo *) param;
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const int late_us = (now > info->due) ? (int) ((now - info->due) * 1000000 / frequency) : 0;
+    int max;
+
+    SDL_AtomicAdd(&late_us_total, late_us);
+    max = SDL_AtomicGet(&late_us_max);
+    while (late_us > max && !SDL_AtomicCAS(&late_us_max, max, late_us)) {
+        max = SDL_AtomicGet(&late_us_max);
+    }
+    SDL_AtomicIncRef(&fired);
+    return 0;
+}
+
+static double
+elapsed_ms(Uint64 start)
+{
+    return (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / frequency;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int num_timers = 10000;
+    SDL_TimerID *ids;
+    TimerInfo *infos;
+    Uint64 start;
+    double add_ms, remove_ms;
+    int i, removed = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--timers") == 0 && i + 1 < argc) {
+            num_timers = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--timers N]\n", argv[0]);
+            return 1;
+        }
+    }
+    num_timers = SDL_max(num_timers, 1);
+
+    if (SDL_Init(SDL_INIT_TIMER) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    ids = (SDL_TimerID *) SDL_calloc(num_timers, sizeof(*ids));
+    infos = (TimerInfo *) SDL_calloc(num_timers, sizeof(*infos));
+    if (!ids || !infos) {
+        SDL_Log("Out of memory\n");
+        SDL_Quit();
+        return 1;
+    }
+    frequency = SDL_GetPerformanceFrequency();
+
+    /* Timeouts that are canceled before they expire */
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_timers; i++) {
+        ids[i] = SDL_AddTimer(10000 + (i * 7919) % 20000, timeout_callback, NULL);
+    }
+    add_ms = elapsed_ms(start);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_timers; i++) {
+        if (SDL_RemoveTimer(ids[(i * 7919) % num_timers])) {
+            ++removed;
+        }
+    }
+    remove_ms = elapsed_ms(start);
+
+    SDL_Log("%d timeouts: add %8.3f ms (%6.0f ns each), remove %8.3f ms (%6.0f ns each), %d removed\n",
+            num_timers, add_ms, add_ms * 1000000.0 / num_timers,
+            remove_ms, remove_ms * 1000000.0 / num_timers, removed);
+
+    /* Timers that all fire within 200 ms, in scattered order */
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_timers; i++) {
+        const Uint64 interval = 10000000 + (Uint64) ((i * 7919) % num_timers) * 200000000 / num_timers;
+        infos[i].due = SDL_GetPerformanceCounter() + interval * frequency / 1000000000;
+        SDL_AddTimerNS(interval, fire_callback, &infos[i]);
+    }
+    while (SDL_AtomicGet(&fired) < num_timers && elapsed_ms(start) < 10000.0) {
+        SDL_Delay(10);
+    }
+
+    SDL_Log("%d timers fired in %8.3f ms, late by %.1f us on average, %d us at most\n",
+            SDL_AtomicGet(&fired), elapsed_ms(start),
+            (double) SDL_AtomicGet(&late_us_total) / SDL_max(SDL_AtomicGet(&fired), 1),
+            SDL_AtomicGet(&late_us_max));
+
+    SDL_free(ids);
+    SDL_free(infos);
+    SDL_Quit();
+    return (SDL_AtomicGet(&fired) == num_timers && removed == num_timers) ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
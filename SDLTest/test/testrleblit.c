@@ -0,0 +1,169 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for RLE accelerated sprites: draws mostly transparent sprites
+   with per-pixel alpha and with a colorkey onto a 1080p surface, with and
+   without RLE, and switches a sprite between two destinations the way a game
+   drawing to a window and to an offscreen surface would. */
+
+#include "SDL.h"
+
+#define SPRITE_SIZE 64
+#define NUM_SPRITES 1000
+
+static int iterations = 20;
+
+/* An antialiased disc, transparent outside */
+static SDL_Surface *
+CreateSprite(SDL_bool colorkey)
+{
+    SDL_Surface *sprite = SDL_CreateRGBSurfaceWithFormat(0, SPRITE_SIZE, SPRITE_SIZE, 0, SDL_PIXELFORMAT_ARGB8888);
+    const float radius = SPRITE_SIZE / 2 - 4;
+    int x, y;
+
+    if (!sprite) {
+        return NULL;
+    }
+    for (y = 0; y < SPRITE_SIZE; ++y) {
+        Uint32 *row = (Uint32 *) ((Uint8 *) sprite->pixels + y * sprite->pitch);
+        for (x = 0; x < SPRITE_SIZE; ++x) {
+            const float dx = x + 0.5f - SPRITE_SIZE / 2;
+            const float dy = y + 0.5f - SPRITE_SIZE / 2;
+            const float edge = radius - SDL_sqrtf(dx * dx + dy * dy);
+            const Uint32 color = 0x00203040 + (x << 17) + (y << 9);
+            Uint32 alpha;
+
+            if (edge <= 0.0f) {
+                alpha = 0;
+            } else if (edge >= 2.0f) {
+                alpha = 255;
+            } else {
+                alpha = (Uint32) (edge * 127.5f);
+            }
+            if (colorkey) {
+                row[x] = alpha >= 128 ? (0xFF000000 | color) : 0xFF000000;
+            } else {
+                row[x] = (alpha << 24) | color;
+            }
+        }
+    }
+    if (colorkey) {
+        SDL_SetColorKey(sprite, SDL_TRUE, 0xFF000000);
+        SDL_SetSurfaceBlendMode(sprite, SDL_BLENDMODE_NONE);
+    } else {
+        SDL_SetSurfaceBlendMode(sprite, SDL_BLENDMODE_BLEND);
+    }
+    return sprite;
+}
+
+/* Milliseconds per frame of NUM_SPRITES sprites, alternating between the destinations */
+static double
+run(SDL_Surface *sprite, SDL_Surface **targets, int num_targets)
+{
+    Uint64 start, elapsed;
+    int i, j;
+
+    /* Once to warm up and to encode the sprite */
+    for (j = 0; j < num_targets; ++j) {
+        SDL_BlitSurface(sprite, NULL, targets[j], NULL);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        Uint32 seed = 1;
+        for (j = 0; j < NUM_SPRITES; ++j) {
+            SDL_Surface *target = targets[j % num_targets];
+            SDL_Rect rect;
+
+            /* Some of them clipped at the edges */
+            seed = seed * 1103515245 + 12345;
+            rect.x = (int) ((seed >> 8) % (target->w + SPRITE_SIZE)) - SPRITE_SIZE / 2;
+            seed = seed * 1103515245 + 12345;
+            rect.y = (int) ((seed >> 8) % (target->h + SPRITE_SIZE)) - SPRITE_SIZE / 2;
+            rect.w = SPRITE_SIZE;
+            rect.h = SPRITE_SIZE;
+            if (SDL_BlitSurface(sprite, NULL, target, &rect) < 0) {
+                SDL_Log("Blit failed: %s\n", SDL_GetError());
+                return 0.0;
+            }
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    return (double) elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_ARGB8888 };
+    SDL_Surface *targets[SDL_arraysize(formats)];
+    int i, rle, colorkey;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--iterations N]\n", argv[0]);
+            return 1;
+        }
+    }
+    iterations = SDL_max(iterations, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    for (i = 0; i < (int) SDL_arraysize(formats); ++i) {
+        targets[i] = SDL_CreateRGBSurfaceWithFormat(0, 1920, 1080, 0, formats[i]);
+        if (!targets[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create target: %s\n", SDL_GetError());
+            return 1;
+        }
+        SDL_FillRect(targets[i], NULL, SDL_MapRGB(targets[i]->format, 0x40, 0x60, 0x80));
+    }
+
+    SDL_Log("%d %dx%d sprites per frame, %d iterations\n", NUM_SPRITES, SPRITE_SIZE, SPRITE_SIZE, iterations);
+    for (colorkey = 0; colorkey <= 1; ++colorkey) {
+        for (rle = 0; rle <= 1; ++rle) {
+            SDL_Surface *sprite = CreateSprite((SDL_bool) colorkey);
+            const char *kind = colorkey ? "colorkey" : "alpha";
+            const char *mode = rle ? "RLE" : "plain";
+            SDL_Surface *both[2];
+
+            if (!sprite) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create sprite: %s\n", SDL_GetError());
+                return 1;
+            }
+            SDL_SetSurfaceRLE(sprite, rle);
+            SDL_Log("%-8s %-5s ARGB8888          %8.3f ms\n", kind, mode, run(sprite, &targets[0], 1));
+            SDL_Log("%-8s %-5s RGB565            %8.3f ms\n", kind, mode, run(sprite, &targets[1], 1));
+            SDL_Log("%-8s %-5s ARGB8888+RGB565   %8.3f ms\n", kind, mode, run(sprite, &targets[0], 2));
+            both[0] = targets[0];
+            both[1] = targets[2];
+            SDL_Log("%-8s %-5s ARGB8888+ARGB8888 %8.3f ms\n", kind, mode, run(sprite, both, 2));
+            SDL_FreeSurface(sprite);
+        }
+    }
+
+    for (i = 0; i < (int) SDL_arraysize(formats); ++i) {
+        SDL_FreeSurface(targets[i]);
+    }
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,191 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Contention benchmark for SDL locks: several threads look things up in a
+   shared table and now and then change it, the way SDL's own device lists
+   are used, under an SDL_mutex, an SDL_rwlock and an SDL_SpinLock. */
+
+#include "SDL.h"
+
+#define TABLE_SIZE 64
+
+typedef enum
+{
+    LOCK_MUTEX,
+    LOCK_RWLOCK,
+    LOCK_SPINLOCK
+} LockType;
+
+static const char *lock_names[] = { "SDL_mutex", "SDL_rwlock", "SDL_SpinLock" };
+
+static LockType lock_type;
+static SDL_mutex *mutex;
+static SDL_rwlock *rwlock;
+static SDL_SpinLock spinlock;
+static int table[TABLE_SIZE];
+static int write_permille = 10;
+static int work = 50;
+static SDL_atomic_t running;
+static SDL_atomic_t total_ops;
+
+static void
+lock_table(SDL_bool writing)
+{
+    switch (lock_type) {
+    case LOCK_MUTEX:
+        SDL_LockMutex(mutex);
+        break;
+    case LOCK_RWLOCK:
+        if (writing) {
+            SDL_LockRWLockForWriting(rwlock);
+        } else {
+            SDL_LockRWLockForReading(rwlock);
+        }
+        break;
+    case LOCK_SPINLOCK:
+        SDL_AtomicLock(&spinlock);
+        break;
+    }
+}
+
+static void
+unlock_table(void)
+{
+    switch (lock_type) {
+    case LOCK_MUTEX:
+        SDL_UnlockMutex(mutex);
+        break;
+    case LOCK_RWLOCK:
+        SDL_UnlockRWLock(rwlock);
+        break;
+    case LOCK_SPINLOCK:
+        SDL_AtomicUnlock(&spinlock);
+        break;
+    }
+}
+
+static int SDLCALL
+worker(void *data)
+{
+    Uint32 seed = (Uint32) (uintptr_t) data * 2654435761u + 1;
+    int ops = 0;
+    int sum = 0;
+
+    while (SDL_AtomicGet(&running)) {
+        SDL_bool writing;
+        int i;
+
+        seed = seed * 1103515245 + 12345;
+        writing = ((seed >> 8) % 1000 < (Uint32) write_permille) ? SDL_TRUE : SDL_FALSE;
+
+        lock_table(writing);
+        if (writing) {
+            for (i = 0; i < TABLE_SIZE; ++i) {
+                ++table[i];
+            }
+        } else {
+            for (i = 0; i < work; ++i) {
+                sum += table[(seed + i) % TABLE_SIZE];
+            }
+        }
+        unlock_table();
+        ++ops;
+    }
+    SDL_AtomicAdd(&total_ops, ops);
+    return sum;
+}
+
+static void
+run(LockType type, int num_threads, Uint32 duration)
+{
+    SDL_Thread **threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof(*threads));
+    Uint64 start, elapsed;
+    int i;
+
+    if (!threads) {
+        SDL_Log("Out of memory\n");
+        return;
+    }
+
+    lock_type = type;
+    SDL_AtomicSet(&total_ops, 0);
+    SDL_AtomicSet(&running, 1);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < num_threads; ++i) {
+        threads[i] = SDL_CreateThread(worker, "worker", (void *) (uintptr_t) i);
+    }
+    SDL_Delay(duration);
+    SDL_AtomicSet(&running, 0);
+    for (i = 0; i < num_threads; ++i) {
+        SDL_WaitThread(threads[i], NULL);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    SDL_free(threads);
+
+    SDL_Log("%2d threads, %-12s %10.0f ops/s\n", num_threads, lock_names[type],
+            (double) SDL_AtomicGet(&total_ops) * SDL_GetPerformanceFrequency() / elapsed);
+}
+
+int
+main(int argc, char *argv[])
+{
+    int max_threads = SDL_max(SDL_GetCPUCount(), 2);
+    Uint32 duration = 1000;
+    int num_threads, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--writes") == 0 && i + 1 < argc) {
+            write_permille = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--work") == 0 && i + 1 < argc) {
+            work = SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--ms") == 0 && i + 1 < argc) {
+            duration = (Uint32) SDL_atoi(argv[++i]);
+        } else {
+            SDL_Log("USAGE: %s [--threads N] [--writes per-mille] [--work N] [--ms N]\n", argv[0]);
+            return 1;
+        }
+    }
+    max_threads = SDL_max(max_threads, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    mutex = SDL_CreateMutex();
+    rwlock = SDL_CreateRWLock();
+    if (!mutex || !rwlock) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create locks: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Log("%d CPUs, %d.%d%% writes, %d reads per lookup\n", SDL_GetCPUCount(),
+            write_permille / 10, write_permille % 10, work);
+    for (num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        run(LOCK_MUTEX, num_threads, duration);
+        run(LOCK_RWLOCK, num_threads, duration);
+        run(LOCK_SPINLOCK, num_threads, duration);
+    }
+
+    SDL_DestroyRWLock(rwlock);
+    SDL_DestroyMutex(mutex);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
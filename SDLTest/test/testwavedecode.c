@@ -0,0 +1,226 @@
+/*
+  Copyright (C) 1997-2022 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark for the ADPCM decoders of SDL_LoadWAV_RW: decodes sample.wav and
+   a few generated long files on the calling thread only and with the default
+   number of decoding threads, and checks that both give the same data. */
+
+#include "SDL.h"
+
+static Uint32 seed = 0x1234567;
+
+static Uint8
+random_byte(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (Uint8) (seed >> 16);
+}
+
+static Uint8 *
+put_le(Uint8 *p, Uint32 value, int bytes)
+{
+    int i;
+    for (i = 0; i < bytes; i++) {
+        *p++ = (Uint8) (value >> (i * 8));
+    }
+    return p;
+}
+
+/* Generates an ADPCM WAVE file with random data and valid block headers. */
+static Uint8 *
+make_adpcm_wave(Uint16 tag, Uint16 channels, Uint32 seconds, size_t *wavelen)
+{
+    /* wSamplesPerBlock (filled in below), wNumCoef and the preset coefficients. */
+    Uint8 ext[32] = {
+        0, 0, 7, 0,
+        0, 1, 0, 0,  0, 2, 0, 0xff,  0, 0, 0, 0,  0xc0, 0, 0x40, 0,
+        0xf0, 0, 0, 0,  0xcc, 1, 0x30, 0xff,  0x88, 1, 0x18, 0xff
+    };
+    const Uint16 extlen = (tag == 0x0002) ? 32 : 2;
+    const Uint16 blockalign = (Uint16) (1024 * channels);
+    const Uint32 samplesperblock = (tag == 0x0002) ? (blockalign - 7 * channels) * 2 / channels + 2
+                                                   : (blockalign - 4 * channels) * 2 / channels + 1;
+    const Uint32 blocks = (44100 * seconds) / samplesperblock;
+    const Uint32 datalen = blocks * blockalign;
+    Uint8 *wave, *p, *data;
+    Uint32 i, c;
+
+    ext[0] = (Uint8) samplesperblock;
+    ext[1] = (Uint8) (samplesperblock >> 8);
+
+    wave = (Uint8 *) SDL_malloc(64 + datalen);
+    if (wave == NULL) {
+        return NULL;
+    }
+
+    p = wave;
+    p = put_le(p, 0x46464952, 4); /* "RIFF" */
+    p = put_le(p, 4 + 8 + 18 + extlen + 8 + datalen, 4);
+    p = put_le(p, 0x45564157, 4); /* "WAVE" */
+    p = put_le(p, 0x20746D66, 4); /* "fmt " */
+    p = put_le(p, 18 + extlen, 4);
+    p = put_le(p, tag, 2);
+    p = put_le(p, channels, 2);
+    p = put_le(p, 44100, 4);
+    p = put_le(p, 44100 * blockalign / samplesperblock, 4);
+    p = put_le(p, blockalign, 2);
+    p = put_le(p, 4, 2);
+    p = put_le(p, extlen, 2);
+    SDL_memcpy(p, ext, extlen);
+    p += extlen;
+    p = put_le(p, 0x61746164, 4); /* "data" */
+    p = put_le(p, datalen, 4);
+
+    data = p;
+    for (i = 0; i < datalen; i++) {
+        data[i] = random_byte();
+    }
+    for (i = 0; i < datalen; i += blockalign) {
+        for (c = 0; c < channels; c++) {
+            if (tag == 0x0002) {
+                data[i + c] = random_byte() % 7;
+            } else {
+                data[i + c * 4 + 2] = random_byte() % 89;
+                data[i + c * 4 + 3] = 0;
+            }
+        }
+    }
+
+    *wavelen = (size_t) (data - wave) + datalen;
+    return wave;
+}
+
+/* Decodes the file 'iterations' times after one warm-up run, returns the
+   average time in ms. */
+static double
+time_decode(const void *wave, size_t wavelen, int iterations, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    SDL_AudioSpec spec;
+    Uint64 start, total = 0;
+    int i;
+
+    *audio_buf = NULL;
+    for (i = 0; i <= iterations; i++) {
+        SDL_FreeWAV(*audio_buf);
+        start = SDL_GetPerformanceCounter();
+        if (SDL_LoadWAV_RW(SDL_RWFromConstMem(wave, (int) wavelen), 1, &spec, audio_buf, audio_len) == NULL) {
+            SDL_Log("Failed to load WAVE data: %s\n", SDL_GetError());
+            return -1.0;
+        }
+        if (i > 0) {
+            total += SDL_GetPerformanceCounter() - start;
+        }
+    }
+
+    return (double) total * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+static int
+bench(const char *name, const void *wave, size_t wavelen, int iterations)
+{
+    Uint8 *serial_buf = NULL, *threaded_buf = NULL;
+    Uint32 serial_len = 0, threaded_len = 0;
+    double serial_ms, threaded_ms;
+    int retval = 0;
+
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "1");
+    serial_ms = time_decode(wave, wavelen, iterations, &serial_buf, &serial_len);
+    SDL_SetHint(SDL_HINT_WAVE_DECODE_THREADS, "0");
+    threaded_ms = time_decode(wave, wavelen, iterations, &threaded_buf, &threaded_len);
+
+    if (serial_ms < 0.0 || threaded_ms < 0.0) {
+        retval = 1;
+    } else if (serial_len != threaded_len || SDL_memcmp(serial_buf, threaded_buf, serial_len) != 0) {
+        SDL_Log("%s: threaded output differs from serial output!\n", name);
+        retval = 1;
+    } else {
+        const double mb = serial_len / (1024.0 * 1024.0);
+        SDL_Log("%-24s %8.2f MB  serial %8.3f ms (%7.1f MB/s)  threaded %8.3f ms (%7.1f MB/s)\n",
+                name, mb, serial_ms, mb * 1000.0 / serial_ms, threaded_ms, mb * 1000.0 / threaded_ms);
+    }
+
+    SDL_FreeWAV(serial_buf);
+    SDL_FreeWAV(threaded_buf);
+    return retval;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *filename = "sample.wav";
+    int iterations = 20;
+    int retval = 0;
+    SDL_RWops *rw;
+    Uint8 *wave;
+    size_t wavelen;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = SDL_atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            filename = argv[i];
+        } else {
+            SDL_Log("USAGE: %s [--iterations N] [file.wav]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    iterations = SDL_max(iterations, 1);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%d CPUs, %d iterations\n", SDL_GetCPUCount(), iterations);
+
+    /* The file as given, loaded into memory so only decoding is measured. */
+    rw = SDL_RWFromFile(filename, "rb");
+    if (rw == NULL) {
+        SDL_Log("Couldn't open %s: %s\n", filename, SDL_GetError());
+    } else {
+        const Sint64 size = SDL_RWsize(rw);
+        wave = (size > 0) ? (Uint8 *) SDL_malloc((size_t) size) : NULL;
+        if (wave != NULL && SDL_RWread(rw, wave, (size_t) size, 1) == 1) {
+            retval |= bench(filename, wave, (size_t) size, iterations);
+        }
+        SDL_free(wave);
+        SDL_RWclose(rw);
+    }
+
+    wave = make_adpcm_wave(0x0002, 2, 60, &wavelen);
+    if (wave != NULL) {
+        retval |= bench("60 s stereo MS ADPCM", wave, wavelen, SDL_max(iterations / 10, 1));
+        SDL_free(wave);
+    }
+
+    wave = make_adpcm_wave(0x0011, 2, 60, &wavelen);
+    if (wave != NULL) {
+        retval |= bench("60 s stereo IMA ADPCM", wave, wavelen, SDL_max(iterations / 10, 1));
+        SDL_free(wave);
+    }
+
+    wave = make_adpcm_wave(0x0011, 6, 20, &wavelen);
+    if (wave != NULL) {
+        retval |= bench("20 s 5.1 IMA ADPCM", wave, wavelen, SDL_max(iterations / 10, 1));
+        SDL_free(wave);
+    }
+
+    SDL_Quit();
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -42,7 +42,7 @@ static SDL_Surface *generate_test_pattern(int pattern_size)
 
         /* R, G, B in alternating horizontal bands */
         for (y = 0; y < pattern->h; y += thickness) {
-            for (i = 0; i < thickness; ++i) {
+            for (i = 0; i < thickness && (y + i) < pattern->h; ++i) {
                 p = (Uint8 *)pattern->pixels + (y + i) * pattern->pitch + ((y/thickness) % 3);
                 for (x = 0; x < pattern->w; ++x) {
                     *p = 0xFF;
@@ -54,7 +54,7 @@ static SDL_Surface *generate_test_pattern(int pattern_size)
         /* Black and white in alternating vertical bands */
         c = 0xFF;
         for (x = 1*thickness; x < pattern->w; x += 2*thickness) {
-            for (i = 0; i < thickness; ++i) {
+            for (i = 0; i < thickness && (x + i) < pattern->w; ++i) {
                 p = (Uint8 *)pattern->pixels + (x + i)*3;
                 for (y = 0; y < pattern->h; ++y) {
                     SDL_memset(p, c, 3);
@@ -216,6 +216,120 @@ done:
     return result;
 }
 
+/* Compare the columns that a conversion of the image starting 'offset' columns
+   to the right shares with the conversion of the whole image, both written
+   with the same pitch. 'offset' is even, so the chroma pairs line up. */
+static SDL_bool compare_yuv_columns(Uint32 format, const Uint8 *whole, const Uint8 *shifted, int pitch, int w, int h, int offset)
+{
+    const int uv_h = (h + 1) / 2;
+    int uv_pitch, y;
+
+    if (is_packed_yuv_format(format)) {
+        for (y = 0; y < h; ++y) {
+            if (SDL_memcmp(whole + y * pitch + 2 * offset, shifted + y * pitch, CalculateYUVPitch(format, w - offset)) != 0) {
+                return SDL_FALSE;
+            }
+        }
+        return SDL_TRUE;
+    }
+
+    for (y = 0; y < h; ++y) {
+        if (SDL_memcmp(whole + y * pitch + offset, shifted + y * pitch, w - offset) != 0) {
+            return SDL_FALSE;
+        }
+    }
+    if (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21) {
+        uv_pitch = 2 * ((pitch + 1) / 2);
+        for (y = 0; y < uv_h; ++y) {
+            const int uv_offset = h * pitch + y * uv_pitch;
+            if (SDL_memcmp(whole + uv_offset + offset, shifted + uv_offset, 2 * ((w - offset + 1) / 2)) != 0) {
+                return SDL_FALSE;
+            }
+        }
+    } else {
+        /* The U and V planes follow each other with the same pitch */
+        uv_pitch = (pitch + 1) / 2;
+        for (y = 0; y < 2 * uv_h; ++y) {
+            const int uv_offset = h * pitch + y * uv_pitch;
+            if (SDL_memcmp(whole + uv_offset + offset / 2, shifted + uv_offset, (w - offset + 1) / 2) != 0) {
+                return SDL_FALSE;
+            }
+        }
+    }
+    return SDL_TRUE;
+}
+
+/* Which encoder converts a column depends on how many pixels are left in the
+   row: whole blocks go to the widest SIMD kernel the CPU has (AVX2 or NEON,
+   then SSE2) and the rest to the C code. Converting a noisy image starting at
+   different columns moves each column between them, so this checks that the
+   AVX2, SSE2 and C encoders give exactly the same output. */
+static int run_simd_column_tests(void)
+{
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_XBGR8888
+    };
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2,
+        SDL_PIXELFORMAT_UYVY,
+        SDL_PIXELFORMAT_YVYU
+    };
+    const int w = 99, h = 5, max_offset = 64;
+    const int pitch = CalculateYUVPitch(SDL_PIXELFORMAT_YUY2, w);
+    const int yuv_len = MAX_YUV_SURFACE_SIZE(w, h, 0);
+    Uint32 *rgb = (Uint32 *)SDL_malloc(w * h * sizeof(Uint32));
+    Uint8 *whole = (Uint8 *)SDL_malloc(yuv_len);
+    Uint8 *shifted = (Uint8 *)SDL_malloc(yuv_len);
+    Uint32 seed = 1;
+    int i, j, offset;
+    int result = -1;
+
+    if (!rgb || !whole || !shifted) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't allocate test images");
+        goto done;
+    }
+    for (i = 0; i < w * h; ++i) {
+        seed = seed * 1103515245 + 12345;
+        rgb[i] = seed ^ (seed >> 15);
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Running SIMD column tests, SSE2 %s, AVX2 %s, NEON %s\n",
+                SDL_HasSSE2() ? "yes" : "no", SDL_HasAVX2() ? "yes" : "no", SDL_HasNEON() ? "yes" : "no");
+    for (i = 0; i < SDL_arraysize(rgb_formats); ++i) {
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            SDL_memset(whole, 0, yuv_len);
+            if (SDL_ConvertPixels(w, h, rgb_formats[i], rgb, w * sizeof(Uint32), formats[j], whole, pitch) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetPixelFormatName(formats[j]), SDL_GetError());
+                goto done;
+            }
+            for (offset = 2; offset <= max_offset; offset += 2) {
+                SDL_memset(shifted, 0, yuv_len);
+                if (SDL_ConvertPixels(w - offset, h, rgb_formats[i], rgb + offset, w * sizeof(Uint32), formats[j], shifted, pitch) < 0) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetPixelFormatName(formats[j]), SDL_GetError());
+                    goto done;
+                }
+                if (!compare_yuv_columns(formats[j], whole, shifted, pitch, w, h, offset)) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Conversion from %s to %s starting at column %d doesn't match\n", SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetPixelFormatName(formats[j]), offset);
+                    goto done;
+                }
+            }
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_free(rgb);
+    SDL_free(whole);
+    SDL_free(shifted);
+    return result;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -323,6 +437,9 @@ main(int argc, char **argv)
                 return 2;
             }
         }
+        if (run_simd_column_tests() < 0) {
+            return 2;
+        }
         return 0;
     }
 